@@ -231,14 +231,20 @@ private:
     wptr<BackupExtExtension> bakExtExtension_;
     bool supportWithoutTar_ {false};
     std::vector<std::string> excludeInfos_;
+    std::vector<std::string> restorePaths_;
     int32_t batchSize_ {500};
     std::string callerBundleName_;
+    std::string sessionActiveTime_;
+    std::string streamKey_;
     
 public:
     bool GetSupportWithoutTar() const;
     std::vector<std::string> GetExcludeInfos() const;
+    std::vector<std::string> GetRestorePaths() const;
     int32_t GetBatchSize() const;
     std::string GetCallerBundleName() const;
+    std::string GetSessionActiveTime() const;
+    std::string GetStreamKey() const;
 };
 } // namespace OHOS::FileManagement::Backup
 
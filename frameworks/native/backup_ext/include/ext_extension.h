@@ -24,12 +24,18 @@
 #include <tuple>
 #include <unordered_set>
 #include <cstdint>
+#include <exception>
 #include <functional>
+#include <thread>
 
 #include <sys/stat.h>
 
 #include "anco_backup_callback_stub.h"
 #include "anco_restore_callback_stub.h"
+#include "b_encryption/b_stream_cipher.h"
+#include "b_filesystem/b_backup_checkpoint.h"
+#include "b_filesystem/b_dir_cache.h"
+#include "b_filesystem/b_scan_snapshot.h"
 #include "b_json/b_json_entity_extension_config.h"
 #include "b_json/b_json_entity_ext_manage.h"
 #include "b_json/b_report_entity.h"
@@ -45,6 +51,7 @@
 #include "timer.h"
 #include "unique_fd.h"
 #include "untar_file.h"
+#include "b_utils/bounded_queue.h"
 #include "b_utils/string_utils.h"
 
 namespace OHOS::FileManagement::Backup {
@@ -52,6 +59,13 @@ const string INDEX_FILE_BACKUP = string(BConstants::PATH_BUNDLE_BACKUP_HOME)
                                      .append(BConstants::SA_BUNDLE_BACKUP_BACKUP)
                                      .append(BConstants::EXT_BACKUP_MANAGE);
 class BackupExtExtension;
+struct BigFileSendTask {
+    std::string fileName;
+    std::string manifestFile;
+    int fd = -1;
+    int manifestFd = -1;
+    int32_t errCode = ERR_OK;
+};
 class AncoBackupCallback : public AncoBackupCallbackStub {
 public:
     AncoBackupCallback(wptr<BackupExtExtension> extension) : extension_(extension)
@@ -144,6 +158,7 @@ public:
         onReleaseTaskPool_.Start(BConstants::EXTENSION_THREAD_POOL_COUNT);
         manageJsonFilePool_.Start(BConstants::EXTENSION_THREAD_POOL_COUNT);
         SetStagingPathProperties();
+        InitStreamKeyProvider();
         appStatistic_ = std::make_shared<RadarAppStatistic>();
     }
     ~BackupExtExtension()
@@ -183,8 +198,9 @@ private:
      * @brief restore
      *
      * @param fileName name of the file that to be untar
+     * @param fingerprint 恢复日志中记录的tar包指纹, 为空时不记录
      */
-    int DoRestore(const string &fileName, const off_t fileSize);
+    int DoRestore(const string &fileName, const off_t fileSize, const string &fingerprint);
 
     /**
      * @brief incremental restore
@@ -280,29 +296,59 @@ private:
     void FillFileInfosWithoutCmp(vector<struct ReportFileInfo> &allFiles,
                                  vector<struct ReportFileInfo> &smallFiles,
                                  vector<struct ReportFileInfo> &bigFiles,
-                                 UniqueFd incrementalFd);
+                                 BReportEntity &storageRp);
     void FillFileInfosWithCmp(vector<struct ReportFileInfo> &allFiles,
                               vector<struct ReportFileInfo> &smallFiles,
                               vector<struct ReportFileInfo> &bigFiles,
                               const unordered_map<string, struct ReportFileInfo> &cloudFiles,
-                              UniqueFd incrementalFd);
+                              BReportEntity &storageRp);
+    // 两份简报都按路径排序时流式归并对比, 不再把云端简报整体载入哈希表
+    void FillFileInfosWithMergeJoin(vector<struct ReportFileInfo> &allFiles,
+                                    vector<struct ReportFileInfo> &smallFiles,
+                                    vector<struct ReportFileInfo> &bigFiles,
+                                    BReportEntity &cloudRp,
+                                    BReportEntity &storageRp);
     void CompareFiles(vector<struct ReportFileInfo> &allFiles,
                       vector<struct ReportFileInfo> &smallFiles,
                       vector<struct ReportFileInfo> &bigFiles,
                       const unordered_map<string, struct ReportFileInfo> &cloudFiles,
                       unordered_map<string, struct ReportFileInfo> &localFilesInfo);
+    // 对比单个本地文件与其云端条目, cloud为空表示云端不存在
+    void CompareFile(vector<struct ReportFileInfo> &allFiles,
+                     vector<struct ReportFileInfo> &smallFiles,
+                     vector<struct ReportFileInfo> &bigFiles,
+                     const struct ReportFileInfo *cloud,
+                     struct ReportFileInfo &local);
+    // 计算本地文件摘要并带出stat结果, 有扫描快照且文件元数据未变化时复用上次的摘要
+    string GetLocalFileHash(const string &path, struct stat &sta);
 
     void AsyncTaskDoIncrementalBackup(UniqueFd incrementalFd, UniqueFd manifestFd);
     void AsyncTaskOnIncrementalBackup();
     int DoIncrementalBackupTask(UniqueFd incrementalFd, UniqueFd manifestFd);
     ErrCode IncrementalBigFileReady(TarMap &pkgInfo, const vector<struct ReportFileInfo> &bigInfos,
         sptr<IService> proxy);
+    void PrepareBigFileSendTasks(TarMap &pkgInfo, const vector<struct ReportFileInfo> &bigInfos,
+        BoundedQueue<BigFileSendTask> &sendQueue, vector<string> &noPermissionFiles);
+    void DrainBigFileSendTasks(BoundedQueue<BigFileSendTask> &sendQueue);
     void WaitToSendFd(std::chrono::system_clock::time_point &startTime, int &fdSendNum);
     void RefreshTimeInfo(std::chrono::system_clock::time_point &startTime, int &fdSendNum);
     void IncrementalPacket(const vector<struct ReportFileInfo> &infos, TarMap &tar, sptr<IService> proxy);
     void DoPacket();
     void DoPacketOnce(const std::vector<std::shared_ptr<ISmallFileInfo>> &packFiles, const string &path,
         std::function<void(std::string, int)> reportCb, uint64_t &totalTarSpend);
+    void DoPacketOnce(TarFile &tarFile, const string &tarName,
+        const std::vector<std::shared_ptr<ISmallFileInfo>> &packFiles, const string &path,
+        std::function<void(std::string, int)> reportCb, uint64_t &totalTarSpend);
+    // 按分片大小和文件数把小文件切成若干包, onSlice返回false时停止切分
+    void SliceSmallFiles(const std::vector<std::shared_ptr<ISmallFileInfo>> &allSmallFile,
+        const std::function<bool(std::vector<std::shared_ptr<ISmallFileInfo>> &)> &onSlice);
+    void ProduceSmallFilePacks(const std::vector<std::shared_ptr<ISmallFileInfo>> &allSmallFile,
+        BoundedQueue<std::vector<std::shared_ptr<ISmallFileInfo>>> &packQueue);
+    static std::function<void(std::string, int)> SerializeReportCb(std::function<void(std::string, int)> reportCb);
+    uint64_t DoPacketMultiLane(BoundedQueue<std::vector<std::shared_ptr<ISmallFileInfo>>> &packQueue,
+        uint32_t laneCount, const string &tarPath, std::function<void(std::string, int)> reportCb);
+    uint64_t JoinPacketLanes(std::vector<std::thread> &lanes, const std::vector<uint64_t> &laneTarUs,
+        const std::vector<std::exception_ptr> &laneErrs);
     void CheckTmpDirFileInfos(bool isSpecialVersion = false);
     std::map<std::string, off_t> GetIdxFileInfos(bool isSpecialVersion = false);
     tuple<bool, vector<string>> CheckRestoreFileInfos();
@@ -401,10 +447,15 @@ private:
     ErrCode RestoreTarForSpecialCloneCloud(const ExtManageInfo &item);
     void RestoreBigFiles(bool appendTargetPath);
     void FillEndFileInfos(const std::string &path, const unordered_map<string, struct ReportFileInfo> &result);
-    void RestoreBigFileAfter(const string &filePath, const struct stat &sta);
+    bool RestoreBigFileAfter(const string &filePath, const struct stat &sta);
     void DealIncreUnPacketResult(const off_t tarFileSize, const std::string &tarFileName,
         const std::tuple<int, EndFileInfo, ErrFileInfo> &result);
 
+    /**
+     * @brief 向应用上报内容摘要校验失败的文件, 不受调试开关影响
+     */
+    void ReportDigestMismatch(const ErrFileInfo &errInfos);
+
     ErrCode StartOnProcessTaskThread(wptr<BackupExtExtension> obj, BackupRestoreScenario scenario);
     void FinishOnProcessTask();
     void ExecCallOnProcessTask(wptr<BackupExtExtension> obj, BackupRestoreScenario scenario);
@@ -415,12 +466,60 @@ private:
     void UpdateOnStartTime();
     int32_t GetOnStartTimeCost();
     bool SetStagingPathProperties();
+    /**
+     * @brief 配置了加密密钥标识或已有本地密钥时, 注册本地密钥提供者, 用于加密备份产物和解密恢复数据
+     */
+    void InitStreamKeyProvider();
 
     std::function<void(std::string, int)> ReportErrFileByProc(wptr<BackupExtExtension> obj,
         BackupRestoreScenario scenario);
     std::tuple<ErrCode, UniqueFd, UniqueFd> GetIncreFileHandleForNormalVersion(const std::string &fileName);
     FileOpenResult GetIncreFileHandleForUntarNormalVersion(const std::string &fileName);
     void RestoreOneBigFile(const std::string &path, const ExtManageInfo &item, const bool appendTargetPath);
+    // 把恢复的大文件移动到目标路径, 大文件已加密时解密写入目标路径
+    bool MoveBigFile(const std::string &src, const std::string &dst);
+
+    /**
+     * @brief 打开恢复日志, 以会话激活时间和恢复索引的摘要标识本次恢复, 同一会话内重新投递时沿用已完成的记录
+     */
+    void OpenRestoreJournal();
+
+    /**
+     * @brief 判断tar包或大文件是否已在本次会话中以相同指纹恢复完成, 已完成时计入跳过数
+     */
+    bool SkipRestored(const std::string &name, const std::string &fingerprint);
+
+    /**
+     * @brief 记录tar包或大文件已恢复完成, 返回前已落盘
+     */
+    void CommitRestored(const std::string &name, const std::string &fingerprint);
+
+    /**
+     * @brief 记录tar包或大文件恢复失败, 不记入恢复日志, 计入失败数
+     */
+    void RecordRestoreFailed(const std::string &name);
+
+    /**
+     * @brief 输出恢复汇总并删除恢复日志
+     */
+    void FinishRestoreJournal(ErrCode ret);
+
+    /**
+     * @brief 读取选择性恢复的路径并同步给解包模块, 为空时恢复全部
+     */
+    void InitRestorePaths();
+
+    /**
+     * @brief 选择性恢复时客户端只投递含有匹配路径的tar包, 未投递的tar包直接跳过
+     */
+    bool IsTarUnrequested(const std::string &tarName);
+
+    /**
+     * @brief 选择性恢复时只保留简报中在恢复范围内的文件
+     *
+     * @return 过滤后没有需要恢复的文件时返回false, 简报为空时返回true, 由解包时按路径过滤
+     */
+    bool FilterRestoreIncludes(std::unordered_map<std::string, struct ReportFileInfo> &includes);
     int DealIncreRestoreBigAndTarFile();
     ErrCode IncrementalTarFileReady(const TarMap &bigFileInfo, const vector<struct ReportFileInfo> &srcFiles,
         sptr<IService> proxy);
@@ -457,7 +556,11 @@ private:
     void AsyncDoBackup();
     void DoBackupTask();
     void ClearPublicTempFiles();
+    void DoBackupFileCore(bool supportWithoutTar, std::shared_ptr<IFileInfo> &fileInfo,
+        std::vector<std::shared_ptr<IFileInfo>> &allFiles, int &fdNum, int &ret);
     void DoBackupTaskCore(bool supportWithoutTar, std::vector<std::shared_ptr<IFileInfo>> &allFiles, int &ret);
+    void ReportBatchFilesAndRelease(std::vector<std::shared_ptr<IFileInfo>> &tmpFiles,
+        std::vector<std::shared_ptr<IFileInfo>> &allFiles, bool supportWithoutTar, int &ret);
 
     void HandleExtDisconnect(bool isAppResultReport, ErrCode errCode);
     bool HandleGetExtOnRelease();
@@ -476,12 +579,14 @@ private:
                            std::vector<int> &errCodes);
 private:
     TarMap GetIncrmentBigInfos(const vector<struct ReportFileInfo> &files);
-    void UpdateFileStat(std::string filePath, uint64_t fileSize);
+    // dirDepth为扫描阶段得到的路径深度, 为0时按路径计算
+    void UpdateFileStat(const std::string &filePath, uint64_t fileSize, uint32_t dirDepth = 0);
     void ReportAppStatistic(const std::string &func, ErrCode errCode);
     ErrCode IndexFileReady();
     // fileInfo cannot be empty
     ErrCode ReportAppFileReady(const std::shared_ptr<IFileInfo> &fileInfo, int &fdNum);
-    ErrCode ReportNormalAppFileReady(const string &filename, const string &filePath, bool needDelete = false);
+    ErrCode ReportNormalAppFileReady(const string &filename, const string &filePath, bool needDelete = false,
+        bool isBigFile = false);
     ErrCode ReportAncoAppFileReady(const string &filename, const string &filePath, bool needDelete = false);
     ErrCode ReportAppFileReadys(std::vector<std::shared_ptr<IFileInfo>>& allFiles);
     ErrCode ReportBatchFiles(std::vector<std::shared_ptr<IFileInfo>> &tmpFiles,
@@ -491,6 +596,8 @@ private:
     int OpenFileWithFDSan(const std::string &path);
     // Helper function to close a file with fdsan ownership tag
     void CloseFileWithFDSan(int fd);
+    // 设置了加密密钥时把大文件经管道边读边加密, fd所有权转移, 返回管道读端, 失败时返回-1
+    int EncryptBigFileForSend(int fd);
 
     void ExecuteAncoMove(const std::vector<std::string> &ancoSourcePath, const std::vector<std::string> &ancoTargetPath,
         const std::vector<StatInfo> &ancoStats);
@@ -541,6 +648,8 @@ private:
     std::map<std::string, std::string> reportHashSrcPathMap_;
 
     std::shared_ptr<RadarAppStatistic> appStatistic_ = nullptr;
+    std::shared_ptr<BScanSnapshot> scanSnapshot_ = nullptr;
+    std::unordered_map<std::string, struct stat> bigFileScanStats_; // 对比阶段得到的增量大文件stat, 回传时复用
     BackupRestoreScenario curScenario_ { BackupRestoreScenario::FULL_BACKUP };
 
     OHOS::ThreadPool onReleaseTaskPool_;
@@ -558,7 +667,7 @@ private:
     std::atomic<bool> stopGetComInfo_ {false};
     std::string compatibilityInfo_ {};
     std::unordered_set<std::string> compatibleDirs_; // 无条件竞争风险, 多处调用存在先后顺序不会并发
-    std::mutex updateFileStatLock_;
+    std::mutex packetStatLock_;
     AncoRestoreResult ancoRestoreRes_;
     std::mutex fileOpenLock_;
     std::condition_variable initManageJsonCon_;
@@ -567,6 +676,13 @@ private:
     std::mutex manageJsonFdLock_;
     std::atomic<int> pendingAppendCount_ { 0 };
     std::atomic<bool> isFirstWrite_ {true};
+    BDirCache bigFileDirCache_; // 恢复大文件时已打开的目标目录, 仅在RestoreBigFiles期间有效
+    std::unique_ptr<BBackupCheckpoint> restoreJournal_; // 已恢复完成的tar包和大文件, 打开失败时为空
+    size_t restoredCount_ {0};
+    size_t restoreSkippedCount_ {0};
+    size_t restoreFailedCount_ {0};
+    std::vector<std::string> restorePaths_; // 选择性恢复的路径, 为空时恢复全部
+    BEncryption::PipeEncryptor pipeEncryptor_; // 回传中的加密大文件, 回传manage.json前等待全部完成
 public:
     void SetSupportWithoutTar(bool isSupportWithoutTar);
     bool GetSupportWithoutTar() const;
@@ -53,6 +53,7 @@ const int MB_TO_BYTE = (1024 * 1024);
 
 #define REGTYPE '0' /* regular file */
 #define AREGTYPE '\0' /* regular file */
+#define LNKTYPE '1' /* hard link */
 #define SYMTYPE '2' /* reserved */
 #define DIRTYPE '5' /* directory */
 #define SPLIT_START_TYPE '8'
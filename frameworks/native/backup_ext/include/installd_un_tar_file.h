@@ -18,6 +18,7 @@
 #include "installd_tar_utils.h"
 #include "tar_util.h"
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace installd {
@@ -28,6 +29,7 @@ struct ParseTarPath {
     char *fullPath = nullptr;
     char *realName = nullptr;
     char *realLink = nullptr;
+    const char *rootPath = nullptr;
 };
 
 struct TarFileInfo {
@@ -64,6 +66,7 @@ private:
         TarFileInfo &tarFileInfo);
     bool FileReadAndWrite(char *destBuff, FILE *destF, size_t readBuffSize);
     void HandleRegularEUnpackFile(char *buff, ParseTarPath *parseTarPath, bool &isSkip, TarFileInfo &tarFileInfo);
+    void HandleHardLink(EParseType type, ParseTarPath *parseTarPath, bool &isSkip, TarFileInfo &tarFileInfo);
     bool ProcessTarBlock(char *buff, EParseType type, ParseTarPath *parseTarPath, bool &isSkip, bool &isSoftLink);
     bool IsValidTarBlock(const TarHeader *tarHeader);
     bool VerifyChecksum(const TarHeader *tarHeader);
@@ -80,6 +83,8 @@ private:
     std::vector<std::string> file_names;
     std::vector<off_t> file_sizes;
     std::vector<off_t> file_data_addrs;
+    // 本次解包已写入的普通文件, 硬链接只能指向其中的文件
+    std::unordered_set<std::string> extracted_files;
 };
 } // namespace installd
 #endif // PHONECLONE_INSTALLDUNTARFILE_H
\ No newline at end of file
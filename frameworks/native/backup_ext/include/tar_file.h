@@ -23,6 +23,8 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include <vector>
+#include "b_encryption/b_encryption.h"
+#include "b_encryption/b_stream_cipher.h"
 #include "b_utils/scan_file_singleton.h"
 
 namespace OHOS::FileManagement::Backup {
@@ -47,6 +49,7 @@ const uint32_t TGID_BASE = 116;
 const uint32_t TSIZE_BASE = 124;
 const uint32_t TMTIME_BASE = 136;
 const uint32_t CHKSUM_BASE = 148;
+const uint32_t TLINKNAME_BASE = 157;
 const uint32_t BLOCK_SIZE = 512;
 const off_t READ_BUFF_SIZE = 512 * 1024;
 const uint8_t BLANK_SPACE = 0x20;
@@ -54,10 +57,17 @@ const uint64_t MB_TO_BYTE = 1024 * 1024;
 const std::string TMAGIC = "ustar";
 const char REGTYPE = '0';   // regular file
 const char AREGTYPE = '\0'; // regular file
+const char LNKTYPE = '1';   // hard link
 const char SYMTYPE = '2';   // reserved
 const char DIRTYPE = '5';   // directory
 const char GNUTYPE_LONGNAME = 'L';
 const char EXTENSION_HEADER = 'x';
+const std::string PAX_DIGEST_KEY = "OHOS.digest"; // pax扩展头中记录文件内容摘要的关键字
+const uint32_t TAR_END_BLOCK_SIZE = 1024;          // tar包结束标记, 两个全零块
+const std::string TAR_INDEX_MAGIC = "OHTARIDX";    // tar包索引尾部的魔数
+const uint32_t TAR_INDEX_VERSION = 1;
+const uint32_t TAR_INDEX_ENTRY_SIZE = 25;   // 名称哈希(8) + 偏移(8) + 长度(8) + 类型(1)
+const uint32_t TAR_INDEX_TRAILER_SIZE = 32; // 魔数(8) + 版本(4) + 条目数(4) + 索引偏移(8) + 校验和(8)
 const uint32_t OTHER_HEADER = 78;
 const int ERR_NO_PERMISSION = 13;
 } // namespace
@@ -83,10 +93,29 @@ using TarHeader = struct {
     char pad[PADDING_LEN];
 };
 using TarMap = std::map<std::string, std::tuple<std::string, struct stat, bool>>;
+
+/**
+ * @brief tar包索引中的一项, 记录一个文件在tar包中的范围, 范围包含文件前面的扩展头和长文件名头
+ *
+ * 索引在tar包结束标记之后写入, 以TAR_INDEX_TRAILER_SIZE字节的尾部结束. 标准tar工具读到结束标记即停止, 不受影响.
+ */
+struct TarIndexEntry {
+    uint64_t nameHash {0};
+    off_t offset {0};
+    off_t length {0};
+    char typeFlag {REGTYPE};
+};
+
 class TarFile {
 public:
     static TarFile &GetInstance();
 
+    /**
+     * @brief 多路并行打包时每一路使用独立的实例, 单路打包仍使用GetInstance
+     */
+    TarFile() {}
+    ~TarFile();
+
     bool Packet(const std::vector<std::string> &srcFiles,
                 const std::string &tarFileName,
                 const std::string &pkPath,
@@ -104,10 +133,32 @@ public:
      */
     void SetPacketMode(bool isReset);
 
+    /**
+     * @brief 设置文件内容摘要算法
+     *
+     * @param algorithm 非NONE时在每个普通文件前写入记录其内容摘要的pax扩展头, 摘要在写入文件内容时一并计算
+     */
+    void SetDigestAlgorithm(BEncryption::DigestAlgorithm algorithm) { digestAlgorithm_ = algorithm; }
+
+    /**
+     * @brief 设置tar包加密密钥
+     *
+     * @param key 非空时之后创建的tar包以分块认证加密流写入, 为空时写入明文tar包
+     */
+    void SetStreamKey(std::shared_ptr<const BEncryption::StreamKey> key) { streamKey_ = std::move(key); }
+
     uint64_t GetTarFileSize() { return static_cast<uint64_t>(currentTarFileSize_); }
+
+    /**
+     * @brief 计算tar包索引使用的哈希(FNV-1a), 用于文件名和索引校验和
+     */
+    static uint64_t IndexHash(const void *data, size_t len);
+
+    /**
+     * @brief 计算文件名在tar包索引中的哈希, 与解包时的匹配规则一致, 开头的'/'不参与计算
+     */
+    static uint64_t IndexNameHash(const std::string &name);
 private:
-    TarFile() {}
-    ~TarFile() = default;
     TarFile(const TarFile &instance) = delete;
     TarFile &operator=(const TarFile &instance) = delete;
 
@@ -184,6 +235,44 @@ private:
      */
     bool WriteLongName(std::string &name, char type);
 
+    /**
+     * @brief write pax header with a placeholder digest
+     *
+     * @param digestPos 摘要在tar文件中的偏移, 文件内容写完后在此处回填
+     */
+    bool WriteDigestHeader(off_t &digestPos);
+
+    /**
+     * @brief fill digest into the pax header written by WriteDigestHeader
+     *
+     * @param digestPos 摘要在tar文件中的偏移
+     * @param digest 文件内容摘要
+     */
+    bool FillDigest(off_t digestPos, const std::string &digest);
+
+    /**
+     * @brief 记录刚写入的文件在tar包中的范围
+     *
+     * @param name 写入tar包的文件名
+     * @param typeFlag 文件类型标志
+     * @param offset 文件的第一个头在tar包中的偏移
+     */
+    void AddIndexEntry(const std::string &name, char typeFlag, off_t offset);
+
+    /**
+     * @brief 在结束标记之后写入tar包索引
+     */
+    bool WriteTarIndex();
+
+    /**
+     * @brief 文件与当前tar包中已写入的文件是同一inode时, 把文件头改为指向该文件的硬链接头
+     *
+     * @param hdr 普通文件的tar文件头
+     * @param st 文件参数结构体
+     * @return 填写文件头失败时返回false; 没有可引用的文件或其名称过长时不修改文件头, 按普通文件写入
+     */
+    bool FillHardLinkHeader(TarHeader &hdr, const struct stat &st);
+
     /**
      * @brief read files
      *
@@ -246,6 +335,13 @@ private:
     std::string currentFileName_ {};
 
     bool isReset_ = false;
+
+    BEncryption::DigestAlgorithm digestAlgorithm_ {BEncryption::DigestAlgorithm::NONE};
+    std::unique_ptr<BEncryption::ContentDigest> fileDigest_ {}; // 正在写入的文件的内容摘要
+    std::shared_ptr<const BEncryption::StreamKey> streamKey_ {};
+    std::vector<TarIndexEntry> tarIndex_ {}; // 当前tar包已写入文件的索引
+    // 当前tar包中已写入内容且有多个硬链接的文件, (dev, inode) -> 写入tar包的文件名
+    std::map<std::pair<dev_t, ino_t>, std::string> linkTargets_ {};
 };
 } // namespace OHOS::FileManagement::Backup
 
@@ -16,10 +16,13 @@
 #ifndef OHOS_FILEMGMT_BACKUP_BACKUP_UNTAR_FILE_H
 #define OHOS_FILEMGMT_BACKUP_BACKUP_UNTAR_FILE_H
 
+#include <unordered_set>
+
 #include <sys/stat.h>
 #include <utime.h>
 
 #include "tar_file.h"
+#include "b_filesystem/b_dir_cache.h"
 #include "b_json/b_report_entity.h"
 
 namespace OHOS::FileManagement::Backup {
@@ -30,6 +33,7 @@ struct FileStatInfo {
     gid_t gid {0};
     off_t mtime {0};
     std::string longName {};
+    std::string linkName {};
 };
 
 enum UNTAR_RESULT {
@@ -38,6 +42,15 @@ enum UNTAR_RESULT {
     ERR_INVALID_PATH = -3,
     ERR_FSEEKO = -4,
     ERR_PARSE_PAX = -5,
+    ERR_DIGEST_MISMATCH = -6,
+};
+
+// 未被选中而跳过的普通文件在tar包中的位置, 被选中的硬链接指向它时补充解包
+struct SkippedTarEntry {
+    off_t offset {0};
+    off_t length {0};
+    // offset指向文件头本身, 之前扩展块中的长文件名需要补充解包时带上
+    bool needName {false};
 };
 
 using ErrFileInfo = std::map<std::string, std::vector<int>>;
@@ -57,6 +70,21 @@ public:
         const std::unordered_map<std::string, struct ReportFileInfo> &includes);
     std::vector<std::tuple<std::string, std::string, struct stat>> GetPublicFileInfos();
 
+    /**
+     * @brief 设置选择性恢复的路径, 之后的解包只恢复与其匹配的文件和目录
+     *
+     * @param restorePaths 经过BDir::PreDealExcludes处理的路径, 为空时恢复全部
+     */
+    void SetRestorePaths(const std::vector<std::string> &restorePaths);
+
+    /**
+     * @brief 判断tar包内的路径是否在选择性恢复的范围内
+     *
+     * @param restorePaths 经过BDir::PreDealExcludes处理的路径, 为空时任何路径都在范围内
+     * @param path tar包内或manage.json中记录的原始路径
+     */
+    static bool IsInRestorePaths(const std::vector<std::string> &restorePaths, const std::string &path);
+
 private:
     UntarFile() = default;
     ~UntarFile() = default;
@@ -77,6 +105,32 @@ private:
      */
     std::tuple<int, EndFileInfo, ErrFileInfo> ParseIncrementalTarFile(const std::string &rootPath);
 
+    /**
+     * @brief 解析一个tar块及其后的文件内容
+     *
+     * @param info 文件属性结构体, 长文件名头解析出的名称对下一个块生效
+     * @param fileInfos out param, record file info
+     * @param errFileInfo out param, record err file info
+     * @param ret out param, 解析结束时的结果
+     * @return 可以继续解析下一个块时返回true
+     */
+    bool ParseIncrementalTarBlock(FileStatInfo &info, EndFileInfo &fileInfos, ErrFileInfo &errFileInfo, int &ret);
+
+    /**
+     * @brief 读取tar包末尾的索引, 不改变后续解析的起始位置
+     *
+     * @param index out param, 按偏移升序排列的索引项
+     * @return 没有索引或索引无效时返回false
+     */
+    bool ReadTarIndex(std::vector<TarIndexEntry> &index);
+
+    /**
+     * @brief 按索引直接定位并解析includes_中的文件和所有目录, 跳过其余文件
+     *
+     * @param index 按偏移升序排列的索引项
+     */
+    std::tuple<int, EndFileInfo, ErrFileInfo> ParseIndexedTarFile(const std::vector<TarIndexEntry> &index);
+
     /**
      * @brief verfy check sum
      *
@@ -205,6 +259,23 @@ private:
 
     std::tuple<int, std::string> ParsePaxBlock();
 
+    /**
+     * @brief 记录pax扩展头中的文件内容摘要, 解包下一个普通文件时校验
+     */
+    void SetPendingDigest(std::string digest);
+
+    /**
+     * @brief 解析完一个不是扩展头或长文件名的tar块后清空待校验的摘要
+     */
+    void ClearPendingDigest(char typeFlag);
+
+    /**
+     * @brief 设置了密钥提供者且tar包已加密时, 把tarFilePtr_替换为解密流
+     *
+     * @return 未加密或替换成功返回true, 找不到密钥或文件头无效时返回false且errno为失败原因
+     */
+    bool WrapEncryptedTarFile();
+
     void CheckLongName(std::string longName, FileStatInfo &info);
 
     std::tuple<int, std::string> GetLongName(uint32_t recLen, uint32_t allLen);
@@ -216,6 +287,31 @@ private:
 
     void MatchDirType(bool &isRightRes, FileStatInfo &info, ErrFileInfo &errFileInfo, bool &isFilter);
 
+    /**
+     * @brief 创建指向tar包中之前已解包文件的硬链接
+     *
+     * @param info 文件属性结构体, linkName为链接目标在tar包中的名称
+     * @return 路径无效时返回false, 创建链接失败记录在errFileInfo中
+     */
+    bool CreateHardLink(FileStatInfo &info, ErrFileInfo &errFileInfo);
+
+    /**
+     * @brief 补充解包之前因未被选中而跳过的链接目标
+     *
+     * @param name 链接目标在tar包中的名称
+     * @return 目标已在本次解包中写入时返回true
+     */
+    bool ExtractLinkTarget(const std::string &name, ErrFileInfo &errFileInfo);
+
+    // 记录未被选中而跳过的普通文件, info.fullPath为tar包中的名称
+    void RecordSkippedFile(const FileStatInfo &info);
+
+    // 补充解包链接目标时, 目标不受includes_和restorePaths_限制
+    bool IsForcedTarget(const std::string &name) const;
+
+    // 解包开始和结束时清空链接相关的记录
+    void ClearLinkState();
+
     void MatchGnuTypeLongName(bool &isRightRes, FileStatInfo &info, ErrFileInfo &errFileInfo, bool &isFilter);
 
     void MatchExtHeader(bool &isRightRes, FileStatInfo &info, bool &isFilter);
@@ -233,7 +329,22 @@ private:
     off_t pos_ {0};
     size_t readCnt_ {0};
     std::unordered_map<std::string, struct ReportFileInfo> includes_;
+    // 选择性恢复的路径, 与includes_同时生效
+    std::vector<std::string> restorePaths_;
     std::vector<std::tuple<std::string, std::string, struct stat>> publicFileInfos_;
+    // 解包过程中已打开的目录, 只在UnPacket/IncrementalUnPacket期间使用, 开始和结束时清空
+    BDirCache dirCache_;
+    bool useDirCache_ {false};
+    // pax扩展头中记录的下一个文件的内容摘要, 只对紧随其后的文件有效
+    std::string pendingDigest_ {};
+    std::unique_ptr<BEncryption::ContentDigest> fileDigest_ {};
+    bool isIncremental_ {false};
+    // 本次解包中已成功写入的普通文件(tar包中的名称), 硬链接只能指向其中的文件
+    std::unordered_set<std::string> extractedFiles_;
+    // 本次解包中未被选中而跳过的普通文件, 按名称和索引中的名称哈希记录
+    std::unordered_map<std::string, SkippedTarEntry> skippedFiles_;
+    std::unordered_multimap<uint64_t, SkippedTarEntry> skippedIndexEntries_;
+    std::string forcedTarget_ {};
 };
 } // namespace OHOS::FileManagement::Backup
 
@@ -44,6 +44,32 @@ using namespace std;
 
 namespace {
     const int32_t DEFAULT_BATCH_SIZE = 500;
+
+    // 从扩展信息中取出加密密钥并删除该项, 密钥既不打印日志也不交给应用
+    string TakeStreamKey(string &extInfo)
+    {
+        nlohmann::json j = nlohmann::json::parse(extInfo, nullptr, false);
+        if (j.is_discarded() || !j.is_array()) {
+            return "";
+        }
+        string streamKey;
+        bool found = false;
+        for (auto it = j.begin(); it != j.end();) {
+            if (it->is_object() && it->contains("type") && (*it)["type"] == BConstants::EXT_INFO_STREAM_KEY_TYPE) {
+                if (it->contains("detail") && (*it)["detail"].is_string()) {
+                    streamKey = (*it)["detail"].get<string>();
+                }
+                found = true;
+                it = j.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (found) {
+            extInfo = j.dump();
+        }
+        return streamKey;
+    }
 }
 CreatorFunc ExtBackup::creator_ = nullptr;
 void ExtBackup::SetCreator(const CreatorFunc &creator)
@@ -179,20 +205,24 @@ BConstants::ExtensionAction ExtBackup::VerifyAndGetAction(const AAFwk::Want &wan
 ErrCode ExtBackup::GetParament(const AAFwk::Want &want)
 {
     callerBundleName_ = want.GetStringParam(BConstants::EXTENSION_CALLER_BUNDLE_NAME_PARA);
+    sessionActiveTime_ = want.GetStringParam(BConstants::EXTENSION_SESSION_ACTIVE_TIME_PARA);
     if (extAction_ == BConstants::ExtensionAction::RESTORE) {
         appVersionStr_ = want.GetStringParam(BConstants::EXTENSION_VERSION_NAME_PARA);
         appVersionCode_ = want.GetLongParam(BConstants::EXTENSION_VERSION_CODE_PARA, 0);
         restoreType_ = want.GetIntParam(BConstants::EXTENSION_RESTORE_TYPE_PARA, 0);
         restoreExtInfo_ = want.GetStringParam(BConstants::EXTENSION_RESTORE_EXT_INFO_PARA);
+        streamKey_ = TakeStreamKey(restoreExtInfo_);
         oldBackupVersion_ = want.GetStringParam(BConstants::EXTENSION_OLD_BACKUP_VERSION_PARA);
         supportWithoutTar_ = want.GetBoolParam(BConstants::EXTENSION_SUPPORT_WITHOUT_TAR_PARA, false);
         excludeInfos_ = want.GetStringArrayParam(BConstants::EXTENSION_EXCLUDE_INFOS_PARA);
+        restorePaths_ = want.GetStringArrayParam(BConstants::EXTENSION_RESTORE_PATHS_PARA);
         batchSize_ = want.GetIntParam(BConstants::EXTENSION_BATCH_SIZE_PARA, DEFAULT_BATCH_SIZE);
         HILOGI("restoreExtInfo_ is %{public}s", GetAnonyString(restoreExtInfo_).c_str());
         HILOGI("Get version %{public}s type %{public}d from want when restore.", appVersionStr_.c_str(), restoreType_);
         HILOGI("oldBackupVersion_ is %{public}s", oldBackupVersion_.c_str());
     } else if (extAction_ == BConstants::ExtensionAction::BACKUP) {
         backupExtInfo_ = want.GetStringParam(BConstants::EXTENSION_BACKUP_EXT_INFO_PARA);
+        streamKey_ = TakeStreamKey(backupExtInfo_);
         backupScene_ = want.GetStringParam(BConstants::EXTENSION_BACKUP_SCENE_PARA);
         supportWithoutTar_ = want.GetBoolParam(BConstants::EXTENSION_SUPPORT_WITHOUT_TAR_PARA, false);
         excludeInfos_ = want.GetStringArrayParam(BConstants::EXTENSION_EXCLUDE_INFOS_PARA);
@@ -393,6 +423,11 @@ std::vector<std::string> ExtBackup::GetExcludeInfos() const
     return excludeInfos_;
 }
 
+std::vector<std::string> ExtBackup::GetRestorePaths() const
+{
+    return restorePaths_;
+}
+
 int32_t ExtBackup::GetBatchSize() const
 {
     return batchSize_;
@@ -402,4 +437,14 @@ std::string ExtBackup::GetCallerBundleName() const
 {
     return callerBundleName_;
 }
+
+std::string ExtBackup::GetSessionActiveTime() const
+{
+    return sessionActiveTime_;
+}
+
+std::string ExtBackup::GetStreamKey() const
+{
+    return streamKey_;
+}
 } // namespace OHOS::FileManagement::Backup
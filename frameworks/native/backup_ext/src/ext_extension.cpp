@@ -19,8 +19,10 @@
 #include <chrono>
 #include <cinttypes>
 #include <cstdint>
+#include <exception>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <iomanip>
 #include <map>
 #include <regex>
@@ -44,6 +46,7 @@
 #include "ipc_skeleton.h"
 
 #include "b_anony/b_anony.h"
+#include "b_encryption/b_stream_cipher.h"
 #include "b_error/b_error.h"
 #include "b_error/b_excep_utils.h"
 #include "b_filesystem/b_dir.h"
@@ -54,6 +57,7 @@
 #include "b_ohos/startup/backup_para.h"
 #include "b_tarball/b_tarball_factory.h"
 #include "b_hiaudit/hi_audit.h"
+#include "b_utils/b_span_tracer.h"
 #include "b_utils/b_time.h"
 #include "b_utils/scan_file_singleton.h"
 #include "b_utils/string_utils.h"
@@ -73,6 +77,7 @@ const string INDEX_FILE_INCREMENTAL_BACKUP = string(BConstants::PATH_BUNDLE_BACK
                                              append(BConstants::SA_BUNDLE_BACKUP_BACKUP);
 const string MEDIA_LIBRARY_BUNDLE_NAME = "com.ohos.medialibrary.medialibrarydata";
 const string FILE_MANAGER_BUNDLE_NAME = "com.ohos.filepicker";
+const string RESTORE_JOURNAL_NAME = "restore.journal";
 using namespace std;
 
 static void RecordDoRestoreRes(const std::string &bundleName, const std::string &func,
@@ -106,6 +111,17 @@ static string GetIndexFileRestorePath(const string &bundleName)
     return INDEX_FILE_RESTORE;
 }
 
+// 恢复日志放在restore目录之外, 解包过程中遍历restore目录时不会误处理
+static string GetRestoreJournalPath(const string &bundleName)
+{
+    if (BFile::EndsWith(bundleName, BConstants::BUNDLE_FILE_MANAGER) && bundleName.size() == BConstants::FM_LEN) {
+        return string(BConstants::PATH_FILEMANAGE_BACKUP_HOME).append("/").append(RESTORE_JOURNAL_NAME);
+    } else if (bundleName == BConstants::BUNDLE_MEDIAL_DATA) {
+        return string(BConstants::PATH_MEDIALDATA_BACKUP_HOME).append("/").append(RESTORE_JOURNAL_NAME);
+    }
+    return string(BConstants::PATH_BUNDLE_BACKUP_HOME).append("/").append(RESTORE_JOURNAL_NAME);
+}
+
 static string GetRestoreTempPath(const string &bundleName, const string &hashName)
 {
     string path = string(BConstants::PATH_BUNDLE_BACKUP_HOME).append(BConstants::SA_BUNDLE_BACKUP_RESTORE);
@@ -448,9 +464,12 @@ ErrCode BackupExtExtension::GetIncrementalFileHandles(const BStringRawData &file
                                                       std::vector<FileOpenResult> &openResults)
 {
     HITRACE_METER_NAME(HITRACE_TAG_FILEMANAGEMENT, __PRETTY_FUNCTION__);
-    std::string serializedData;
-    fileNamesRD.Unmarshalling(serializedData);
-    auto fileNames = StringUtils::StringVectorDeserialize(serializedData);
+    std::string_view serializedData;
+    std::vector<std::string_view> fileNames;
+    if (fileNamesRD.Unmarshalling(serializedData) != 0 || !StringUtils::StringVectorViews(serializedData, fileNames)) {
+        HILOGE("Failed to unmarshalling file names, data size: %{public}u", fileNamesRD.size);
+        return BError(BError::Codes::EXT_INVAL_ARG).GetCode();
+    }
     HILOGI("Enter GetIncrementalFileHandles, input file count: %{public}zu, output container size: %{public}zu",
            fileNames.size(), openResults.size());
     try {
@@ -464,7 +483,8 @@ ErrCode BackupExtExtension::GetIncrementalFileHandles(const BStringRawData &file
             throw BError(BError::Codes::EXT_INVAL_ARG, "Action is invalid");
         }
         VerifyCaller();
-        for (auto fileName : fileNames) {
+        for (auto fileNameView : fileNames) {
+            std::string fileName(fileNameView);
             if (BDir::IsFilePathValid(fileName)) {
                 continue;
             }
@@ -482,7 +502,7 @@ ErrCode BackupExtExtension::GetIncrementalFileHandles(const BStringRawData &file
         {
             std::unique_lock<std::mutex> lock_(fileOpenLock_);
             for (const auto &fileName : fileNames) {
-                auto openResult = GetIncreFileHandleForUntarNormalVersion(fileName);
+                auto openResult = GetIncreFileHandleForUntarNormalVersion(std::string(fileName));
                 openResults.push_back(openResult);
             }
         }
@@ -623,6 +643,7 @@ ErrCode BackupExtExtension::HandleClear()
             return BError(BError::Codes::EXT_INVAL_ARG, "Action is invalid").GetCode();
         }
         VerifyCaller();
+        ScanFileSingleton::GetInstance().StopPendingFiles();
         DoClear();
         return ERR_OK;
     } catch (...) {
@@ -633,12 +654,20 @@ ErrCode BackupExtExtension::HandleClear()
 
 ErrCode BackupExtExtension::IndexFileReady()
 {
+    BACKUP_SPAN("ext.IndexFileReady");
     int32_t err = 0;
     appStatistic_->manageJsonSize_ = BFile::GetFileSize(INDEX_FILE_BACKUP, err);
     if (err != 0) {
         HILOGE("get index size fail err:%{public}d", err);
     }
-    return ReportNormalAppFileReady(string(BConstants::EXT_BACKUP_MANAGE), INDEX_FILE_BACKUP.data());
+    // manage.json最后回传, 服务端收到时大文件必须已经完整写出
+    bool streamed = pipeEncryptor_.Wait();
+    ErrCode ret = ReportNormalAppFileReady(string(BConstants::EXT_BACKUP_MANAGE), INDEX_FILE_BACKUP.data());
+    if (!streamed) {
+        HILOGE("Failed to send encrypted big files");
+        return BError(BError::Codes::EXT_REPORT_FILE_READY_FAIL).GetCode();
+    }
+    return ret;
 }
 
 void BackupExtExtension::ClearNoPermissionFiles(TarMap &pkgInfo, vector<std::string> &noPermissionFiles)
@@ -656,12 +685,13 @@ void BackupExtExtension::ClearNoPermissionFiles(TarMap &pkgInfo, vector<std::str
 
 ErrCode BackupExtExtension::ReportAppFileReady(const std::shared_ptr<IFileInfo>& fileInfo, int& fdNum)
 {
+    BACKUP_SPAN("ext.AppFileReady");
     ErrCode subRet = ERR_OK;
     if (fileInfo->isAncoFile_) {
         if (fileInfo->isBigFile_) {
             subRet = ReportAncoAppFileReady(fileInfo->filename_, fileInfo->filePath_);
             appStatistic_->bigFileCount_++;
-            UpdateFileStat(fileInfo->filePath_, fileInfo->sta_.st_size);
+            UpdateFileStat(fileInfo->filePath_, fileInfo->sta_.st_size, fileInfo->dirDepth_);
             fdNum++;
         } else {
             subRet = ReportAncoAppFileReady(fileInfo->filename_, fileInfo->filePath_, true);
@@ -669,9 +699,9 @@ ErrCode BackupExtExtension::ReportAppFileReady(const std::shared_ptr<IFileInfo>&
         }
     } else {
         if (fileInfo->isBigFile_) {
-            subRet = ReportNormalAppFileReady(fileInfo->filename_, fileInfo->filePath_);
+            subRet = ReportNormalAppFileReady(fileInfo->filename_, fileInfo->filePath_, false, true);
             appStatistic_->bigFileCount_++;
-            UpdateFileStat(fileInfo->filePath_, fileInfo->sta_.st_size);
+            UpdateFileStat(fileInfo->filePath_, fileInfo->sta_.st_size, fileInfo->dirDepth_);
             fdNum++;
         } else {
             subRet = ReportNormalAppFileReady(fileInfo->filename_, fileInfo->filePath_, true);
@@ -681,7 +711,8 @@ ErrCode BackupExtExtension::ReportAppFileReady(const std::shared_ptr<IFileInfo>&
     return subRet;
 }
 
-ErrCode BackupExtExtension::ReportNormalAppFileReady(const string& filename, const string& filePath, bool needDelete)
+ErrCode BackupExtExtension::ReportNormalAppFileReady(const string& filename, const string& filePath, bool needDelete,
+    bool isBigFile)
 {
     int32_t errCode = ERR_OK;
     std::string newPath = BExcepUltils::Canonicalize(filePath);
@@ -695,6 +726,10 @@ ErrCode BackupExtExtension::ReportNormalAppFileReady(const string& filename, con
         }
     }
     fdsan_exchange_owner_tag(fdval, 0, BConstants::FDSAN_EXT_TAG);
+    if (isBigFile && fdval >= 0) {
+        fdval = EncryptBigFileForSend(fdval);
+        errCode = fdval < 0 ? errno : errCode;
+    }
     auto proxy = ServiceClient::GetInstance();
     if (proxy == nullptr) {
         HILOGE("ServiceClient is null");
@@ -776,14 +811,26 @@ ErrCode BackupExtExtension::ReportAppFileReadys(std::vector<std::shared_ptr<IFil
     int reportRsWithoutFd = ERR_OK;
     if (!abnormalfileNames.empty()) {
         BStringRawData abnormalfileNamesRD;
-        abnormalfileNamesRD.Marshalling(StringUtils::StringVectorSerialize(abnormalfileNames));
-        reportRsWithoutFd = proxy->AppFileReadysWithoutFd(abnormalfileNamesRD, errCodes);
+        if (!StringUtils::StringVectorSerialize(abnormalfileNames, abnormalfileNamesRD.BeginMarshalling()) ||
+            abnormalfileNamesRD.EndMarshalling() != 0) {
+            HILOGE("Failed to marshalling abnormal file names, size: %{public}zu", abnormalfileNames.size());
+            reportRsWithoutFd = static_cast<int32_t>(BError::Codes::EXT_INVAL_ARG);
+        } else {
+            reportRsWithoutFd = proxy->AppFileReadysWithoutFd(abnormalfileNamesRD, errCodes);
+        }
     }
 
     vector<int> temp(normalfds.size(), ERR_OK);
     HILOGI("send get file Names length %{public}zu", fileNames.size());
     BStringRawData fileNamesRD;
-    fileNamesRD.Marshalling(StringUtils::StringVectorSerialize(fileNames));
+    if (!StringUtils::StringVectorSerialize(fileNames, fileNamesRD.BeginMarshalling()) ||
+        fileNamesRD.EndMarshalling() != 0) {
+        HILOGE("Failed to marshalling file names, size: %{public}zu", fileNames.size());
+        for (auto fdval : normalfds) {
+            CloseFileWithFDSan(fdval);
+        }
+        return static_cast<int32_t>(BError::Codes::EXT_INVAL_ARG);
+    }
     int reportRs = proxy->AppFileReadys(fileNamesRD, normalfds, temp);
     for (auto fdval : normalfds) {
         CloseFileWithFDSan(fdval);
@@ -910,6 +957,20 @@ static bool IsUserTar(const string &tarFile, const std::vector<ExtManageInfo> &e
     return false;
 }
 
+// 以索引中记录的大小、修改时间和收到的tar包大小标识tar包, 获取失败时返回空串
+static string GetTarFingerprint(const string &tarName, const string &tarFile,
+    const std::vector<ExtManageInfo> &extManageInfo)
+{
+    auto iter = find_if(extManageInfo.begin(), extManageInfo.end(),
+        [&tarFile](const auto &item) { return item.hashName == tarFile; });
+    struct stat sta = {};
+    if (iter == extManageInfo.end() || stat(tarName.c_str(), &sta) != 0) {
+        return "";
+    }
+    return to_string(iter->sta.st_size) + ":" + to_string(iter->sta.st_mtim.tv_sec) + "." +
+        to_string(iter->sta.st_mtim.tv_nsec) + ":" + to_string(sta.st_size);
+}
+
 std::function<void(std::string, int)> BackupExtExtension::ReportErrFileByProc(wptr<BackupExtExtension> obj,
     BackupRestoreScenario scenario)
 {
@@ -930,52 +991,184 @@ std::function<void(std::string, int)> BackupExtExtension::ReportErrFileByProc(wp
 void BackupExtExtension::DoPacketOnce(const std::vector<std::shared_ptr<ISmallFileInfo>>& packFiles, const string& path,
     std::function<void(std::string, int)> reportCb, uint64_t& totalTarSpend)
 {
-    ScanFileSingleton::GetInstance().WaitForPacketFlag();
+    DoPacketOnce(TarFile::GetInstance(), "part", packFiles, path, reportCb, totalTarSpend);
+}
+
+void BackupExtExtension::DoPacketOnce(TarFile &tarFile, const string &tarName,
+    const std::vector<std::shared_ptr<ISmallFileInfo>> &packFiles, const string &path,
+    std::function<void(std::string, int)> reportCb, uint64_t &totalTarSpend)
+{
+    BACKUP_SPAN("ext.DoPacketOnce");
+    // 打包前按本包文件总大小预占tar空间预算, 多路打包时各路不会同时越过预算
+    uint64_t reservedSize = 0;
+    for (const auto &file : packFiles) {
+        reservedSize += file->fileSize_;
+    }
+    ScanFileSingleton::GetInstance().ReserveTarBudget(reservedSize);
+    if (ScanFileSingleton::GetInstance().IsPendingStopped()) {
+        HILOGE("Pending files stopped, skip packet");
+        return;
+    }
     TarMap tarMap {};
     int64_t tarStartUs = TimeUtils::GetTimeUS();
-    bool packetRs = TarFile::GetInstance().Packet(packFiles, "part", path, tarMap, reportCb);
+    bool packetRs = false;
+    try {
+        packetRs = tarFile.Packet(packFiles, tarName, path, tarMap, reportCb);
+    } catch (...) {
+        ScanFileSingleton::GetInstance().CancelTarBudget(reservedSize);
+        throw;
+    }
     totalTarSpend += TimeUtils::GetSpendUS(tarStartUs);
     if (!packetRs) {
         HILOGE("Packet fail!");
+        ScanFileSingleton::GetInstance().CancelTarBudget(reservedSize);
         return;
     }
     if (tarMap.size() != 1) {
         HILOGE("size is invalid, size=%{public}zu", tarMap.size());
+        ScanFileSingleton::GetInstance().CancelTarBudget(reservedSize);
         return;
     }
-    appStatistic_->tarFileSize_ += TarFile::GetInstance().GetTarFileSize();
-    appStatistic_->tarFileCount_++;
+    {
+        std::lock_guard<std::mutex> lock(packetStatLock_);
+        appStatistic_->tarFileSize_ += tarFile.GetTarFileSize();
+        appStatistic_->tarFileCount_++;
+    }
     auto item = tarMap.begin();
     auto [filePath, sta, isBigFile] = item->second;
-    ScanFileSingleton::GetInstance().AddTarFile(item->first, filePath, sta);
+    ScanFileSingleton::GetInstance().AddTarFile(item->first, filePath, sta, reservedSize);
 }
 
-void BackupExtExtension::DoPacket()
+std::function<void(std::string, int)> BackupExtExtension::SerializeReportCb(
+    std::function<void(std::string, int)> reportCb)
+{
+    // 多路打包时各路会并发上报错误文件, 统一加锁串行化, 避免并发修改错误文件统计
+    auto reportLock = std::make_shared<std::mutex>();
+    return [reportLock, reportCb](std::string msg, int err) {
+        std::lock_guard<std::mutex> lock(*reportLock);
+        if (reportCb) {
+            reportCb(move(msg), err);
+        }
+    };
+}
+
+uint64_t BackupExtExtension::DoPacketMultiLane(BoundedQueue<std::vector<std::shared_ptr<ISmallFileInfo>>> &packQueue,
+    uint32_t laneCount, const string &tarPath, std::function<void(std::string, int)> reportCb)
+{
+    reportCb = SerializeReportCb(move(reportCb));
+    std::vector<std::thread> lanes;
+    std::vector<uint64_t> laneTarUs(laneCount, 0);
+    std::vector<std::exception_ptr> laneErrs(laneCount, nullptr);
+    auto digestAlgorithm = BackupPara::GetBackupTarDigestAlgorithm();
+    auto streamKey = BEncryption::GetCurrentKey();
+    for (uint32_t lane = 0; lane < laneCount; lane++) {
+        lanes.emplace_back([this, lane, &packQueue, &tarPath, &reportCb, &laneTarUs, &laneErrs, digestAlgorithm,
+            streamKey]() {
+            try {
+                // 每一路独立的TarFile实例和包名, 避免分片计数和tar文件名冲突
+                TarFile tarFile;
+                tarFile.SetPacketMode(true);
+                tarFile.SetDigestAlgorithm(digestAlgorithm);
+                tarFile.SetStreamKey(streamKey);
+                string tarName = lane == 0 ? "part" : "part_" + to_string(lane);
+                std::vector<std::shared_ptr<ISmallFileInfo>> packFiles;
+                while (packQueue.Pop(packFiles)) {
+                    DoPacketOnce(tarFile, tarName, packFiles, tarPath, reportCb, laneTarUs[lane]);
+                }
+            } catch (...) {
+                laneErrs[lane] = std::current_exception();
+                packQueue.Close();
+            }
+        });
+    }
+    return JoinPacketLanes(lanes, laneTarUs, laneErrs);
+}
+
+uint64_t BackupExtExtension::JoinPacketLanes(std::vector<std::thread> &lanes, const std::vector<uint64_t> &laneTarUs,
+    const std::vector<std::exception_ptr> &laneErrs)
+{
+    for (auto &lane : lanes) {
+        lane.join();
+    }
+    for (const auto &err : laneErrs) {
+        if (err != nullptr) {
+            std::rethrow_exception(err);
+        }
+    }
+    // 多路并行时以最慢的一路作为打包耗时
+    return laneTarUs.empty() ? 0 : *std::max_element(laneTarUs.begin(), laneTarUs.end());
+}
+
+void BackupExtExtension::SliceSmallFiles(const vector<shared_ptr<ISmallFileInfo>> &allSmallFile,
+    const std::function<bool(vector<shared_ptr<ISmallFileInfo>> &)> &onSlice)
 {
-    string tarPath = string(BConstants::PATH_BUNDLE_BACKUP_HOME).append(BConstants::SA_BUNDLE_BACKUP_BACKUP);
     uint64_t totalSize = 0;
     uint32_t fileCount = 0;
     vector<shared_ptr<ISmallFileInfo>> packFiles;
-    TarFile::GetInstance().SetPacketMode(true); // 设置下打包模式
-    auto reportCb = ReportErrFileByProc(wptr<BackupExtExtension> {this}, curScenario_);
-    uint64_t totalTarUs = 0;
-    auto allSmallFile = ScanFileSingleton::GetInstance().GetAllSmallFiles();
-    appStatistic_->smallFileCount_ = allSmallFile.size();
-    HILOGI("DoPacket begin, small normal file count: %{public}zu", allSmallFile.size());
     for (const auto &smallFile : allSmallFile) {
-        UpdateFileStat(smallFile->filePath_, smallFile->fileSize_);
+        UpdateFileStat(smallFile->filePath_, smallFile->fileSize_, smallFile->dirDepth_);
         totalSize += smallFile->fileSize_;
         fileCount += 1;
         packFiles.emplace_back(smallFile);
         if (totalSize >= BConstants::DEFAULT_SLICE_SIZE || fileCount >= BConstants::MAX_FILE_COUNT) {
-            DoPacketOnce(packFiles, tarPath, reportCb, totalTarUs);
+            if (!onSlice(packFiles)) {
+                return;
+            }
             totalSize = 0;
             fileCount = 0;
             packFiles.clear();
         }
     }
     if (fileCount > 0) {
-        DoPacketOnce(packFiles, tarPath, reportCb, totalTarUs);
+        onSlice(packFiles);
+    }
+}
+
+void BackupExtExtension::ProduceSmallFilePacks(const vector<shared_ptr<ISmallFileInfo>> &allSmallFile,
+    BoundedQueue<vector<shared_ptr<ISmallFileInfo>>> &packQueue)
+{
+    SliceSmallFiles(allSmallFile, [&packQueue](vector<shared_ptr<ISmallFileInfo>> &packFiles) {
+        if (!packQueue.Push(move(packFiles))) {
+            HILOGE("Packet lanes stopped, stop producing small file packs");
+            return false;
+        }
+        return true;
+    });
+}
+
+void BackupExtExtension::DoPacket()
+{
+    string tarPath = string(BConstants::PATH_BUNDLE_BACKUP_HOME).append(BConstants::SA_BUNDLE_BACKUP_BACKUP);
+    TarFile::GetInstance().SetPacketMode(true); // 设置下打包模式
+    TarFile::GetInstance().SetDigestAlgorithm(BackupPara::GetBackupTarDigestAlgorithm());
+    TarFile::GetInstance().SetStreamKey(BEncryption::GetCurrentKey());
+    auto reportCb = ReportErrFileByProc(wptr<BackupExtExtension> {this}, curScenario_);
+    uint64_t totalTarUs = 0;
+    auto allSmallFile = ScanFileSingleton::GetInstance().GetAllSmallFiles();
+    appStatistic_->smallFileCount_ = allSmallFile.size();
+    uint32_t laneCount = BackupPara::GetBackupPacketLaneCount();
+    HILOGI("DoPacket begin, small normal file count: %{public}zu, lane count: %{public}u", allSmallFile.size(),
+        laneCount);
+    if (laneCount <= 1) {
+        SliceSmallFiles(allSmallFile, [this, &tarPath, &reportCb, &totalTarUs](
+            vector<shared_ptr<ISmallFileInfo>> &packFiles) {
+            DoPacketOnce(packFiles, tarPath, reportCb, totalTarUs);
+            return true;
+        });
+    } else {
+        BoundedQueue<vector<shared_ptr<ISmallFileInfo>>> packQueue(laneCount);
+        std::future<uint64_t> packetRes = std::async(std::launch::async, [this, &packQueue, laneCount, &tarPath,
+            &reportCb]() { return DoPacketMultiLane(packQueue, laneCount, tarPath, reportCb); });
+        try {
+            ProduceSmallFilePacks(allSmallFile, packQueue);
+        } catch (...) {
+            // 生产侧异常时必须关闭队列并等待各路退出, 否则打包线程会一直阻塞在Pop上
+            packQueue.Close();
+            packetRes.wait();
+            throw;
+        }
+        packQueue.Close();
+        totalTarUs = packetRes.get();
     }
     uint64_t ancoSmallFileCount = 0;
     if (BConstants::CheckBundlePermissions(bundleName_)) {
@@ -988,6 +1181,7 @@ void BackupExtExtension::DoPacket()
 
 ErrCode BackupExtExtension::ScanAllDirs(const BJsonEntityExtensionConfig &usrConfig, int64_t &totalSize)
 {
+    BACKUP_SPAN("ext.ScanAllDirs");
     HILOGI("Start scanning files and calculate datasize");
     string path = string(BConstants::PATH_BUNDLE_BACKUP_HOME).append(BConstants::SA_BUNDLE_BACKUP_BACKUP);
     if (mkdir(path.data(), S_IRWXU) && errno != EEXIST) {
@@ -1011,8 +1205,14 @@ ErrCode BackupExtExtension::ScanAllDirs(const BJsonEntityExtensionConfig &usrCon
     AdvancedScanOption scanOption;
     scanOption.enableBatch = GetSupportWithoutTar();
     scanOption.restoreTempPath = GetRestoreTempPath(bundleName_);
+    string snapshotPath = string(BConstants::BACKUP_CONFIG_EXTENSION_PATH).append(BConstants::BACKUP_SCAN_SNAPSHOT);
+    scanOption.snapshot = make_shared<BScanSnapshot>();
+    scanOption.snapshot->Load(snapshotPath);
     auto [errCode, bigFileSize, smallFileSize] =
         BDir::ScanAllDirs(expandIncludes, compatibleIncludes, excludes, scanOption);
+    if (errCode == ERR_OK) {
+        scanOption.snapshot->Save(snapshotPath);
+    }
     if (BConstants::CheckBundlePermissions(bundleName_)) {
         auto [aErrCode, aBigFileSize, aSmallFileSize] = AncoBackupHelper::StartAncoScanAllDirs();
         bigFileSize += aBigFileSize;
@@ -1054,8 +1254,9 @@ bool BackupExtExtension::RefreshDataSize(int64_t totalSize)
     return true;
 }
 
-int BackupExtExtension::DoRestore(const string &fileName, const off_t fileSize)
+int BackupExtExtension::DoRestore(const string &fileName, const off_t fileSize, const string &fingerprint)
 {
+    BACKUP_SPAN("ext.DoRestore");
     HITRACE_METER_NAME(HITRACE_TAG_FILEMANAGEMENT, __PRETTY_FUNCTION__);
     HILOGI("Do restore");
     if (extension_ == nullptr) {
@@ -1075,6 +1276,7 @@ int BackupExtExtension::DoRestore(const string &fileName, const off_t fileSize)
         path = "/";
     }
     auto [ret, fileInfos, errInfos] = UntarFile::GetInstance().UnPacket(tarName, path);
+    ReportDigestMismatch(errInfos);
     if (isDebug_) {
         if (ret != 0) {
             endFileInfos_[tarName] = fileSize;
@@ -1085,12 +1287,19 @@ int BackupExtExtension::DoRestore(const string &fileName, const off_t fileSize)
     }
     if (ret != 0) {
         HILOGE("Failed to untar file = %{public}s, err = %{public}d", tarName.c_str(), ret);
+        RecordRestoreFailed(fileName);
         return ret;
     }
     HILOGI("Application recovered successfully, package path is %{public}s", tarName.c_str());
     if (!RemoveFile(tarName)) {
         HILOGE("Failed to delete the backup tar %{public}s", tarName.c_str());
     }
+    // 包内有文件恢复失败时不记入恢复日志, 重新投递时整包重新解压
+    if (errInfos.empty()) {
+        CommitRestored(fileName, fingerprint);
+    } else {
+        RecordRestoreFailed(fileName);
+    }
     return ERR_OK;
 }
 
@@ -1129,8 +1338,20 @@ void BackupExtExtension::DealIncreUnPacketResult(const off_t tarFileSize, const
     errFileInfos_.merge(tmpErrInfo);
 }
 
+void BackupExtExtension::ReportDigestMismatch(const ErrFileInfo &errInfos)
+{
+    for (const auto &[path, errs] : errInfos) {
+        if (find(errs.begin(), errs.end(), ERR_DIGEST_MISMATCH) == errs.end()) {
+            continue;
+        }
+        HILOGE("ReportErr content digest mismatch, path:%{public}s", GetAnonyPath(path).c_str());
+        ReportErrFileByProc(wptr<BackupExtExtension> {this}, curScenario_)(path, BError::E_UNPACKET);
+    }
+}
+
 int BackupExtExtension::DoIncrementalRestore()
 {
+    BACKUP_SPAN("ext.DoIncrementalRestore");
     HILOGI("Do incremental restore");
     if (extension_ == nullptr) {
         HILOGE("Failed to do incremental restore, extension is nullptr");
@@ -1205,7 +1426,20 @@ ErrCode BackupExtExtension::ProcessTarFile(const std::string& item, const std::v
             tempPath = path;
             return ERR_OK;
         }
+        if (IsTarUnrequested(tarName)) {
+            return ERR_OK;
+        }
+        string fingerprint = GetTarFingerprint(tarName, item, extManageInfo);
+        if (SkipRestored(item, fingerprint)) {
+            DeleteBackupIncrementalTars(tarName);
+            return ERR_OK;
+        }
         GetTarIncludes(tarName, result);
+        if (!FilterRestoreIncludes(result)) {
+            HILOGI("No file to restore in tar %{public}s", GetAnonyPath(tarName).c_str());
+            DeleteBackupIncrementalTars(tarName);
+            return ERR_OK;
+        }
         if ((!extension_->SpecialVersionForCloneAndCloud()) && (!extension_->UseFullBackupOnly())) {
             path = "/";
         }
@@ -1215,9 +1449,15 @@ ErrCode BackupExtExtension::ProcessTarFile(const std::string& item, const std::v
         std::tuple<int, EndFileInfo, ErrFileInfo> unPacketRes =
             UntarFile::GetInstance().IncrementalUnPacket(tarName, path, result);
         ErrCode err = std::get<FIRST_PARAM>(unPacketRes);
+        ReportDigestMismatch(std::get<THIRD_PARAM>(unPacketRes));
         DealIncreUnPacketResult(tarFileSize, item, unPacketRes);
         HILOGI("Application recovered successfully, package path is %{public}s", tarName.c_str());
         DeleteBackupIncrementalTars(tarName);
+        if (err == ERR_OK && std::get<THIRD_PARAM>(unPacketRes).empty()) {
+            CommitRestored(item, fingerprint);
+        } else {
+            RecordRestoreFailed(item);
+        }
         return err;
     }
     return ERR_OK;
@@ -1226,6 +1466,8 @@ ErrCode BackupExtExtension::ProcessTarFile(const std::string& item, const std::v
 void BackupExtExtension::AsyncTaskBackup(const string config)
 {
     HITRACE_METER_NAME(HITRACE_TAG_FILEMANAGEMENT, __PRETTY_FUNCTION__);
+    // 扫描和发送线程启动前重新打开待发送队列, 上一次备份结束时已停止
+    ScanFileSingleton::GetInstance().ResetPendingFiles();
     auto task = [obj {wptr<BackupExtExtension>(this)}, config]() {
         auto ptr = obj.promote();
         BExcepUltils::BAssert(ptr, BError::Codes::EXT_BROKEN_FRAMEWORK, "Ext extension handle have been released");
@@ -1315,6 +1557,7 @@ ErrCode BackupExtExtension::RestoreTarForSpecialCloneCloud(const ExtManageInfo &
         return ret;
     }
     auto [err, fileInfos, errInfos] = UntarFile::GetInstance().UnPacket(tarName, untarPath);
+    ReportDigestMismatch(errInfos);
     if (isDebug_) {
         if (err != 0) {
             endFileInfos_[tarName] = item.sta.st_size;
@@ -1477,7 +1720,8 @@ void BackupExtExtension::DeleteIndexAndRpFile()
     }
 }
 
-static bool RestoreBigFilePrecheck(string &fileName, const string &path, const string &hashName, const string &filePath)
+static bool RestoreBigFilePrecheck(string &fileName, const string &path, const string &hashName, const string &filePath,
+    BDirCache *dirCache = nullptr)
 {
     if (filePath.empty()) {
         HILOGE("file path is empty. %{public}s", GetAnonyString(filePath).c_str());
@@ -1491,6 +1735,10 @@ static bool RestoreBigFilePrecheck(string &fileName, const string &path, const s
     }
 
     // 目录不存在且只有大文件时，不能通过untar创建，需要检查并创建
+    size_t pos = filePath.rfind('/');
+    if (dirCache != nullptr && pos != string::npos && dirCache->EnsureDir("/" + filePath.substr(0, pos))) {
+        return true;
+    }
     if (!BDir::CheckAndCreateDirectory(filePath)) {
         HILOGE("failed to create directory %{public}s", GetAnonyString(filePath).c_str());
         return false;
@@ -1498,28 +1746,64 @@ static bool RestoreBigFilePrecheck(string &fileName, const string &path, const s
     return true;
 }
 
-void BackupExtExtension::RestoreBigFileAfter(const string &filePath, const struct stat &sta)
+bool BackupExtExtension::RestoreBigFileAfter(const string &filePath, const struct stat &sta)
 {
+    bool succ = true;
     if (chmod(filePath.c_str(), sta.st_mode) != 0) {
         errFileInfos_[filePath].emplace_back(errno);
         HILOGE("Failed to chmod filePath, err = %{public}d", errno);
+        succ = false;
     }
     struct timespec tv[2] = {sta.st_atim, sta.st_mtim};
     UniqueFd fd(open(filePath.data(), O_RDONLY));
     if (fd < 0) {
         errFileInfos_[filePath].emplace_back(errno);
         HILOGE("Failed to open file = %{public}s, err = %{public}d", GetAnonyPath(filePath).c_str(), errno);
-        return;
+        return false;
     }
     if (futimens(fd.Get(), tv) != 0) {
         errFileInfos_[filePath].emplace_back(errno);
         HILOGE("failed to change the file time. %{public}s , %{public}d", GetAnonyPath(filePath).c_str(), errno);
+        succ = false;
+    }
+    return succ;
+}
+
+bool BackupExtExtension::MoveBigFile(const std::string &src, const std::string &dst)
+{
+    auto provider = BEncryption::GetKeyProvider();
+    if (provider == nullptr) {
+        return BFile::MoveFile(src, dst);
+    }
+    UniqueFd srcFd(open(src.c_str(), O_RDONLY | O_CLOEXEC));
+    if (srcFd < 0 || !BEncryption::StreamCipher::IsEncrypted(srcFd)) {
+        return BFile::MoveFile(src, dst);
+    }
+    UniqueFd dstFd(open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR));
+    if (dstFd < 0) {
+        HILOGE("Failed to open big file %{public}s, err = %{public}d", GetAnonyPath(dst).c_str(), errno);
+        return false;
     }
+    if (!BEncryption::StreamCipher::DecryptFile(srcFd, dstFd, *provider)) {
+        int err = errno;
+        HILOGE("Failed to decrypt big file %{public}s, err = %{public}d", GetAnonyPath(dst).c_str(), err);
+        RemoveFile(dst);
+        errno = err;
+        return false;
+    }
+    RemoveFile(src);
+    return true;
 }
 
 void BackupExtExtension::RestoreOneBigFile(const std::string &path, const ExtManageInfo &item,
     const bool appendTargetPath)
 {
+    BACKUP_SPAN("ext.RestoreOneBigFile");
+    string fingerprint = to_string(item.sta.st_size) + ":" + to_string(item.sta.st_mtime);
+    if (SkipRestored(item.hashName, fingerprint)) {
+        RemoveFile(path + item.hashName);
+        return;
+    }
     string itemHashName = item.hashName;
     string itemFileName = item.fileName;
     if (!item.isLongPath) {
@@ -1539,21 +1823,125 @@ void BackupExtExtension::RestoreOneBigFile(const std::string &path, const ExtMan
     string filePath = appendTargetPath ? (path + itemFileName) : itemFileName;
     if (!BDir::IsFilePathValid(filePath)) {
         HILOGE("Check big file path : %{public}s err, path is forbidden", GetAnonyPath(filePath).c_str());
+        RecordRestoreFailed(item.hashName);
         return;
     }
     if (isDebug_) {
         endFileInfos_[filePath] = item.sta.st_size;
     }
 
-    if (!RestoreBigFilePrecheck(fileName, path, item.hashName, filePath)) {
+    if (!RestoreBigFilePrecheck(fileName, path, item.hashName, filePath, &bigFileDirCache_)) {
+        RecordRestoreFailed(item.hashName);
         return;
     }
-    if (!BFile::MoveFile(fileName, filePath)) {
+    if (!MoveBigFile(fileName, filePath)) {
         errFileInfos_[filePath].emplace_back(errno);
         HILOGE("failed to move the file. err = %{public}d", errno);
+        RecordRestoreFailed(item.hashName);
+        return;
+    }
+    if (!RestoreBigFileAfter(filePath, item.sta)) {
+        RecordRestoreFailed(item.hashName);
         return;
     }
-    RestoreBigFileAfter(filePath, item.sta);
+    CommitRestored(item.hashName, fingerprint);
+}
+
+void BackupExtExtension::OpenRestoreJournal()
+{
+    restoredCount_ = 0;
+    restoreSkippedCount_ = 0;
+    restoreFailedCount_ = 0;
+    restoreJournal_ = nullptr;
+    string activeTime = extension_ ? extension_->GetSessionActiveTime() : "";
+    if (activeTime.empty()) {
+        HILOGW("No session active time, restore without journal");
+        return;
+    }
+    auto [err, manageHash] = BackupFileHash::HashWithSHA256(GetIndexFileRestorePath(bundleName_));
+    if (err != ERR_OK || manageHash.empty()) {
+        HILOGW("Failed to hash restore index, restore without journal, err = %{public}d", err);
+        return;
+    }
+    // 以会话和恢复索引标识日志, 其他会话或其他数据留下的日志在打开时被清空
+    string token = extension_->GetCallerBundleName() + "|" + activeTime + "|" + manageHash;
+    auto journal = make_unique<BBackupCheckpoint>(GetRestoreJournalPath(bundleName_));
+    if (!journal->Open(token)) {
+        HILOGW("Failed to open restore journal, restore without journal");
+        return;
+    }
+    restoreJournal_ = move(journal);
+}
+
+bool BackupExtExtension::SkipRestored(const string &name, const string &fingerprint)
+{
+    if (restoreJournal_ == nullptr || fingerprint.empty() || !restoreJournal_->IsCommitted(name, fingerprint)) {
+        return false;
+    }
+    HILOGI("Skip restored file %{public}s", GetAnonyPath(name).c_str());
+    restoreSkippedCount_++;
+    return true;
+}
+
+void BackupExtExtension::CommitRestored(const string &name, const string &fingerprint)
+{
+    restoredCount_++;
+    if (restoreJournal_ != nullptr && !fingerprint.empty() && !restoreJournal_->Commit(name, fingerprint)) {
+        HILOGW("Failed to journal restored file %{public}s", GetAnonyPath(name).c_str());
+    }
+}
+
+void BackupExtExtension::RecordRestoreFailed(const string &name)
+{
+    restoreFailedCount_++;
+    HILOGW("Restore failed, not journaled: %{public}s", GetAnonyPath(name).c_str());
+}
+
+void BackupExtExtension::FinishRestoreJournal(ErrCode ret)
+{
+    // 日志中的记录数应等于本次恢复与之前已恢复的个数之和
+    size_t journaled = restoreJournal_ == nullptr ? 0 : restoreJournal_->GetCommittedCount();
+    HILOGI("Restore summary: ret = %{public}d, restored = %{public}zu, skipped = %{public}zu, failed = %{public}zu, "
+        "journaled = %{public}zu", ret, restoredCount_, restoreSkippedCount_, restoreFailedCount_, journaled);
+    // 应用恢复结束后不论成败都删除日志, 之后再次恢复同一份数据时全部重新恢复
+    if (restoreJournal_ != nullptr) {
+        restoreJournal_->Remove();
+    }
+    restoreJournal_ = nullptr;
+}
+
+void BackupExtExtension::InitRestorePaths()
+{
+    restorePaths_ = extension_->GetRestorePaths();
+    BDir::PreDealExcludes(restorePaths_);
+    UntarFile::GetInstance().SetRestorePaths(restorePaths_);
+    if (!restorePaths_.empty()) {
+        HILOGI("Selective restore, restore paths size:%{public}zu", restorePaths_.size());
+    }
+}
+
+bool BackupExtExtension::IsTarUnrequested(const string &tarName)
+{
+    if (restorePaths_.empty() || access(tarName.c_str(), F_OK) == 0) {
+        return false;
+    }
+    HILOGI("Skip unrequested tar %{public}s", GetAnonyPath(tarName).c_str());
+    return true;
+}
+
+bool BackupExtExtension::FilterRestoreIncludes(unordered_map<string, struct ReportFileInfo> &includes)
+{
+    if (restorePaths_.empty() || includes.empty()) {
+        return true;
+    }
+    for (auto it = includes.begin(); it != includes.end();) {
+        if (UntarFile::IsInRestorePaths(restorePaths_, it->first)) {
+            ++it;
+        } else {
+            it = includes.erase(it);
+        }
+    }
+    return !includes.empty();
 }
 
 void BackupExtExtension::RestoreBigFiles(bool appendTargetPath)
@@ -1570,6 +1958,7 @@ void BackupExtExtension::RestoreBigFiles(bool appendTargetPath)
     auto info = cache.GetExtManageInfo();
     HILOGI("Start Restore Big Files");
     auto start = std::chrono::system_clock::now();
+    bigFileDirCache_.Clear();
     vector<string> ancoSourcePath;
     vector<string> ancoTargetPath;
     vector<StatInfo> ancoStats;
@@ -1577,6 +1966,9 @@ void BackupExtExtension::RestoreBigFiles(bool appendTargetPath)
         if (item.hashName.empty() || (!item.isUserTar && !item.isBigFile)) {
             continue;
         }
+        if (!UntarFile::IsInRestorePaths(restorePaths_, item.fileName)) {
+            continue;
+        }
         radarRestoreInfo_.bigFileNum++;
         radarRestoreInfo_.bigFileSize += static_cast<uint64_t>(item.sta.st_size);
         // 获取索引文件内容
@@ -1592,6 +1984,7 @@ void BackupExtExtension::RestoreBigFiles(bool appendTargetPath)
         }
         RestoreOneBigFile(path, item, appendTargetPath);
     }
+    bigFileDirCache_.Clear();
     ExecuteAncoMove(ancoSourcePath, ancoTargetPath, ancoStats);
     auto end = std::chrono::system_clock::now();
     radarRestoreInfo_.bigFileSpendTime = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
@@ -1711,7 +2104,16 @@ void BackupExtExtension::ExtractTarFiles(const std::set<std::string> &fileSet,
     for (const auto &item : fileSet) {  // 处理要解压的tar文件
         off_t tarFileSize = 0;
         if (ExtractFileExt(item) == "tar" && !IsUserTar(item, extManageInfo, tarFileSize)) {
-            ret = DoRestore(item, tarFileSize);
+            string tarName = GetRestoreTempPath(bundleName_) + item;
+            if (IsTarUnrequested(tarName)) {
+                continue;
+            }
+            string fingerprint = GetTarFingerprint(tarName, item, extManageInfo);
+            if (SkipRestored(item, fingerprint)) {
+                RemoveFile(tarName);
+                continue;
+            }
+            ret = DoRestore(item, tarFileSize, fingerprint);
         }
     }
 }
@@ -1731,6 +2133,8 @@ void BackupExtExtension::AsyncTaskRestore(std::set<std::string> fileSet,
                 ptr->HandleSpecialVersionRestore();
                 return;
             }
+            ptr->OpenRestoreJournal();
+            ptr->InitRestorePaths();
             // 解压
             ptr->ExtractTarFiles(fileSet, extManageInfo, ret);
             if (!enableBatch) {
@@ -1740,6 +2144,7 @@ void BackupExtExtension::AsyncTaskRestore(std::set<std::string> fileSet,
                     ptr->extension_->UseFullBackupOnly() && !ptr->extension_->SpecialVersionForCloneAndCloud();
                 ptr->RestoreBigFiles(appendTargetPath);
             }
+            ptr->FinishRestoreJournal(ret);
             if (ret == ERR_OK) {
                 ptr->AsyncTaskRestoreForUpgrade();
             } else {
@@ -1776,15 +2181,19 @@ int BackupExtExtension::DealIncreRestoreBigAndTarFile()
     auto startTime = std::chrono::system_clock::now();
     // 解压
     int ret = ERR_OK;
+    OpenRestoreJournal();
+    InitRestorePaths();
     ret = DoIncrementalRestore();
     if (ret != ERR_OK) {
         HILOGE("Do incremental restore err");
+        FinishRestoreJournal(ret);
         return ret;
     }
     // 恢复用户tar包以及大文件
     // 目的地址是否需要拼接path(临时目录)，FullBackupOnly为true并且非特殊场景
     bool appendTargetPath = extension_->UseFullBackupOnly() && !extension_->SpecialVersionForCloneAndCloud();
     RestoreBigFiles(appendTargetPath);
+    FinishRestoreJournal(ret);
     // delete 1.tar/manage.json
     DeleteBackupIncrementalIdxFile();
     if (isDebug_) {
@@ -2012,6 +2421,7 @@ void BackupExtExtension::DoClearInner()
         string backupCache = string(BConstants::PATH_BUNDLE_BACKUP_HOME).append(BConstants::SA_BUNDLE_BACKUP_BACKUP);
         string restoreCache = string(BConstants::PATH_BUNDLE_BACKUP_HOME).append(BConstants::SA_BUNDLE_BACKUP_RESTORE);
         string specialRestoreCache = GetRestoreTempPath(bundleName_);
+        string restoreJournal = GetRestoreJournalPath(bundleName_);
 
         if (!ForceRemoveDirectoryBMS(backupCache)) {
             HILOGE("Failed to delete the backup cache %{public}s", backupCache.c_str());
@@ -2024,6 +2434,10 @@ void BackupExtExtension::DoClearInner()
         if (!ForceRemoveDirectoryBMS(specialRestoreCache)) {
             HILOGE("Failed to delete cache for filemanager or medialibrary %{public}s", specialRestoreCache.c_str());
         }
+
+        if (unlink(restoreJournal.c_str()) != 0 && errno != ENOENT) {
+            HILOGE("Failed to delete the restore journal, errno = %{public}d", errno);
+        }
         // delete el1 backup/restore
         ForceRemoveDirectoryBMS(
             string(BConstants::PATH_BUNDLE_BACKUP_HOME_EL1).append(BConstants::SA_BUNDLE_BACKUP_BACKUP));
@@ -2066,6 +2480,11 @@ void BackupExtExtension::ReportAppStatistic(const std::string &func, ErrCode err
         appStatistic_->tarFileSize_ = radarRestoreInfo_.tarFileSize;
         appStatistic_->ReportRestore(func, RadarError(MODULE_RESTORE, errCode).GenCode());
     }
+    if (BSpanTracer::IsEnabled()) {
+        string tracePath = string(BConstants::BACKUP_CONFIG_EXTENSION_PATH) + BConstants::BACKUP_TRACE_FILE_NAME;
+        BSpanTracer::GetInstance().ExportChromeTrace(tracePath);
+        BSpanTracer::GetInstance().Clear();
+    }
 }
 
 void BackupExtExtension::AppDone(ErrCode errCode)
@@ -2255,6 +2674,21 @@ static void AdDeduplication(vector<struct ReportFileInfo> &filesList)
     filesList.erase(it, filesList.end());
 }
 
+// 简报未按路径排序时在内存上限内外部排序, 失败返回nullptr, 原简报仍可从头读取
+static BReportEntity *GetSortedReport(BReportEntity &rp, unique_ptr<BReportEntity> &sortedRp, size_t &count)
+{
+    if (rp.IsSortedByPath(count)) {
+        return &rp;
+    }
+    UniqueFd sortedFd = rp.SortByPath(string(BConstants::BACKUP_CONFIG_EXTENSION_PATH),
+        BConstants::REPORT_SORT_MEMORY_LIMIT, count);
+    if (sortedFd < 0) {
+        return nullptr;
+    }
+    sortedRp = make_unique<BReportEntity>(move(sortedFd));
+    return sortedRp.get();
+}
+
 void BackupExtExtension::FillFileInfos(UniqueFd incrementalFd,
                                        UniqueFd manifestFd,
                                        vector<struct ReportFileInfo> &allFiles,
@@ -2263,14 +2697,32 @@ void BackupExtExtension::FillFileInfos(UniqueFd incrementalFd,
 {
     HILOGI("Begin Compare");
     BReportEntity cloudRp(move(manifestFd));
-    unordered_map<string, struct ReportFileInfo> cloudFiles;
-    cloudRp.GetReportInfos(cloudFiles);
+    BReportEntity storageRp(move(incrementalFd));
     appStatistic_->scanFileSpend_.Start();
-    if (cloudFiles.empty()) {
-        FillFileInfosWithoutCmp(allFiles, smallFiles, bigFiles, move(incrementalFd));
+    string snapshotPath = string(BConstants::BACKUP_CONFIG_EXTENSION_PATH).append(BConstants::BACKUP_SCAN_SNAPSHOT);
+    scanSnapshot_ = make_shared<BScanSnapshot>();
+    scanSnapshot_->Load(snapshotPath);
+    bigFileScanStats_.clear();
+    unique_ptr<BReportEntity> sortedCloudRp;
+    unique_ptr<BReportEntity> sortedStorageRp;
+    size_t cloudCount = 0;
+    size_t localCount = 0;
+    BReportEntity *cloudSorted = GetSortedReport(cloudRp, sortedCloudRp, cloudCount);
+    BReportEntity *storageSorted = (cloudSorted != nullptr && cloudCount > 0) ?
+        GetSortedReport(storageRp, sortedStorageRp, localCount) : nullptr;
+    if (storageSorted != nullptr) {
+        FillFileInfosWithMergeJoin(allFiles, smallFiles, bigFiles, *cloudSorted, *storageSorted);
     } else {
-        FillFileInfosWithCmp(allFiles, smallFiles, bigFiles, cloudFiles, move(incrementalFd));
+        unordered_map<string, struct ReportFileInfo> cloudFiles;
+        cloudRp.GetReportInfos(cloudFiles);
+        if (cloudFiles.empty()) {
+            FillFileInfosWithoutCmp(allFiles, smallFiles, bigFiles, storageRp);
+        } else {
+            FillFileInfosWithCmp(allFiles, smallFiles, bigFiles, cloudFiles, storageRp);
+        }
     }
+    scanSnapshot_->Save(snapshotPath);
+    scanSnapshot_ = nullptr;
 
     AdDeduplication(allFiles);
     AdDeduplication(smallFiles);
@@ -2314,53 +2766,118 @@ ErrCode BackupExtExtension::IncrementalTarFileReady(const TarMap &bigFileInfo,
 }
 
 /**
- * 增量大文件和简报信息回传
+ * 增量大文件回传的准备阶段: 打开文件并生成简报, 与发送阶段并行执行
  */
-ErrCode BackupExtExtension::IncrementalBigFileReady(TarMap &pkgInfo,
-    const vector<struct ReportFileInfo> &bigInfos, sptr<IService> proxy)
+void BackupExtExtension::PrepareBigFileSendTasks(TarMap &pkgInfo, const vector<struct ReportFileInfo> &bigInfos,
+    BoundedQueue<BigFileSendTask> &sendQueue, vector<string> &noPermissionFiles)
 {
-    ErrCode ret {ERR_OK};
-    HILOGI("IncrementalBigFileReady Begin, pkgInfo size:%{public}zu", pkgInfo.size());
-    auto startTime = std::chrono::system_clock::now();
-    int fdNum = 0;
-    vector<string> noPermissionFiles;
-    for (const auto &item : pkgInfo) {
+    unordered_map<string, const struct ReportFileInfo *> bigInfoIndex;
+    bigInfoIndex.reserve(bigInfos.size());
+    for (const auto &info : bigInfos) {
+        bigInfoIndex.emplace(info.filePath, &info);
+    }
+    for (auto &item : pkgInfo) {
         if (item.first.empty()) {
             continue;
         }
-        auto [path, sta, isBeforeTar] = item.second;
-        int32_t errCode = ERR_OK;
-        WaitToSendFd(startTime, fdNum);
-        int fdval = OpenFileWithFDSan(path);
-        if (fdval < 0) {
+        auto &[path, sta, isBeforeTar] = item.second;
+        BigFileSendTask task;
+        task.fileName = item.first;
+        task.fd = OpenFileWithFDSan(path);
+        if (task.fd < 0) {
+            task.errCode = errno;
             HILOGE("IncrementalBigFileReady open file failed, file name is %{public}s, err = %{public}d",
-                GetAnonyString(path).c_str(), errno);
-            errCode = errno;
-            if (errCode == ERR_NO_PERMISSION) {
+                GetAnonyString(path).c_str(), task.errCode);
+            if (task.errCode == ERR_NO_PERMISSION) {
                 noPermissionFiles.emplace_back(item.first.c_str());
                 continue;
             }
+        } else {
+            task.fd = EncryptBigFileForSend(task.fd);
+            task.errCode = task.fd < 0 ? errno : task.errCode;
         }
         vector<struct ReportFileInfo> bigInfo;
-        for (const auto &tempFile : bigInfos) {
-            if (tempFile.filePath == path) {
-                bigInfo.emplace_back(tempFile);
-                break;
-            }
+        auto it = bigInfoIndex.find(path);
+        if (it != bigInfoIndex.end()) {
+            bigInfo.emplace_back(*(it->second));
+        }
+        task.manifestFile = GetReportFileName(string(INDEX_FILE_INCREMENTAL_BACKUP).append(item.first));
+        BFile::WriteFile(task.manifestFile, bigInfo);
+        task.manifestFd = OpenFileWithFDSan(task.manifestFile);
+        if (!sendQueue.Push(move(task))) {
+            CloseFileWithFDSan(task.fd);
+            CloseFileWithFDSan(task.manifestFd);
+            break;
         }
-        string file = GetReportFileName(string(INDEX_FILE_INCREMENTAL_BACKUP).append(item.first));
-        BFile::WriteFile(file, bigInfo);
-        int manifestFdval = OpenFileWithFDSan(file);
-        ErrCode ret = (fdval < 0 || manifestFdval < 0) ? proxy->AppIncrementalFileReadyWithoutFd(item.first, errCode) :
-                      proxy->AppIncrementalFileReady(item.first, fdval, manifestFdval, errCode);
-        CheckAppIncrementalFileReadyResult(ret, item.first, file);
-        CloseFileWithFDSan(fdval);
-        CloseFileWithFDSan(manifestFdval);
-        fdNum += BConstants::FILE_AND_MANIFEST_FD_COUNT;
-        RefreshTimeInfo(startTime, fdNum);
+    }
+    sendQueue.Close();
+}
+
+void BackupExtExtension::DrainBigFileSendTasks(BoundedQueue<BigFileSendTask> &sendQueue)
+{
+    BigFileSendTask task;
+    while (sendQueue.Pop(task)) {
+        CloseFileWithFDSan(task.fd);
+        CloseFileWithFDSan(task.manifestFd);
+    }
+}
+
+/**
+ * 增量大文件和简报信息回传
+ */
+ErrCode BackupExtExtension::IncrementalBigFileReady(TarMap &pkgInfo,
+    const vector<struct ReportFileInfo> &bigInfos, sptr<IService> proxy)
+{
+    ErrCode ret {ERR_OK};
+    HILOGI("IncrementalBigFileReady Begin, pkgInfo size:%{public}zu", pkgInfo.size());
+    int64_t bigFileStart = TimeUtils::GetTimeMS();
+    auto startTime = std::chrono::system_clock::now();
+    int fdNum = 0;
+    vector<string> noPermissionFiles;
+    BoundedQueue<BigFileSendTask> sendQueue(BConstants::BIG_FILE_PIPELINE_DEPTH);
+    std::exception_ptr prepareErr = nullptr;
+    uint64_t prepareSpendUS = 0;
+    std::thread prepareThread([this, &pkgInfo, &bigInfos, &sendQueue, &noPermissionFiles, &prepareErr,
+        &prepareSpendUS]() {
+        int64_t prepareStart = TimeUtils::GetTimeUS();
+        try {
+            PrepareBigFileSendTasks(pkgInfo, bigInfos, sendQueue, noPermissionFiles);
+        } catch (...) {
+            prepareErr = std::current_exception();
+            sendQueue.Close();
+        }
+        prepareSpendUS = TimeUtils::GetSpendUS(prepareStart);
+    });
+    uint64_t sendSpendUS = 0;
+    try {
+        BigFileSendTask task;
+        while (sendQueue.Pop(task)) {
+            WaitToSendFd(startTime, fdNum);
+            int64_t sendStart = TimeUtils::GetTimeUS();
+            ErrCode ret = (task.fd < 0 || task.manifestFd < 0) ?
+                proxy->AppIncrementalFileReadyWithoutFd(task.fileName, task.errCode) :
+                proxy->AppIncrementalFileReady(task.fileName, task.fd, task.manifestFd, task.errCode);
+            sendSpendUS += TimeUtils::GetSpendUS(sendStart);
+            CheckAppIncrementalFileReadyResult(ret, task.fileName, task.manifestFile);
+            CloseFileWithFDSan(task.fd);
+            CloseFileWithFDSan(task.manifestFd);
+            fdNum += BConstants::FILE_AND_MANIFEST_FD_COUNT;
+            RefreshTimeInfo(startTime, fdNum);
+        }
+    } catch (...) {
+        sendQueue.Close();
+        prepareThread.join();
+        DrainBigFileSendTasks(sendQueue);
+        throw;
+    }
+    prepareThread.join();
+    if (prepareErr != nullptr) {
+        std::rethrow_exception(prepareErr);
     }
     ClearNoPermissionFiles(pkgInfo, noPermissionFiles);
-    HILOGI("IncrementalBigFileReady End");
+    appStatistic_->bigFileSpend_ = TimeUtils::GetSpendMS(bigFileStart);
+    HILOGI("IncrementalBigFileReady End, spend:%{public}u ms, prepare:%{public}" PRIu64 " us, "
+        "send:%{public}" PRIu64 " us", appStatistic_->bigFileSpend_, prepareSpendUS, sendSpendUS);
     return ret;
 }
 
@@ -2390,6 +2907,8 @@ ErrCode BackupExtExtension::IncrementalAllFileReady(const TarMap &pkgInfo,
 
     string file = GetReportFileName(string(INDEX_FILE_INCREMENTAL_BACKUP).append("all"));
     BFile::WriteFile(file, srcFiles);
+    // manage.json最后回传, 服务端收到时大文件必须已经完整写出
+    bool streamed = pipeEncryptor_.Wait();
     int fdval = OpenFileWithFDSan(INDEX_FILE_BACKUP);
     int manifestFdval = OpenFileWithFDSan(file);
     ErrCode ret = (fdval < 0 || manifestFdval < 0) ?
@@ -2403,6 +2922,10 @@ ErrCode BackupExtExtension::IncrementalAllFileReady(const TarMap &pkgInfo,
     }
     CloseFileWithFDSan(fdval);
     CloseFileWithFDSan(manifestFdval);
+    if (!streamed) {
+        HILOGE("Failed to send encrypted big files");
+        return BError(BError::Codes::EXT_REPORT_FILE_READY_FAIL).GetCode();
+    }
     return ret;
 }
 
@@ -2421,4 +2944,22 @@ void BackupExtExtension::CloseFileWithFDSan(int fd)
         fdsan_close_with_tag(fd, BConstants::FDSAN_EXT_TAG);
     }
 }
+
+int BackupExtExtension::EncryptBigFileForSend(int fd)
+{
+    auto key = BEncryption::GetCurrentKey();
+    if (fd < 0 || key == nullptr) {
+        return fd;
+    }
+    // 原文件交给加密线程, 不再由扩展按fdsan标签关闭
+    fdsan_exchange_owner_tag(fd, BConstants::FDSAN_EXT_TAG, 0);
+    int readFd = pipeEncryptor_.Start(fd, key);
+    if (readFd < 0) {
+        HILOGE("Failed to encrypt big file");
+        errno = EIO;
+        return -1;
+    }
+    fdsan_exchange_owner_tag(readFd, 0, BConstants::FDSAN_EXT_TAG);
+    return readFd;
+}
 } // namespace OHOS::FileManagement::Backup
@@ -15,13 +15,16 @@
 
 #include "installd_un_tar_file.h"
 
+#include <cerrno>
 #include <cstdio>
 #include <directory_ex.h>
+#include <fcntl.h>
 #include <string>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "b_encryption/b_stream_cipher.h"
 #include "securec.h"
 
 #include <hilog/log.h>
@@ -177,6 +180,34 @@ static int CreateSoftlink(const char* oldPath, const char* newPath)
     return ret;
 }
 
+// 加密的tar包以解密流打开, 之后的读取和定位都是明文偏移
+static FILE *OpenTarFile(const char *path)
+{
+    using namespace OHOS::FileManagement::Backup::BEncryption;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    if (!StreamCipher::IsEncrypted(fd)) {
+        FILE *f = fdopen(fd, "rb");
+        if (f == nullptr) {
+            close(fd);
+        }
+        return f;
+    }
+    auto provider = GetKeyProvider();
+    if (provider == nullptr) {
+        LOGE("tar is encrypted but no key provider");
+        close(fd);
+        return nullptr;
+    }
+    FILE *f = StreamCipher::OpenReader(fd, *provider);
+    if (f == nullptr) {
+        LOGE("open encrypted tar failed, err = %{public}d", errno);
+    }
+    return f;
+}
+
 UnTarFile::UnTarFile(const char *tarPath): FilePtr(nullptr), tarSize(0), newOwner(0)
 {
     file_names.clear();
@@ -186,7 +217,7 @@ UnTarFile::UnTarFile(const char *tarPath): FilePtr(nullptr), tarSize(0), newOwne
     if (tarPath != nullptr) {
         LOGI("untarfile begin..");
         m_srcPath = tarPath;
-        FilePtr = fopen(tarPath, "rb");
+        FilePtr = OpenTarFile(tarPath);
         if (FilePtr == nullptr) {
             LOGE("open file fail");
         }
@@ -216,11 +247,12 @@ void UnTarFile::Reset()
     file_names.clear();
     file_sizes.clear();
     file_data_addrs.clear();
+    extracted_files.clear();
 }
 
 int UnTarFile::UnSplitTar(const std::string &tarFile, const std::string &rootpath)
 {
-    FilePtr = fopen(tarFile.c_str(), "rb");
+    FilePtr = OpenTarFile(tarFile.c_str());
     if (FilePtr == nullptr) {
         LOGE("UnTarFile::UnSplitPack, untar split failed!");
     }
@@ -244,7 +276,7 @@ int UnTarFile::UnSplitTar(const std::string &tarFile, const std::string &rootpat
 
 bool UnTarFile::CheckIsSplitTar(const std::string &tarFile, const std::string &rootpath)
 {
-    FilePtr = fopen(tarFile.c_str(), "rb");
+    FilePtr = OpenTarFile(tarFile.c_str());
     if (FilePtr == nullptr) {
         LOGE("UnTarFile::CheckIsSplitTar, open split failed!");
     }
@@ -354,6 +386,9 @@ bool UnTarFile::ProcessTarBlock(char *buff, EParseType type, ParseTarPath *parse
         case AREGTYPE:
             HandleRegularFile(buff, type, parseTarPath, isSkip, tarFileInfo);
             break;
+        case LNKTYPE:
+            HandleHardLink(type, parseTarPath, isSkip, tarFileInfo);
+            break;
         case SYMTYPE:
             CreateSoftlink(parseTarPath->realLink, parseTarPath->fullPath);
             isSoftLink = true;
@@ -462,6 +497,45 @@ void UnTarFile::HandleRegularFile(char *buff, EParseType type, ParseTarPath *par
     }
 }
 
+void UnTarFile::HandleHardLink(EParseType type, ParseTarPath *parseTarPath, bool &isSkip, TarFileInfo &tarFileInfo)
+{
+    isSkip = true;
+    // 硬链接没有内容, 防御性地跳过可能存在的数据块
+    fseeko(FilePtr, tarFileInfo.pos + tarFileInfo.fileBlockCnt * BLOCK_SIZE, SEEK_SET);
+    if (eUnpack != type || parseTarPath->realLink == nullptr) {
+        return;
+    }
+    std::string target(PATH_MAX_LEN, '\0');
+    char *targetPath = &target[0];
+    if (GenRealPath(parseTarPath->rootPath, parseTarPath->realLink, targetPath) != 0) {
+        return;
+    }
+    target.resize(strlen(targetPath));
+    // 只链接到本次解包写入的文件, 否则不改动目的路径上已有的文件
+    if (extracted_files.find(target) == extracted_files.end()) {
+        LOGE("hard link target is not unpacked, skip");
+        return;
+    }
+    std::string linkPath(parseTarPath->fullPath);
+    size_t pos = linkPath.rfind('/');
+    if (pos != std::string::npos) {
+        CreateDirWithRecursive(linkPath.substr(0, pos));
+    }
+    // 先链接到临时文件再替换, 失败时不影响已有的文件
+    std::string tmpPath = linkPath + ".linktmp";
+    unlink(tmpPath.c_str());
+    if (link(target.c_str(), tmpPath.c_str()) != 0) {
+        LOGE("fail to create hard link, errno %{public}d", errno);
+        return;
+    }
+    if (rename(tmpPath.c_str(), linkPath.c_str()) != 0) {
+        LOGE("fail to rename hard link, errno %{public}d", errno);
+        unlink(tmpPath.c_str());
+        return;
+    }
+    isSkip = false;
+}
+
 bool UnTarFile::FileReadAndWrite(char *destBuff, FILE *destF, size_t readBuffSize)
 {
     if (readBuffSize != fread(destBuff, sizeof(char), readBuffSize, FilePtr)) {
@@ -521,6 +595,7 @@ void UnTarFile::HandleRegularEUnpackFile(char *buff, ParseTarPath *parseTarPath,
         unlink(parseTarPath->fullPath);
         isSkip = true;
     } else {
+        extracted_files.insert(parseTarPath->fullPath);
         isSkip = false;
     }
     // anyway, go to correct pos
@@ -572,6 +647,7 @@ int UnTarFile::ParseTarFile(const char *rootPath, EParseType type)
     if (ret != 0) {
         return ret;
     }
+    parseTarPath.rootPath = rootPath;
     LOGI("ParseTarFile");
 
     // re-parse tar header
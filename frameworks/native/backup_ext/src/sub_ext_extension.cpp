@@ -23,7 +23,6 @@
 #include <cstdio>
 #include <fstream>
 #include <fnmatch.h>
-#include <iomanip>
 #include <iterator>
 #include <map>
 #include <memory>
@@ -49,6 +48,7 @@
 #include "errors.h"
 #include "ipc_skeleton.h"
 
+#include "b_encryption/b_stream_cipher.h"
 #include "b_error/b_error.h"
 #include "b_error/b_excep_utils.h"
 #include "b_filesystem/b_dir.h"
@@ -62,6 +62,7 @@
 #include "b_ohos/startup/backup_para.h"
 #include "b_radar/b_radar.h"
 #include "b_tarball/b_tarball_factory.h"
+#include "b_utils/b_span_tracer.h"
 #include "b_utils/scan_file_singleton.h"
 #include "b_utils/string_utils.h"
 #include "clone_file_info_backup_rdbstore.h"
@@ -126,6 +127,7 @@ ErrCode BackupExtExtension::IncrementalOnBackup(bool isClearData)
 
 void BackupExtExtension::WaitToSendFd(std::chrono::system_clock::time_point &startTime, int &fdSendNum)
 {
+    BACKUP_SPAN("ext.WaitToSendFd");
     HILOGD("WaitToSendFd Begin");
     std::unique_lock<std::mutex> lock(startSendMutex_);
     startSendFdRateCon_.wait(lock, [this] { return sendRate_ > 0; });
@@ -977,6 +979,7 @@ ErrCode BackupExtExtension::UpdateDfxInfo(int64_t uniqId, uint32_t extConnectSpe
     appStatistic_->SetUniqId(uniqId);
     appStatistic_->extConnectSpend_ = extConnectSpend;
     appStatistic_->appCaller_ = bundleName;
+    BSpanTracer::GetInstance().SetEnabled(BackupPara::GetBackupTraceEnable());
     return ERR_OK;
 }
 
@@ -1000,6 +1003,24 @@ bool BackupExtExtension::SetStagingPathProperties()
     return true;
 }
 
+void BackupExtExtension::InitStreamKeyProvider()
+{
+    // 默认不加密, 只使用调用方下发的密钥, 恢复时调用方下发同一密钥, 换设备也能解密
+    string keyText = extension_ == nullptr ? "" : extension_->GetStreamKey();
+    if (keyText.empty()) {
+        BEncryption::SetKeyProvider(nullptr);
+        return;
+    }
+    auto key = BEncryption::ParseStreamKey(keyText);
+    if (key == nullptr) {
+        HILOGE("Invalid stream key from caller, backup artifacts will not be encrypted");
+        BEncryption::SetKeyProvider(nullptr);
+        return;
+    }
+    HILOGI("Encrypt backup artifacts, key id:%{public}s", key->keyId.c_str());
+    BEncryption::SetKeyProvider(make_shared<BEncryption::CallerKeyProvider>(key));
+}
+
 bool BackupExtExtension::IfAllowToBackupRestore()
 {
     if (extension_ == nullptr) {
@@ -1129,23 +1150,12 @@ int BackupExtExtension::User0DoBackup(const BJsonEntityExtensionConfig &usrConfi
     return ERR_OK;
 }
 
-void BackupExtExtension::UpdateFileStat(std::string filePath, uint64_t fileSize)
+void BackupExtExtension::UpdateFileStat(const std::string &filePath, uint64_t fileSize, uint32_t dirDepth)
 {
-    std::lock_guard<std::mutex> lock(updateFileStatLock_);
-    appStatistic_->UpdateFileDist(ExtractFileExt(filePath), fileSize);
-    uint32_t dirDepth = 0;
-    const char* pstr = filePath.c_str();
-    char pre = '-';
-    uint32_t pathLen = filePath.size();
-    for (uint32_t i = 0; i < pathLen; i++) {
-        if (pstr[i] == '/' && pre != '/') {
-            dirDepth++;
-        }
-        pre = pstr[i];
-    }
-    if (dirDepth > appStatistic_->dirDepth_) {
-        appStatistic_->dirDepth_ = dirDepth;
+    if (dirDepth == 0) {
+        dirDepth = StringUtils::GetPathDepth(filePath);
     }
+    appStatistic_->UpdateFileStat(ExtractFileExt(filePath), fileSize, dirDepth);
 }
 
 /**
@@ -1153,40 +1163,28 @@ void BackupExtExtension::UpdateFileStat(std::string filePath, uint64_t fileSize)
  */
 TarMap BackupExtExtension::GetIncrmentBigInfos(const vector<struct ReportFileInfo> &files)
 {
-    auto getStringHash = [](const TarMap &tarMap, const string &str) -> string {
-        ostringstream strHex;
-        strHex << hex;
-
-        hash<string> strHash;
-        size_t szHash = strHash(str);
-        strHex << setfill('0') << setw(BConstants::BIG_FILE_NAME_SIZE) << szHash;
-        string name = strHex.str();
-        for (int i = 0; tarMap.find(name) != tarMap.end(); ++i, strHex.str("")) {
-            szHash = strHash(str + to_string(i));
-            strHex << setfill('0') << setw(BConstants::BIG_FILE_NAME_SIZE) << szHash;
-            name = strHex.str();
-        }
-
-        return name;
-    };
-
     TarMap bigFiles;
     for (const auto &item : files) {
         struct stat sta = {};
-        if (stat(item.filePath.c_str(), &sta) != 0) {
+        auto scanIt = bigFileScanStats_.find(item.filePath);
+        if (scanIt != bigFileScanStats_.end()) {
+            sta = scanIt->second;
+        } else if (stat(item.filePath.c_str(), &sta) != 0) {
             HILOGE("Failed to stat file %{public}s, err = %{public}d", item.filePath.c_str(), errno);
             throw errno;
         }
         appStatistic_->bigFileSize_ += static_cast<uint64_t>(sta.st_size);
         UpdateFileStat(item.filePath, sta.st_size);
         uint64_t hashStart = static_cast<uint64_t>(TimeUtils::GetTimeUS());
-        string md5Name = getStringHash(bigFiles, item.filePath);
+        string md5Name = StringUtils::GenHashName(item.filePath, [&bigFiles](const string &name) {
+            return bigFiles.find(name) != bigFiles.end();
+        });
         appStatistic_->hashSpendUS_ += TimeUtils::GetSpendUS(hashStart);
         if (!md5Name.empty()) {
             bigFiles.emplace(md5Name, make_tuple(item.filePath, sta, true));
         }
     }
-
+    bigFileScanStats_.clear();
     return bigFiles;
 }
 
@@ -1330,6 +1328,8 @@ void BackupExtExtension::IncrementalPacket(const vector<struct ReportFileInfo> &
     vector<string> packFiles;
     vector<struct ReportFileInfo> tarInfos;
     TarFile::GetInstance().SetPacketMode(true); // 设置下打包模式
+    TarFile::GetInstance().SetDigestAlgorithm(BackupPara::GetBackupTarDigestAlgorithm());
+    TarFile::GetInstance().SetStreamKey(BEncryption::GetCurrentKey());
     auto startTime = std::chrono::system_clock::now();
     int fdNum = 0;
     string partName = GetIncrmentPartName();
@@ -1378,6 +1378,7 @@ int BackupExtExtension::DoIncrementalBackup(const vector<struct ReportFileInfo>
                                             const vector<struct ReportFileInfo> &smallFiles,
                                             const vector<struct ReportFileInfo> &bigFiles)
 {
+    BACKUP_SPAN("ext.DoIncrementalBackup");
     HILOGI("Do increment backup begin");
     if (extension_ == nullptr) {
         HILOGE("Failed to do incremental backup, extension is nullptr");
@@ -1465,10 +1466,9 @@ std::function<void(ErrCode, std::string)> BackupExtExtension::ReportOnProcessRes
 void BackupExtExtension::FillFileInfosWithoutCmp(vector<struct ReportFileInfo> &allFiles,
                                                  vector<struct ReportFileInfo> &smallFiles,
                                                  vector<struct ReportFileInfo> &bigFiles,
-                                                 UniqueFd incrementalFd)
+                                                 BReportEntity &storageRp)
 {
     HILOGI("Fill file info without cmp begin");
-    BReportEntity storageRp(move(incrementalFd));
     unordered_map<string, struct ReportFileInfo> localFilesInfo;
     while (storageRp.GetStorageReportInfos(localFilesInfo)) {
         for (auto localIter = localFilesInfo.begin(); localIter != localFilesInfo.end(); ++localIter) {
@@ -1484,7 +1484,8 @@ void BackupExtExtension::FillFileInfosWithoutCmp(vector<struct ReportFileInfo> &
                 allFiles.emplace_back(localIter->second);
                 continue;
             }
-            auto [res, fileHash] = BackupFileHash::HashWithSHA256(path);
+            struct stat sta = {};
+            string fileHash = GetLocalFileHash(path, sta);
             if (fileHash.empty()) {
                 HILOGE("Do hash err, fileHash is empty, path: %{public}s", GetAnonyPath(path).c_str());
                 continue;
@@ -1502,6 +1503,7 @@ void BackupExtExtension::FillFileInfosWithoutCmp(vector<struct ReportFileInfo> &
                 smallFiles.emplace_back(localIter->second);
                 continue;
             }
+            bigFileScanStats_[path] = sta;
             bigFiles.emplace_back(localIter->second);
         }
         localFilesInfo.clear();
@@ -1512,10 +1514,9 @@ void BackupExtExtension::FillFileInfosWithCmp(vector<struct ReportFileInfo> &all
                                               vector<struct ReportFileInfo> &smallFiles,
                                               vector<struct ReportFileInfo> &bigFiles,
                                               const unordered_map<string, struct ReportFileInfo> &cloudFiles,
-                                              UniqueFd incrementalFd)
+                                              BReportEntity &storageRp)
 {
     HILOGI("Fill file info with cmp begin");
-    BReportEntity storageRp(move(incrementalFd));
     unordered_map<string, struct ReportFileInfo> localFilesInfo;
     while (storageRp.GetStorageReportInfos(localFilesInfo)) {
         CompareFiles(allFiles, smallFiles, bigFiles, cloudFiles, localFilesInfo);
@@ -1523,56 +1524,106 @@ void BackupExtExtension::FillFileInfosWithCmp(vector<struct ReportFileInfo> &all
     }
 }
 
+void BackupExtExtension::FillFileInfosWithMergeJoin(vector<struct ReportFileInfo> &allFiles,
+                                                    vector<struct ReportFileInfo> &smallFiles,
+                                                    vector<struct ReportFileInfo> &bigFiles,
+                                                    BReportEntity &cloudRp,
+                                                    BReportEntity &storageRp)
+{
+    HILOGI("Fill file info with merge join begin");
+    BACKUP_SPAN("ext.CompareFiles");
+    BReportEntity::MergeJoin(storageRp, cloudRp,
+        [&](ReportDiffType type, struct ReportFileInfo *local, const struct ReportFileInfo *cloud) {
+            if (type == ReportDiffType::DELETED) {
+                return;
+            }
+            CompareFile(allFiles, smallFiles, bigFiles, cloud, *local);
+        });
+}
+
 void BackupExtExtension::CompareFiles(vector<struct ReportFileInfo> &allFiles,
                                       vector<struct ReportFileInfo> &smallFiles,
                                       vector<struct ReportFileInfo> &bigFiles,
                                       const unordered_map<string, struct ReportFileInfo> &cloudFiles,
                                       unordered_map<string, struct ReportFileInfo> &localFilesInfo)
 {
+    BACKUP_SPAN("ext.CompareFiles");
     for (auto localIter = localFilesInfo.begin(); localIter != localFilesInfo.end(); ++localIter) {
-        // 进行文件对比, 当后续使用 isUserTar 字段时需注意 字段解析函数
-        const string &path = localIter->second.filePath;
-        if (path.empty()) {
-            HILOGE("GetStorageReportInfos failed");
-            continue;
-        }
-        auto it = cloudFiles.find(path);
-        bool isExist = (it != cloudFiles.end());
-        if (localIter->second.isIncremental && !isExist && localIter->second.isDir) {
-            smallFiles.emplace_back(localIter->second);
+        auto it = cloudFiles.find(localIter->second.filePath);
+        const struct ReportFileInfo *cloud = (it == cloudFiles.end()) ? nullptr : &it->second;
+        CompareFile(allFiles, smallFiles, bigFiles, cloud, localIter->second);
+    }
+}
+
+void BackupExtExtension::CompareFile(vector<struct ReportFileInfo> &allFiles,
+                                     vector<struct ReportFileInfo> &smallFiles,
+                                     vector<struct ReportFileInfo> &bigFiles,
+                                     const struct ReportFileInfo *cloud,
+                                     struct ReportFileInfo &local)
+{
+    // 进行文件对比, 当后续使用 isUserTar 字段时需注意 字段解析函数
+    const string &path = local.filePath;
+    if (path.empty()) {
+        HILOGE("GetStorageReportInfos failed");
+        return;
+    }
+    bool isExist = (cloud != nullptr);
+    if (local.isIncremental && !isExist && local.isDir) {
+        smallFiles.emplace_back(local);
+    }
+    if (local.isDir) {
+        allFiles.emplace_back(local);
+        return;
+    }
+    bool isChange = !(isExist && local.size == cloud->size && local.mtime == cloud->mtime);
+    struct stat sta = {};
+    if (isChange) {
+        string fileHash = GetLocalFileHash(path, sta);
+        if (fileHash.empty()) {
+            HILOGE("Do hash err, fileHash is empty");
+            return;
         }
-        if (localIter->second.isDir) {
-            allFiles.emplace_back(localIter->second);
-            continue;
+        local.hash = fileHash;
+    } else {
+        local.hash = cloud->hash;
+    }
+
+    if (ExtractFileExt(path) == "tar") {
+        local.userTar = 1; // 1: default value, means true
+    }
+
+    allFiles.emplace_back(local);
+    if (local.isIncremental && (!isExist || cloud->hash != local.hash)) {
+        // 在云空间简报里不存在或者hash不一致
+        if (local.size <= BConstants::BIG_FILE_BOUNDARY) {
+            smallFiles.emplace_back(local);
+            return;
         }
-        bool isChange = !(isExist && localIter->second.size == it->second.size &&
-            localIter->second.mtime == it->second.mtime);
         if (isChange) {
-            auto [res, fileHash] = BackupFileHash::HashWithSHA256(path);
-            if (fileHash.empty()) {
-                HILOGE("Do hash err, fileHash is empty");
-                continue;
-            }
-            localIter->second.hash = fileHash;
-        } else {
-            localIter->second.hash = it->second.hash;
-        }
-
-        if (ExtractFileExt(path) == "tar") {
-            localIter->second.userTar = 1; // 1: default value, means true
+            bigFileScanStats_[path] = sta;
         }
+        bigFiles.emplace_back(local);
+    }
+}
 
-        allFiles.emplace_back(localIter->second);
-        if (localIter->second.isIncremental && (!isExist ||
-            it->second.hash != localIter->second.hash)) {
-            // 在云空间简报里不存在或者hash不一致
-            if (localIter->second.size <= BConstants::BIG_FILE_BOUNDARY) {
-                smallFiles.emplace_back(localIter->second);
-                continue;
-            }
-            bigFiles.emplace_back(localIter->second);
+string BackupExtExtension::GetLocalFileHash(const string &path, struct stat &sta)
+{
+    if (stat(path.c_str(), &sta) != 0) {
+        HILOGE("Failed to stat file %{public}s, err = %{public}d", GetAnonyPath(path).c_str(), errno);
+        return "";
+    }
+    bool useSnapshot = scanSnapshot_ != nullptr;
+    if (useSnapshot) {
+        string hash = scanSnapshot_->LookupHash(path, sta);
+        if (!hash.empty()) {
+            return hash;
         }
     }
+    auto [res, fileHash] = BackupFileHash::HashWithSHA256(path);
+    if (useSnapshot && res == ERR_OK) {
+        scanSnapshot_->RecordHash(path, sta, fileHash);
+    }
+    return fileHash;
 }
 
 bool BackupExtExtension::IfCloudSpecialRestore(string tarName)
@@ -1686,6 +1737,23 @@ ErrCode BackupExtExtension::ReportBatchFiles(std::vector<std::shared_ptr<IFileIn
     return ERR_OK;
 }
 
+void BackupExtExtension::DoBackupFileCore(bool supportWithoutTar, std::shared_ptr<IFileInfo> &fileInfo,
+    std::vector<std::shared_ptr<IFileInfo>> &allFiles, int &fdNum, int &ret)
+{
+    ErrCode subRet = ReportAppFileReady(fileInfo, fdNum);
+    if (subRet != ERR_NO_PERMISSION) {
+        allFiles.push_back(fileInfo);
+        DoAppendFiles(std::vector<std::shared_ptr<IFileInfo>> {fileInfo}, ret, supportWithoutTar);
+    } else {
+        subRet = ERR_OK;
+    }
+    if (subRet != ERR_OK) { // 后续错误码上报DFX
+        HILOGE("report file ready fail,filename=%{public}s, err=%{public}d",
+            fileInfo->filename_.c_str(), subRet);
+        ret = static_cast<int>(BError::Codes::EXT_REPORT_FILE_READY_FAIL);
+    }
+}
+
 void BackupExtExtension::DoBackupTaskCore(
     bool supportWithoutTar, std::vector<std::shared_ptr<IFileInfo>> &allFiles, int &ret)
 {
@@ -1699,47 +1767,48 @@ void BackupExtExtension::DoBackupTaskCore(
     while (!ScanFileSingleton::GetInstance().IsProcessCompleted() ||
            ScanFileSingleton::GetInstance().HasFileReady()) {
         ScanFileSingleton::GetInstance().WaitForFiles();
-        std::shared_ptr<IFileInfo> fileInfo = ScanFileSingleton::GetInstance().GetFileInfo();
-        if (fileInfo == nullptr) {
-            HILOGE("Get null file info!!");
-            continue;
-        }
-        bool isWithoutTarFile = supportWithoutTar && !fileInfo->isAncoFile_;
-        if (isWithoutTarFile && !fileInfo->isLongPath_) {
-            std::string restorePath = fileInfo->GetRestorePath();
-            fileInfo->filename_ = restorePath.empty() ? fileInfo->filePath_ : restorePath;
-        }
-        WaitToSendFd(startTime, fdNum);
-        if (isWithoutTarFile) {
-            tmpFiles.push_back(fileInfo);
-            if (tmpFiles.size() == static_cast<size_t>(GetBatchSize())) {
-                ret = ReportBatchFiles(tmpFiles, allFiles);
-                DoAppendFiles(tmpFiles, ret, supportWithoutTar);
-                tmpFiles.clear();
+        // 批量出队减少分片队列加锁次数, 取到tar包即结束本批
+        auto fileInfos = ScanFileSingleton::GetInstance().GetFileInfos(BConstants::BACKUP_FILE_FETCH_BATCH);
+        for (auto &fileInfo : fileInfos) {
+            if (fileInfo == nullptr) {
+                HILOGE("Get null file info!!");
+                continue;
             }
-            fdNum++;
-        } else {
-            ErrCode subRet = ReportAppFileReady(fileInfo, fdNum);
-            if (subRet != ERR_NO_PERMISSION) {
-                allFiles.push_back(fileInfo);
-                DoAppendFiles(std::vector<std::shared_ptr<IFileInfo>> {fileInfo}, ret, supportWithoutTar);
-            } else {
-                subRet = ERR_OK;
+            bool isWithoutTarFile = supportWithoutTar && !fileInfo->isAncoFile_;
+            if (isWithoutTarFile && !fileInfo->isLongPath_) {
+                std::string restorePath = fileInfo->GetRestorePath();
+                fileInfo->filename_ = restorePath.empty() ? fileInfo->filePath_ : restorePath;
             }
-            if (subRet != ERR_OK) { // 后续错误码上报DFX
-                HILOGE("report file ready fail,filename=%{public}s, err=%{public}d",
-                    fileInfo->filename_.c_str(), subRet);
-                ret = static_cast<int>(BError::Codes::EXT_REPORT_FILE_READY_FAIL);
+            WaitToSendFd(startTime, fdNum);
+            if (isWithoutTarFile) {
+                tmpFiles.push_back(fileInfo);
+                if (tmpFiles.size() == static_cast<size_t>(GetBatchSize())) {
+                    ReportBatchFilesAndRelease(tmpFiles, allFiles, supportWithoutTar, ret);
+                }
+                fdNum++;
+            } else {
+                DoBackupFileCore(supportWithoutTar, fileInfo, allFiles, fdNum, ret);
+                // 发送完一个再释放其tar空间预算, 未发送的tar包仍计入预算
+                ScanFileSingleton::GetInstance().ReleaseTarBudget(fileInfo);
             }
+            RefreshTimeInfo(startTime, fdNum);
         }
-        RefreshTimeInfo(startTime, fdNum);
     }
 
     if (supportWithoutTar && !tmpFiles.empty()) {
-        ret = ReportBatchFiles(tmpFiles, allFiles);
-        DoAppendFiles(tmpFiles, ret, supportWithoutTar);
-        tmpFiles.clear();
+        ReportBatchFilesAndRelease(tmpFiles, allFiles, supportWithoutTar, ret);
+    }
+}
+
+void BackupExtExtension::ReportBatchFilesAndRelease(std::vector<std::shared_ptr<IFileInfo>> &tmpFiles,
+    std::vector<std::shared_ptr<IFileInfo>> &allFiles, bool supportWithoutTar, int &ret)
+{
+    ret = ReportBatchFiles(tmpFiles, allFiles);
+    DoAppendFiles(tmpFiles, ret, supportWithoutTar);
+    for (const auto &fileInfo : tmpFiles) {
+        ScanFileSingleton::GetInstance().ReleaseTarBudget(fileInfo);
     }
+    tmpFiles.clear();
 }
 
 void BackupExtExtension::DoBackupTask()
@@ -1748,7 +1817,14 @@ void BackupExtExtension::DoBackupTask()
     std::vector<std::shared_ptr<IFileInfo>> allFiles;
     HILOGD("supportWithoutTar is, %{public}d", supportWithoutTar);
     int ret = ERR_OK;
-    DoBackupTaskCore(supportWithoutTar, allFiles, ret);
+    try {
+        DoBackupTaskCore(supportWithoutTar, allFiles, ret);
+    } catch (...) {
+        // 发送侧异常退出时停止接收, 避免扫描和打包线程阻塞在已满的待发送队列上
+        ScanFileSingleton::GetInstance().StopPendingFiles();
+        throw;
+    }
+    ScanFileSingleton::GetInstance().StopPendingFiles();
     WaitforFdAppendComplete(allFiles);
     int indexRet = IndexFileReady(); // 无需WaitToSendFd，sendRate=0时克隆实际还可以继续接收数据
     if (indexRet != ERR_OK) {
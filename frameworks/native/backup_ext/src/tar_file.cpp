@@ -45,6 +45,10 @@ const uint32_t WAIT_INDEX = 100000;
 const uint32_t WAIT_TIME = 5;
 const string VERSION = "1.0";
 const string LONG_LINK_SYMBOL = "longLinkSymbol";
+const string PAX_HEADER_NAME = "PaxHeader";
+const uint32_t BITS_PER_BYTE = 8;
+const uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+const uint64_t FNV_PRIME = 0x100000001b3ULL;
 } // namespace
 
 TarFile &TarFile::GetInstance()
@@ -53,6 +57,14 @@ TarFile &TarFile::GetInstance()
     return instance;
 }
 
+TarFile::~TarFile()
+{
+    if (currentTarFile_ != nullptr) {
+        fclose(currentTarFile_);
+        currentTarFile_ = nullptr;
+    }
+}
+
 bool TarFile::InitBeforePacket(const string &tarFileName, const string &pkPath)
 {
     if (tarFileName.empty() || pkPath.empty()) {
@@ -338,6 +350,7 @@ bool TarFile::AddFile(string &fileName, const struct stat &st, int &err, const s
     currentFileName_ = fileName;
 
     TarHeader hdr;
+    off_t entryOffset = currentTarFileSize_;
     string writeFileName = restorePath.empty() ? fileName : restorePath;
     if (!I2OcsConvert(st, hdr, writeFileName)) {
         HILOGE("Failed to I2OcsConvert");
@@ -346,6 +359,15 @@ bool TarFile::AddFile(string &fileName, const struct stat &st, int &err, const s
     if (!ReadyHeader(hdr, writeFileName)) {
         return false;
     }
+    if (hdr.typeFlag == REGTYPE && st.st_nlink > 1 && !FillHardLinkHeader(hdr, st)) {
+        return false;
+    }
+    // 摘要扩展头需在长文件名头之前写入, 解包时长文件名只对紧随其后的文件头生效
+    off_t digestPos = -1;
+    if (hdr.typeFlag == REGTYPE && digestAlgorithm_ != BEncryption::DigestAlgorithm::NONE &&
+        !WriteDigestHeader(digestPos)) {
+        return false;
+    }
     if (writeFileName.length() >= TNAME_LEN) {
         if (!WriteLongName(writeFileName, GNUTYPE_LONGNAME)) {
             return false;
@@ -359,6 +381,7 @@ bool TarFile::AddFile(string &fileName, const struct stat &st, int &err, const s
             HILOGE("Failed to write all");
             return false;
         }
+        AddIndexEntry(writeFileName, hdr.typeFlag, entryOffset);
         currentFileName_.clear();
         return true;
     }
@@ -369,14 +392,47 @@ bool TarFile::AddFile(string &fileName, const struct stat &st, int &err, const s
         return false;
     }
     // write src file content to tar file
+    fileDigest_ = digestPos < 0 ? nullptr : make_unique<BEncryption::ContentDigest>(digestAlgorithm_);
     if (!WriteFileContent(fileName, st.st_size, err)) {
         HILOGE("Failed to write file content");
+        fileDigest_ = nullptr;
         return false;
     }
+    if (fileDigest_ != nullptr && !FillDigest(digestPos, fileDigest_->Final())) {
+        fileDigest_ = nullptr;
+        return false;
+    }
+    fileDigest_ = nullptr;
+    AddIndexEntry(writeFileName, hdr.typeFlag, entryOffset);
+    if (st.st_nlink > 1) {
+        linkTargets_.emplace(make_pair(st.st_dev, st.st_ino), writeFileName);
+    }
     currentFileName_.clear();
     return true;
 }
 
+bool TarFile::FillHardLinkHeader(TarHeader &hdr, const struct stat &st)
+{
+    auto it = linkTargets_.find(make_pair(st.st_dev, st.st_ino));
+    // 链接目标只能引用同一个tar包中的文件, 分片后重新写入内容
+    if (it == linkTargets_.end() || it->second.length() >= TNAME_LEN) {
+        return true;
+    }
+    auto ret = memcpy_s(hdr.linkName, sizeof(hdr.linkName), it->second.c_str(), it->second.length());
+    if (ret != EOK) {
+        HILOGE("Failed to call memcpy_s, err = %{public}d", ret);
+        return false;
+    }
+    string size = I2Ocs(sizeof(hdr.size), 0);
+    ret = memcpy_s(hdr.size, sizeof(hdr.size), size.c_str(), min(sizeof(hdr.size) - 1, size.length()));
+    if (ret != EOK) {
+        HILOGE("Failed to call memcpy_s, err = %{public}d", ret);
+        return false;
+    }
+    hdr.typeFlag = LNKTYPE;
+    return true;
+}
+
 bool TarFile::WriteFileContent(const string &fileName, off_t size, int &err)
 {
     int fd = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
@@ -401,6 +457,9 @@ bool TarFile::WriteFileContent(const string &fileName, off_t size, int &err)
             HILOGE("Failed to read all");
             break;
         }
+        if (fileDigest_ != nullptr) {
+            fileDigest_->Update(ioBuffer_.data(), static_cast<size_t>(read));
+        }
 
         // write buffer to tar file
         if (SplitWriteAll(ioBuffer_, read, err) != read) {
@@ -450,12 +509,20 @@ bool TarFile::CreateSplitTarFile()
         currentTarFile_ = nullptr;
     }
     // create a tar file
-    currentTarFile_ = fopen(currentTarName_.c_str(), "wb+");
+    if (streamKey_ != nullptr) {
+        int fd = open(currentTarName_.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC,
+            S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+        currentTarFile_ = fd < 0 ? nullptr : BEncryption::StreamCipher::OpenWriter(fd, *streamKey_);
+    } else {
+        currentTarFile_ = fopen(currentTarName_.c_str(), "wb+");
+    }
     if (currentTarFile_ == nullptr) {
         HILOGE("Failed to open file %{public}s, err = %{public}d", currentTarName_.c_str(), errno);
         throw BError(BError::Codes::EXT_BACKUP_PACKET_ERROR, "CreateSplitTarFile Failed to open file");
     }
     currentTarFileSize_ = 0;
+    tarIndex_.clear();
+    linkTargets_.clear();
 
     return true;
 }
@@ -479,24 +546,40 @@ bool TarFile::FillSplitTailBlocks()
     }
 
     // write tar file tail
-    const int END_BLOCK_SIZE = 1024;
     vector<uint8_t> buff {};
-    buff.resize(END_BLOCK_SIZE);
-    WriteAll(buff, END_BLOCK_SIZE);
+    buff.resize(TAR_END_BLOCK_SIZE);
+    WriteAll(buff, TAR_END_BLOCK_SIZE);
+    if (!tarIndex_.empty() && !WriteTarIndex()) {
+        // 索引只用于加速选择性解包, 写入失败时tar包仍可完整解包
+        HILOGW("Failed to write index of %{public}s", currentTarName_.c_str());
+    }
     fflush(currentTarFile_);
+    if (streamKey_ != nullptr) {
+        // 加密tar包的最后一个分块在关闭时写入, 关闭后才是最终大小
+        int closeRet = fclose(currentTarFile_);
+        currentTarFile_ = nullptr;
+        if (closeRet != 0) {
+            HILOGE("Failed to close encrypted file %{public}s, err = %{public}d", currentTarName_.c_str(), errno);
+            throw BError(BError::Codes::EXT_BACKUP_PACKET_ERROR, "FillSplitTailBlocks Failed to close file");
+        }
+    }
 
     struct stat staTar {};
     int ret = stat(currentTarName_.c_str(), &staTar);
     if (ret != 0) {
         HILOGE("Failed to stat file %{public}s, err = %{public}d", currentTarName_.c_str(), errno);
-        fclose(currentTarFile_);
-        currentTarFile_ = nullptr;
+        if (currentTarFile_ != nullptr) {
+            fclose(currentTarFile_);
+            currentTarFile_ = nullptr;
+        }
         throw BError(BError::Codes::EXT_BACKUP_PACKET_ERROR, "FillSplitTailBlocks Failed to stat file");
     }
 
     if (staTar.st_size == 0 && tarFileCount_ > 0 && fileCount_ == 0) {
-        fclose(currentTarFile_);
-        currentTarFile_ = nullptr;
+        if (currentTarFile_ != nullptr) {
+            fclose(currentTarFile_);
+            currentTarFile_ = nullptr;
+        }
         remove(currentTarName_.c_str());
         return true;
     }
@@ -507,8 +590,10 @@ bool TarFile::FillSplitTailBlocks()
 
     tarMap_.emplace(tarFileName_, make_tuple(currentTarName_, staTar, false));
 
-    fclose(currentTarFile_);
-    currentTarFile_ = nullptr;
+    if (currentTarFile_ != nullptr) {
+        fclose(currentTarFile_);
+        currentTarFile_ = nullptr;
+    }
     tarFileCount_++;
 
     return true;
@@ -699,6 +784,126 @@ bool TarFile::WriteLongName(string &name, char type)
     return CompleteBlock(static_cast<off_t>(sz));
 }
 
+bool TarFile::WriteDigestHeader(off_t &digestPos)
+{
+    // 记录格式为"长度 关键字=值\n", 长度包含自身的位数
+    string placeholder(BEncryption::ContentDigest::GetDigestLength(digestAlgorithm_), '0');
+    string body = " " + PAX_DIGEST_KEY + "=" + placeholder + "\n";
+    size_t recLen = body.size() + to_string(body.size()).size();
+    if (to_string(recLen).size() != to_string(body.size()).size()) {
+        recLen++;
+    }
+    string record = to_string(recLen) + body;
+
+    TarHeader tmp;
+    errno_t ret = memset_s(&tmp, sizeof(tmp), 0, sizeof(tmp));
+    if (ret != EOK) {
+        HILOGE("Failed to call memset_s, err = %{public}d", ret);
+        return false;
+    }
+    if (!WriteNormalData(tmp)) {
+        return false;
+    }
+    if (ret = memset_s(tmp.name, sizeof(tmp.name), 0, sizeof(tmp.name)), ret != EOK) {
+        HILOGE("Failed to call memset_s, err = %{public}d", ret);
+        return false;
+    }
+    strlcpy(tmp.name, PAX_HEADER_NAME.c_str(), sizeof(tmp.name));
+    string size = I2Ocs(sizeof(tmp.size), static_cast<off_t>(record.size()));
+    ret = memcpy_s(tmp.size, sizeof(tmp.size), size.c_str(), min(sizeof(tmp.size) - 1, size.length()));
+    if (ret != EOK) {
+        HILOGE("Failed to call memcpy_s, err = %{public}d", ret);
+        return false;
+    }
+    tmp.typeFlag = EXTENSION_HEADER;
+    if (ret = memset_s(tmp.chksum, sizeof(tmp.chksum), BLANK_SPACE, sizeof(tmp.chksum)), ret != EOK) {
+        HILOGE("Failed to call memset_s, err = %{public}d", ret);
+        return false;
+    }
+    strlcpy(tmp.magic, TMAGIC.c_str(), sizeof(tmp.magic));
+    strlcpy(tmp.version, VERSION.c_str(), sizeof(tmp.version));
+    SetCheckSum(tmp);
+    if (WriteTarHeader(tmp) != BLOCK_SIZE) {
+        HILOGE("Failed to write digest header");
+        return false;
+    }
+
+    digestPos = currentTarFileSize_ + static_cast<off_t>(record.size() - placeholder.size() - 1);
+    vector<uint8_t> buffer(record.begin(), record.end());
+    if (static_cast<size_t>(WriteAll(buffer, buffer.size())) != buffer.size()) {
+        HILOGE("Failed to write digest record");
+        return false;
+    }
+    return CompleteBlock(static_cast<off_t>(record.size()));
+}
+
+bool TarFile::FillDigest(off_t digestPos, const string &digest)
+{
+    if (fseeko(currentTarFile_, digestPos, SEEK_SET) != 0) {
+        HILOGE("Failed to seek to digest, err = %{public}d", errno);
+        return false;
+    }
+    bool written = fwrite(digest.data(), sizeof(char), digest.size(), currentTarFile_) == digest.size();
+    if (!written) {
+        HILOGE("Failed to fill digest, err = %{public}d", errno);
+    }
+    if (fseeko(currentTarFile_, 0, SEEK_END) != 0) {
+        HILOGE("Failed to seek to end of tar file, err = %{public}d", errno);
+        return false;
+    }
+    return written;
+}
+
+static void AppendLe(vector<uint8_t> &buffer, uint64_t value, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        buffer.push_back(static_cast<uint8_t>(value >> (i * BITS_PER_BYTE)));
+    }
+}
+
+uint64_t TarFile::IndexHash(const void *data, size_t len)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    auto bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < len; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+uint64_t TarFile::IndexNameHash(const string &name)
+{
+    size_t start = (!name.empty() && name[0] == '/') ? 1 : 0;
+    return IndexHash(name.data() + start, name.size() - start);
+}
+
+void TarFile::AddIndexEntry(const string &name, char typeFlag, off_t offset)
+{
+    tarIndex_.push_back({IndexNameHash(name), offset, currentTarFileSize_ - offset, typeFlag});
+}
+
+bool TarFile::WriteTarIndex()
+{
+    // 条目和尾部均为小端序, 尾部位于文件末尾, 解包时从末尾读取
+    vector<uint8_t> buffer;
+    buffer.reserve(tarIndex_.size() * TAR_INDEX_ENTRY_SIZE + TAR_INDEX_TRAILER_SIZE);
+    for (const auto &entry : tarIndex_) {
+        AppendLe(buffer, entry.nameHash, sizeof(uint64_t));
+        AppendLe(buffer, static_cast<uint64_t>(entry.offset), sizeof(uint64_t));
+        AppendLe(buffer, static_cast<uint64_t>(entry.length), sizeof(uint64_t));
+        buffer.push_back(static_cast<uint8_t>(entry.typeFlag));
+    }
+    uint64_t checksum = IndexHash(buffer.data(), buffer.size());
+    buffer.insert(buffer.end(), TAR_INDEX_MAGIC.begin(), TAR_INDEX_MAGIC.end());
+    AppendLe(buffer, TAR_INDEX_VERSION, sizeof(uint32_t));
+    AppendLe(buffer, tarIndex_.size(), sizeof(uint32_t));
+    AppendLe(buffer, static_cast<uint64_t>(currentTarFileSize_), sizeof(uint64_t));
+    AppendLe(buffer, checksum, sizeof(uint64_t));
+    tarIndex_.clear();
+    return static_cast<size_t>(WriteAll(buffer, buffer.size())) == buffer.size();
+}
+
 void TarFile::SetPacketMode(bool isReset)
 {
     isReset_ = isReset;
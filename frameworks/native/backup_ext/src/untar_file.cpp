@@ -15,6 +15,7 @@
 
 
 #include "b_anony/b_anony.h"
+#include "b_encryption/b_stream_cipher.h"
 #include "b_filesystem/b_dir.h"
 #include "b_utils/string_utils.h"
 #include "directory_ex.h"
@@ -22,9 +23,24 @@
 #include "securec.h"
 #include "untar_file.h"
 
+#include <cstring>
+#include <unordered_set>
+
 namespace OHOS::FileManagement::Backup {
 using namespace std;
 const int32_t OCTAL = 8;
+// 与fopen(path, "wb+")新建文件时的权限一致
+const mode_t CREATE_FILE_MODE = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
+// tar包索引项和尾部中各字段的偏移, 格式见TarFile::WriteTarIndex
+const uint32_t BITS_PER_BYTE = 8;
+const size_t ENTRY_OFFSET_POS = 8;
+const size_t ENTRY_LENGTH_POS = 16;
+const size_t ENTRY_TYPE_POS = 24;
+const size_t INDEX_VERSION_POS = 8;
+const size_t INDEX_COUNT_POS = 12;
+const size_t INDEX_OFFSET_POS = 16;
+const size_t INDEX_CHECKSUM_POS = 24;
+const string HARD_LINK_TMP_SUFFIX = ".linktmp";
 
 static bool IsEmptyBlock(const char *p)
 {
@@ -70,6 +86,16 @@ static bool ForceCreateDirectoryWithMode(const string& path, mode_t mode)
     return access(path.c_str(), F_OK) == 0;
 }
 
+// 读取小端序整数
+static uint64_t ReadLe(const uint8_t *p, size_t len)
+{
+    uint64_t value = 0;
+    for (size_t i = len; i > 0; i--) {
+        value = (value << BITS_PER_BYTE) | p[i - 1];
+    }
+    return value;
+}
+
 static void RTrimNull(std::string &s)
 {
     auto iter = std::find_if(s.rbegin(), s.rend(), [](unsigned char ch) { return ch != '\0'; });
@@ -112,6 +138,27 @@ UntarFile &UntarFile::GetInstance()
     return instance;
 }
 
+void UntarFile::SetRestorePaths(const vector<string> &restorePaths)
+{
+    restorePaths_ = restorePaths;
+}
+
+bool UntarFile::IsInRestorePaths(const vector<string> &restorePaths, const string &path)
+{
+    if (restorePaths.empty()) {
+        return true;
+    }
+    string fullPath = path;
+    RTrimNull(fullPath);
+    if (fullPath.empty()) {
+        return false;
+    }
+    if (fullPath.front() != BConstants::FILE_SEPARATOR_CHAR) {
+        fullPath = BConstants::FILE_SEPARATOR_CHAR + fullPath;
+    }
+    return BDir::IsDirsMatch(restorePaths, fullPath);
+}
+
 std::tuple<int, EndFileInfo, ErrFileInfo> UntarFile::UnPacket(
     const std::string &tarFile, const std::string &rootPath)
 {
@@ -120,11 +167,26 @@ std::tuple<int, EndFileInfo, ErrFileInfo> UntarFile::UnPacket(
         HILOGE("Failed to open tar file %{public}s, err = %{public}d", tarFile.c_str(), errno);
         return {errno, {}, {}};
     }
+    if (!WrapEncryptedTarFile()) {
+        int err = errno;
+        fclose(tarFilePtr_);
+        tarFilePtr_ = nullptr;
+        return {err, {}, {}};
+    }
 
+    // 缓存的目录描述符只在同一根目录的一次解包内有效
+    dirCache_.Clear();
+    useDirCache_ = true;
+    pendingDigest_.clear();
+    isIncremental_ = false;
+    ClearLinkState();
     auto [ret, fileInfos, errInfos] = ParseTarFile(rootPath);
     if (ret != 0) {
         HILOGE("Failed to parse tar file");
     }
+    useDirCache_ = false;
+    dirCache_.Clear();
+    ClearLinkState();
 
     fclose(tarFilePtr_);
     tarFilePtr_ = nullptr;
@@ -147,11 +209,25 @@ std::tuple<int, EndFileInfo, ErrFileInfo> UntarFile::IncrementalUnPacket(
         close(fd);
         return {errno, {}, {}};
     }
+    if (!WrapEncryptedTarFile()) {
+        int err = errno;
+        fclose(tarFilePtr_);
+        tarFilePtr_ = nullptr;
+        return {err, {}, {}};
+    }
 
+    dirCache_.Clear();
+    useDirCache_ = true;
+    pendingDigest_.clear();
+    isIncremental_ = true;
+    ClearLinkState();
     auto [ret, fileInfos, errFileInfos] = ParseIncrementalTarFile(rootPath);
     if (ret != 0) {
         HILOGE("Failed to parse tar file");
     }
+    useDirCache_ = false;
+    dirCache_.Clear();
+    ClearLinkState();
 
     fclose(tarFilePtr_);
     tarFilePtr_ = nullptr;
@@ -159,6 +235,22 @@ std::tuple<int, EndFileInfo, ErrFileInfo> UntarFile::IncrementalUnPacket(
     return {0, fileInfos, errFileInfos};
 }
 
+bool UntarFile::WrapEncryptedTarFile()
+{
+    auto provider = BEncryption::GetKeyProvider();
+    if (provider == nullptr || !BEncryption::StreamCipher::IsEncrypted(fileno(tarFilePtr_))) {
+        return true;
+    }
+    FILE *decrypted = BEncryption::StreamCipher::OpenReader(dup(fileno(tarFilePtr_)), *provider);
+    if (decrypted == nullptr) {
+        HILOGE("Failed to open encrypted tar file, err = %{public}d", errno);
+        return false;
+    }
+    fclose(tarFilePtr_);
+    tarFilePtr_ = decrypted;
+    return true;
+}
+
 std::vector<std::tuple<std::string, std::string, struct stat>> UntarFile::GetPublicFileInfos()
 {
     return publicFileInfos_;
@@ -180,6 +272,8 @@ off_t UntarFile::HandleTarBuffer(const string &buff, const string &name, FileSta
         realName = info.longName;
         info.longName.clear();
     }
+    const char *linkName = &buff[0] + TLINKNAME_BASE;
+    info.linkName.assign(linkName, strnlen(linkName, TNAME_LEN));
     if (realName.length() > 0 && realName[0] == '/') {
         info.fullPath = realName.substr(1, realName.length() - 1);
         return tarFileSize_;
@@ -217,7 +311,7 @@ int UntarFile::DealParseTarFileResult(const std::tuple<int, bool, ErrFileInfo> &
     if (!isFilter) {
         fileInfos[fileName] = fileSize;
     }
-    if (!errInfos.empty()) {
+    if (!subErrInfos.empty()) {
         errInfos.merge(subErrInfos);
     }
     return 0;
@@ -276,6 +370,7 @@ std::tuple<int, EndFileInfo, ErrFileInfo> UntarFile::ParseTarFile(const string &
         }
         off_t fileSize = HandleTarBuffer(string(buff, BLOCK_SIZE), header->name, info);
         auto result = ParseFileByTypeFlag(header->typeFlag, info);
+        ClearPendingDigest(header->typeFlag);
         if ((ret = DealParseTarFileResult(result, fileSize, info.fullPath, fileInfos, errInfos)) != 0) {
             return {ret, fileInfos, errInfos};
         }
@@ -305,38 +400,146 @@ std::tuple<int, EndFileInfo, ErrFileInfo> UntarFile::ParseIncrementalTarFile(con
 {
     // re-parse tar header
     rootPath_ = rootPath;
-    char buff[BLOCK_SIZE] = {0};
     FileStatInfo info {};
     int ret = 0;
     if ((ret = CheckAndFillTarSize()) != 0) {
         return {ret, {}, {}};
     }
+    if (!includes_.empty()) {
+        vector<TarIndexEntry> index;
+        bool hasIndex = ReadTarIndex(index);
+        if ((ret = fseeko(tarFilePtr_, 0L, SEEK_SET)) != 0) {
+            HILOGE("Failed to fseeko reback SEEK_SET, err = %{public}d", errno);
+            return {ret, {}, {}};
+        }
+        if (hasIndex) {
+            return ParseIndexedTarFile(index);
+        }
+    }
     EndFileInfo fileInfos;
     ErrFileInfo errFileInfo;
-    do {
-        readCnt_ = fread(buff, 1, BLOCK_SIZE, tarFilePtr_);
-        if (readCnt_ < BLOCK_SIZE) {
-            HILOGE("Parsing tar file completed, read data count is less then block size.");
-            return {0, fileInfos, errFileInfo};
+    while (ParseIncrementalTarBlock(info, fileInfos, errFileInfo, ret)) {
+    }
+    return {ret, fileInfos, errFileInfo};
+}
+
+bool UntarFile::ParseIncrementalTarBlock(FileStatInfo &info, EndFileInfo &fileInfos, ErrFileInfo &errFileInfo,
+    int &ret)
+{
+    char buff[BLOCK_SIZE] = {0};
+    readCnt_ = fread(buff, 1, BLOCK_SIZE, tarFilePtr_);
+    if (readCnt_ < BLOCK_SIZE) {
+        HILOGE("Parsing tar file completed, read data count is less then block size.");
+        ret = 0;
+        return false;
+    }
+    TarHeader *header = reinterpret_cast<TarHeader *>(buff);
+    bool isValid = CheckIfTarBlockValid(buff, sizeof(buff), header, ret);
+    if (!isValid) {
+        return false;
+    }
+    off_t fileSize = HandleTarBuffer(string(buff, BLOCK_SIZE), header->name, info);
+    auto result = ParseIncrementalFileByTypeFlag(header->typeFlag, info);
+    ClearPendingDigest(header->typeFlag);
+    ret = DealIncreParseTarFileResult(result, fileSize, info.fullPath, fileInfos, errFileInfo);
+    return ret == 0;
+}
+
+bool UntarFile::ReadTarIndex(vector<TarIndexEntry> &index)
+{
+    // CheckAndFillTarSize之后tarFileSize_为tar包大小
+    off_t tarSize = tarFileSize_;
+    uint8_t trailer[TAR_INDEX_TRAILER_SIZE] = {0};
+    if (tarSize < static_cast<off_t>(TAR_END_BLOCK_SIZE + TAR_INDEX_TRAILER_SIZE) ||
+        fseeko(tarFilePtr_, tarSize - TAR_INDEX_TRAILER_SIZE, SEEK_SET) != 0 ||
+        fread(trailer, 1, sizeof(trailer), tarFilePtr_) != sizeof(trailer) ||
+        memcmp(trailer, TAR_INDEX_MAGIC.data(), TAR_INDEX_MAGIC.size()) != 0) {
+        return false;
+    }
+    uint64_t version = ReadLe(trailer + INDEX_VERSION_POS, sizeof(uint32_t));
+    uint64_t count = ReadLe(trailer + INDEX_COUNT_POS, sizeof(uint32_t));
+    uint64_t indexOffset = ReadLe(trailer + INDEX_OFFSET_POS, sizeof(uint64_t));
+    uint64_t checksum = ReadLe(trailer + INDEX_CHECKSUM_POS, sizeof(uint64_t));
+    uint64_t indexLen = count * TAR_INDEX_ENTRY_SIZE;
+    // 索引紧跟在结束标记之后, 尾部位于文件末尾
+    if (version != TAR_INDEX_VERSION || indexOffset < TAR_END_BLOCK_SIZE ||
+        indexOffset > static_cast<uint64_t>(tarSize) ||
+        indexOffset + indexLen + TAR_INDEX_TRAILER_SIZE != static_cast<uint64_t>(tarSize)) {
+        HILOGE("Invalid tar index trailer");
+        return false;
+    }
+    vector<uint8_t> buffer(indexLen);
+    if (fseeko(tarFilePtr_, static_cast<off_t>(indexOffset), SEEK_SET) != 0 ||
+        fread(buffer.data(), 1, buffer.size(), tarFilePtr_) != buffer.size() ||
+        TarFile::IndexHash(buffer.data(), buffer.size()) != checksum) {
+        HILOGE("Failed to read tar index, err = %{public}d", errno);
+        return false;
+    }
+    uint64_t dataEnd = indexOffset - TAR_END_BLOCK_SIZE;
+    uint64_t prevEnd = 0;
+    index.clear();
+    index.reserve(count);
+    for (const uint8_t *p = buffer.data(); p < buffer.data() + buffer.size(); p += TAR_INDEX_ENTRY_SIZE) {
+        uint64_t offset = ReadLe(p + ENTRY_OFFSET_POS, sizeof(uint64_t));
+        uint64_t length = ReadLe(p + ENTRY_LENGTH_POS, sizeof(uint64_t));
+        if (offset % BLOCK_SIZE != 0 || offset < prevEnd || length < BLOCK_SIZE || offset > dataEnd ||
+            length > dataEnd - offset) {
+            HILOGE("Invalid tar index entry");
+            index.clear();
+            return false;
         }
-        TarHeader *header = reinterpret_cast<TarHeader *>(buff);
-        bool isValid = CheckIfTarBlockValid(buff, sizeof(buff), header, ret);
-        if (!isValid) {
-            return {ret, fileInfos, errFileInfo};
+        prevEnd = offset + length;
+        index.push_back({ReadLe(p, sizeof(uint64_t)), static_cast<off_t>(offset), static_cast<off_t>(length),
+            static_cast<char>(p[ENTRY_TYPE_POS])});
+    }
+    return true;
+}
+
+std::tuple<int, EndFileInfo, ErrFileInfo> UntarFile::ParseIndexedTarFile(const vector<TarIndexEntry> &index)
+{
+    unordered_set<uint64_t> includeHashes;
+    for (const auto &include : includes_) {
+        includeHashes.insert(TarFile::IndexNameHash(include.first));
+    }
+    EndFileInfo fileInfos;
+    ErrFileInfo errFileInfo;
+    int ret = 0;
+    size_t parsedCnt = 0;
+    for (const auto &entry : index) {
+        // 目录不受includes限制, 与顺序解析时一致; 哈希冲突的文件在解析文件头时按名称过滤
+        if (entry.typeFlag != DIRTYPE && includeHashes.find(entry.nameHash) == includeHashes.end()) {
+            if (entry.typeFlag == REGTYPE || entry.typeFlag == AREGTYPE) {
+                skippedIndexEntries_.emplace(entry.nameHash, SkippedTarEntry {entry.offset, entry.length, false});
+            }
+            continue;
         }
-        off_t fileSize = HandleTarBuffer(string(buff, BLOCK_SIZE), header->name, info);
-        auto result = ParseIncrementalFileByTypeFlag(header->typeFlag, info);
-        ret = DealIncreParseTarFileResult(result, fileSize, info.fullPath, fileInfos, errFileInfo);
-        if (ret != 0) {
-            return {ret, fileInfos, errFileInfo};
+        if (fseeko(tarFilePtr_, entry.offset, SEEK_SET) != 0) {
+            HILOGE("Failed to fseeko to tar index entry, err = %{public}d", errno);
+            return {ERR_FSEEKO, fileInfos, errFileInfo};
         }
-    } while (readCnt_ >= BLOCK_SIZE);
-
+        FileStatInfo info {};
+        pendingDigest_.clear();
+        off_t entryEnd = entry.offset + entry.length;
+        while (ftello(tarFilePtr_) < entryEnd) {
+            if (!ParseIncrementalTarBlock(info, fileInfos, errFileInfo, ret)) {
+                HILOGE("Tar index does not match tar content, ret = %{public}d", ret);
+                return {ret == 0 ? ERR_INVALID_TAR : ret, fileInfos, errFileInfo};
+            }
+        }
+        parsedCnt++;
+    }
+    HILOGI("Parsed %{public}zu of %{public}zu entries by tar index", parsedCnt, index.size());
     return {ret, fileInfos, errFileInfo};
 }
 
 void UntarFile::MatchAregType(bool &isRightRes, FileStatInfo &info, ErrFileInfo &errFileInfo, bool &isFilter)
 {
+    if (!IsForcedTarget(info.fullPath) && !IsInRestorePaths(restorePaths_, info.fullPath)) {
+        RecordSkippedFile(info);
+        MatchDefault(isRightRes, info);
+        return;
+    }
+    string name = info.fullPath;
     info.fullPath = GenRealPath(rootPath_, info.fullPath);
     if (!BDir::IsFilePathValid(info.fullPath)) {
         HILOGE("Check file path : %{public}s err, path is forbidden", GetAnonyPath(info.fullPath).c_str());
@@ -344,11 +547,17 @@ void UntarFile::MatchAregType(bool &isRightRes, FileStatInfo &info, ErrFileInfo
         return;
     }
     errFileInfo = ParseRegularFile(info);
+    if (errFileInfo.find(info.fullPath) == errFileInfo.end()) {
+        extractedFiles_.insert(name);
+    }
     isFilter = false;
 }
 
 void UntarFile::MatchDirType(bool &isRightRes, FileStatInfo &info, ErrFileInfo &errFileInfo, bool &isFilter)
 {
+    if (!IsInRestorePaths(restorePaths_, info.fullPath)) {
+        return;
+    }
     info.fullPath = GenRealPath(rootPath_, info.fullPath);
     if (!BDir::IsFilePathValid(info.fullPath)) {
         HILOGE("Check file path : %{public}s err, path is forbidden", GetAnonyPath(info.fullPath).c_str());
@@ -359,6 +568,123 @@ void UntarFile::MatchDirType(bool &isRightRes, FileStatInfo &info, ErrFileInfo &
     isFilter = false;
 }
 
+bool UntarFile::CreateHardLink(FileStatInfo &info, ErrFileInfo &errFileInfo)
+{
+    string targetName = info.linkName;
+    RTrimNull(targetName);
+    if (!targetName.empty() && targetName[0] == BConstants::FILE_SEPARATOR_CHAR) {
+        targetName.erase(0, 1);
+    }
+    info.fullPath = GenRealPath(rootPath_, info.fullPath);
+    string target = GenRealPath(rootPath_, targetName);
+    if (!BDir::IsFilePathValid(info.fullPath) || !BDir::IsFilePathValid(target) || target.empty()) {
+        HILOGE("Check link path : %{public}s or target : %{public}s err, path is forbidden",
+            GetAnonyPath(info.fullPath).c_str(), GetAnonyPath(target).c_str());
+        return false;
+    }
+    // 只链接到本次解包写入的文件, 否则目标内容不可信, 保留目的路径上已有的文件
+    if (extractedFiles_.find(targetName) == extractedFiles_.end() && !ExtractLinkTarget(targetName, errFileInfo)) {
+        HILOGE("Link target of %{public}s is not restored", GetAnonyPath(info.fullPath).c_str());
+        errFileInfo[info.fullPath].emplace_back(ENOENT);
+        return true;
+    }
+    size_t pos = info.fullPath.rfind('/');
+    if (pos != string::npos) {
+        ForceCreateDirectory(info.fullPath.substr(0, pos));
+    }
+    // 先链接到临时文件再替换, 失败时不影响目的路径上已有的文件
+    string tmpPath = info.fullPath + HARD_LINK_TMP_SUFFIX;
+    unlink(tmpPath.c_str());
+    if (link(target.c_str(), tmpPath.c_str()) != 0) {
+        HILOGE("Failed to link %{public}s, err = %{public}d", GetAnonyPath(info.fullPath).c_str(), errno);
+        errFileInfo[info.fullPath].emplace_back(errno);
+        return true;
+    }
+    if (rename(tmpPath.c_str(), info.fullPath.c_str()) != 0) {
+        HILOGE("Failed to rename link %{public}s, err = %{public}d", GetAnonyPath(info.fullPath).c_str(), errno);
+        errFileInfo[info.fullPath].emplace_back(errno);
+        unlink(tmpPath.c_str());
+    }
+    return true;
+}
+
+bool UntarFile::ExtractLinkTarget(const string &name, ErrFileInfo &errFileInfo)
+{
+    vector<SkippedTarEntry> entries;
+    auto it = skippedFiles_.find(name);
+    if (it != skippedFiles_.end()) {
+        entries.emplace_back(it->second);
+    }
+    auto range = skippedIndexEntries_.equal_range(TarFile::IndexNameHash(name));
+    for (auto iter = range.first; iter != range.second; ++iter) {
+        entries.emplace_back(iter->second);
+    }
+    if (entries.empty()) {
+        return false;
+    }
+    // 目标总在链接之前, 解包完成后回到链接之后继续顺序解析
+    off_t resumeOffset = ftello(tarFilePtr_);
+    off_t savedPos = pos_;
+    off_t savedSize = tarFileSize_;
+    off_t savedBlockCnt = tarFileBlockCnt_;
+    string savedDigest = move(pendingDigest_);
+    forcedTarget_ = name;
+    for (const auto &entry : entries) {
+        if (extractedFiles_.find(name) != extractedFiles_.end() ||
+            fseeko(tarFilePtr_, entry.offset, SEEK_SET) != 0) {
+            break;
+        }
+        FileStatInfo info {};
+        info.longName = entry.needName ? name : "";
+        pendingDigest_.clear();
+        char buff[BLOCK_SIZE] = {0};
+        while (ftello(tarFilePtr_) < entry.offset + entry.length &&
+            fread(buff, 1, BLOCK_SIZE, tarFilePtr_) == BLOCK_SIZE) {
+            TarHeader *header = reinterpret_cast<TarHeader *>(buff);
+            if (!IsValidTarBlock(*header)) {
+                break;
+            }
+            HandleTarBuffer(string(buff, BLOCK_SIZE), header->name, info);
+            auto [ret, isFilter, subErrInfo] = isIncremental_ ? ParseIncrementalFileByTypeFlag(header->typeFlag, info)
+                                                              : ParseFileByTypeFlag(header->typeFlag, info);
+            ClearPendingDigest(header->typeFlag);
+            errFileInfo.merge(subErrInfo);
+            if (ret != 0) {
+                break;
+            }
+        }
+    }
+    forcedTarget_.clear();
+    pendingDigest_ = move(savedDigest);
+    pos_ = savedPos;
+    tarFileSize_ = savedSize;
+    tarFileBlockCnt_ = savedBlockCnt;
+    if (fseeko(tarFilePtr_, resumeOffset, SEEK_SET) != 0) {
+        HILOGE("Failed to fseeko back after link target, err = %{public}d", errno);
+    }
+    return extractedFiles_.find(name) != extractedFiles_.end();
+}
+
+void UntarFile::RecordSkippedFile(const FileStatInfo &info)
+{
+    string name = info.fullPath;
+    RTrimNull(name);
+    skippedFiles_[name] = SkippedTarEntry {pos_ - BLOCK_SIZE, BLOCK_SIZE, true};
+}
+
+bool UntarFile::IsForcedTarget(const string &name) const
+{
+    return !forcedTarget_.empty() && name == forcedTarget_;
+}
+
+void UntarFile::ClearLinkState()
+{
+    extractedFiles_.clear();
+    skippedFiles_.clear();
+    skippedIndexEntries_.clear();
+    forcedTarget_.clear();
+}
+
 void UntarFile::MatchGnuTypeLongName(bool &isRightRes, FileStatInfo &info, ErrFileInfo &errFileInfo, bool &isFilter)
 {
     auto result = ReadLongName(info);
@@ -405,6 +731,13 @@ tuple<int, bool, ErrFileInfo> UntarFile::ParseFileByTypeFlag(char typeFlag, File
             break;
         case SYMTYPE:
             break;
+        case LNKTYPE:
+            // 硬链接计入恢复的文件, 内容与目标共享, 文件头中的大小为0
+            if (IsInRestorePaths(restorePaths_, info.fullPath)) {
+                isRightRes = CreateHardLink(info, errFileInfo);
+                isFilter = false;
+            }
+            break;
         case DIRTYPE:
             MatchDirType(isRightRes, info, errFileInfo, isFilter);
             break;
@@ -426,7 +759,9 @@ tuple<int, bool, ErrFileInfo> UntarFile::ParseFileByTypeFlag(char typeFlag, File
 bool UntarFile::DealFileTag(ErrFileInfo &errFileInfo,
     FileStatInfo &info, bool &isFilter, const std::string &tmpFullPath)
 {
-    if (!includes_.empty() && includes_.find(tmpFullPath) == includes_.end()) { // not in includes
+    bool notIncluded = !includes_.empty() && includes_.find(tmpFullPath) == includes_.end();
+    if (!IsForcedTarget(tmpFullPath) && (notIncluded || !IsInRestorePaths(restorePaths_, tmpFullPath))) {
+        RecordSkippedFile(info);
         if (fseeko(tarFilePtr_, pos_ + tarFileBlockCnt_ * BLOCK_SIZE, SEEK_SET) != 0) {
             HILOGE("Failed to fseeko of %{private}s, err = %{public}d", info.fullPath.c_str(), errno);
             errFileInfo[info.fullPath].emplace_back(ERR_FSEEKO);
@@ -447,6 +782,9 @@ bool UntarFile::DealFileTag(ErrFileInfo &errFileInfo,
         errFileInfo[info.fullPath][0] == ERR_INVALID_TAR) {
         return false;
     }
+    if (errFileInfo.find(info.fullPath) == errFileInfo.end()) {
+        extractedFiles_.insert(tmpFullPath);
+    }
     if (StringUtils::IsPublicFilePath(targetFullPath)) {
         struct stat sta;
         if (stat(info.fullPath.c_str(), &sta) == 0) {
@@ -470,7 +808,21 @@ std::tuple<int, bool, ErrFileInfo> UntarFile::MatchIncrementalScenario(bool isFi
         }
         case SYMTYPE:
             break;
+        case LNKTYPE: {
+            bool notIncluded = !includes_.empty() && includes_.find(tmpFullPath) == includes_.end();
+            if (notIncluded || !IsInRestorePaths(restorePaths_, tmpFullPath)) {
+                break;
+            }
+            if (!CreateHardLink(info, errFileInfo)) {
+                return {DEFAULT_ERR, true, {{info.fullPath, {ERR_INVALID_PATH}}}};
+            }
+            isFilter = false;
+            break;
+        }
         case DIRTYPE:
+            if (!IsInRestorePaths(restorePaths_, tmpFullPath)) {
+                break;
+            }
             info.fullPath = GenRealPath(rootPath_, info.fullPath);
             if (!BDir::IsFilePathValid(info.fullPath)) {
                 HILOGE("Check file path : %{public}s err, path is forbidden", GetAnonyPath(info.fullPath).c_str());
@@ -521,6 +873,12 @@ std::tuple<int, bool, ErrFileInfo> UntarFile::ParseIncrementalFileByTypeFlag(cha
 ErrFileInfo UntarFile::ParseRegularFile(FileStatInfo &info)
 {
     ErrFileInfo errFileInfo;
+    string expectedDigest = move(pendingDigest_);
+    pendingDigest_.clear();
+    auto algorithm = BEncryption::ContentDigest::ParseAlgorithm(expectedDigest);
+    // 无法识别的摘要算法不做校验, 兼容更新版本打出的包
+    fileDigest_ = algorithm == BEncryption::DigestAlgorithm::NONE ?
+        nullptr : make_unique<BEncryption::ContentDigest>(algorithm);
     FILE *destFile = CreateFile(info.fullPath);
     if (destFile != nullptr) {
         if (!UnTarFileInner(destFile)) {
@@ -528,8 +886,14 @@ ErrFileInfo UntarFile::ParseRegularFile(FileStatInfo &info)
             HILOGE("UnTarFileInner fail path:%{public}s", GetAnonyPath(info.fullPath).c_str());
             // 报错说明tar包有问题，直接fseeko跳转结束流程
             fseeko(tarFilePtr_, pos_ + tarFileBlockCnt_ * BLOCK_SIZE, SEEK_SET);
+            fileDigest_ = nullptr;
             return errFileInfo;
         }
+        if (fileDigest_ != nullptr && fileDigest_->Final() != expectedDigest) {
+            HILOGE("Content digest mismatch, path:%{public}s", GetAnonyPath(info.fullPath).c_str());
+            errFileInfo[info.fullPath].emplace_back(ERR_DIGEST_MISMATCH);
+        }
+        fileDigest_ = nullptr;
         if (chmod(info.fullPath.data(), info.mode) != 0) {
             HILOGE("Failed to chmod of %{public}s, err = %{public}d", GetAnonyPath(info.fullPath).c_str(), errno);
             errFileInfo[info.fullPath].emplace_back(errno);
@@ -578,6 +942,9 @@ bool UntarFile::UnTarFileInner(FILE *destFile)
         if (readSize != readBuffSize) {
             readBuffSize = readSize;
         }
+        if (fileDigest_ != nullptr) {
+            fileDigest_->Update(destStr.data(), readBuffSize);
+        }
         writeSize = 0;
         size_t fwriteSize = 0;
         do {
@@ -649,6 +1016,10 @@ ErrFileInfo UntarFile::CreateDir(string &path, mode_t mode)
     if (path[len - 1] == '/') {
         path[len - 1] = '\0';
     }
+    if (useDirCache_ && dirCache_.EnsureDir(path.c_str(), mode)) {
+        return errFileInfo;
+    }
+    // 未在解包过程中或目录缓存无法处理时(如描述符不足)按路径逐级创建
     if (access(path.c_str(), F_OK) != 0) {
         HILOGD("directory does not exist, path:%{public}s, err = %{public}d", GetAnonyPath(path).c_str(), errno);
         if (!ForceCreateDirectoryWithMode(path, mode)) {
@@ -662,6 +1033,21 @@ ErrFileInfo UntarFile::CreateDir(string &path, mode_t mode)
 FILE *UntarFile::CreateFile(string &filePath)
 {
     FILE *f = nullptr;
+    UniqueFd fd(-1);
+    if (useDirCache_) {
+        fd = dirCache_.OpenFile(filePath, O_RDWR | O_CREAT | O_TRUNC, CREATE_FILE_MODE);
+    }
+    if (fd >= 0) {
+        f = fdopen(fd.Get(), "wb+");
+        if (f == nullptr) {
+            HILOGE("Failed to fdopen file %{public}s, err = %{public}d", GetAnonyPath(filePath).c_str(), errno);
+            return nullptr;
+        }
+        fd.Release();
+        return f;
+    }
+
+    // 未在解包过程中或目录缓存无法处理时(如描述符不足)按路径创建
     char rpath[PATH_MAX] = {0};
     if (realpath(filePath.c_str(), rpath)) {
         f = fopen(filePath.c_str(), "wb+");
@@ -732,6 +1118,8 @@ std::tuple<int, std::string> UntarFile::ParsePaxBlock()
         if (key == "path") {
             longName = value;
             err = ERR_OK;
+        } else if (key == PAX_DIGEST_KEY) {
+            SetPendingDigest(value);
         }
         pos += recLen;
     }
@@ -793,10 +1181,27 @@ std::tuple<int, std::string> UntarFile::GetLongName(uint32_t recLen, uint32_t al
         if (key == "path") {
             longName = value;
             err = ERR_OK;
+        } else if (key == PAX_DIGEST_KEY) {
+            SetPendingDigest(value);
         }
         pos += recLen;
     }
     delete[] block;
     return {err, longName};
 }
+
+void UntarFile::SetPendingDigest(std::string digest)
+{
+    if (!digest.empty() && digest.back() == '\n') {
+        digest.pop_back();
+    }
+    pendingDigest_ = move(digest);
+}
+
+void UntarFile::ClearPendingDigest(char typeFlag)
+{
+    if (typeFlag != EXTENSION_HEADER && typeFlag != GNUTYPE_LONGNAME) {
+        pendingDigest_.clear();
+    }
+}
 } // namespace OHOS::FileManagement::Backup
\ No newline at end of file
@@ -16,6 +16,7 @@
 #ifndef OHOS_FILEMGMT_BACKUP_SERVICE_REVERSE_H
 #define OHOS_FILEMGMT_BACKUP_SERVICE_REVERSE_H
 
+#include <string_view>
 #include <vector>
 
 #include "b_session_backup.h"
@@ -119,12 +120,12 @@ private:
     void FlushPendingFiles();
     void FlushPendingIncrementalFiles();
     void AddFileToBatch(const std::string &bundleName,
-                        const std::vector<std::string> &fileNames,
+                        const std::vector<std::string_view> &fileNames,
                         const std::vector<int> &fds,
                         const std::vector<int> &manifestFds,
                         const std::vector<int32_t> &errCodes);
     void AddIncrementalFileToBatch(const std::string &bundleName,
-                                   const std::vector<std::string> &fileNames,
+                                   const std::vector<std::string_view> &fileNames,
                                    const std::vector<FileOpenResult> &openResults);
 
     Scenario scenario_ {Scenario::UNDEFINED};
@@ -149,7 +149,11 @@ ErrCode BIncrementalRestoreSession::GetFileHandles(const string &bundleName, con
     HILOGI("Begin getFileHandles, bundle:%{public}s, fileNameSize:%{public}zu", bundleName.c_str(),
         fileNames.size());
     BStringRawData fileNamesRD;
-    fileNamesRD.Marshalling(StringUtils::StringVectorSerialize(fileNames));
+    if (!StringUtils::StringVectorSerialize(fileNames, fileNamesRD.BeginMarshalling()) ||
+        fileNamesRD.EndMarshalling() != 0) {
+        HILOGE("Failed to marshalling file names, bundle:%{public}s", bundleName.c_str());
+        return BError(BError::Codes::SDK_INVAL_ARG, "File names are too large").GetCode();
+    }
     return proxy->GetIncrementalFileHandles(bundleName, fileNamesRD);
 }
 
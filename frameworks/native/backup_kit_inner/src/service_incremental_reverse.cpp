@@ -38,7 +38,7 @@ void ServiceReverse::FlushPendingIncrementalFiles()
 }
  
 void ServiceReverse::AddIncrementalFileToBatch(const std::string &bundleName,
-                                               const std::vector<std::string> &fileNames,
+                                               const std::vector<std::string_view> &fileNames,
                                                const std::vector<FileOpenResult> &openResults)
 {
     bool needFlush = false;
@@ -237,9 +237,12 @@ ErrCode ServiceReverse::IncrementalRestoreOnFileReadys(const std::string &bundle
         HILOGE("Error scenario or callback is nullptr, scenario = %{public}d", scenario_);
         return BError(BError::Codes::OK);
     }
-    std::string serializedData;
-    fileNamesRD.Unmarshalling(serializedData);
-    auto fileNames = StringUtils::StringVectorDeserialize(serializedData);
+    std::string_view serializedData;
+    std::vector<std::string_view> fileNames;
+    if (fileNamesRD.Unmarshalling(serializedData) != 0 || !StringUtils::StringVectorViews(serializedData, fileNames)) {
+        HILOGE("Failed to unmarshalling file names, bundle:%{public}s", bundleName.c_str());
+        return BError(BError::Codes::SDK_INVAL_ARG);
+    }
     AddIncrementalFileToBatch(bundleName, fileNames, openResults);
     return BError(BError::Codes::OK);
 }
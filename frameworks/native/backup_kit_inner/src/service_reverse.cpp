@@ -36,7 +36,7 @@ void ServiceReverse::FlushPendingFiles()
 }
  
 void ServiceReverse::AddFileToBatch(const std::string &bundleName,
-                                    const std::vector<std::string> &fileNames,
+                                    const std::vector<std::string_view> &fileNames,
                                     const std::vector<int> &fds,
                                     const std::vector<int> &manifestFds,
                                     const std::vector<int32_t> &errCodes)
@@ -226,9 +226,12 @@ ErrCode ServiceReverse::BackupOnFileReadys(const std::string &bundleName,
         HILOGE("Error scenario or callback is nullptr, scenario = %{public}d", scenario_);
         return BError(BError::Codes::OK);
     }
-    std::string serializedData;
-    fileNamesRD.Unmarshalling(serializedData);
-    auto fileNames = StringUtils::StringVectorDeserialize(serializedData);
+    std::string_view serializedData;
+    std::vector<std::string_view> fileNames;
+    if (fileNamesRD.Unmarshalling(serializedData) != 0 || !StringUtils::StringVectorViews(serializedData, fileNames)) {
+        HILOGE("Failed to unmarshalling file names, bundle:%{public}s", bundleName.c_str());
+        return BError(BError::Codes::SDK_INVAL_ARG);
+    }
     std::vector<int> manifestFds(fileNames.size(), INVALID_FD);
     AddFileToBatch(bundleName, fileNames, fds, manifestFds, errCodes);
     return BError(BError::Codes::OK);
@@ -242,9 +245,12 @@ ErrCode ServiceReverse::BackupOnFileReadysWithoutFd(const std::string &bundleNam
         HILOGE("Error scenario or callback is nullptr, scenario = %{public}d", scenario_);
         return BError(BError::Codes::OK);
     }
-    std::string serializedData;
-    fileNamesRD.Unmarshalling(serializedData);
-    auto fileNames = StringUtils::StringVectorDeserialize(serializedData);
+    std::string_view serializedData;
+    std::vector<std::string_view> fileNames;
+    if (fileNamesRD.Unmarshalling(serializedData) != 0 || !StringUtils::StringVectorViews(serializedData, fileNames)) {
+        HILOGE("Failed to unmarshalling file names, bundle:%{public}s", bundleName.c_str());
+        return BError(BError::Codes::SDK_INVAL_ARG);
+    }
     std::vector<int> fds(fileNames.size(), INVALID_FD);
     std::vector<int> manifestFds(fileNames.size(), INVALID_FD);
     AddFileToBatch(bundleName, fileNames, fds, manifestFds, errCodes);
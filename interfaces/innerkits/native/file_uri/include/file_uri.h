@@ -17,6 +17,7 @@
 #define APP_FILE_SERVICE_FILE_URI_FILE_URI_H
 
 #include <string>
+#include <vector>
 
 #include "uri.h"
 namespace OHOS {
@@ -33,10 +34,22 @@ public:
     bool IsRemoteUri();
 
     bool CheckUriFormat(const std::string &uri);
+
+    /**
+     * @brief Convert a batch of uris to real paths, resolving the caller's bundle name and user name only once
+     *
+     * @param uris uri strings or paths, same as the constructor accepts
+     * @return real paths in the same order as uris, each one the same as GetRealPath() of that uri
+     */
+    static std::vector<std::string> GetRealPaths(const std::vector<std::string> &uris);
+
     explicit FileUri(const std::string &uriOrPath);
     ~FileUri() = default;
 
     Uri uri_;
+
+private:
+    std::string GetRealPath(const std::string &selfBundleName);
 };
 }  // ModuleFileUri
 }  // namespace AppFileService
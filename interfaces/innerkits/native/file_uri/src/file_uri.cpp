@@ -51,6 +51,8 @@ const int DECODE_FORMAT_NUM = 16;
 const int32_t DECODE_LEN = 2;
 std::string BUNDLE_NAME = "";
 std::mutex g_globalMutex;
+std::once_flag g_userNameFlag;
+std::string g_userName;
 static string GetNextDirName(string &path)
 {
     if (path.find(BACKSLASH) == 0) {
@@ -65,15 +67,26 @@ static string GetNextDirName(string &path)
     return dirname;
 }
 
-static std::string GetUserName()
+static const std::string &GetUserName()
 {
-    std::string userName;
-    ErrCode errCode = OHOS::AccountSA::OsAccountManager::GetOsAccountShortName(userName);
-    if (errCode != ERR_OK || userName.empty()) {
-        LOGD("Reserved for multi-user adaptation");
+    std::call_once(g_userNameFlag, [] {
+        std::string userName;
+        ErrCode errCode = OHOS::AccountSA::OsAccountManager::GetOsAccountShortName(userName);
+        if (errCode != ERR_OK || userName.empty()) {
+            LOGD("Reserved for multi-user adaptation");
+        }
+        g_userName = DEFAULT_USERNAME;
+    });
+    return g_userName;
+}
+
+static std::string GetSelfBundleName()
+{
+    std::lock_guard<std::mutex> lock(g_globalMutex);
+    if (BUNDLE_NAME.empty()) {
+        BUNDLE_NAME = CommonFunc::GetSelfBundleName();
     }
-    userName = DEFAULT_USERNAME;
-    return userName;
+    return BUNDLE_NAME;
 }
 
 string FileUri::GetName()
@@ -114,7 +127,7 @@ static string DecodeBySA(const string &uri)
     return outPutStr;
 }
 
-string GetOpenPath(string &path, string bundleName)
+string GetOpenPath(string &path, const string &bundleName)
 {
     if (path.find(FILE_HAP_URI_HEAD) == 0) {
         path = path.substr(FILE_HAP_URI_HEAD.size());
@@ -152,11 +165,18 @@ string FileUri::GetPath()
 
 string FileUri::GetRealPath()
 {
-    LOGD("GetRealPath uri is ,%{private}s", uri_.ToString().c_str());
+    return GetRealPath(GetSelfBundleName());
+}
+
+string FileUri::GetRealPath(const std::string &selfBundleName)
+{
+    string uriStr = uri_.ToString();
+    LOGD("GetRealPath uri is ,%{private}s", uriStr.c_str());
     string sandboxPath = SandboxHelper::Decode(uri_.GetPath());
     string realPath = sandboxPath;
     string bundleName = uri_.GetAuthority();
-    if (bundleName == FILE_MANAGER_AUTHORITY && uri_.ToString().find(NETWORK_PARA) == string::npos) {
+    bool isRemote = uriStr.find(NETWORK_PARA) != string::npos;
+    if (bundleName == FILE_MANAGER_AUTHORITY && !isRemote) {
         LOGD("GetRealPath return path is ,%{private}s", realPath.c_str());
         return realPath;
     }
@@ -167,9 +187,9 @@ string FileUri::GetRealPath()
         realPath = MEDIA_FUSE_PATH_HEAD + bundleName + sandboxPath;
         return realPath;
     }
-    if (bundleName == FILE_MANAGER_AUTHORITY && uri_.ToString().find(NETWORK_PARA) != string::npos) {
+    if (bundleName == FILE_MANAGER_AUTHORITY && isRemote) {
         string networkId = "";
-        SandboxHelper::GetNetworkIdFromUri(uri_.ToString(), networkId);
+        SandboxHelper::GetNetworkIdFromUri(uriStr, networkId);
         if (!networkId.empty()) {
             realPath = PATH_SHARE + MODE_RW + networkId + BACKSLASH + bundleName + sandboxPath;
         } else {
@@ -185,19 +205,25 @@ string FileUri::GetRealPath()
         LOGD("GetRealPath return path is ,%{private}s", realPath.c_str());
         return realPath;
     }
-    {
-        std::lock_guard<std::mutex> lock(g_globalMutex);
-        if (BUNDLE_NAME.empty()) {
-            BUNDLE_NAME = CommonFunc::GetSelfBundleName();
-        }
-    }
-    if ((!bundleName.empty()) && (bundleName != BUNDLE_NAME)) {
+    if ((!bundleName.empty()) && (bundleName != selfBundleName)) {
         realPath = GetOpenPath(realPath, bundleName);
     }
     LOGD("GetRealPath return path is ,%{private}s", realPath.c_str());
     return realPath;
 }
 
+vector<string> FileUri::GetRealPaths(const vector<string> &uris)
+{
+    vector<string> realPaths;
+    realPaths.reserve(uris.size());
+    const string selfBundleName = GetSelfBundleName();
+    for (const auto &uri : uris) {
+        FileUri fileUri(uri);
+        realPaths.emplace_back(fileUri.GetRealPath(selfBundleName));
+    }
+    return realPaths;
+}
+
 string FileUri::GetRealPathBySA(const std::string &targeBundleName)
 {
     string sandboxPath = DecodeBySA(uri_.GetPath());
@@ -22,6 +22,13 @@
 namespace OHOS::FileManagement::Backup {
 using namespace std;
 
+namespace {
+// 待回调事件的上限, 超过后阻塞native线程
+constexpr size_t COALESCE_CAPACITY = 256;
+// 一次JS线程任务中最多回调的事件个数, 避免长时间占用JS线程
+constexpr size_t COALESCE_MAX_BATCH = 32;
+} // namespace
+
 void GeneralCallbacks::RemoveCallbackRef()
 {
     HILOGI("Called RemoveCallbackRef");
@@ -171,4 +178,72 @@ void BackupRestoreCallback::CallJsMethod(InputArgsParser argParser)
     workArgs->callbackCondition.wait(lock, [workArgs]() { return workArgs->isReady.load(); });
     HILOGI("call BackupRestoreCallback CallJsMethod end.");
 }
+
+void BackupRestoreCallback::CallJsMethodInJsThread(InputArgsParser argParser)
+{
+    DoCallJsMethod(env_, ctx_, argParser);
+}
+
+CoalescedCallback::CoalescedCallback(napi_env env, LibN::NVal thisPtr, LibN::NVal cb)
+    : env_(env), callback_(make_shared<BackupRestoreCallback>(env, thisPtr, cb))
+{
+    auto scheduler = [env](function<void()> task) -> bool {
+        auto data = make_unique<function<void()>>(move(task));
+        auto run = [](void *ptr) -> void {
+            unique_ptr<function<void()>> task(static_cast<function<void()> *>(ptr));
+            if (task != nullptr && *task) {
+                (*task)();
+            }
+        };
+        uint64_t handleId = 0;
+        auto ret = napi_send_cancelable_event(env, run, data.get(), napi_eprio_high, &handleId, "coalesced");
+        if (ret != napi_status::napi_ok) {
+            HILOGE("failed to napi_send_cancelable_event, ret:%{public}d, name:%{public}s.", ret, "coalesced");
+            return false;
+        }
+        data.release();
+        return true;
+    };
+    auto consumer = [callback {callback_}](vector<CBComplete> &batch) {
+        HILOGD("Call js method for %{public}zu events", batch.size());
+        for (auto &cbCompl : batch) {
+            callback->CallJsMethodInJsThread([&cbCompl](napi_env env, vector<napi_value> &argv) -> bool {
+                LibN::NVal res = cbCompl(env, LibN::NError(LibN::ERRNO_NOERR));
+                if (res.TypeIsError(true)) {
+                    argv = {res.val_};
+                } else {
+                    argv = {LibN::NVal::CreateUndefined(env).val_, res.val_};
+                }
+                return true;
+            });
+            // 尽早释放事件持有的资源(如文件描述符)
+            cbCompl = nullptr;
+        }
+    };
+    coalescer_ = make_shared<CallbackCoalescer<CBComplete>>(COALESCE_CAPACITY, COALESCE_MAX_BATCH, scheduler,
+        consumer);
+}
+
+CoalescedCallback::~CoalescedCallback()
+{
+    coalescer_->Close();
+}
+
+void CoalescedCallback::ThreadSafeSchedule(CBComplete cbCompl)
+{
+    if (!coalescer_->Push(move(cbCompl))) {
+        HILOGE("Failed to schedule js callback, the callback has been closed");
+    }
+}
+
+CoalescedCallback::operator bool() const
+{
+    return bool(*callback_);
+}
+
+void CoalescedCallback::CleanRef()
+{
+    coalescer_->Close();
+    callback_->CleanRef();
+}
 } // namespace OHOS::FileManagement::Backup
\ No newline at end of file
@@ -19,6 +19,7 @@
 #include <node_api.h>
 #include <string>
 
+#include "b_utils/callback_coalescer.h"
 #include "filemgmt_libn.h"
 
 namespace OHOS::FileManagement::Backup {
@@ -29,6 +30,8 @@ public:
     BackupRestoreCallback(napi_env env, LibN::NVal thisPtr, LibN::NVal cb);
     ~BackupRestoreCallback();
     void CallJsMethod(InputArgsParser argParser);
+    // 只能在JS线程调用, 直接执行JS回调
+    void CallJsMethodInJsThread(InputArgsParser argParser);
     explicit operator bool() const;
     void CleanRef();
 private:
@@ -36,6 +39,27 @@ private:
     LibN::NAsyncContextCallback *ctx_ = nullptr;
 };
 
+/**
+ * @brief 合并native线程的高频事件, 在一次JS线程任务中依次回调多个事件
+ *
+ * 接口与NAsyncWorkCallback一致: cbCompl返回错误对象时以(err)回调, 否则以(undefined, obj)回调.
+ * 队列满时ThreadSafeSchedule阻塞调用线程, 不能在JS线程调用.
+ */
+class CoalescedCallback {
+public:
+    using CBComplete = std::function<LibN::NVal(napi_env, LibN::NError)>;
+
+    CoalescedCallback(napi_env env, LibN::NVal thisPtr, LibN::NVal cb);
+    ~CoalescedCallback();
+    void ThreadSafeSchedule(CBComplete cbCompl);
+    explicit operator bool() const;
+    void CleanRef();
+private:
+    napi_env env_;
+    std::shared_ptr<BackupRestoreCallback> callback_;
+    std::shared_ptr<CallbackCoalescer<CBComplete>> coalescer_;
+};
+
 struct WorkArgs {
     std::mutex callbackMutex;
     std::condition_variable callbackCondition;
@@ -60,8 +84,8 @@ public:
 public:
     void RemoveCallbackRef();
 public:
-    LibN::NAsyncWorkCallback onFileReady;
-    LibN::NAsyncWorkCallback onFileReadyBatch;
+    CoalescedCallback onFileReady;
+    CoalescedCallback onFileReadyBatch;
     LibN::NAsyncWorkCallback onBundleBegin;
     LibN::NAsyncWorkCallback onBundleEnd;
     LibN::NAsyncWorkCallback onAllBundlesEnd;
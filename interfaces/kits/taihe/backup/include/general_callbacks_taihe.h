@@ -20,6 +20,7 @@
 #include <string>
 #include "backup_file_info.h"
 #include "b_error/b_error.h"
+#include "b_utils/callback_coalescer.h"
 #include "filemgmt_libn.h"
 #include "taihe/runtime.hpp"
 #include "unique_fd.h"
@@ -29,8 +30,8 @@ using  BFileInfo = OHOS::FileManagement::Backup::BFileInfo;
 namespace OHOS::FileManagement::Backup::TAIHE {
 class TaiheGeneralCallbacks {
 public:
-    TaiheGeneralCallbacks(ani_ref* ref, ani_vm* vm):ref_(ref), vm_(vm) {};
-    ~TaiheGeneralCallbacks() {};
+    TaiheGeneralCallbacks(ani_ref* ref, ani_vm* vm);
+    ~TaiheGeneralCallbacks();
     void onFileReady(const BFileInfo &, UniqueFd, ErrCode);  // 当备份服务有文件待发送时执行的回调
     void onBundleStarted(ErrCode, const BundleName);  // 当启动某个应用的备份流程结束时执行的回调函数
     void onBundleFinished(ErrCode, const BundleName); // 当某个应用的备份流程结束或意外中止时执行的回调函数
@@ -41,8 +42,17 @@ public:
     void onBackupSizeReport(const std::string); // 返回已获取待备份数据量的信息
     ani_ref* getRef(){return ref_;}
 private:
+    struct FileReadyEvent {
+        BFileInfo info;
+        UniqueFd fd;
+        ErrCode code;
+    };
+    // 多个线程同时上报的文件合并处理, 每批只绑定一次虚拟机线程
+    void FileReadyBatch(std::vector<FileReadyEvent> &events);
+
     ani_ref* ref_ = nullptr;
     ani_vm* vm_ = nullptr;
+    std::shared_ptr<CallbackCoalescer<FileReadyEvent>> fileReadyCoalescer_;
 };
 } // namespace OHOS::FileManagement::Backup
 #endif // INTERFACES_KITS_JS_SRC_MOD_BACKUP_PROPERTIES_GENERAL_CALLBACKS_H
\ No newline at end of file
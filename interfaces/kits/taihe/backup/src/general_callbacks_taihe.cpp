@@ -37,6 +37,11 @@
 namespace OHOS::FileManagement::Backup::TAIHE {
 using namespace std;
 
+namespace {
+constexpr size_t FILE_READY_CAPACITY = 256;
+constexpr size_t FILE_READY_MAX_BATCH = 32;
+} // namespace
+
 ani_object WrapBusinessError(ani_env* env, const std::string& msg)
 {
     ani_class cls {};
@@ -137,11 +142,28 @@ ani_status ExecCallBack(ani_env *env, ani_object param, ani_object callbackFunc)
     return status;
 }
 
+TaiheGeneralCallbacks::TaiheGeneralCallbacks(ani_ref* ref, ani_vm* vm) : ref_(ref), vm_(vm)
+{
+    fileReadyCoalescer_ = make_shared<CallbackCoalescer<FileReadyEvent>>(FILE_READY_CAPACITY, FILE_READY_MAX_BATCH,
+        nullptr, [this](vector<FileReadyEvent> &events) { FileReadyBatch(events); });
+}
+
+TaiheGeneralCallbacks::~TaiheGeneralCallbacks()
+{
+    // Close等待其他线程上正在执行的FileReadyBatch返回, 之后consumer不再访问this
+    fileReadyCoalescer_->Close();
+}
+
 void TaiheGeneralCallbacks::onFileReady(const BFileInfo& info, UniqueFd fd, ErrCode code)
 {
     if (!vm_) {
         return;
     }
+    fileReadyCoalescer_->Push(FileReadyEvent {info, move(fd), code});
+}
+
+void TaiheGeneralCallbacks::FileReadyBatch(vector<FileReadyEvent> &events)
+{
     ani_env* env = nullptr;
     ani_options aniArgs {0, nullptr};
     if (ANI_OK != vm_->AttachCurrentThread(&aniArgs, ANI_VERSION_1, &env)) {
@@ -150,26 +172,28 @@ void TaiheGeneralCallbacks::onFileReady(const BFileInfo& info, UniqueFd fd, ErrC
             return;
         }
     }
-
-    ani_string ani_owner = {};
-    env->String_NewUTF8(info.owner.c_str(), info.owner.size(), &ani_owner);
-
-    ani_string ani_url = {};
-    env->String_NewUTF8(info.fileName.c_str(), info.fileName.size(), &ani_url);
-
-    ani_int ani_fd = static_cast<ani_int>(fd.Get());
-    ani_int ani_manifestFd = static_cast<ani_int>(info.sn);
-    ani_object ani_obj = {};
-
-    env->Object_New(TH_ANI_FIND_CLASS(env, "@ohos.file.backup.backup._taihe_File_inner"),
-        TH_ANI_FIND_CLASS_METHOD(env, "@ohos.file.backup.backup._taihe_File_inner", "<ctor>", nullptr),
-        &ani_obj, ani_owner, ani_url, ani_fd, ani_manifestFd);
-    ani_ref businessError = CreateBusinessError(env, static_cast<ani_int>(code), std::string("onFileReady error"));
     ani_object callback = reinterpret_cast<ani_object>(*getRef());
-
     ani_ref method = {};
     env->Object_GetPropertyByName_Ref(callback, "onFileReady", &method);
-    ExecAsyncCallBack(env, static_cast<ani_object>(businessError), ani_obj, static_cast<ani_object>(method));
+    for (auto &event : events) {
+        ani_string ani_owner = {};
+        env->String_NewUTF8(event.info.owner.c_str(), event.info.owner.size(), &ani_owner);
+
+        ani_string ani_url = {};
+        env->String_NewUTF8(event.info.fileName.c_str(), event.info.fileName.size(), &ani_url);
+
+        ani_int ani_fd = static_cast<ani_int>(event.fd.Get());
+        ani_int ani_manifestFd = static_cast<ani_int>(event.info.sn);
+        ani_object ani_obj = {};
+
+        env->Object_New(TH_ANI_FIND_CLASS(env, "@ohos.file.backup.backup._taihe_File_inner"),
+            TH_ANI_FIND_CLASS_METHOD(env, "@ohos.file.backup.backup._taihe_File_inner", "<ctor>", nullptr),
+            &ani_obj, ani_owner, ani_url, ani_fd, ani_manifestFd);
+        ani_ref businessError = CreateBusinessError(env, static_cast<ani_int>(event.code),
+            std::string("onFileReady error"));
+        ExecAsyncCallBack(env, static_cast<ani_object>(businessError), ani_obj, static_cast<ani_object>(method));
+        event.fd.Reset();
+    }
     vm_->DetachCurrentThread();
 }
 
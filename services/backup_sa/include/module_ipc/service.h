@@ -849,6 +849,7 @@ private:
 
     void TotalStatStart(BizScene bizScene, std::string caller, uint64_t startTime, Mode mode = Mode::FULL);
     void TotalStatEnd(ErrCode errCode);
+    void ExportSpanTrace();
     void UpdateHandleCnt(ErrCode errCode);
     void TotalStatReport();
     void CreateRunningLock();
@@ -881,7 +882,7 @@ private:
     ErrCode ProcessFileHandlesByAction(const std::string &bundleName,
                                        const vector<std::string> &fileNames,
                                        BConstants::ServiceSchedAction action);
-    ErrCode ProcessReadyFiles(const std::vector<std::string> &fileNames,
+    ErrCode ProcessReadyFiles(const std::vector<std::string_view> &fileNames,
                               const std::vector<int> &errCodes,
                               const std::string &callerName);
     ErrCode SendIncrementalFileHandlesByEnhance(const std::string &bundleName,
@@ -80,6 +80,7 @@ struct BackupExtInfo {
     std::string backupScene;
     bool isSupportWithoutTar {false};
     std::vector<std::string> excludeInfos;
+    std::vector<std::string> restorePaths;
     int32_t batchSize {500};
 };
 
@@ -623,6 +624,8 @@ public:
     bool GetSupportWithoutTar(const std::string &bundleName);
     void SetExcludeInfos(const std::string &bundleName, const std::vector<std::string> &excludeInfos);
     std::vector<std::string> GetExcludeInfos(const std::string &bundleName);
+    void SetRestorePaths(const std::string &bundleName, const std::vector<std::string> &restorePaths);
+    std::vector<std::string> GetRestorePaths(const std::string &bundleName);
     void SetBatchSize(const std::string &bundleName, int32_t batchSize);
     int32_t GetBatchSize(const std::string &bundleName);
     
@@ -71,7 +71,7 @@ public:
     void DoClearInner();
     void AppDone(ErrCode errCode, const std::string &bundleName);
     void ReportAppStatistic(const std::string &func, ErrCode errCode);
-    void UpdateFileStat(std::string filePath, uint64_t fileSize);
+    void UpdateFileStat(const std::string &filePath, uint64_t fileSize, uint32_t dirDepth = 0);
     void HandleExtOnRelease(bool isAppResultReport, ErrCode errCode);
     ErrCode HandleExtOnDisconnect(BackupType scenario, bool isAppResultReport, ErrCode errCode);
     void HandleCurBundleEndWork(std::string bundleName, const BackupType scenario);
@@ -128,7 +128,6 @@ private:
 // lock
     std::mutex onStartTimeLock_;
     std::mutex scanSizeLock_;
-    std::mutex updateFileStatLock_;
     std::mutex onReleaseLock_;
     std::mutex bundleEndLock_;
     std::mutex updateSendRateLock_;
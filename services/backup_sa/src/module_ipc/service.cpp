@@ -52,6 +52,7 @@
 #include "b_radar/b_radar.h"
 #include "b_resources/b_constants.h"
 #include "b_sa/b_sa_utils.h"
+#include "b_utils/b_span_tracer.h"
 #include "b_utils/b_time.h"
 #include "bundle_mgr_client.h"
 #include "filemgmt_libhilog.h"
@@ -786,6 +787,7 @@ void Service::SetCurrentSessProperties(
             session_->SetClearDataFlag(bundleNameIndexInfo, iterSet->second.isClearData);
             session_->SetSupportWithoutTar(bundleNameIndexInfo, iterSet->second.isSupportWithoutTar);
             session_->SetExcludeInfos(bundleNameIndexInfo, iterSet->second.excludeInfos);
+            session_->SetRestorePaths(bundleNameIndexInfo, iterSet->second.restorePaths);
             session_->SetBatchSize(bundleNameIndexInfo, iterSet->second.batchSize);
         }
         BJsonUtil::BundleDetailInfo broadCastInfo;
@@ -963,6 +965,7 @@ ErrCode Service::LaunchBackupSAExtension(const BundleName &bundleName)
 void Service::ExtStart(const string &bundleName)
 {
     HITRACE_METER_NAME(HITRACE_TAG_FILEMANAGEMENT, __PRETTY_FUNCTION__);
+    BACKUP_SPAN("sa.ExtStart");
     try {
         HILOGI("begin ExtStart, bundle name:%{public}s", bundleName.data());
         if (defaultAppManager_->IsDefaultBundle(bundleName)) {
@@ -1124,6 +1127,7 @@ void Service::StartRunningTimer(const std::string &bundleName)
 void Service::ExtConnectDone(string bundleName)
 {
     HITRACE_METER_NAME(HITRACE_TAG_FILEMANAGEMENT, __PRETTY_FUNCTION__);
+    BACKUP_SPAN("sa.ExtConnectDone");
     try {
         HILOGE("begin %{public}s", bundleName.data());
         BConstants::ServiceSchedAction curSchedAction = session_->GetServiceSchedAction(bundleName);
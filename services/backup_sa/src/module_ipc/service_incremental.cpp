@@ -641,7 +641,11 @@ ErrCode Service::AppIncrementalFileReadys(const std::string &bundleName,
         if (session_->GetScenario() == IServiceReverseType::Scenario::RESTORE) {
             session_->GetServiceReverseProxy()->SetBatchSize(static_cast<unsigned int>(fileNames.size()));
             BStringRawData fileNamesRD;
-            fileNamesRD.Marshalling(StringUtils::StringVectorSerialize(fileNames));
+            if (!StringUtils::StringVectorSerialize(fileNames, fileNamesRD.BeginMarshalling()) ||
+                fileNamesRD.EndMarshalling() != 0) {
+                HILOGE("Marshalling file names failed, bundle: %{public}s", bundleName.c_str());
+                return BError(BError::Codes::SA_INVAL_ARG);
+            }
             session_->GetServiceReverseProxy()->IncrementalRestoreOnFileReadys(bundleName, fileNamesRD, openResults);
             OnAllBundlesFinished(BError(BError::Codes::OK));
             return BError(BError::Codes::OK);
@@ -898,9 +902,14 @@ ErrCode Service::GetIncrementalFileHandles(const std::string &bundleName, const
             HILOGE("action is unknown, bundleName:%{public}s", bundleName.c_str());
             return BError(BError::Codes::SA_INVAL_ARG);
         }
-        std::string serializedData;
-        fileNamesRD.Unmarshalling(serializedData);
-        auto fileNames = StringUtils::StringVectorDeserialize(serializedData);
+        std::string_view serializedData;
+        std::vector<std::string_view> fileNameViews;
+        if (fileNamesRD.Unmarshalling(serializedData) != 0 ||
+            !StringUtils::StringVectorViews(serializedData, fileNameViews)) {
+            HILOGE("Unmarshalling file names failed, bundleName:%{public}s", bundleName.c_str());
+            return BError(BError::Codes::SA_INVAL_ARG);
+        }
+        std::vector<std::string> fileNames(fileNameViews.begin(), fileNameViews.end());
         return ProcessFileHandlesByAction(bundleName, fileNames, action);
     } catch (const BError &e) {
         HILOGE("GetIncrementalFileHandles exception, bundleName:%{public}s", bundleName.c_str());
@@ -1003,8 +1012,13 @@ std::function<void()> Service::CreateIncrementalFileHandlesTask(const std::strin
         if (!extFileNames.empty()) {
             std::vector<FileOpenResult> extOpenResults;
             BStringRawData extFileNamesRD;
-            extFileNamesRD.Marshalling(StringUtils::StringVectorSerialize(extFileNames));
-            auto err = proxyPtr->GetIncrementalFileHandles(extFileNamesRD, extOpenResults);
+            ErrCode err = BError(BError::Codes::SA_INVAL_ARG);
+            if (!StringUtils::StringVectorSerialize(extFileNames, extFileNamesRD.BeginMarshalling()) ||
+                extFileNamesRD.EndMarshalling() != 0) {
+                HILOGE("Marshalling ext file names failed, bundle: %{public}s", bundleName.c_str());
+            } else {
+                err = proxyPtr->GetIncrementalFileHandles(extFileNamesRD, extOpenResults);
+            }
             finalErr = err == ERR_OK ? finalErr : err;
             finalFileNames.insert(finalFileNames.end(), extFileNames.begin(), extFileNames.end());
             openResults.insert(openResults.end(), extOpenResults.begin(), extOpenResults.end());
@@ -49,6 +49,7 @@
 #include "b_radar/radar_app_statistic.h"
 #include "b_resources/b_constants.h"
 #include "b_sa/b_sa_utils.h"
+#include "b_utils/b_span_tracer.h"
 #include "b_utils/b_time.h"
 #include "bundle_mgr_client.h"
 #include "filemgmt_libhilog.h"
@@ -221,6 +222,7 @@ ErrCode Service::Finish()
 ErrCode Service::GetFileHandle(const string &bundleName, const string &fileName)
 {
     HITRACE_METER_NAME(HITRACE_TAG_FILEMANAGEMENT, __PRETTY_FUNCTION__);
+    BACKUP_SPAN("sa.GetFileHandle");
     try {
         if (session_ == nullptr) {
             HILOGE("GetFileHandle error, session is empty");
@@ -288,6 +290,7 @@ ErrCode Service::SendFileHandle(const std::string &bundleName, const std::string
 ErrCode Service::PublishFile(const BFileInfo &fileInfo)
 {
     HITRACE_METER_NAME(HITRACE_TAG_FILEMANAGEMENT, __PRETTY_FUNCTION__);
+    BACKUP_SPAN("sa.PublishFile");
     if (session_ == nullptr) {
         HILOGE("PublishFile error, session is empty");
         return BError(BError::Codes::SA_INVAL_ARG);
@@ -383,6 +386,7 @@ ErrCode Service::AppAncoFileReady(const std::string &fileName, const std::string
 ErrCode Service::AppFileReady(const string &fileName, UniqueFd fd, int32_t errCode)
 {
     HITRACE_METER_NAME(HITRACE_TAG_FILEMANAGEMENT, __PRETTY_FUNCTION__);
+    BACKUP_SPAN("sa.AppFileReady");
     try {
         if (session_ == nullptr) {
             HILOGE("AppFileReady error, session is empty");
@@ -437,9 +441,14 @@ ErrCode Service::AppFileReadysWithoutFd(const BStringRawData &abnormalfileNamesR
             HILOGE("AppFileReadysWithoutFd error, Get bundle name failed, ret:%{public}d", ret);
             return ret;
         }
-        std::string serializedData;
-        abnormalfileNamesRD.Unmarshalling(serializedData);
-        auto abnormalfileNames = StringUtils::StringVectorDeserialize(serializedData);
+        std::string_view serializedData;
+        std::vector<std::string_view> abnormalfileNames;
+        if (abnormalfileNamesRD.Unmarshalling(serializedData) != 0 ||
+            !StringUtils::StringVectorViews(serializedData, abnormalfileNames)) {
+            HILOGE("AppFileReadysWithoutFd error, unmarshalling file names failed, bundle:%{public}s",
+                callerName.c_str());
+            return BError(BError::Codes::SA_INVAL_ARG);
+        }
         HILOGI("AppFileReadysWithoutFd filenames size is, %{public}zu", abnormalfileNames.size());
         session_->GetServiceReverseProxy()->BackupOnFileReadysWithoutFd(callerName, abnormalfileNamesRD, errCodes);
         ret = ProcessReadyFiles(abnormalfileNames, errCodes, callerName);
@@ -457,12 +466,12 @@ ErrCode Service::AppFileReadysWithoutFd(const BStringRawData &abnormalfileNamesR
 }
 
 ErrCode Service::ProcessReadyFiles(
-    const std::vector<std::string>& fileNames,
+    const std::vector<std::string_view>& fileNames,
     const std::vector<int>& errCodes,
     const std::string& callerName)
 {
     for (size_t i = 0; i < fileNames.size(); ++i) {
-        string fileName = fileNames[i];
+        string fileName(fileNames[i]);
         int errCode = errCodes[i];
         string filePath = BJsonUtil::GetPath(fileName);
 
@@ -497,9 +506,13 @@ ErrCode Service::AppFileReadys(const BStringRawData &fileNamesRD,
             HILOGE("AppFileReady error, Get bundle name failed, ret:%{public}d", ret);
             return ret;
         }
-        std::string serializedData;
-        fileNamesRD.Unmarshalling(serializedData);
-        auto fileNames = StringUtils::StringVectorDeserialize(serializedData);
+        std::string_view serializedData;
+        std::vector<std::string_view> fileNames;
+        if (fileNamesRD.Unmarshalling(serializedData) != 0 ||
+            !StringUtils::StringVectorViews(serializedData, fileNames)) {
+            HILOGE("AppFileReady error, unmarshalling file names failed, bundle:%{public}s", callerName.c_str());
+            return BError(BError::Codes::SA_INVAL_ARG);
+        }
         HILOGI("AppfileReadys filenames size is, %{public}zu", fileNames.size());
         session_->GetServiceReverseProxy()->BackupOnFileReadys(callerName, fileNamesRD, fds, errCodes);
         ret = ProcessReadyFiles(fileNames, errCodes, callerName);
@@ -519,6 +532,7 @@ ErrCode Service::AppFileReadys(const BStringRawData &fileNamesRD,
 ErrCode Service::AppDone(ErrCode errCode)
 {
     HITRACE_METER_NAME(HITRACE_TAG_FILEMANAGEMENT, __PRETTY_FUNCTION__);
+    BACKUP_SPAN("sa.AppDone");
     try {
         if (session_ == nullptr) {
             HILOGE("App finish error, session info is empty");
@@ -552,6 +566,7 @@ ErrCode Service::AppDone(ErrCode errCode)
 ErrCode Service::LaunchBackupExtension(const BundleName &bundleName)
 {
     HITRACE_METER_NAME(HITRACE_TAG_FILEMANAGEMENT, __PRETTY_FUNCTION__);
+    BACKUP_SPAN("sa.LaunchBackupExtension");
     HILOGI("begin %{public}s", bundleName.data());
     IServiceReverseType::Scenario scenario = session_->GetScenario();
     BConstants::ExtensionAction action;
@@ -629,8 +644,10 @@ void Service::SetWant(AAFwk::Want &want, const BundleName &bundleName, const BCo
     want.SetParam(BConstants::EXTENSION_BACKUP_SCENE_PARA, bundleDetail.backupScene);
     want.SetParam(BConstants::EXTENSION_SUPPORT_WITHOUT_TAR_PARA, session_->GetSupportWithoutTar(bundleName));
     want.SetParam(BConstants::EXTENSION_EXCLUDE_INFOS_PARA, session_->GetExcludeInfos(bundleName));
+    want.SetParam(BConstants::EXTENSION_RESTORE_PATHS_PARA, session_->GetRestorePaths(bundleName));
     want.SetParam(BConstants::EXTENSION_BATCH_SIZE_PARA, session_->GetBatchSize(bundleName));
     want.SetParam(BConstants::EXTENSION_CALLER_BUNDLE_NAME_PARA, session_->GetSessionCallerName());
+    want.SetParam(BConstants::EXTENSION_SESSION_ACTIVE_TIME_PARA, session_->GetSessionActiveTime());
 }
 
 std::vector<std::string> Service::GetSupportBackupBundleNames(vector<BJsonEntityCaps::BundleInfo> &backupInfos,
@@ -942,6 +959,7 @@ void Service::OnAllBundlesFinished(ErrCode errCode)
     if (session_->IsOnAllBundlesFinished()) {
         IServiceReverseType::Scenario scenario = session_->GetScenario();
         TotalStatEnd(errCode);
+        ExportSpanTrace();
         if (scenario == IServiceReverseType::Scenario::BACKUP && session_->GetIsIncrementalBackup()) {
             session_->GetServiceReverseProxy()->IncrementalBackupOnAllBundlesFinished(errCode);
         } else if (scenario == IServiceReverseType::Scenario::RESTORE &&
@@ -1753,6 +1771,7 @@ void Service::TotalStatStart(BizScene bizScene, std::string caller, uint64_t sta
     std::unique_lock<std::shared_mutex> lock(totalStatMutex_);
     totalStatistic_ = std::make_shared<RadarTotalStatistic>(bizScene, caller, mode);
     totalStatistic_->totalSpendTime_.startMilli_ = startTime;
+    BSpanTracer::GetInstance().SetEnabled(BackupPara::GetBackupTraceEnable());
 }
 
 void Service::TotalStatEnd(ErrCode errCode)
@@ -1766,6 +1785,17 @@ void Service::TotalStatEnd(ErrCode errCode)
     }
 }
 
+void Service::ExportSpanTrace()
+{
+    if (!BSpanTracer::IsEnabled()) {
+        return;
+    }
+    string tracePath = BConstants::GetSaBundleBackupRootDir(session_->GetSessionUserId()) +
+        string(BConstants::BACKUP_TRACE_FILE_NAME);
+    BSpanTracer::GetInstance().ExportChromeTrace(tracePath);
+    BSpanTracer::GetInstance().Clear();
+}
+
 void Service::UpdateHandleCnt(ErrCode errCode)
 {
     std::unique_lock<std::shared_mutex> lock(totalStatMutex_);
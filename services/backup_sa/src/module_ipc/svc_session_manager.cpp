@@ -1599,6 +1599,38 @@ std::vector<std::string> SvcSessionManager::GetExcludeInfos(const std::string &b
     return it->second.excludeInfos;
 }
 
+void SvcSessionManager::SetRestorePaths(const std::string &bundleName,
+    const std::vector<std::string> &restorePaths)
+{
+    unique_lock<shared_mutex> lock(lock_);
+    if (!impl_.clientToken) {
+        HILOGE("No caller token was specified, bundleName:%{public}s", bundleName.c_str());
+        return;
+    }
+    auto [findBundleSuc, it] = GetBackupExtNameMap(bundleName);
+    if (!findBundleSuc) {
+        HILOGE("BackupExtNameMap can not find bundle %{public}s", bundleName.c_str());
+        return;
+    }
+    it->second.restorePaths = restorePaths;
+    HILOGI("bundleName:%{public}s, set restorePaths size:%{public}zu.", bundleName.c_str(), restorePaths.size());
+}
+
+std::vector<std::string> SvcSessionManager::GetRestorePaths(const std::string &bundleName)
+{
+    shared_lock<shared_mutex> lock(lock_);
+    if (!impl_.clientToken) {
+        HILOGE("No caller token was specified, bundleName:%{public}s", bundleName.c_str());
+        return {};
+    }
+    auto [findBundleSuc, it] = GetBackupExtNameMap(bundleName);
+    if (!findBundleSuc) {
+        HILOGE("BackupExtNameMap can not find bundle %{public}s", bundleName.c_str());
+        return {};
+    }
+    return it->second.restorePaths;
+}
+
 void SvcSessionManager::SetBatchSize(const std::string &bundleName, int32_t batchSize)
 {
     unique_lock<shared_mutex> lock(lock_);
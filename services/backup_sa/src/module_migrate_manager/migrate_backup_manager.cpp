@@ -262,7 +262,7 @@ void MigrateManager::DoBackupTask(const std::string &bundleName)
         if (fileInfo->isBigFile_) {
             subRet = ReportAppFileReady(bundleName, fileInfo->filename_, fileInfo->filePath_);
             appStatistic_->bigFileCount_++;
-            UpdateFileStat(fileInfo->filePath_, fileInfo->sta_.st_size);
+            UpdateFileStat(fileInfo->filePath_, fileInfo->sta_.st_size, fileInfo->dirDepth_);
             fdNum++;
         } else {
             subRet = ReportAppFileReady(bundleName, fileInfo->filename_, fileInfo->filePath_, true);
@@ -427,23 +427,12 @@ void MigrateManager::CloseFileWithFDSan(int fd)
     }
 }
 
-void MigrateManager::UpdateFileStat(std::string filePath, uint64_t fileSize)
+void MigrateManager::UpdateFileStat(const std::string &filePath, uint64_t fileSize, uint32_t dirDepth)
 {
-    std::lock_guard<std::mutex> lock(updateFileStatLock_);
-    appStatistic_->UpdateFileDist(ExtractFileExt(filePath), fileSize);
-    uint32_t dirDepth = 0;
-    const char* pstr = filePath.c_str();
-    char pre = '-';
-    uint32_t pathLen = filePath.size();
-    for (uint32_t i = 0; i < pathLen; i++) {
-        if (pstr[i] == '/' && pre != '/') {
-            dirDepth++;
-        }
-        pre = pstr[i];
-    }
-    if (dirDepth > appStatistic_->dirDepth_) {
-        appStatistic_->dirDepth_ = dirDepth;
+    if (dirDepth == 0) {
+        dirDepth = StringUtils::GetPathDepth(filePath);
     }
+    appStatistic_->UpdateFileStat(ExtractFileExt(filePath), fileSize, dirDepth);
 }
 
 void MigrateManager::SetDefaultAppTimer(int64_t &appSize, const string &bundleName)
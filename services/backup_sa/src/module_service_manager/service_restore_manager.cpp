@@ -140,6 +140,7 @@ ErrCode Service::SetSessPropertiesWithDetailRestore(const std::vector<std::strin
             session_->SetClearDataFlag(bundleNameIndexInfo, iterSet->second.isClearData);
             session_->SetSupportWithoutTar(bundleNameIndexInfo, iterSet->second.isSupportWithoutTar);
             session_->SetExcludeInfos(bundleNameIndexInfo, iterSet->second.excludeInfos);
+            session_->SetRestorePaths(bundleNameIndexInfo, iterSet->second.restorePaths);
             session_->SetBatchSize(bundleNameIndexInfo, iterSet->second.batchSize);
         }
         StrategyContext context;
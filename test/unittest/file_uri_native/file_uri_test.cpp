@@ -896,4 +896,56 @@ HWTEST_F(FileUriTest, File_uri_GetUriFromPath_CurrentUser_0007, testing::ext::Te
     EXPECT_EQ(fileUri.ToString(), expectedUri);
     GTEST_LOG_(INFO) << "FileUriTest-end File_uri_GetUriFromPath_CurrentUser_0007";
 }
+
+/**
+ * @tc.name: File_uri_GetRealPaths_0000
+ * @tc.desc: Test function of GetRealPaths() for media and document uris, the batch result must match GetRealPath().
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ * @tc.require:
+ */
+HWTEST_F(FileUriTest, File_uri_GetRealPaths_0000, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "FileUriTest-begin File_uri_GetRealPaths_0000";
+    const size_t uriCount = 10;
+    vector<string> uris;
+    uris.reserve(uriCount * 3);
+    for (size_t i = 0; i < uriCount; ++i) {
+        uris.emplace_back("file://media/Photo/" + to_string(i) + "/IMG_" + to_string(i) + "/IMG_" + to_string(i) +
+                          ".jpg");
+        uris.emplace_back("file://docs/storage/Users/currentUser/Documents/" + to_string(i) + ".txt");
+        uris.emplace_back("file://com.example.fileshareb/data/storage/el2/base/files/" + to_string(i) + ".txt");
+    }
+    vector<string> realPaths = FileUri::GetRealPaths(uris);
+    ASSERT_EQ(realPaths.size(), uris.size());
+    for (size_t i = 0; i < uriCount; ++i) {
+        string idx = to_string(i);
+        EXPECT_EQ(realPaths[i * 3], "/data/storage/el2/media/Photo/" + idx + "/IMG_" + idx + "/IMG_" + idx + ".jpg");
+        EXPECT_EQ(realPaths[i * 3 + 1], "/storage/Users/currentUser/Documents/" + idx + ".txt");
+        EXPECT_EQ(realPaths[i * 3 + 2],
+                  "/storage/Users/currentUser/appdata/el2/base/com.example.fileshareb/files/" + idx + ".txt");
+    }
+    for (size_t i = 0; i < uris.size(); ++i) {
+        FileUri fileUri(uris[i]);
+        EXPECT_EQ(fileUri.GetRealPath(), realPaths[i]);
+    }
+    GTEST_LOG_(INFO) << "FileUriTest-end File_uri_GetRealPaths_0000";
+}
+
+/**
+ * @tc.name: File_uri_GetRealPaths_0001
+ * @tc.desc: Test function of GetRealPaths() for empty input.
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ * @tc.require:
+ */
+HWTEST_F(FileUriTest, File_uri_GetRealPaths_0001, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "FileUriTest-begin File_uri_GetRealPaths_0001";
+    vector<string> uris;
+    EXPECT_TRUE(FileUri::GetRealPaths(uris).empty());
+    GTEST_LOG_(INFO) << "FileUriTest-end File_uri_GetRealPaths_0001";
+}
 }
\ No newline at end of file
@@ -58,8 +58,11 @@ public:
     virtual void SetBackupExtExtension(const wptr<BackupExtExtension> &) = 0;
     virtual bool GetSupportWithoutTar() const = 0;
     virtual std::vector<std::string> GetExcludeInfos() const = 0;
+    virtual std::vector<std::string> GetRestorePaths() const = 0;
     virtual int32_t GetBatchSize() const = 0;
     virtual std::string GetCallerBundleName() const = 0;
+    virtual std::string GetSessionActiveTime() const = 0;
+    virtual std::string GetStreamKey() const = 0;
 public:
     virtual std::unique_ptr<NativeReference> LoadSystemModuleByEngine(napi_env, const std::string&, const napi_value*,
         size_t) = 0;
@@ -111,8 +114,11 @@ public:
     MOCK_METHOD(void, SetBackupExtExtension, (const wptr<BackupExtExtension> &));
     MOCK_METHOD(bool, GetSupportWithoutTar, (), (const));
     MOCK_METHOD((std::vector<std::string>), GetExcludeInfos, (), (const));
+    MOCK_METHOD((std::vector<std::string>), GetRestorePaths, (), (const));
     MOCK_METHOD(int32_t, GetBatchSize, (), (const));
     MOCK_METHOD(std::string, GetCallerBundleName, (), (const));
+    MOCK_METHOD(std::string, GetSessionActiveTime, (), (const));
+    MOCK_METHOD(std::string, GetStreamKey, (), (const));
 public:
     MOCK_METHOD((std::unique_ptr<NativeReference>), LoadSystemModuleByEngine, (napi_env, const std::string&,
         const napi_value*, size_t));
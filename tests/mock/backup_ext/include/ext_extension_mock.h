@@ -33,7 +33,7 @@ public:
     virtual ErrCode PublishIncrementalFile(const string &) = 0;
     virtual ErrCode HandleBackup(bool) = 0;
     virtual int DoBackup(TarMap &, TarMap &, map<string, size_t> &, uint32_t, uint32_t) = 0;
-    virtual int DoRestore(const string &, const off_t) = 0;
+    virtual int DoRestore(const string &, const off_t, const string &) = 0;
     virtual int DoIncrementalRestore() = 0;
     virtual void AsyncTaskBackup(const string) = 0;
     virtual void AsyncTaskRestore(std::set<std::string>, const std::vector<ExtManageInfo>) = 0;
@@ -90,7 +90,7 @@ public:
     MOCK_METHOD(ErrCode, PublishIncrementalFile, (const string &));
     MOCK_METHOD(ErrCode, HandleBackup, (bool));
     MOCK_METHOD(int, DoBackup, (TarMap &, TarMap &, (map<string, size_t> &), uint32_t, uint32_t));
-    MOCK_METHOD(int, DoRestore, (const string &, const off_t));
+    MOCK_METHOD(int, DoRestore, (const string &, const off_t, const string &));
     MOCK_METHOD(int, DoIncrementalRestore, ());
     MOCK_METHOD(void, AsyncTaskBackup, (const string));
     MOCK_METHOD(void, AsyncTaskRestore, (std::set<std::string>, const std::vector<ExtManageInfo>));
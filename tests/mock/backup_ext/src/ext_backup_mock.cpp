@@ -170,6 +170,11 @@ std::vector<std::string> ExtBackup::GetExcludeInfos() const
 {
     return BExtBackup::extBackup->GetExcludeInfos();
 }
+
+std::vector<std::string> ExtBackup::GetRestorePaths() const
+{
+    return BExtBackup::extBackup->GetRestorePaths();
+}
  
 int32_t ExtBackup::GetBatchSize() const
 {
@@ -180,4 +185,14 @@ std::string ExtBackup::GetCallerBundleName() const
 {
     return BExtBackup::extBackup->GetCallerBundleName();
 }
+
+std::string ExtBackup::GetSessionActiveTime() const
+{
+    return BExtBackup::extBackup->GetSessionActiveTime();
+}
+
+std::string ExtBackup::GetStreamKey() const
+{
+    return BExtBackup::extBackup->GetStreamKey();
+}
 } // namespace OHOS::FileManagement::Backup
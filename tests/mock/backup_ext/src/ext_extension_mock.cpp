@@ -66,9 +66,9 @@ int BackupExtExtension::DoBackup(TarMap &bigFileInfo, TarMap &bigFileInfoBackupe
         includesNum, excludesNum);
 }
 
-int BackupExtExtension::DoRestore(const string &fileName, const off_t fileSize)
+int BackupExtExtension::DoRestore(const string &fileName, const off_t fileSize, const string &fingerprint)
 {
-    return BExtExtension::extExtension->DoRestore(fileName, fileSize);
+    return BExtExtension::extExtension->DoRestore(fileName, fileSize, fingerprint);
 }
 
 int BackupExtExtension::DoIncrementalRestore()
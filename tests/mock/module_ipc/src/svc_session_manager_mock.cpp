@@ -364,6 +364,14 @@ std::vector<std::string> SvcSessionManager::GetExcludeInfos(const std::string &b
     return {};
 }
 
+void SvcSessionManager::SetRestorePaths(const std::string &bundleName,
+    const std::vector<std::string> &restorePaths) {}
+
+std::vector<std::string> SvcSessionManager::GetRestorePaths(const std::string &bundleName)
+{
+    return {};
+}
+
 void SvcSessionManager::SetBatchSize(const std::string &bundleName, int32_t batchSize) {}
  	 
 int32_t SvcSessionManager::GetBatchSize(const std::string &bundleName)
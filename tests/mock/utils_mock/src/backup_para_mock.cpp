@@ -38,4 +38,14 @@ tuple<bool, int32_t> BackupPara::GetBackupDebugOverrideAccount()
 {
     return BBackupPara::backupPara->GetBackupDebugOverrideAccount();
 }
+
+bool BackupPara::GetBackupTraceEnable()
+{
+    return false;
+}
+
+BEncryption::DigestAlgorithm BackupPara::GetBackupTarDigestAlgorithm()
+{
+    return BEncryption::DigestAlgorithm::NONE;
+}
 } // namespace OHOS::FileManagement::Backup
\ No newline at end of file
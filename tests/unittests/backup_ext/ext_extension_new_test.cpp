@@ -13,6 +13,7 @@
  * limitations under the License.
  */
 
+#include <atomic>
 #include <chrono>
 #include <fstream>
 #include <iostream>
@@ -89,8 +90,7 @@ public:
         serviceMock_ = new IServiceMock();
         ServiceClient::serviceProxy_ = serviceMock_;
 
-        std::queue<std::shared_ptr<IFileInfo>> emptyQueue;
-        ScanFileSingleton::GetInstance().pendingFileQueue_.swap(emptyQueue);
+        ScanFileSingleton::GetInstance().pendingFileQueue_.Clear();
         ScanFileSingleton::GetInstance().smallFiles_.clear();
         extBackupMock_ = make_shared<ExtBackupMock>();
         ExtBackupMock::extBackup = extBackupMock_;
@@ -245,7 +245,7 @@ HWTEST_F(ExtExtensionNewTest, Ext_Extension_DoPacketOnce_Test_0100, testing::ext
         return;
     };
     extExtension_->DoPacketOnce(srcFiles, path, reportCb, totalTarSpend);
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 0);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 0);
     fclose(tmpFile);
     GTEST_LOG_(INFO) << "ExtExtensionSubTest-end Ext_Extension_DoPacketOnce_Test_0100";
 }
@@ -285,7 +285,7 @@ HWTEST_F(ExtExtensionNewTest, Ext_Extension_DoPacketOnce_Test_0200, testing::ext
         return;
     };
     extExtension_->DoPacketOnce(srcFiles, path, reportCb, totalTarSpend);
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 1);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 1);
     GTEST_LOG_(INFO) << "ExtExtensionSubTest-end Ext_Extension_DoPacketOnce_Test_0200";
 }
 
@@ -320,7 +320,7 @@ HWTEST_F(ExtExtensionNewTest, Ext_Extension_DoPacket_Test_0200, testing::ext::Te
     shared_ptr<ISmallFileInfo> file1 = make_shared<SmallFileInfo>(filename1, fileSize1);
     ScanFileSingleton::GetInstance().smallFiles_.push_back(file1);
     extExtension_->DoPacket();
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 1);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 1);
 
     string filename2 = "app_file_ready_test2";
     size_t fileSize2 = 10;
@@ -328,7 +328,7 @@ HWTEST_F(ExtExtensionNewTest, Ext_Extension_DoPacket_Test_0200, testing::ext::Te
     ScanFileSingleton::GetInstance().smallFiles_.push_back(file1);
     ScanFileSingleton::GetInstance().smallFiles_.push_back(file2);
     extExtension_->DoPacket();
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 3);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 3);
     GTEST_LOG_(INFO) << "ExtExtensionSubTest-end Ext_Extension_DoPacket_Test_0200";
 }
 
@@ -399,7 +399,7 @@ HWTEST_F(ExtExtensionNewTest, Ext_Extension_DoBackupTask_Test_0100, testing::ext
     string filePath = "/tmp";
     struct stat sta;
     shared_ptr<IFileInfo> file1 = make_shared<FileInfo>(filename, filePath, sta, false);
-    ScanFileSingleton::GetInstance().pendingFileQueue_.push(file1);
+    ScanFileSingleton::GetInstance().pendingFileQueue_.Push(file1);
     ScanFileSingleton::GetInstance().SetCompletedFlag(true);
     EXPECT_CALL(*funcMock_, open(_, _)).WillRepeatedly([](const char* path, int mode) -> int {
         errno = EPERM;
@@ -433,9 +433,9 @@ HWTEST_F(ExtExtensionNewTest, Ext_Extension_DoBackupTask_Test_0200, testing::ext
     struct stat sta;
     shared_ptr<IFileInfo> file1 = make_shared<FileInfo>(filename, filePath, sta, false);
     shared_ptr<IFileInfo> file2 = make_shared<FileInfo>(filename, filePath, sta, true);
-    ScanFileSingleton::GetInstance().pendingFileQueue_.push(file1);
-    ScanFileSingleton::GetInstance().pendingFileQueue_.push(file2);
-    ScanFileSingleton::GetInstance().pendingFileQueue_.push(nullptr);
+    ScanFileSingleton::GetInstance().pendingFileQueue_.Push(file1);
+    ScanFileSingleton::GetInstance().pendingFileQueue_.Push(file2);
+    ScanFileSingleton::GetInstance().pendingFileQueue_.Push(nullptr);
     ScanFileSingleton::GetInstance().SetCompletedFlag(true);
     int ret = 0;
     EXPECT_CALL(*funcMock_, write(_, _, _)).WillRepeatedly([](int, const void *, size_t size) -> ssize_t {
@@ -479,9 +479,9 @@ HWTEST_F(ExtExtensionNewTest, Ext_Extension_DoBackupTask_Test_0300, testing::ext
     struct stat sta;
     shared_ptr<IFileInfo> file1 = make_shared<FileInfo>(filename, filePath, sta, false);
     shared_ptr<IFileInfo> file2 = make_shared<FileInfo>(filename, filePath, sta, true);
-    ScanFileSingleton::GetInstance().pendingFileQueue_.push(file1);
-    ScanFileSingleton::GetInstance().pendingFileQueue_.push(file2);
-    ScanFileSingleton::GetInstance().pendingFileQueue_.push(nullptr);
+    ScanFileSingleton::GetInstance().pendingFileQueue_.Push(file1);
+    ScanFileSingleton::GetInstance().pendingFileQueue_.Push(file2);
+    ScanFileSingleton::GetInstance().pendingFileQueue_.Push(nullptr);
     ScanFileSingleton::GetInstance().SetCompletedFlag(true);
     int ret = 0;
     EXPECT_CALL(*funcMock_, open(_, _)).WillRepeatedly([](const char* path, int mode) -> int {
@@ -1112,7 +1112,7 @@ HWTEST_F(ExtExtensionNewTest, Ext_Extension_RestoreBigFileAfter_Test_0000, testi
         errno = ERR_NO_PERMISSION;
         return -1;
     }));
-    extExtension_->RestoreBigFileAfter(filePath, sta);
+    EXPECT_FALSE(extExtension_->RestoreBigFileAfter(filePath, sta));
     EXPECT_NE(extExtension_->errFileInfos_.find(filePath), extExtension_->errFileInfos_.end());
 
     // 2
@@ -1123,9 +1123,101 @@ HWTEST_F(ExtExtensionNewTest, Ext_Extension_RestoreBigFileAfter_Test_0000, testi
         return 100;
     }));
     EXPECT_CALL(*funcMock_, futimens(_, _)).WillOnce(Return(0));
-    extExtension_->RestoreBigFileAfter(filePath, sta);
+    EXPECT_TRUE(extExtension_->RestoreBigFileAfter(filePath, sta));
     EXPECT_EQ(extExtension_->errFileInfos_.find(filePath), extExtension_->errFileInfos_.end());
 
     GTEST_LOG_(INFO) << "ExtExtensionNewTest-end Ext_Extension_RestoreBigFileAfter_Test_0000";
 }
-}
\ No newline at end of file
+
+/**
+ * @tc.number: Ext_Extension_JoinPacketLanes_Test_0100
+ * @tc.name: Ext_Extension_JoinPacketLanes_Test_0100
+ * @tc.desc: 测试多路打包汇总耗时取最慢一路, 以及某一路异常时抛出
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(ExtExtensionNewTest, Ext_Extension_JoinPacketLanes_Test_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "ExtExtensionNewTest-begin Ext_Extension_JoinPacketLanes_Test_0100";
+    ASSERT_TRUE(extExtension_ != nullptr);
+    std::vector<std::thread> lanes;
+    lanes.emplace_back([]() {});
+    lanes.emplace_back([]() {});
+    std::vector<uint64_t> laneTarUs = {100, 300};
+    std::vector<std::exception_ptr> laneErrs(laneTarUs.size(), nullptr);
+    EXPECT_EQ(extExtension_->JoinPacketLanes(lanes, laneTarUs, laneErrs), 300U);
+
+    lanes.clear();
+    lanes.emplace_back([]() {});
+    laneErrs = {std::make_exception_ptr(BError(BError::Codes::EXT_INVAL_ARG))};
+    EXPECT_THROW(extExtension_->JoinPacketLanes(lanes, laneTarUs, laneErrs), BError);
+    GTEST_LOG_(INFO) << "ExtExtensionNewTest-end Ext_Extension_JoinPacketLanes_Test_0100";
+}
+
+/**
+ * @tc.number: Ext_Extension_SerializeReportCb_Test_0100
+ * @tc.name: Ext_Extension_SerializeReportCb_Test_0100
+ * @tc.desc: 测试多路打包并发上报错误文件时上报回调被串行调用
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(ExtExtensionNewTest, Ext_Extension_SerializeReportCb_Test_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "ExtExtensionNewTest-begin Ext_Extension_SerializeReportCb_Test_0100";
+    std::atomic<int> inFlight = 0;
+    std::atomic<bool> overlapped = false;
+    std::vector<std::string> reported;
+    auto reportCb = BackupExtExtension::SerializeReportCb([&](std::string msg, int err) {
+        if (inFlight.fetch_add(1) != 0) {
+            overlapped = true;
+        }
+        reported.emplace_back(msg);
+        std::this_thread::sleep_for(std::chrono::microseconds(10));
+        inFlight.fetch_sub(1);
+    });
+    const int laneCount = 4;
+    const int reportCount = 50;
+    std::vector<std::thread> lanes;
+    for (int lane = 0; lane < laneCount; lane++) {
+        lanes.emplace_back([&reportCb, lane]() {
+            for (int i = 0; i < reportCount; i++) {
+                reportCb("lane_" + std::to_string(lane), EPERM);
+            }
+        });
+    }
+    for (auto &lane : lanes) {
+        lane.join();
+    }
+    EXPECT_FALSE(overlapped.load());
+    EXPECT_EQ(reported.size(), static_cast<size_t>(laneCount * reportCount));
+    GTEST_LOG_(INFO) << "ExtExtensionNewTest-end Ext_Extension_SerializeReportCb_Test_0100";
+}
+
+/**
+ * @tc.number: Ext_Extension_ProduceSmallFilePacks_Test_0100
+ * @tc.name: Ext_Extension_ProduceSmallFilePacks_Test_0100
+ * @tc.desc: 测试打包各路已退出(队列关闭)时生产侧停止投递而不阻塞
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(ExtExtensionNewTest, Ext_Extension_ProduceSmallFilePacks_Test_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "ExtExtensionNewTest-begin Ext_Extension_ProduceSmallFilePacks_Test_0100";
+    ASSERT_TRUE(extExtension_ != nullptr);
+    std::vector<std::shared_ptr<ISmallFileInfo>> allSmallFile;
+    for (uint32_t i = 0; i < BConstants::MAX_FILE_COUNT * 3; i++) {
+        allSmallFile.emplace_back(std::make_shared<SmallFileInfo>("/data/small_" + std::to_string(i), 1));
+    }
+    BoundedQueue<std::vector<std::shared_ptr<ISmallFileInfo>>> packQueue(3);
+    extExtension_->ProduceSmallFilePacks(allSmallFile, packQueue);
+    EXPECT_EQ(packQueue.Size(), 3U);
+
+    packQueue.Close();
+    extExtension_->ProduceSmallFilePacks(allSmallFile, packQueue);
+    EXPECT_EQ(packQueue.Size(), 3U);
+    GTEST_LOG_(INFO) << "ExtExtensionNewTest-end Ext_Extension_ProduceSmallFilePacks_Test_0100";
+}
+}
@@ -709,4 +709,125 @@ HWTEST_F(ExtExtensionTest, Ext_Extension_FDSan_ReportAncoAppFileReady_Test_1301,
     }
     GTEST_LOG_(INFO) << "ExtExtensionTest-end Ext_Extension_FDSan_ReportAncoAppFileReady_Test_1301";
 }
+
+/**
+ * @tc.number: SUB_Ext_Extension_RestoreJournal_0100
+ * @tc.name: Ext_Extension_RestoreJournal_Test_0100
+ * @tc.desc: 测试同一会话内重新投递时跳过已恢复的文件, 会话变化时日志失效, 恢复结束后不论成败都删除恢复日志
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(ExtExtensionTest, Ext_Extension_RestoreJournal_Test_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "ExtExtensionTest-begin Ext_Extension_RestoreJournal_Test_0100";
+    string restoreDir = string(BConstants::PATH_BUNDLE_BACKUP_HOME).append(BConstants::SA_BUNDLE_BACKUP_RESTORE);
+    string journalPath = GetRestoreJournalPath("com.example.app2backup");
+    ASSERT_TRUE(ForceCreateDirectory(restoreDir));
+    {
+        ofstream manage(INDEX_FILE_RESTORE, ios::out | ios::trunc);
+        manage << "{\"1.tar\":{}}";
+    }
+    auto extExtension = sptr<BackupExtExtension>(new BackupExtExtension(nullptr, "com.example.app2backup"));
+    extExtension->OpenRestoreJournal();
+    EXPECT_EQ(extExtension->restoreJournal_, nullptr);
+
+    auto extension = make_shared<ExtBackup>();
+    extExtension->extension_ = extension;
+    extExtension->OpenRestoreJournal();
+    EXPECT_EQ(extExtension->restoreJournal_, nullptr);
+
+    extension->callerBundleName_ = "com.example.caller";
+    extension->sessionActiveTime_ = "100";
+    extExtension->OpenRestoreJournal();
+    ASSERT_NE(extExtension->restoreJournal_, nullptr);
+    EXPECT_FALSE(extExtension->SkipRestored("1.tar", "10:1.0:10"));
+    extExtension->CommitRestored("1.tar", "10:1.0:10");
+    extExtension->CommitRestored("2.tar", "");
+    EXPECT_EQ(extExtension->restoreJournal_->GetCommittedCount(), 1U);
+
+    // 同一会话内重新投递, 已恢复的文件被跳过, 指纹变化或无指纹的文件重新恢复
+    extExtension->OpenRestoreJournal();
+    ASSERT_NE(extExtension->restoreJournal_, nullptr);
+    EXPECT_TRUE(extExtension->SkipRestored("1.tar", "10:1.0:10"));
+    EXPECT_FALSE(extExtension->SkipRestored("1.tar", "10:2.0:10"));
+    EXPECT_FALSE(extExtension->SkipRestored("2.tar", ""));
+    EXPECT_EQ(extExtension->restoreSkippedCount_, 1U);
+
+    // 另一次会话恢复同一份数据时之前的记录作废
+    extension->sessionActiveTime_ = "200";
+    extExtension->OpenRestoreJournal();
+    ASSERT_NE(extExtension->restoreJournal_, nullptr);
+    EXPECT_FALSE(extExtension->SkipRestored("1.tar", "10:1.0:10"));
+    extExtension->CommitRestored("1.tar", "10:1.0:10");
+
+    // 恢复失败结束时同样删除日志
+    extExtension->RecordRestoreFailed("3.tar");
+    extExtension->FinishRestoreJournal(BError(BError::Codes::EXT_INVAL_ARG).GetCode());
+    EXPECT_EQ(extExtension->restoreJournal_, nullptr);
+    EXPECT_NE(access(journalPath.c_str(), F_OK), 0);
+    extExtension->extension_ = nullptr;
+    ForceRemoveDirectory(restoreDir);
+    GTEST_LOG_(INFO) << "ExtExtensionTest-end Ext_Extension_RestoreJournal_Test_0100";
+}
+
+/**
+ * @tc.number: SUB_Ext_Extension_InitStreamKeyProvider_0100
+ * @tc.name: Ext_Extension_InitStreamKeyProvider_Test_0100
+ * @tc.desc: 测试默认不加密, 调用方下发合法密钥时才加密, 密钥非法时不加密
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(ExtExtensionTest, Ext_Extension_InitStreamKeyProvider_Test_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "ExtExtensionTest-begin Ext_Extension_InitStreamKeyProvider_Test_0100";
+    auto extension = make_shared<ExtBackup>();
+    auto extExtension = sptr<BackupExtExtension>(new BackupExtExtension(extension, "com.example.app2backup"));
+    EXPECT_EQ(BEncryption::GetKeyProvider(), nullptr);
+    EXPECT_EQ(BEncryption::GetCurrentKey(), nullptr);
+
+    extension->streamKey_ = "k1:" + string(BEncryption::StreamCipher::KEY_SIZE * 2, 'a');
+    extExtension->InitStreamKeyProvider();
+    auto key = BEncryption::GetCurrentKey();
+    ASSERT_NE(key, nullptr);
+    EXPECT_EQ(key->keyId, "k1");
+
+    extension->streamKey_ = "k1:abc";
+    extExtension->InitStreamKeyProvider();
+    EXPECT_EQ(BEncryption::GetCurrentKey(), nullptr);
+    extension->streamKey_.clear();
+    extExtension->InitStreamKeyProvider();
+    EXPECT_EQ(BEncryption::GetKeyProvider(), nullptr);
+    GTEST_LOG_(INFO) << "ExtExtensionTest-end Ext_Extension_InitStreamKeyProvider_Test_0100";
+}
+
+/**
+ * @tc.number: SUB_Ext_Extension_GetTarFingerprint_0100
+ * @tc.name: Ext_Extension_GetTarFingerprint_Test_0100
+ * @tc.desc: 测试tar包指纹包含索引中的大小、修改时间和收到的tar包大小, 索引缺失或文件不存在时为空
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(ExtExtensionTest, Ext_Extension_GetTarFingerprint_Test_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "ExtExtensionTest-begin Ext_Extension_GetTarFingerprint_Test_0100";
+    string tarName = PATH + TAR_FILE;
+    {
+        ofstream tar(tarName, ios::out | ios::trunc);
+        tar << "abc";
+    }
+    ExtManageInfo info;
+    info.hashName = TAR_FILE;
+    info.sta.st_size = 10;
+    info.sta.st_mtim.tv_sec = 1;
+    info.sta.st_mtim.tv_nsec = 2;
+    vector<ExtManageInfo> extManageInfo = { info };
+    EXPECT_EQ(GetTarFingerprint(tarName, TAR_FILE, extManageInfo), "10:1.2:3");
+    EXPECT_EQ(GetTarFingerprint(tarName, "2.tar", extManageInfo), "");
+    EXPECT_EQ(GetTarFingerprint(PATH + "2.tar", TAR_FILE, extManageInfo), "");
+    remove(tarName.c_str());
+    GTEST_LOG_(INFO) << "ExtExtensionTest-end Ext_Extension_GetTarFingerprint_Test_0100";
+}
 } // namespace OHOS::FileManagement::Backup
\ No newline at end of file
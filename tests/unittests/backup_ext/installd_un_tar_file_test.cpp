@@ -19,12 +19,15 @@
 #include "installd_un_tar_file.h"
 
 #include <dirent.h>
+#include <fcntl.h>
 #include <file_ex.h>
 #include <filesystem>
 #include <unistd.h>
 
+#include "b_encryption/b_stream_cipher.h"
 #include "b_error/b_error.h"
 #include "test_manager.h"
+#include "unique_fd.h"
 
 #include <sys/stat.h>
 
@@ -366,4 +369,88 @@ HWTEST_F(InstalldUnTarFileTest, Installd_Un_Tar_File_ProcessTarBlock_0100, testi
     }
     GTEST_LOG_(INFO) << "InstalldUnTarFileTest-end Installd_Un_Tar_File_ProcessTarBlock_0100";
 }
-} // namespace OHOS::FileManagement::Backup
\ No newline at end of file
+
+/**
+ * @tc.number: Installd_Un_Tar_File_HardLink_0100
+ * @tc.name: Installd_Un_Tar_File_HardLink_0100
+ * @tc.desc: 测试硬链接恢复为指向本次解包文件的硬链接, 目标未写入时不改动已有的文件
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(InstalldUnTarFileTest, Installd_Un_Tar_File_HardLink_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "InstalldUnTarFileTest-begin Installd_Un_Tar_File_HardLink_0100";
+    const TestManager tm("Installd_Un_Tar_File_HardLink_0100");
+    const string rootPath = tm.GetRootDirCurTest();
+    const string testDir = rootPath + "testLink/";
+    ASSERT_EQ(mkdir(testDir.c_str(), S_IRWXU), 0);
+    ASSERT_TRUE(SaveStringToFile(testDir + "a.txt", "hello"));
+    ASSERT_EQ(link((testDir + "a.txt").c_str(), (testDir + "b.txt").c_str()), 0);
+    const string tarFile = rootPath + "link.tar";
+    // 按顺序打包, b.txt记录为指向a.txt的硬链接
+    ASSERT_EQ(system(("tar -cf " + tarFile + " -C " + rootPath + " testLink/a.txt testLink/b.txt").c_str()), 0);
+
+    const string out = rootPath + "out/";
+    UnTarFile unTarFile(nullptr);
+    EXPECT_EQ(unTarFile.UnSplitTar(tarFile, out), 0);
+    struct stat staA = {};
+    struct stat staB = {};
+    ASSERT_EQ(stat((out + "testLink/a.txt").c_str(), &staA), 0);
+    ASSERT_EQ(stat((out + "testLink/b.txt").c_str(), &staB), 0);
+    EXPECT_EQ(staA.st_ino, staB.st_ino);
+
+    const string failOut = rootPath + "failout/";
+    for (const string &dir : {failOut, failOut + "testLink", failOut + "testLink/a.txt"}) {
+        ASSERT_EQ(mkdir(dir.c_str(), S_IRWXU), 0);
+    }
+    ASSERT_TRUE(SaveStringToFile(failOut + "testLink/b.txt", "old"));
+    UnTarFile failUnTarFile(nullptr);
+    failUnTarFile.UnSplitTar(tarFile, failOut);
+    string content;
+    EXPECT_TRUE(LoadStringFromFile(failOut + "testLink/b.txt", content));
+    EXPECT_EQ(content, "old");
+    GTEST_LOG_(INFO) << "InstalldUnTarFileTest-end Installd_Un_Tar_File_HardLink_0100";
+}
+
+/**
+ * @tc.number: Installd_Un_Tar_File_Encrypt_0100
+ * @tc.name: Installd_Un_Tar_File_Encrypt_0100
+ * @tc.desc: 测试加密的tar包使用调用方下发的密钥解包, 没有密钥时解包失败
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(InstalldUnTarFileTest, Installd_Un_Tar_File_Encrypt_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "InstalldUnTarFileTest-begin Installd_Un_Tar_File_Encrypt_0100";
+    const TestManager tm("Installd_Un_Tar_File_Encrypt_0100");
+    const string rootPath = tm.GetRootDirCurTest();
+    ASSERT_EQ(mkdir((rootPath + "testEnc").c_str(), S_IRWXU), 0);
+    ASSERT_TRUE(SaveStringToFile(rootPath + "testEnc/a.txt", "hello encrypt"));
+    const string tarFile = rootPath + "plain.tar";
+    ASSERT_EQ(system(("tar -cf " + tarFile + " -C " + rootPath + " testEnc/a.txt").c_str()), 0);
+    auto key = BEncryption::ParseStreamKey("k1:" + string(BEncryption::StreamCipher::KEY_SIZE * 2, 'c'));
+    ASSERT_NE(key, nullptr);
+    const string encFile = rootPath + "enc.tar";
+    {
+        UniqueFd src(open(tarFile.c_str(), O_RDONLY));
+        UniqueFd dst(open(encFile.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR));
+        ASSERT_TRUE(BEncryption::StreamCipher::EncryptFile(src, dst, *key));
+    }
+
+    BEncryption::SetKeyProvider(make_shared<BEncryption::CallerKeyProvider>(key));
+    const string out = rootPath + "out/";
+    UnTarFile unTarFile(nullptr);
+    EXPECT_EQ(unTarFile.UnSplitTar(encFile, out), 0);
+    string content;
+    EXPECT_TRUE(LoadStringFromFile(out + "testEnc/a.txt", content));
+    EXPECT_EQ(content, "hello encrypt");
+
+    BEncryption::SetKeyProvider(nullptr);
+    UnTarFile noKeyUnTarFile(nullptr);
+    EXPECT_NE(noKeyUnTarFile.UnSplitTar(encFile, rootPath + "out2/"), 0);
+    EXPECT_NE(access((rootPath + "out2/testEnc/a.txt").c_str(), F_OK), 0);
+    GTEST_LOG_(INFO) << "InstalldUnTarFileTest-end Installd_Un_Tar_File_Encrypt_0100";
+}
+} // namespace OHOS::FileManagement::Backup
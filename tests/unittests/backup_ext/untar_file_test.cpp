@@ -17,6 +17,8 @@
 #include <gtest/gtest.h>
 
 #include "b_error/b_error.h"
+#include "b_filesystem/b_dir.h"
+#include "directory_ex.h"
 #include "file_ex.h"
 #include "test_manager.h"
 #include "untar_file.h"
@@ -54,6 +56,7 @@ static void ClearCache()
     UntarFile::GetInstance().tarFileBlockCnt_ = 0;
     UntarFile::GetInstance().pos_ = 0;
     UntarFile::GetInstance().readCnt_ = 0;
+    UntarFile::GetInstance().restorePaths_.clear();
     if (UntarFile::GetInstance().tarFilePtr_ != nullptr) {
         fclose(UntarFile::GetInstance().tarFilePtr_);
         UntarFile::GetInstance().tarFilePtr_ = nullptr;
@@ -69,6 +72,9 @@ static void ClearCache()
     TarFile::GetInstance().currentTarFileSize_ = 0;
     TarFile::GetInstance().tarFileCount_ = 0;
     TarFile::GetInstance().currentFileName_.clear();
+    TarFile::GetInstance().digestAlgorithm_ = BEncryption::DigestAlgorithm::NONE;
+    TarFile::GetInstance().tarIndex_.clear();
+    TarFile::GetInstance().linkTargets_.clear();
     if (TarFile::GetInstance().currentTarFile_ != nullptr) {
         fclose(TarFile::GetInstance().currentTarFile_);
         TarFile::GetInstance().currentTarFile_ = nullptr;
@@ -763,4 +769,405 @@ HWTEST_F(UntarFileTest, SUB_Untar_File_ParsePaxBlock_0300, testing::ext::TestSiz
     }
     GTEST_LOG_(INFO) << "UntarFileTest-end SUB_Untar_File_ParsePaxBlock_0300";
 }
+
+static bool FlipTarByte(const string &tarFile, const string &content)
+{
+    string data;
+    if (!LoadStringFromFile(tarFile, data)) {
+        return false;
+    }
+    size_t pos = data.find(content);
+    if (pos == string::npos) {
+        return false;
+    }
+    data[pos] ^= 1;
+    return SaveStringToFile(tarFile, data);
+}
+
+/**
+ * @tc.number: SUB_Untar_File_Digest_0100
+ * @tc.name: SUB_Untar_File_Digest_0100
+ * @tc.desc: 测试打包时写入文件内容摘要, 解包时校验通过; tar包内容被篡改时只上报被篡改的文件
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(UntarFileTest, SUB_Untar_File_Digest_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "UntarFileTest-begin SUB_Untar_File_Digest_0100";
+    TestManager tm("SUB_Untar_File_Digest_0100");
+    string root = tm.GetRootDirCurTest();
+    string testDir = root + "testdir/";
+    ASSERT_TRUE(ForceCreateDirectory(testDir));
+    string aFile = testDir + "a.txt";
+    string longFile = testDir + string(TNAME_LEN, 'l') + ".txt";
+    string bigContent;
+    for (int i = 0; bigContent.size() < 3 * READ_BUFF_SIZE / 2; i++) {
+        bigContent.append(to_string(i));
+    }
+    ASSERT_TRUE(SaveStringToFile(aFile, "hello digest"));
+    ASSERT_TRUE(SaveStringToFile(longFile, bigContent));
+    vector<string> smallFiles = {aFile, longFile};
+    auto reportCb = [](std::string msg, int err) {};
+
+    for (auto algorithm : {BEncryption::DigestAlgorithm::XXH64, BEncryption::DigestAlgorithm::SHA256}) {
+        ClearCache();
+        TarFile::GetInstance().SetDigestAlgorithm(algorithm);
+        TarMap tarMap {};
+        ASSERT_TRUE(TarFile::GetInstance().Packet(smallFiles, "digest", root, tarMap, reportCb));
+        string tarFile = root + "digest.0.tar";
+        auto [ret, fileInfos, errInfos] = UntarFile::GetInstance().UnPacket(tarFile, root + "out");
+        EXPECT_EQ(ret, 0);
+        EXPECT_EQ(fileInfos.size(), smallFiles.size());
+        EXPECT_TRUE(errInfos.empty());
+
+        ASSERT_TRUE(FlipTarByte(tarFile, "hello digest"));
+        auto [badRet, badFileInfos, badErrInfos] = UntarFile::GetInstance().UnPacket(tarFile, root + "out");
+        EXPECT_EQ(badRet, 0);
+        EXPECT_EQ(badFileInfos.size(), smallFiles.size());
+        ASSERT_EQ(badErrInfos.size(), 1U);
+        EXPECT_TRUE(badErrInfos.begin()->first.rfind("a.txt") != string::npos);
+        EXPECT_EQ(badErrInfos.begin()->second, vector<int> {ERR_DIGEST_MISMATCH});
+    }
+    ClearCache();
+    GTEST_LOG_(INFO) << "UntarFileTest-end SUB_Untar_File_Digest_0100";
+}
+
+/**
+ * @tc.number: SUB_Untar_File_Encrypt_0100
+ * @tc.name: SUB_Untar_File_Encrypt_0100
+ * @tc.desc: 测试设置密钥后打出的tar包为密文, 解包后内容摘要校验通过; 找不到密钥时解包失败
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(UntarFileTest, SUB_Untar_File_Encrypt_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "UntarFileTest-begin SUB_Untar_File_Encrypt_0100";
+    TestManager tm("SUB_Untar_File_Encrypt_0100");
+    string root = tm.GetRootDirCurTest();
+    string testDir = root + "testdir/";
+    ASSERT_TRUE(ForceCreateDirectory(testDir));
+    string aFile = testDir + "a.txt";
+    string bigFile = testDir + "big.txt";
+    string bigContent;
+    for (int i = 0; bigContent.size() < 3 * READ_BUFF_SIZE / 2; i++) {
+        bigContent.append(to_string(i));
+    }
+    ASSERT_TRUE(SaveStringToFile(aFile, "hello encrypt"));
+    ASSERT_TRUE(SaveStringToFile(bigFile, bigContent));
+    vector<string> smallFiles = {aFile, bigFile};
+    auto reportCb = [](std::string msg, int err) {};
+
+    ClearCache();
+    auto key = BEncryption::ParseStreamKey("k1:" + string(BEncryption::StreamCipher::KEY_SIZE * 2, 'a'));
+    ASSERT_NE(key, nullptr);
+    BEncryption::SetKeyProvider(make_shared<BEncryption::CallerKeyProvider>(key));
+    TarFile::GetInstance().SetStreamKey(BEncryption::GetCurrentKey());
+    TarFile::GetInstance().SetDigestAlgorithm(BEncryption::DigestAlgorithm::XXH64);
+    TarMap tarMap {};
+    ASSERT_TRUE(TarFile::GetInstance().Packet(smallFiles, "enc", root, tarMap, reportCb));
+    TarFile::GetInstance().SetStreamKey(nullptr);
+    TarFile::GetInstance().SetDigestAlgorithm(BEncryption::DigestAlgorithm::NONE);
+    string tarFile = root + "enc.0.tar";
+    struct stat sta = {};
+    ASSERT_EQ(stat(tarFile.c_str(), &sta), 0);
+    EXPECT_EQ(std::get<1>(tarMap["enc.0.tar"]).st_size, sta.st_size);
+    string tarContent;
+    ASSERT_TRUE(LoadStringFromFile(tarFile, tarContent));
+    EXPECT_EQ(tarContent.find("hello encrypt"), string::npos);
+    EXPECT_EQ(tarContent.find("a.txt"), string::npos);
+
+    auto [ret, fileInfos, errInfos] = UntarFile::GetInstance().UnPacket(tarFile, root + "out");
+    EXPECT_EQ(ret, 0);
+    EXPECT_EQ(fileInfos.size(), smallFiles.size());
+    // 打包时写入了内容摘要, 解包无错误说明解密出的内容与原文件一致
+    EXPECT_TRUE(errInfos.empty());
+
+    ClearCache();
+    auto otherKey = BEncryption::ParseStreamKey("k2:" + string(BEncryption::StreamCipher::KEY_SIZE * 2, 'b'));
+    BEncryption::SetKeyProvider(make_shared<BEncryption::CallerKeyProvider>(otherKey));
+    auto [noKeyRet, noKeyInfos, noKeyErrInfos] = UntarFile::GetInstance().UnPacket(tarFile, root + "out2");
+    EXPECT_EQ(noKeyRet, ENOKEY);
+    EXPECT_TRUE(noKeyInfos.empty());
+    BEncryption::SetKeyProvider(nullptr);
+    ClearCache();
+    GTEST_LOG_(INFO) << "UntarFileTest-end SUB_Untar_File_Encrypt_0100";
+}
+
+/**
+ * @tc.number: SUB_Untar_File_TarIndex_0100
+ * @tc.name: SUB_Untar_File_TarIndex_0100
+ * @tc.desc: 测试tar包结束标记后写入索引, tar工具可正常解包; 选择性解包按索引定位, 不解析未选中的文件
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(UntarFileTest, SUB_Untar_File_TarIndex_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "UntarFileTest-begin SUB_Untar_File_TarIndex_0100";
+    TestManager tm("SUB_Untar_File_TarIndex_0100");
+    string root = tm.GetRootDirCurTest();
+    string testDir = root + "testdir/";
+    ASSERT_TRUE(ForceCreateDirectory(testDir + "sub"));
+    const int fileCnt = 8;
+    vector<string> srcFiles = {testDir + "sub"};
+    for (int i = 0; i < fileCnt; i++) {
+        srcFiles.emplace_back(testDir + "f" + to_string(i) + ".txt");
+        ASSERT_TRUE(SaveStringToFile(srcFiles.back(), "content " + to_string(i)));
+    }
+    auto reportCb = [](std::string msg, int err) {};
+    ClearCache();
+    TarFile::GetInstance().SetDigestAlgorithm(BEncryption::DigestAlgorithm::XXH64);
+    TarMap tarMap {};
+    ASSERT_TRUE(TarFile::GetInstance().Packet(srcFiles, "index", root, tarMap, reportCb));
+    string tarFile = root + "index.0.tar";
+
+    string gnuDir = root + "gnu";
+    ASSERT_TRUE(ForceCreateDirectory(gnuDir));
+    EXPECT_EQ(system(("tar -xf " + tarFile + " -C " + gnuDir).c_str()), 0);
+    string gnuContent;
+    EXPECT_TRUE(LoadStringFromFile(gnuDir + srcFiles.back(), gnuContent));
+    EXPECT_EQ(gnuContent, "content " + to_string(fileCnt - 1));
+
+    auto &untar = UntarFile::GetInstance();
+    untar.tarFilePtr_ = fopen(tarFile.c_str(), "rb");
+    ASSERT_NE(untar.tarFilePtr_, nullptr);
+    ASSERT_EQ(untar.CheckAndFillTarSize(), 0);
+    vector<TarIndexEntry> index;
+    ASSERT_TRUE(untar.ReadTarIndex(index));
+    ASSERT_EQ(index.size(), srcFiles.size());
+    EXPECT_EQ(index[0].typeFlag, DIRTYPE);
+    for (size_t i = 1; i < index.size(); i++) {
+        EXPECT_EQ(index[i].nameHash, TarFile::IndexNameHash(srcFiles[i]));
+    }
+    ClearCache();
+
+    // 破坏未选中文件的tar头, 按索引解包时不会读到它
+    const int brokenFile = 2;
+    const off_t magicPos = TNAME_LEN + TMODE_LEN + TUID_LEN + TGID_LEN + TSIZE_LEN + MTIME_LEN + CHKSUM_LEN + 1 +
+        TNAME_LEN;
+    FILE *f = fopen(tarFile.c_str(), "rb+");
+    ASSERT_NE(f, nullptr);
+    EXPECT_EQ(fseeko(f, index[brokenFile + 1].offset + magicPos, SEEK_SET), 0);
+    EXPECT_EQ(fputc('X', f), 'X');
+    fclose(f);
+    const int selectedFile = 6;
+    unordered_map<string, struct ReportFileInfo> includes;
+    includes[srcFiles[selectedFile + 1].substr(1)] = {};
+    auto [ret, fileInfos, errInfos] = untar.IncrementalUnPacket(tarFile, root + "out", includes);
+    EXPECT_EQ(ret, 0);
+    ASSERT_EQ(fileInfos.size(), 2U); // 目录和选中的文件
+    EXPECT_TRUE(errInfos.empty());
+    EXPECT_TRUE(fileInfos.begin()->first.rfind("f" + to_string(selectedFile) + ".txt") != string::npos);
+
+    // 去掉索引后按顺序解析, 在被破坏的tar头处停止
+    struct stat sta = {};
+    ASSERT_EQ(stat(tarFile.c_str(), &sta), 0);
+    ASSERT_EQ(truncate(tarFile.c_str(), sta.st_size - TAR_INDEX_TRAILER_SIZE -
+        static_cast<off_t>(index.size() * TAR_INDEX_ENTRY_SIZE)), 0);
+    auto [scanRet, scanFileInfos, scanErrInfos] = untar.IncrementalUnPacket(tarFile, root + "out", includes);
+    EXPECT_EQ(scanFileInfos.size(), 1U);
+    ClearCache();
+    GTEST_LOG_(INFO) << "UntarFileTest-end SUB_Untar_File_TarIndex_0100";
+}
+
+/**
+ * @tc.number: SUB_Untar_File_RestorePaths_0100
+ * @tc.name: SUB_Untar_File_RestorePaths_0100
+ * @tc.desc: 测试选择性恢复, 全量和增量解包都只恢复与恢复路径匹配的文件和目录
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(UntarFileTest, SUB_Untar_File_RestorePaths_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "UntarFileTest-begin SUB_Untar_File_RestorePaths_0100";
+    TestManager tm("SUB_Untar_File_RestorePaths_0100");
+    string root = tm.GetRootDirCurTest();
+    string testDir = root + "testdir/";
+    ASSERT_TRUE(ForceCreateDirectory(testDir + "keep"));
+    ASSERT_TRUE(ForceCreateDirectory(testDir + "drop"));
+    vector<string> srcFiles = {testDir + "keep", testDir + "drop", testDir + "keep/a.txt", testDir + "keep/b.txt",
+        testDir + "drop/c.txt", testDir + "top.txt"};
+    for (size_t i = 2; i < srcFiles.size(); i++) {
+        ASSERT_TRUE(SaveStringToFile(srcFiles[i], srcFiles[i]));
+    }
+    auto reportCb = [](std::string msg, int err) {};
+    ClearCache();
+    TarMap tarMap {};
+    ASSERT_TRUE(TarFile::GetInstance().Packet(srcFiles, "select", root, tarMap, reportCb));
+    string tarFile = root + "select.0.tar";
+
+    vector<string> restorePaths = {testDir + "keep/", testDir.substr(1) + "top.txt"};
+    BDir::PreDealExcludes(restorePaths);
+    EXPECT_TRUE(UntarFile::IsInRestorePaths({}, srcFiles[4]));
+    EXPECT_TRUE(UntarFile::IsInRestorePaths(restorePaths, srcFiles[2].substr(1)));
+    EXPECT_FALSE(UntarFile::IsInRestorePaths(restorePaths, srcFiles[4].substr(1)));
+
+    auto &untar = UntarFile::GetInstance();
+    untar.SetRestorePaths(restorePaths);
+    auto [ret, fileInfos, errInfos] = untar.UnPacket(tarFile, root + "out");
+    EXPECT_EQ(ret, 0);
+    EXPECT_EQ(fileInfos.size(), 4U); // keep目录, keep下的两个文件和top.txt
+    for (const auto &[fileName, fileSize] : fileInfos) {
+        EXPECT_EQ(fileName.find("drop"), string::npos);
+    }
+
+    unordered_map<string, struct ReportFileInfo> includes;
+    includes[srcFiles[2].substr(1)] = {};
+    includes[srcFiles[4].substr(1)] = {};
+    auto [incRet, incFileInfos, incErrInfos] = untar.IncrementalUnPacket(tarFile, root + "incout", includes);
+    EXPECT_EQ(incRet, 0);
+    ASSERT_EQ(incFileInfos.size(), 2U); // keep目录和a.txt
+    EXPECT_NE(incFileInfos.rbegin()->first.rfind("keep/a.txt"), string::npos);
+    ClearCache();
+    GTEST_LOG_(INFO) << "UntarFileTest-end SUB_Untar_File_RestorePaths_0100";
+}
+
+/**
+ * @tc.number: SUB_Untar_File_HardLink_0100
+ * @tc.name: SUB_Untar_File_HardLink_0100
+ * @tc.desc: 测试同一inode的多个路径只写入一份内容, tar工具和解包时都恢复为硬链接
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(UntarFileTest, SUB_Untar_File_HardLink_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "UntarFileTest-begin SUB_Untar_File_HardLink_0100";
+    TestManager tm("SUB_Untar_File_HardLink_0100");
+    string root = tm.GetRootDirCurTest();
+    string testDir = root + "testdir/";
+    ASSERT_TRUE(ForceCreateDirectory(testDir));
+    vector<string> srcFiles = {testDir + "a.txt", testDir + "b.txt", testDir + "c.txt"};
+    string content(BLOCK_SIZE * 4, 'x');
+    ASSERT_TRUE(SaveStringToFile(srcFiles[0], content));
+    ASSERT_EQ(link(srcFiles[0].c_str(), srcFiles[1].c_str()), 0);
+    ASSERT_TRUE(SaveStringToFile(srcFiles[2], content));
+    auto reportCb = [](std::string msg, int err) {};
+    ClearCache();
+    TarMap tarMap {};
+    ASSERT_TRUE(TarFile::GetInstance().Packet(srcFiles, "link", root, tarMap, reportCb));
+    string tarFile = root + "link.0.tar";
+    struct stat tarSta = {};
+    ASSERT_EQ(stat(tarFile.c_str(), &tarSta), 0);
+    // 3个文件头, 2份内容, 结束标记和3项索引
+    EXPECT_EQ(tarSta.st_size, static_cast<off_t>(BLOCK_SIZE * 3 + content.size() * 2 + TAR_END_BLOCK_SIZE +
+        TAR_INDEX_ENTRY_SIZE * 3 + TAR_INDEX_TRAILER_SIZE));
+
+    string gnuDir = root + "gnu";
+    ASSERT_TRUE(ForceCreateDirectory(gnuDir));
+    EXPECT_EQ(system(("tar -xf " + tarFile + " -C " + gnuDir).c_str()), 0);
+    struct stat gnuSta = {};
+    ASSERT_EQ(stat((gnuDir + srcFiles[1]).c_str(), &gnuSta), 0);
+    EXPECT_EQ(gnuSta.st_nlink, 2U);
+    EXPECT_EQ(gnuSta.st_size, static_cast<off_t>(content.size()));
+
+    auto &untar = UntarFile::GetInstance();
+    string out = root + "out";
+    auto [ret, fileInfos, errInfos] = untar.UnPacket(tarFile, out);
+    EXPECT_EQ(ret, 0);
+    EXPECT_TRUE(errInfos.empty());
+    // 硬链接同样计入恢复的文件
+    EXPECT_EQ(fileInfos.size(), srcFiles.size());
+    EXPECT_NE(fileInfos.find(untar.GenRealPath(out, srcFiles[1])), fileInfos.end());
+    struct stat staA = {};
+    struct stat staB = {};
+    ASSERT_EQ(stat(untar.GenRealPath(out, srcFiles[0]).c_str(), &staA), 0);
+    ASSERT_EQ(stat(untar.GenRealPath(out, srcFiles[1]).c_str(), &staB), 0);
+    EXPECT_EQ(staA.st_ino, staB.st_ino);
+    EXPECT_EQ(staB.st_size, static_cast<off_t>(content.size()));
+
+    unordered_map<string, struct ReportFileInfo> includes;
+    includes[srcFiles[0].substr(1)] = {};
+    includes[srcFiles[1].substr(1)] = {};
+    string incOut = root + "incout";
+    auto [incRet, incFileInfos, incErrInfos] = untar.IncrementalUnPacket(tarFile, incOut, includes);
+    EXPECT_EQ(incRet, 0);
+    EXPECT_TRUE(incErrInfos.empty());
+    EXPECT_EQ(incFileInfos.size(), includes.size());
+    ASSERT_EQ(stat(untar.GenRealPath(incOut, srcFiles[1]).c_str(), &staB), 0);
+    EXPECT_EQ(staB.st_nlink, 2U);
+    ClearCache();
+    GTEST_LOG_(INFO) << "UntarFileTest-end SUB_Untar_File_HardLink_0100";
+}
+/**
+ * @tc.number: SUB_Untar_File_HardLink_0200
+ * @tc.name: SUB_Untar_File_HardLink_0200
+ * @tc.desc: 测试只选中硬链接时补充解包其目标, 目标未写入时链接失败且不改动目的路径上已有的文件
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(UntarFileTest, SUB_Untar_File_HardLink_0200, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "UntarFileTest-begin SUB_Untar_File_HardLink_0200";
+    TestManager tm("SUB_Untar_File_HardLink_0200");
+    string root = tm.GetRootDirCurTest();
+    string testDir = root + "testdir/";
+    ASSERT_TRUE(ForceCreateDirectory(testDir));
+    vector<string> srcFiles = {testDir + "a.txt", testDir + "b.txt"};
+    string content(BLOCK_SIZE * 2, 'x');
+    ASSERT_TRUE(SaveStringToFile(srcFiles[0], content));
+    ASSERT_EQ(link(srcFiles[0].c_str(), srcFiles[1].c_str()), 0);
+    auto reportCb = [](std::string msg, int err) {};
+    ClearCache();
+    TarMap tarMap {};
+    ASSERT_TRUE(TarFile::GetInstance().Packet(srcFiles, "link", root, tarMap, reportCb));
+    string tarFile = root + "link.0.tar";
+    auto &untar = UntarFile::GetInstance();
+
+    // 只选中链接, 目标随之恢复
+    vector<string> restorePaths = {srcFiles[1]};
+    BDir::PreDealExcludes(restorePaths);
+    untar.SetRestorePaths(restorePaths);
+    string out = root + "out";
+    auto [ret, fileInfos, errInfos] = untar.UnPacket(tarFile, out);
+    untar.SetRestorePaths({});
+    EXPECT_EQ(ret, 0);
+    EXPECT_TRUE(errInfos.empty());
+    struct stat staA = {};
+    struct stat staB = {};
+    ASSERT_EQ(stat(untar.GenRealPath(out, srcFiles[0]).c_str(), &staA), 0);
+    ASSERT_EQ(stat(untar.GenRealPath(out, srcFiles[1]).c_str(), &staB), 0);
+    EXPECT_EQ(staA.st_ino, staB.st_ino);
+    EXPECT_EQ(staB.st_size, static_cast<off_t>(content.size()));
+
+    unordered_map<string, struct ReportFileInfo> includes;
+    includes[srcFiles[1].substr(1)] = {};
+    string incOut = root + "incout";
+    auto [incRet, incFileInfos, incErrInfos] = untar.IncrementalUnPacket(tarFile, incOut, includes);
+    EXPECT_EQ(incRet, 0);
+    EXPECT_TRUE(incErrInfos.empty());
+    ASSERT_EQ(stat(untar.GenRealPath(incOut, srcFiles[1]).c_str(), &staB), 0);
+    EXPECT_EQ(staB.st_size, static_cast<off_t>(content.size()));
+    EXPECT_EQ(staB.st_nlink, 2U);
+
+    // 目标无法写入时链接失败, 目的路径上已有的文件保持不变
+    string failOut = root + "failout";
+    string linkPath = untar.GenRealPath(failOut, srcFiles[1]);
+    ASSERT_TRUE(ForceCreateDirectory(untar.GenRealPath(failOut, srcFiles[0])));
+    ASSERT_TRUE(SaveStringToFile(linkPath, "old"));
+    auto [failRet, failFileInfos, failErrInfos] = untar.UnPacket(tarFile, failOut);
+    EXPECT_EQ(failRet, 0);
+    EXPECT_NE(failErrInfos.find(linkPath), failErrInfos.end());
+    string linkContent;
+    EXPECT_TRUE(LoadStringFromFile(linkPath, linkContent));
+    EXPECT_EQ(linkContent, "old");
+    EXPECT_NE(access((linkPath + ".linktmp").c_str(), F_OK), 0);
+
+    // 目的路径上已有的文件被替换为链接
+    string replaceOut = root + "replaceout";
+    ASSERT_TRUE(ForceCreateDirectory(untar.GenRealPath(replaceOut, testDir)));
+    ASSERT_TRUE(SaveStringToFile(untar.GenRealPath(replaceOut, srcFiles[1]), "old"));
+    auto [repRet, repFileInfos, repErrInfos] = untar.UnPacket(tarFile, replaceOut);
+    EXPECT_EQ(repRet, 0);
+    EXPECT_TRUE(repErrInfos.empty());
+    ASSERT_EQ(stat(untar.GenRealPath(replaceOut, srcFiles[1]).c_str(), &staB), 0);
+    EXPECT_EQ(staB.st_nlink, 2U);
+    EXPECT_EQ(staB.st_size, static_cast<off_t>(content.size()));
+    ClearCache();
+    GTEST_LOG_(INFO) << "UntarFileTest-end SUB_Untar_File_HardLink_0200";
+}
 } // namespace OHOS::FileManagement::Backup
\ No newline at end of file
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "test_manager.h"
+#include "tools_op.h"
+#include "tools_op_bench.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+
+class ToolsOpBenchTest : public testing::Test {
+public:
+    static void SetUpTestCase(void)
+    {
+        BenchRegister();
+    };
+    static void TearDownTestCase() {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+static int ExecBench(map<string, vector<string>> &mapArgToVal)
+{
+    vector<string_view> curOp = {"bench"};
+    auto &&operations = ToolsOp::GetAllOperations();
+    auto matchedOp = find_if(operations.begin(), operations.end(),
+        [&curOp](const ToolsOp &op) { return op.TryMatch(curOp); });
+    if (matchedOp == operations.end()) {
+        return -1;
+    }
+    return matchedOp->Execute(mapArgToVal);
+}
+
+/**
+ * @tc.number: SUB_backup_tools_op_bench_0100
+ * @tc.name: tools_op_bench_0100
+ * @tc.desc: 测试生成数据集后依次执行扫描、哈希、打包和解包, 解包文件数与扫描结果一致, 默认删除生成的文件
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(ToolsOpBenchTest, tools_op_bench_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "ToolsOpBenchTest-begin tools_op_bench_0100";
+    TestManager tm(__func__);
+    string root = tm.GetRootDirCurTest();
+    map<string, vector<string>> mapArgToVal = {
+        {"path", {root}},
+        {"files", {"200"}},
+        {"size", {"4096"}},
+        {"sizeDist", {"exp"}},
+        {"depth", {"2"}},
+        {"exclude", {"d0/*"}},
+    };
+    EXPECT_EQ(ExecBench(mapArgToVal), 0);
+    EXPECT_NE(access((root + "data").c_str(), F_OK), 0);
+    EXPECT_NE(access((root + "restore").c_str(), F_OK), 0);
+    GTEST_LOG_(INFO) << "ToolsOpBenchTest-end tools_op_bench_0100";
+}
+
+/**
+ * @tc.number: SUB_backup_tools_op_bench_0200
+ * @tc.name: tools_op_bench_0200
+ * @tc.desc: 测试缺少path、相对路径和非法参数时返回失败
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(ToolsOpBenchTest, tools_op_bench_0200, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "ToolsOpBenchTest-begin tools_op_bench_0200";
+    TestManager tm(__func__);
+    string root = tm.GetRootDirCurTest();
+    map<string, vector<string>> noPath;
+    EXPECT_NE(ExecBench(noPath), 0);
+    map<string, vector<string>> relative = {{"path", {"bench"}}};
+    EXPECT_NE(ExecBench(relative), 0);
+    map<string, vector<string>> badDist = {{"path", {root}}, {"sizeDist", {"normal"}}};
+    EXPECT_NE(ExecBench(badDist), 0);
+    map<string, vector<string>> badFiles = {{"path", {root}}, {"files", {"-1"}}};
+    EXPECT_NE(ExecBench(badFiles), 0);
+    GTEST_LOG_(INFO) << "ToolsOpBenchTest-end tools_op_bench_0200";
+}
+} // namespace OHOS::FileManagement::Backup
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <fcntl.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "b_error/b_error.h"
+#include "test_manager.h"
+#include "tools_restore_feeder.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+
+namespace {
+constexpr int FILE_COUNT = 64;
+constexpr size_t FILE_SIZE = 256 * 1024;
+} // namespace
+
+class ToolsRestoreFeederTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase() {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+static string MakeContent(int seed, size_t size)
+{
+    string content(size, '\0');
+    for (size_t i = 0; i < size; i++) {
+        content[i] = static_cast<char>((seed * 31 + i) % 251);
+    }
+    return content;
+}
+
+static string ReadAll(const string &path)
+{
+    string content;
+    UniqueFd fd(open(path.c_str(), O_RDONLY));
+    char buf[4096];
+    ssize_t ret = 0;
+    while (fd >= 0 && (ret = read(fd, buf, sizeof(buf))) > 0) {
+        content.append(buf, ret);
+    }
+    return content;
+}
+
+/**
+ * @tc.number: SUB_tools_restore_feeder_Copy_0100
+ * @tc.name: tools_restore_feeder_Copy_0100
+ * @tc.desc: 测试多个文件并发拷贝后内容一致, 目标文件原有的多余内容被截断, 每个任务回调一次
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(ToolsRestoreFeederTest, tools_restore_feeder_Copy_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "ToolsRestoreFeederTest-begin tools_restore_feeder_Copy_0100";
+    TestManager tm(__func__);
+    string root = tm.GetRootDirCurTest();
+    atomic<int> done = 0;
+    ToolsRestoreFeeder feeder(0, chrono::milliseconds(0));
+    for (int i = 0; i < FILE_COUNT; i++) {
+        string src = root + "src" + to_string(i);
+        string dst = root + "dst" + to_string(i);
+        string content = MakeContent(i, FILE_SIZE + i);
+        UniqueFd srcFd(open(src.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR));
+        ASSERT_EQ(write(srcFd, content.data(), content.size()), static_cast<ssize_t>(content.size()));
+        UniqueFd dstFd(open(dst.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR));
+        string stale = MakeContent(i + 1, FILE_SIZE * 2);
+        ASSERT_EQ(write(dstFd, stale.data(), stale.size()), static_cast<ssize_t>(stale.size()));
+        feeder.Submit({move(dstFd), move(srcFd), [&done](int err) {
+            EXPECT_EQ(err, 0);
+            done++;
+        }});
+    }
+    EXPECT_EQ(feeder.Finish(), 0);
+    EXPECT_EQ(done.load(), FILE_COUNT);
+    auto stats = feeder.GetStats();
+    EXPECT_EQ(stats.files, static_cast<uint64_t>(FILE_COUNT));
+    EXPECT_EQ(stats.failed, 0U);
+    uint64_t bytes = 0;
+    for (int i = 0; i < FILE_COUNT; i++) {
+        EXPECT_EQ(ReadAll(root + "dst" + to_string(i)), MakeContent(i, FILE_SIZE + i));
+        bytes += FILE_SIZE + i;
+    }
+    EXPECT_EQ(stats.bytes, bytes);
+    GTEST_LOG_(INFO) << "ToolsRestoreFeederTest-end tools_restore_feeder_Copy_0100";
+}
+
+/**
+ * @tc.number: SUB_tools_restore_feeder_Error_0100
+ * @tc.name: tools_restore_feeder_Error_0100
+ * @tc.desc: 测试目标不可写时回调错误码并由Finish返回, Finish之后不能再提交任务
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(ToolsRestoreFeederTest, tools_restore_feeder_Error_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "ToolsRestoreFeederTest-begin tools_restore_feeder_Error_0100";
+    TestManager tm(__func__);
+    string root = tm.GetRootDirCurTest();
+    string src = root + "src";
+    string content = MakeContent(0, FILE_SIZE);
+    UniqueFd srcFd(open(src.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR));
+    ASSERT_EQ(write(srcFd, content.data(), content.size()), static_cast<ssize_t>(content.size()));
+    UniqueFd dstFd(open(src.c_str(), O_RDONLY));
+    atomic<int> cbErr = 0;
+    ToolsRestoreFeeder feeder(1, chrono::milliseconds(0));
+    feeder.Submit({move(dstFd), move(srcFd), [&cbErr](int err) { cbErr = err; }});
+    EXPECT_NE(feeder.Finish(), 0);
+    EXPECT_NE(cbErr.load(), 0);
+    EXPECT_EQ(feeder.GetStats().failed, 1U);
+    EXPECT_THROW(feeder.Submit({UniqueFd(-1), UniqueFd(-1), nullptr}), BError);
+    GTEST_LOG_(INFO) << "ToolsRestoreFeederTest-end tools_restore_feeder_Error_0100";
+}
+} // namespace OHOS::FileManagement::Backup
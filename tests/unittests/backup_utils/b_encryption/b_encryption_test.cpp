@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "b_encryption/b_encryption.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+using namespace BEncryption;
+
+class BEncryptionTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase() {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+static string Digest(DigestAlgorithm algorithm, const string &data)
+{
+    ContentDigest digest(algorithm);
+    digest.Update(data.data(), data.size());
+    return digest.Final();
+}
+
+/**
+ * @tc.number: SUB_b_encryption_ContentDigest_0100
+ * @tc.name: b_encryption_ContentDigest_0100
+ * @tc.desc: 测试XXH64和SHA-256摘要与标准结果一致, 摘要串长度与算法名可解析
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BEncryptionTest, b_encryption_ContentDigest_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BEncryptionTest-begin b_encryption_ContentDigest_0100";
+    EXPECT_EQ(Digest(DigestAlgorithm::XXH64, ""), "xxh64:ef46db3751d8e999");
+    EXPECT_EQ(Digest(DigestAlgorithm::XXH64, "abc"), "xxh64:44bc2cf5ad770999");
+    EXPECT_EQ(Digest(DigestAlgorithm::SHA256, "abc"),
+        "sha256:ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    EXPECT_EQ(Digest(DigestAlgorithm::NONE, "abc"), "");
+
+    for (auto algorithm : {DigestAlgorithm::XXH64, DigestAlgorithm::SHA256}) {
+        string digest = Digest(algorithm, "abc");
+        EXPECT_EQ(digest.size(), ContentDigest::GetDigestLength(algorithm));
+        EXPECT_EQ(ContentDigest::ParseAlgorithm(digest), algorithm);
+    }
+    EXPECT_EQ(ContentDigest::ParseAlgorithm("xxh3:0123"), DigestAlgorithm::NONE);
+    EXPECT_EQ(ContentDigest::ParseAlgorithm(""), DigestAlgorithm::NONE);
+    GTEST_LOG_(INFO) << "BEncryptionTest-end b_encryption_ContentDigest_0100";
+}
+
+/**
+ * @tc.number: SUB_b_encryption_ContentDigest_0200
+ * @tc.name: b_encryption_ContentDigest_0200
+ * @tc.desc: 测试分段Update与一次性Update的摘要相同
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BEncryptionTest, b_encryption_ContentDigest_0200, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BEncryptionTest-begin b_encryption_ContentDigest_0200";
+    string data;
+    for (int i = 0; data.size() < 100 * 1024; i++) {
+        data.append(to_string(i * i));
+    }
+    const size_t chunks[] = {1, 7, 31, 32, 33, 4096};
+    for (auto algorithm : {DigestAlgorithm::XXH64, DigestAlgorithm::SHA256}) {
+        string expected = Digest(algorithm, data);
+        for (size_t chunk : chunks) {
+            ContentDigest digest(algorithm);
+            for (size_t pos = 0; pos < data.size(); pos += chunk) {
+                digest.Update(data.data() + pos, min(chunk, data.size() - pos));
+            }
+            EXPECT_EQ(digest.Final(), expected) << "chunk " << chunk;
+        }
+        EXPECT_NE(Digest(algorithm, data.substr(1)), expected);
+    }
+    GTEST_LOG_(INFO) << "BEncryptionTest-end b_encryption_ContentDigest_0200";
+}
+} // namespace OHOS::FileManagement::Backup
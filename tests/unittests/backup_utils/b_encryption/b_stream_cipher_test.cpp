@@ -0,0 +1,407 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cerrno>
+#include <fcntl.h>
+#include <map>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "b_encryption/b_stream_cipher.h"
+#include "test_manager.h"
+#include "unique_fd.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+using namespace BEncryption;
+
+namespace {
+constexpr uint32_t TEST_CHUNK_SIZE = 1000;
+
+class MemKeyProvider : public KeyProvider {
+public:
+    void AddKey(const string &keyId, uint8_t seed)
+    {
+        auto key = make_shared<StreamKey>();
+        key->keyId = keyId;
+        for (size_t i = 0; i < StreamCipher::KEY_SIZE; i++) {
+            key->key.push_back(static_cast<uint8_t>(seed + i));
+        }
+        keys_[keyId] = key;
+    }
+
+    shared_ptr<const StreamKey> GetCurrentKey() override
+    {
+        return keys_.empty() ? nullptr : keys_.begin()->second;
+    }
+
+    shared_ptr<const StreamKey> GetKey(const string &keyId) override
+    {
+        auto it = keys_.find(keyId);
+        return it == keys_.end() ? nullptr : it->second;
+    }
+
+    bool IsExportable() const override
+    {
+        return exportable_;
+    }
+
+    bool exportable_ = true;
+
+private:
+    map<string, shared_ptr<const StreamKey>> keys_;
+};
+} // namespace
+
+class BStreamCipherTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase() {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+static vector<uint8_t> FromHex(const string &hex)
+{
+    vector<uint8_t> out;
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        out.push_back(static_cast<uint8_t>(stoi(hex.substr(i, 2), nullptr, 16)));
+    }
+    return out;
+}
+
+static string MakeData(size_t len)
+{
+    string data(len, '\0');
+    for (size_t i = 0; i < len; i++) {
+        data[i] = static_cast<char>((i * 131 + i / 7) & 0xff);
+    }
+    return data;
+}
+
+static bool WriteEncrypted(const string &path, const StreamKey &key, const string &data)
+{
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    FILE *fp = StreamCipher::OpenWriter(fd, key, TEST_CHUNK_SIZE);
+    if (fp == nullptr) {
+        return false;
+    }
+    bool ok = fwrite(data.data(), 1, data.size(), fp) == data.size();
+    return fclose(fp) == 0 && ok;
+}
+
+// 解密失败时返回false, errno为失败原因
+static bool ReadDecrypted(const string &path, KeyProvider &provider, string &data)
+{
+    FILE *fp = StreamCipher::OpenReader(open(path.c_str(), O_RDONLY), provider);
+    if (fp == nullptr) {
+        return false;
+    }
+    data.clear();
+    char buf[777];
+    size_t len = 0;
+    while ((len = fread(buf, 1, sizeof(buf), fp)) > 0) {
+        data.append(buf, len);
+    }
+    int err = errno;
+    bool ok = ferror(fp) == 0;
+    fclose(fp);
+    errno = err;
+    return ok;
+}
+
+/**
+ * @tc.number: SUB_b_stream_cipher_Seal_0100
+ * @tc.name: b_stream_cipher_Seal_0100
+ * @tc.desc: 测试AES-256-GCM与标准测试向量(GCM规范Test Case 16)一致, 篡改密文或附加数据后认证失败
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BStreamCipherTest, b_stream_cipher_Seal_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BStreamCipherTest-begin b_stream_cipher_Seal_0100";
+    auto key = FromHex("feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308");
+    auto nonce = FromHex("cafebabefacedbaddecaf888");
+    auto aadBytes = FromHex("feedfacedeadbeeffeedfacedeadbeefabaddad2");
+    string aad(aadBytes.begin(), aadBytes.end());
+    auto plain = FromHex("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+                         "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39");
+    auto cipher = FromHex("522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa"
+                          "8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662");
+    auto tag = FromHex("76fc6ece0f4e1768cddf8853bb2d551b");
+
+    vector<uint8_t> out(plain.size());
+    vector<uint8_t> outTag(StreamCipher::TAG_SIZE);
+    ASSERT_TRUE(StreamCipher::Seal(key.data(), nonce.data(), aad, plain.data(), plain.size(), out.data(),
+        outTag.data()));
+    EXPECT_EQ(out, cipher);
+    EXPECT_EQ(outTag, tag);
+
+    vector<uint8_t> decrypted(cipher.size());
+    EXPECT_TRUE(StreamCipher::Open(key.data(), nonce.data(), aad, cipher.data(), cipher.size(), decrypted.data(),
+        tag.data()));
+    EXPECT_EQ(decrypted, plain);
+    cipher[0] ^= 1;
+    EXPECT_FALSE(StreamCipher::Open(key.data(), nonce.data(), aad, cipher.data(), cipher.size(), decrypted.data(),
+        tag.data()));
+    cipher[0] ^= 1;
+    EXPECT_FALSE(StreamCipher::Open(key.data(), nonce.data(), aad + "x", cipher.data(), cipher.size(),
+        decrypted.data(), tag.data()));
+    GTEST_LOG_(INFO) << "BStreamCipherTest-end b_stream_cipher_Seal_0100";
+}
+
+/**
+ * @tc.number: SUB_b_stream_cipher_Stream_0100
+ * @tc.name: b_stream_cipher_Stream_0100
+ * @tc.desc: 测试不同长度的数据加密后可完整解密, 密文不含明文, 解密流可随机定位读取
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BStreamCipherTest, b_stream_cipher_Stream_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BStreamCipherTest-begin b_stream_cipher_Stream_0100";
+    TestManager tm(__func__);
+    string path = tm.GetRootDirCurTest() + "stream";
+    MemKeyProvider provider;
+    provider.AddKey("k1", 1);
+    auto key = provider.GetCurrentKey();
+    const size_t sizes[] = {0, 1, TEST_CHUNK_SIZE - 1, TEST_CHUNK_SIZE, TEST_CHUNK_SIZE + 1, 10 * TEST_CHUNK_SIZE,
+        12345};
+    for (size_t size : sizes) {
+        string data = MakeData(size);
+        ASSERT_TRUE(WriteEncrypted(path, *key, data));
+        UniqueFd fd(open(path.c_str(), O_RDONLY));
+        EXPECT_TRUE(StreamCipher::IsEncrypted(fd));
+        EXPECT_EQ(lseek(fd, 0, SEEK_CUR), 0);
+        string decrypted;
+        EXPECT_TRUE(ReadDecrypted(path, provider, decrypted)) << size;
+        EXPECT_TRUE(decrypted == data) << size;
+    }
+
+    string data = MakeData(12345);
+    string raw(StreamCipher::HEADER_SIZE + data.size() * 2, '\0');
+    UniqueFd rawFd(open(path.c_str(), O_RDONLY));
+    ssize_t rawLen = read(rawFd, raw.data(), raw.size());
+    ASSERT_GT(rawLen, static_cast<ssize_t>(data.size()));
+    raw.resize(rawLen);
+    EXPECT_EQ(raw.find(data.substr(0, 64)), string::npos);
+
+    FILE *fp = StreamCipher::OpenReader(open(path.c_str(), O_RDONLY), provider);
+    ASSERT_NE(fp, nullptr);
+    char buf[100] = {};
+    ASSERT_EQ(fseeko(fp, 5990, SEEK_SET), 0);
+    ASSERT_EQ(fread(buf, 1, sizeof(buf), fp), sizeof(buf));
+    EXPECT_EQ(string(buf, sizeof(buf)), data.substr(5990, sizeof(buf)));
+    EXPECT_EQ(ftello(fp), 6090);
+    ASSERT_EQ(fseeko(fp, -10, SEEK_END), 0);
+    EXPECT_EQ(fread(buf, 1, sizeof(buf), fp), 10U);
+    EXPECT_EQ(string(buf, 10), data.substr(data.size() - 10));
+    fclose(fp);
+
+    string plainFile = tm.GetRootDirCurTest() + "plain";
+    UniqueFd plainFd(open(plainFile.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR));
+    ASSERT_EQ(write(plainFd, data.data(), data.size()), static_cast<ssize_t>(data.size()));
+    EXPECT_FALSE(StreamCipher::IsEncrypted(plainFd));
+    GTEST_LOG_(INFO) << "BStreamCipherTest-end b_stream_cipher_Stream_0100";
+}
+
+/**
+ * @tc.number: SUB_b_stream_cipher_Stream_0200
+ * @tc.name: b_stream_cipher_Stream_0200
+ * @tc.desc: 测试写入过程中回到已写入的位置改写, 解密结果为改写后的内容
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BStreamCipherTest, b_stream_cipher_Stream_0200, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BStreamCipherTest-begin b_stream_cipher_Stream_0200";
+    TestManager tm(__func__);
+    string path = tm.GetRootDirCurTest() + "stream";
+    MemKeyProvider provider;
+    provider.AddKey("k1", 1);
+    string data = MakeData(5 * TEST_CHUNK_SIZE + 10);
+    FILE *fp = StreamCipher::OpenWriter(open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR),
+        *provider.GetCurrentKey(), TEST_CHUNK_SIZE);
+    ASSERT_NE(fp, nullptr);
+    ASSERT_EQ(fwrite(data.data(), 1, 3 * TEST_CHUNK_SIZE, fp), 3 * TEST_CHUNK_SIZE);
+    off_t patchPos = TEST_CHUNK_SIZE - 2;
+    string patch = "patched";
+    ASSERT_EQ(fseeko(fp, patchPos, SEEK_SET), 0);
+    ASSERT_EQ(fwrite(patch.data(), 1, patch.size(), fp), patch.size());
+    EXPECT_NE(fseeko(fp, 3 * TEST_CHUNK_SIZE + 1, SEEK_SET), 0);
+    ASSERT_EQ(fseeko(fp, 0, SEEK_END), 0);
+    EXPECT_EQ(ftello(fp), static_cast<off_t>(3 * TEST_CHUNK_SIZE));
+    ASSERT_EQ(fwrite(data.data() + 3 * TEST_CHUNK_SIZE, 1, data.size() - 3 * TEST_CHUNK_SIZE, fp),
+        data.size() - 3 * TEST_CHUNK_SIZE);
+    ASSERT_EQ(fclose(fp), 0);
+
+    data.replace(patchPos, patch.size(), patch);
+    string decrypted;
+    EXPECT_TRUE(ReadDecrypted(path, provider, decrypted));
+    EXPECT_TRUE(decrypted == data);
+    GTEST_LOG_(INFO) << "BStreamCipherTest-end b_stream_cipher_Stream_0200";
+}
+
+/**
+ * @tc.number: SUB_b_stream_cipher_Tamper_0100
+ * @tc.name: b_stream_cipher_Tamper_0100
+ * @tc.desc: 测试篡改、截断、分块调换和密钥缺失时解密失败
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BStreamCipherTest, b_stream_cipher_Tamper_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BStreamCipherTest-begin b_stream_cipher_Tamper_0100";
+    TestManager tm(__func__);
+    string path = tm.GetRootDirCurTest() + "stream";
+    MemKeyProvider provider;
+    provider.AddKey("k1", 1);
+    string data = MakeData(3 * TEST_CHUNK_SIZE + 500);
+    const off_t recordSize = StreamCipher::NONCE_SIZE + TEST_CHUNK_SIZE + StreamCipher::TAG_SIZE;
+    string decrypted;
+
+    // 篡改第二个分块的一个字节, 读到该分块时失败
+    ASSERT_TRUE(WriteEncrypted(path, *provider.GetCurrentKey(), data));
+    UniqueFd fd(open(path.c_str(), O_RDWR));
+    char byte = 0;
+    off_t tamperPos = StreamCipher::HEADER_SIZE + recordSize + StreamCipher::NONCE_SIZE + 3;
+    ASSERT_EQ(pread(fd, &byte, 1, tamperPos), 1);
+    byte ^= 1;
+    ASSERT_EQ(pwrite(fd, &byte, 1, tamperPos), 1);
+    EXPECT_FALSE(ReadDecrypted(path, provider, decrypted));
+    EXPECT_EQ(errno, EBADMSG);
+    EXPECT_EQ(decrypted, data.substr(0, TEST_CHUNK_SIZE));
+
+    // 调换前两个分块
+    ASSERT_TRUE(WriteEncrypted(path, *provider.GetCurrentKey(), data));
+    string first(recordSize, '\0');
+    string second(recordSize, '\0');
+    ASSERT_EQ(pread(fd, first.data(), recordSize, StreamCipher::HEADER_SIZE), recordSize);
+    ASSERT_EQ(pread(fd, second.data(), recordSize, StreamCipher::HEADER_SIZE + recordSize), recordSize);
+    ASSERT_EQ(pwrite(fd, second.data(), recordSize, StreamCipher::HEADER_SIZE), recordSize);
+    ASSERT_EQ(pwrite(fd, first.data(), recordSize, StreamCipher::HEADER_SIZE + recordSize), recordSize);
+    EXPECT_FALSE(ReadDecrypted(path, provider, decrypted));
+
+    // 在分块边界截断, 剩下的都是完整分块, 但最后一块不是写入时的最后一块
+    ASSERT_TRUE(WriteEncrypted(path, *provider.GetCurrentKey(), data));
+    ASSERT_EQ(ftruncate(fd, StreamCipher::HEADER_SIZE + 2 * recordSize), 0);
+    EXPECT_FALSE(ReadDecrypted(path, provider, decrypted));
+    EXPECT_EQ(errno, EBADMSG);
+
+    // 找不到密钥, 或密钥标识相同但密钥不同
+    ASSERT_TRUE(WriteEncrypted(path, *provider.GetCurrentKey(), data));
+    MemKeyProvider other;
+    other.AddKey("k2", 2);
+    EXPECT_FALSE(ReadDecrypted(path, other, decrypted));
+    EXPECT_EQ(errno, ENOKEY);
+    auto sameId = make_shared<MemKeyProvider>();
+    sameId->AddKey("k1", 3);
+    EXPECT_FALSE(ReadDecrypted(path, *sameId, decrypted));
+    GTEST_LOG_(INFO) << "BStreamCipherTest-end b_stream_cipher_Tamper_0100";
+}
+
+/**
+ * @tc.number: SUB_b_stream_cipher_CallerKeyProvider_0100
+ * @tc.name: b_stream_cipher_CallerKeyProvider_0100
+ * @tc.desc: 测试调用方下发密钥的解析, 以及不能导出的密钥不用于加密
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BStreamCipherTest, b_stream_cipher_CallerKeyProvider_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BStreamCipherTest-begin b_stream_cipher_CallerKeyProvider_0100";
+    string hex = "000102030405060708090a0b0c0d0e0f101112131415161718191A1B1C1D1E1F";
+    auto key = ParseStreamKey("key_1:" + hex);
+    ASSERT_NE(key, nullptr);
+    EXPECT_EQ(key->keyId, "key_1");
+    EXPECT_EQ(key->key, FromHex(hex));
+    EXPECT_EQ(ParseStreamKey(hex), nullptr);
+    EXPECT_EQ(ParseStreamKey("key_1:" + hex.substr(2)), nullptr);
+    EXPECT_EQ(ParseStreamKey("key_1:" + hex.substr(2) + "zz"), nullptr);
+    EXPECT_EQ(ParseStreamKey("../key:" + hex), nullptr);
+
+    CallerKeyProvider provider(key);
+    EXPECT_TRUE(provider.IsExportable());
+    EXPECT_EQ(provider.GetKey("key_1"), key);
+    EXPECT_EQ(provider.GetKey("key_2"), nullptr);
+
+    SetKeyProvider(nullptr);
+    EXPECT_EQ(GetCurrentKey(), nullptr);
+    SetKeyProvider(make_shared<CallerKeyProvider>(key));
+    EXPECT_EQ(GetCurrentKey(), key);
+    auto local = make_shared<MemKeyProvider>();
+    local->AddKey("k1", 1);
+    local->exportable_ = false;
+    SetKeyProvider(local);
+    EXPECT_EQ(GetCurrentKey(), nullptr);
+    SetKeyProvider(nullptr);
+    GTEST_LOG_(INFO) << "BStreamCipherTest-end b_stream_cipher_CallerKeyProvider_0100";
+}
+
+/**
+ * @tc.number: SUB_b_stream_cipher_PipeEncryptor_0100
+ * @tc.name: b_stream_cipher_PipeEncryptor_0100
+ * @tc.desc: 测试经管道加密的文件可以解密, 读端提前关闭时加密以失败结束
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BStreamCipherTest, b_stream_cipher_PipeEncryptor_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BStreamCipherTest-begin b_stream_cipher_PipeEncryptor_0100";
+    TestManager tm(__func__);
+    string plainPath = tm.GetRootDirCurTest() + "plain";
+    string path = tm.GetRootDirCurTest() + "stream";
+    MemKeyProvider provider;
+    provider.AddKey("k1", 1);
+    auto key = provider.GetCurrentKey();
+    PipeEncryptor encryptor;
+    for (size_t len : {0, 1, 65536, 200000}) {
+        string data = MakeData(len);
+        {
+            UniqueFd fd(open(plainPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR));
+            ASSERT_EQ(write(fd, data.data(), data.size()), static_cast<ssize_t>(data.size()));
+        }
+        UniqueFd readEnd(encryptor.Start(open(plainPath.c_str(), O_RDONLY), key));
+        ASSERT_GE(readEnd, 0);
+        UniqueFd dst(open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR));
+        char buf[4096];
+        ssize_t ret = 0;
+        while ((ret = read(readEnd, buf, sizeof(buf))) > 0) {
+            ASSERT_EQ(write(dst, buf, ret), ret);
+        }
+        EXPECT_TRUE(encryptor.Wait());
+        string decrypted;
+        EXPECT_TRUE(ReadDecrypted(path, provider, decrypted));
+        EXPECT_TRUE(decrypted == data);
+    }
+
+    int readEnd = encryptor.Start(open(plainPath.c_str(), O_RDONLY), key);
+    ASSERT_GE(readEnd, 0);
+    close(readEnd);
+    EXPECT_FALSE(encryptor.Wait());
+    EXPECT_EQ(encryptor.Start(-1, key), -1);
+    GTEST_LOG_(INFO) << "BStreamCipherTest-end b_stream_cipher_PipeEncryptor_0100";
+}
+} // namespace OHOS::FileManagement::Backup
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <csignal>
+#include <fcntl.h>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "b_filesystem/b_backup_checkpoint.h"
+#include "test_manager.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+
+namespace {
+const string TOKEN = "com.example.app|2026-01-01 00:00:00";
+constexpr int ARTIFACT_COUNT = 200;
+constexpr int CRASH_ROUNDS = 20;
+constexpr int MAX_KILL_DELAY_US = 3000;
+} // namespace
+
+class BBackupCheckpointTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase() {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+static string ArtifactName(int index)
+{
+    return "part." + to_string(index) + ".tar";
+}
+
+static string ArtifactFingerprint(int index)
+{
+    return to_string(index * index) + ":0.0";
+}
+
+// 子进程从第一个未提交的产物开始继续提交, 每提交一个通过管道告知父进程
+static void RunProducer(const string &path, int ackFd)
+{
+    BBackupCheckpoint checkpoint(path);
+    if (!checkpoint.Open(TOKEN)) {
+        _exit(1);
+    }
+    for (int i = 0; i < ARTIFACT_COUNT; i++) {
+        if (checkpoint.IsCommitted(ArtifactName(i), ArtifactFingerprint(i))) {
+            continue;
+        }
+        if (!checkpoint.Commit(ArtifactName(i), ArtifactFingerprint(i))) {
+            _exit(1);
+        }
+        char ack = 0;
+        if (write(ackFd, &ack, 1) != 1) {
+            _exit(1);
+        }
+    }
+    _exit(0);
+}
+
+/**
+ * @tc.number: SUB_b_backup_checkpoint_Commit_0100
+ * @tc.name: b_backup_checkpoint_Commit_0100
+ * @tc.desc: 测试提交后重新打开可恢复, 指纹不同视为未交付, 会话标识不同时清空重新开始
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BBackupCheckpointTest, b_backup_checkpoint_Commit_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BBackupCheckpointTest-begin b_backup_checkpoint_Commit_0100";
+    TestManager tm(__func__);
+    string path = tm.GetRootDirCurTest() + "checkpoint";
+    {
+        BBackupCheckpoint checkpoint(path);
+        ASSERT_TRUE(checkpoint.Open(TOKEN));
+        EXPECT_EQ(checkpoint.GetCommittedCount(), 0U);
+        EXPECT_TRUE(checkpoint.Commit("big1", "10:1.0"));
+        EXPECT_TRUE(checkpoint.Commit("part.0.tar", "20:2.0"));
+        EXPECT_TRUE(checkpoint.Commit("big1", "11:3.0"));
+    }
+    BBackupCheckpoint checkpoint(path);
+    ASSERT_TRUE(checkpoint.Open(TOKEN));
+    EXPECT_EQ(checkpoint.GetCommittedCount(), 2U);
+    EXPECT_TRUE(checkpoint.IsCommitted("big1", "11:3.0"));
+    EXPECT_FALSE(checkpoint.IsCommitted("big1", "10:1.0"));
+    EXPECT_TRUE(checkpoint.IsCommitted("part.0.tar", "20:2.0"));
+
+    ASSERT_TRUE(checkpoint.Open("another session"));
+    EXPECT_EQ(checkpoint.GetCommittedCount(), 0U);
+    EXPECT_FALSE(checkpoint.IsCommitted("part.0.tar", "20:2.0"));
+
+    checkpoint.Remove();
+    EXPECT_NE(access(path.c_str(), F_OK), 0);
+    EXPECT_FALSE(checkpoint.Commit("big1", "10:1.0"));
+    GTEST_LOG_(INFO) << "BBackupCheckpointTest-end b_backup_checkpoint_Commit_0100";
+}
+
+/**
+ * @tc.number: SUB_b_backup_checkpoint_TornTail_0100
+ * @tc.name: b_backup_checkpoint_TornTail_0100
+ * @tc.desc: 测试末尾不完整或损坏的记录被丢弃, 之后的提交不受影响
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BBackupCheckpointTest, b_backup_checkpoint_TornTail_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BBackupCheckpointTest-begin b_backup_checkpoint_TornTail_0100";
+    TestManager tm(__func__);
+    string path = tm.GetRootDirCurTest() + "checkpoint";
+    {
+        BBackupCheckpoint checkpoint(path);
+        ASSERT_TRUE(checkpoint.Open(TOKEN));
+        EXPECT_TRUE(checkpoint.Commit("a", "1"));
+        EXPECT_TRUE(checkpoint.Commit("b", "2"));
+    }
+    struct stat sta = {};
+    ASSERT_EQ(stat(path.c_str(), &sta), 0);
+    // 截掉最后一条记录的一个字节, 并在末尾追加零填充
+    ASSERT_EQ(truncate(path.c_str(), sta.st_size - 1), 0);
+    UniqueFd fd(open(path.c_str(), O_WRONLY | O_APPEND));
+    ASSERT_GE(fd, 0);
+    string zeros(16, '\0');
+    ASSERT_EQ(write(fd, zeros.data(), zeros.size()), static_cast<ssize_t>(zeros.size()));
+    fd.Reset();
+
+    BBackupCheckpoint checkpoint(path);
+    ASSERT_TRUE(checkpoint.Open(TOKEN));
+    EXPECT_EQ(checkpoint.GetCommittedCount(), 1U);
+    EXPECT_TRUE(checkpoint.IsCommitted("a", "1"));
+    EXPECT_FALSE(checkpoint.IsCommitted("b", "2"));
+    EXPECT_TRUE(checkpoint.Commit("c", "3"));
+
+    BBackupCheckpoint reopened(path);
+    ASSERT_TRUE(reopened.Open(TOKEN));
+    EXPECT_EQ(reopened.GetCommittedCount(), 2U);
+    EXPECT_TRUE(reopened.IsCommitted("c", "3"));
+    GTEST_LOG_(INFO) << "BBackupCheckpointTest-end b_backup_checkpoint_TornTail_0100";
+}
+
+/**
+ * @tc.number: SUB_b_backup_checkpoint_Crash_0100
+ * @tc.name: b_backup_checkpoint_Crash_0100
+ * @tc.desc: 测试提交过程中进程在随机时刻被杀死, 已确认的提交不丢失, 续传后最终结果完整
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BBackupCheckpointTest, b_backup_checkpoint_Crash_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BBackupCheckpointTest-begin b_backup_checkpoint_Crash_0100";
+    TestManager tm(__func__);
+    string path = tm.GetRootDirCurTest() + "checkpoint";
+    mt19937 rng(ARTIFACT_COUNT);
+    size_t acked = 0;
+    int exitCode = -1;
+    for (int round = 0; round < CRASH_ROUNDS && exitCode != 0; round++) {
+        int pipeFds[2] = {-1, -1};
+        ASSERT_EQ(pipe(pipeFds), 0);
+        pid_t pid = fork();
+        ASSERT_GE(pid, 0);
+        if (pid == 0) {
+            close(pipeFds[0]);
+            RunProducer(path, pipeFds[1]);
+        }
+        close(pipeFds[1]);
+        usleep(rng() % MAX_KILL_DELAY_US);
+        kill(pid, SIGKILL);
+        char ack = 0;
+        while (read(pipeFds[0], &ack, 1) == 1) {
+            acked++;
+        }
+        close(pipeFds[0]);
+        int status = 0;
+        ASSERT_EQ(waitpid(pid, &status, 0), pid);
+        exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+        ASSERT_TRUE(exitCode <= 0);
+
+        // 已确认的提交必须全部恢复, 且恢复出的是从头开始的连续前缀
+        BBackupCheckpoint checkpoint(path);
+        ASSERT_TRUE(checkpoint.Open(TOKEN));
+        size_t committed = checkpoint.GetCommittedCount();
+        GTEST_LOG_(INFO) << "round " << round << ": acked " << acked << ", committed " << committed;
+        EXPECT_GE(committed, acked);
+        for (int i = 0; i < static_cast<int>(committed); i++) {
+            EXPECT_TRUE(checkpoint.IsCommitted(ArtifactName(i), ArtifactFingerprint(i)));
+        }
+        acked = committed;
+    }
+    if (exitCode != 0) {
+        int pipeFds[2] = {-1, -1};
+        ASSERT_EQ(pipe(pipeFds), 0);
+        pid_t pid = fork();
+        ASSERT_GE(pid, 0);
+        if (pid == 0) {
+            close(pipeFds[0]);
+            RunProducer(path, pipeFds[1]);
+        }
+        close(pipeFds[1]);
+        char ack = 0;
+        while (read(pipeFds[0], &ack, 1) == 1) {
+        }
+        close(pipeFds[0]);
+        int status = 0;
+        ASSERT_EQ(waitpid(pid, &status, 0), pid);
+        ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    BBackupCheckpoint checkpoint(path);
+    ASSERT_TRUE(checkpoint.Open(TOKEN));
+    EXPECT_EQ(checkpoint.GetCommittedCount(), static_cast<size_t>(ARTIFACT_COUNT));
+    for (int i = 0; i < ARTIFACT_COUNT; i++) {
+        EXPECT_TRUE(checkpoint.IsCommitted(ArtifactName(i), ArtifactFingerprint(i)));
+    }
+    GTEST_LOG_(INFO) << "BBackupCheckpointTest-end b_backup_checkpoint_Crash_0100";
+}
+} // namespace OHOS::FileManagement::Backup
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "b_filesystem/b_dir_cache.h"
+#include "test_manager.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+
+namespace {
+constexpr int FILE_FLAGS = O_RDWR | O_CREAT | O_TRUNC;
+constexpr mode_t FILE_MODE = S_IRUSR | S_IWUSR;
+constexpr int DIR_COUNT = 10;
+constexpr int FILES_PER_DIR = 100;
+} // namespace
+
+class BDirCacheTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase() {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+static bool IsDir(const string &path)
+{
+    struct stat sta = {};
+    return stat(path.c_str(), &sta) == 0 && S_ISDIR(sta.st_mode);
+}
+
+// 按原有方式(realpath失败后ForceCreateDirectory逐级access+mkdir)创建文件时的stat类和mkdir调用次数
+static void LegacyCreateFile(const string &filePath, uint64_t &stats, uint64_t &mkdirs)
+{
+    string parent = filePath.substr(0, filePath.rfind('/'));
+    stats++;
+    string::size_type index = 0;
+    do {
+        index = parent.find('/', index + 1);
+        string subPath = (index == string::npos) ? parent : parent.substr(0, index);
+        stats++;
+        if (access(subPath.c_str(), F_OK) != 0) {
+            mkdirs++;
+            mkdir(subPath.c_str(), S_IRWXU);
+        }
+    } while (index != string::npos);
+    // 结尾的access和realpath校验父目录
+    stats += 2;
+    close(open(filePath.c_str(), FILE_FLAGS | O_CLOEXEC, FILE_MODE));
+}
+
+/**
+ * @tc.number: SUB_b_dir_cache_EnsureDir_0100
+ * @tc.name: b_dir_cache_EnsureDir_0100
+ * @tc.desc: 测试逐级创建目录, 已缓存的目录不再打开, 重复和末尾的'/'视为同一目录
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BDirCacheTest, b_dir_cache_EnsureDir_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BDirCacheTest-begin b_dir_cache_EnsureDir_0100";
+    TestManager tm(__func__);
+    string root = tm.GetRootDirCurTest();
+    BDirCache cache;
+    ASSERT_TRUE(cache.EnsureDir(root + "a/b/c", S_IRWXU));
+    EXPECT_TRUE(IsDir(root + "a/b/c"));
+    EXPECT_EQ(cache.GetStats().mkdirs, 3U);
+
+    auto before = cache.GetStats();
+    EXPECT_TRUE(cache.EnsureDir(root + "a//b/c/", S_IRWXU));
+    EXPECT_TRUE(cache.EnsureDir(root + "a/b", S_IRWXU));
+    auto after = cache.GetStats();
+    EXPECT_EQ(after.hits, before.hits + 2);
+    EXPECT_EQ(after.dirOpens, before.dirOpens);
+    EXPECT_EQ(after.mkdirs, before.mkdirs);
+
+    EXPECT_TRUE(cache.EnsureDir(root + "a/b/d", S_IRWXU));
+    EXPECT_EQ(cache.GetStats().mkdirs, 4U);
+    GTEST_LOG_(INFO) << "BDirCacheTest-end b_dir_cache_EnsureDir_0100";
+}
+
+/**
+ * @tc.number: SUB_b_dir_cache_OpenFile_0100
+ * @tc.name: b_dir_cache_OpenFile_0100
+ * @tc.desc: 测试大量文件分布在少量目录时, 每个目录只创建和打开一次, 并与按路径创建的调用次数对比
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BDirCacheTest, b_dir_cache_OpenFile_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BDirCacheTest-begin b_dir_cache_OpenFile_0100";
+    TestManager tm(__func__);
+    string root = tm.GetRootDirCurTest();
+    uint64_t legacyStats = 0;
+    uint64_t legacyMkdirs = 0;
+    BDirCache cache;
+    for (int i = 0; i < DIR_COUNT; i++) {
+        for (int j = 0; j < FILES_PER_DIR; j++) {
+            string name = "/d" + to_string(i) + "/sub/f" + to_string(j);
+            LegacyCreateFile(root + "legacy" + name, legacyStats, legacyMkdirs);
+            UniqueFd fd = cache.OpenFile(root + "cached" + name, FILE_FLAGS, FILE_MODE, S_IRWXU);
+            ASSERT_GE(fd, 0);
+        }
+    }
+    auto stats = cache.GetStats();
+    GTEST_LOG_(INFO) << "legacy: stat " << legacyStats << ", mkdir " << legacyMkdirs;
+    GTEST_LOG_(INFO) << "cached: open dir " << stats.dirOpens << ", mkdir " << stats.mkdirs;
+    // cached, d0..d9, d*/sub
+    EXPECT_EQ(stats.mkdirs, 1U + DIR_COUNT * 2);
+    EXPECT_EQ(legacyMkdirs, stats.mkdirs);
+    // 已存在的祖先目录各打开一次, 新建的目录各打开两次, 与文件个数无关
+    EXPECT_LE(stats.dirOpens, stats.mkdirs * 2 + count(root.begin(), root.end(), '/'));
+    EXPECT_LT(stats.dirOpens + stats.mkdirs, legacyStats / FILES_PER_DIR);
+    EXPECT_EQ(access((root + "cached/d9/sub/f99").c_str(), F_OK), 0);
+    GTEST_LOG_(INFO) << "BDirCacheTest-end b_dir_cache_OpenFile_0100";
+}
+
+/**
+ * @tc.number: SUB_b_dir_cache_Invalidate_0100
+ * @tc.name: b_dir_cache_Invalidate_0100
+ * @tc.desc: 测试已缓存的目录被删除后重新创建, 清空缓存后改名的目录不再被使用
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BDirCacheTest, b_dir_cache_Invalidate_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BDirCacheTest-begin b_dir_cache_Invalidate_0100";
+    TestManager tm(__func__);
+    string root = tm.GetRootDirCurTest();
+    BDirCache cache;
+    ASSERT_TRUE(cache.EnsureDir(root + "x/y", S_IRWXU));
+    ASSERT_EQ(rmdir((root + "x/y").c_str()), 0);
+    ASSERT_EQ(rmdir((root + "x").c_str()), 0);
+    UniqueFd fd = cache.OpenFile(root + "x/y/file", FILE_FLAGS, FILE_MODE, S_IRWXU);
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(access((root + "x/y/file").c_str(), F_OK), 0);
+
+    ASSERT_EQ(rename((root + "x").c_str(), (root + "old").c_str()), 0);
+    cache.Clear();
+    fd = cache.OpenFile(root + "x/y/file2", FILE_FLAGS, FILE_MODE, S_IRWXU);
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(access((root + "x/y/file2").c_str(), F_OK), 0);
+    EXPECT_NE(access((root + "old/y/file2").c_str(), F_OK), 0);
+    GTEST_LOG_(INFO) << "BDirCacheTest-end b_dir_cache_Invalidate_0100";
+}
+
+/**
+ * @tc.number: SUB_b_dir_cache_Evict_0100
+ * @tc.name: b_dir_cache_Evict_0100
+ * @tc.desc: 测试缓存个数超过上限时淘汰最久未使用的目录且结果正确
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BDirCacheTest, b_dir_cache_Evict_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BDirCacheTest-begin b_dir_cache_Evict_0100";
+    TestManager tm(__func__);
+    string root = tm.GetRootDirCurTest();
+    BDirCache cache(2);
+    for (int i = 0; i < DIR_COUNT; i++) {
+        UniqueFd fd = cache.OpenFile(root + "e" + to_string(i) + "/file", FILE_FLAGS, FILE_MODE, S_IRWXU);
+        ASSERT_GE(fd, 0);
+    }
+    for (int i = 0; i < DIR_COUNT; i++) {
+        EXPECT_EQ(access((root + "e" + to_string(i) + "/file").c_str(), F_OK), 0);
+    }
+    EXPECT_EQ(cache.GetStats().mkdirs, static_cast<uint64_t>(DIR_COUNT));
+    GTEST_LOG_(INFO) << "BDirCacheTest-end b_dir_cache_Evict_0100";
+}
+
+/**
+ * @tc.number: SUB_b_dir_cache_Error_0100
+ * @tc.name: b_dir_cache_Error_0100
+ * @tc.desc: 测试路径中间为普通文件或不含父目录时返回失败
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BDirCacheTest, b_dir_cache_Error_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BDirCacheTest-begin b_dir_cache_Error_0100";
+    TestManager tm(__func__);
+    string root = tm.GetRootDirCurTest();
+    BDirCache cache;
+    UniqueFd fd = cache.OpenFile(root + "regular", FILE_FLAGS, FILE_MODE, S_IRWXU);
+    ASSERT_GE(fd, 0);
+    EXPECT_FALSE(cache.EnsureDir(root + "regular/dir", S_IRWXU));
+    EXPECT_EQ(errno, ENOTDIR);
+    EXPECT_LT(cache.OpenFile("file", FILE_FLAGS, FILE_MODE), 0);
+    EXPECT_EQ(errno, EINVAL);
+    EXPECT_FALSE(cache.EnsureDir("", S_IRWXU));
+    GTEST_LOG_(INFO) << "BDirCacheTest-end b_dir_cache_Error_0100";
+}
+} // namespace OHOS::FileManagement::Backup
@@ -45,8 +45,7 @@ public:
     static void TearDownTestCase();
     void SetUp()
     {
-        std::queue<std::shared_ptr<IFileInfo>> emptyQueue;
-        ScanFileSingleton::GetInstance().pendingFileQueue_.swap(emptyQueue);
+        ScanFileSingleton::GetInstance().pendingFileQueue_.Clear();
         ScanFileSingleton::GetInstance().smallFiles_.clear();
     };
     void TearDown() {};
@@ -86,7 +85,7 @@ HWTEST_F(BDirSubTest, B_DIR_ProcessFile_001, testing::ext::TestSize.Level1)
     int64_t smallFileSize = 0;
     int64_t bigFileSize = 0;
     ProcessFile({backupPath, restorePath, 0}, smallFileSize, bigFileSize, {});
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 0);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 0);
     EXPECT_EQ(ScanFileSingleton::GetInstance().smallFiles_.size(), 0);
     GTEST_LOG_(INFO) << "BDirTest-end B_DIR_ProcessFile_001";
 }
@@ -116,7 +115,7 @@ HWTEST_F(BDirSubTest, B_DIR_ProcessFile_002, testing::ext::TestSize.Level1)
     int64_t smallFileSize = 0;
     int64_t bigFileSize = 0;
     ProcessFile({backupPath, restorePath, 10}, bigFileSize, smallFileSize, {});
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 0);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 0);
     EXPECT_EQ(ScanFileSingleton::GetInstance().smallFiles_.size(), 1);
     EXPECT_EQ(smallFileSize, 5);
     GTEST_LOG_(INFO) << "BDirTest-end B_DIR_ProcessFile_002";
@@ -147,7 +146,7 @@ HWTEST_F(BDirSubTest, B_DIR_ProcessFile_003, testing::ext::TestSize.Level1)
     int64_t smallFileSize = 0;
     int64_t bigFileSize = 0;
     ProcessFile({backupPath, restorePath, 10}, bigFileSize, smallFileSize, {});
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 1);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 1);
     EXPECT_EQ(ScanFileSingleton::GetInstance().smallFiles_.size(), 0);
     EXPECT_EQ(bigFileSize, 15);
     GTEST_LOG_(INFO) << "BDirSubTest-end B_DIR_ProcessFile_003";
@@ -178,7 +177,7 @@ HWTEST_F(BDirSubTest, B_DIR_ProcessFile_004, testing::ext::TestSize.Level1)
     ProcessFile({"/abc/ttest4.abc", "", 10}, bigFileSize, smallFileSize, {"/abc/test*"});
     ProcessFile({"/abc/test4", "", 10}, bigFileSize, smallFileSize, {"/abc/test4/*"});
     ProcessFile({"/abc/test4.abc", "restore", 10}, bigFileSize, smallFileSize, {"/abc/test*"});
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 3);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 3);
     EXPECT_EQ(ScanFileSingleton::GetInstance().smallFiles_.size(), 0);
     EXPECT_EQ(bigFileSize, 45);
     GTEST_LOG_(INFO) << "BDirSubTest-end B_DIR_ProcessFile_004";
@@ -202,7 +201,7 @@ HWTEST_F(BDirSubTest, B_DIR_ProcessSingleFile_001, testing::ext::TestSize.Level1
     off_t sizeBoundary = 10;
     auto [ret1, bigSize1, smallSize1] = ProcessSingleFile({}, backupPath, restorePath, sizeBoundary);
     EXPECT_EQ(ret1, 0);
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 0);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 0);
     EXPECT_EQ(ScanFileSingleton::GetInstance().smallFiles_.size(), 0);
 
     struct stat sta = {.st_size = 15};
@@ -214,7 +213,7 @@ HWTEST_F(BDirSubTest, B_DIR_ProcessSingleFile_001, testing::ext::TestSize.Level1
     auto [ret2, bigSize2, smallSize2] = ProcessSingleFile({}, backupPath, restorePath, sizeBoundary);
     EXPECT_EQ(ret2, 0);
     EXPECT_EQ(bigSize2, 15);
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 1);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 1);
     GTEST_LOG_(INFO) << "BDirTest-end B_DIR_ProcessSingleFile_001";
 }
 
@@ -237,7 +236,7 @@ HWTEST_F(BDirSubTest, B_DIR_DirScanner_ScanDir_001, testing::ext::TestSize.Level
     vector<string> excludes;
     DirScanner scanner;
     auto [ret1, bigSize1, smallSize1] = scanner.ScanDir(backupPath, excludes, sizeBoundary);
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 0);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 0);
     EXPECT_EQ(ScanFileSingleton::GetInstance().smallFiles_.size(), 0);
     EXPECT_EQ(ret1, 0);
     GTEST_LOG_(INFO) << "BDirTest-end B_DIR_DirScanner_ScanDir_001";
@@ -261,7 +260,7 @@ HWTEST_F(BDirSubTest, B_DIR_DirScanner_ScanDir_002, testing::ext::TestSize.Level
     vector<string> excludes = {"/tmp"};
     DirScanner scanner;
     auto [ret1, bigSize1, smallSize1] = scanner.ScanDir(backupPath, excludes, sizeBoundary);
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 0);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 0);
     EXPECT_EQ(ScanFileSingleton::GetInstance().smallFiles_.size(), 0);
     EXPECT_EQ(ret1, 0);
     GTEST_LOG_(INFO) << "BDirTest-end B_DIR_DirScanner_ScanDir_002";
@@ -286,7 +285,7 @@ HWTEST_F(BDirSubTest, B_DIR_DirScanner_ScanDir_003, testing::ext::TestSize.Level
     vector<string> excludes;
     DirScanner scanner;
     auto [ret1, bigSize1, smallSize1] = scanner.ScanDir(backupPath, excludes, sizeBoundary);
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 0);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 0);
     EXPECT_EQ(ScanFileSingleton::GetInstance().smallFiles_.size(), 0);
     EXPECT_EQ(ret1, 0);
     GTEST_LOG_(INFO) << "BDirTest-end B_DIR_DirScanner_ScanDir_003";
@@ -310,7 +309,7 @@ HWTEST_F(BDirSubTest, B_DIR_DirScanner_ScanDir_004, testing::ext::TestSize.Level
     vector<string> excludes;
     DirScanner scanner;
     auto [ret1, bigSize1, smallSize1] = scanner.ScanDir(backupPath, excludes, sizeBoundary);
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 0);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 0);
     EXPECT_EQ(ret1, 0);
     GTEST_LOG_(INFO) << "BDirTest-end B_DIR_DirScanner_ScanDir_004";
 }
@@ -334,7 +333,7 @@ HWTEST_F(BDirSubTest, B_DIR_DirScanner_ScanDir_005, testing::ext::TestSize.Level
     vector<string> excludes;
     DirScanner scanner;
     auto [ret1, bigSize1, smallSize1] = scanner.ScanDir(backupPath, excludes, sizeBoundary);
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 0);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 0);
     EXPECT_EQ(ret1, 0);
     GTEST_LOG_(INFO) << "BDirTest-end B_DIR_DirScanner_ScanDir_005";
 }
@@ -358,7 +357,7 @@ HWTEST_F(BDirSubTest, B_DIR_CompatibleDirScanner_ScanDir_001, testing::ext::Test
     vector<string> excludes;
     CompatibleDirScanner scanner;
     auto [ret1, bigSize1, smallSize1] = scanner.ScanDir(backupPath, excludes, sizeBoundary);
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 0);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 0);
     EXPECT_EQ(ScanFileSingleton::GetInstance().smallFiles_.size(), 0);
     EXPECT_EQ(ret1, 0);
     GTEST_LOG_(INFO) << "BDirTest-end B_DIR_CompatibleDirScanner_ScanDir_001";
@@ -382,7 +381,7 @@ HWTEST_F(BDirSubTest, B_DIR_CompatibleDirScanner_ScanDir_002, testing::ext::Test
     vector<string> excludes = {"/tmp"};
     CompatibleDirScanner scanner;
     auto [ret1, bigSize1, smallSize1] = scanner.ScanDir(backupPath, excludes, sizeBoundary);
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 0);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 0);
     EXPECT_EQ(ScanFileSingleton::GetInstance().smallFiles_.size(), 0);
     EXPECT_EQ(ret1, 0);
     GTEST_LOG_(INFO) << "BDirTest-end B_DIR_CompatibleDirScanner_ScanDir_002";
@@ -407,7 +406,7 @@ HWTEST_F(BDirSubTest, B_DIR_CompatibleDirScanner_ScanDir_003, testing::ext::Test
     vector<string> excludes;
     CompatibleDirScanner scanner;
     auto [ret1, bigSize1, smallSize1] = scanner.ScanDir(backupPath, excludes, sizeBoundary);
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 0);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 0);
     EXPECT_EQ(ScanFileSingleton::GetInstance().smallFiles_.size(), 0);
     EXPECT_EQ(ret1, 0);
     GTEST_LOG_(INFO) << "BDirTest-end B_DIR_CompatibleDirScanner_ScanDir_003";
@@ -431,7 +430,7 @@ HWTEST_F(BDirSubTest, B_DIR_CompatibleDirScanner_ScanDir_004, testing::ext::Test
     vector<string> excludes;
     CompatibleDirScanner scanner;
     auto [ret1, bigSize1, smallSize1] = scanner.ScanDir(backupPath, excludes, sizeBoundary);
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 0);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 0);
     EXPECT_EQ(ret1, 0);
     GTEST_LOG_(INFO) << "BDirTest-end B_DIR_CompatibleDirScanner_ScanDir_004";
 }
@@ -455,7 +454,7 @@ HWTEST_F(BDirSubTest, B_DIR_CompatibleDirScanner_ScanDir_005, testing::ext::Test
     vector<string> excludes;
     CompatibleDirScanner scanner;
     auto [ret1, bigSize1, smallSize1] = scanner.ScanDir(backupPath, excludes, sizeBoundary);
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 0);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 0);
     EXPECT_EQ(ret1, 0);
     GTEST_LOG_(INFO) << "BDirTest-end B_DIR_CompatibleDirScanner_ScanDir_005";
 }
@@ -477,7 +476,7 @@ HWTEST_F(BDirSubTest, B_DIR_DirScanner_ScanAllDirs_001, testing::ext::TestSize.L
     vector<string> excludes;
     DirScanner scanner;
     auto [ret1, bigSize1, smallSize1] = scanner.ScanAllDirs(includes, excludes);
-    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.size(), 0);
+    EXPECT_EQ(ScanFileSingleton::GetInstance().pendingFileQueue_.Size(), 0);
     EXPECT_EQ(ret1, 0);
     GTEST_LOG_(INFO) << "BDirTest-end B_DIR_DirScanner_ScanAllDirs_001";
 }
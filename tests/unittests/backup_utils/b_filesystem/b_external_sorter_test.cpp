@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <dirent.h>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "b_filesystem/b_external_sorter.h"
+#include "test_manager.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+
+namespace {
+constexpr size_t RECORD_COUNT = 20000;
+constexpr size_t SMALL_MEMORY_LIMIT = 64 * 1024;
+constexpr size_t SMALL_MERGE_WAYS = 4;
+constexpr uint32_t KEY_RANGE = 5000;
+} // namespace
+
+class BExternalSorterTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase() {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+static size_t CountDirEntries(const string &path)
+{
+    size_t count = 0;
+    DIR *dir = opendir(path.c_str());
+    if (dir == nullptr) {
+        return 0;
+    }
+    while (struct dirent *ptr = readdir(dir)) {
+        string name = ptr->d_name;
+        if (name != "." && name != "..") {
+            count++;
+        }
+    }
+    closedir(dir);
+    return count;
+}
+
+static vector<pair<string, string>> SortAll(BExternalSorter &sorter, const vector<pair<string, string>> &input)
+{
+    for (const auto &[key, value] : input) {
+        EXPECT_TRUE(sorter.Add(key, value));
+    }
+    EXPECT_TRUE(sorter.Finish());
+    vector<pair<string, string>> output;
+    string key;
+    string value;
+    while (sorter.Next(key, value)) {
+        output.emplace_back(key, value);
+    }
+    EXPECT_FALSE(sorter.HasError());
+    return output;
+}
+
+/**
+ * @tc.number: SUB_b_external_sorter_InMemory_0100
+ * @tc.name: b_external_sorter_InMemory_0100
+ * @tc.desc: 测试未超过内存上限时不写临时文件, 空输入和重复key保持加入顺序
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BExternalSorterTest, b_external_sorter_InMemory_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BExternalSorterTest-begin b_external_sorter_InMemory_0100";
+    TestManager tm(__func__);
+    string root = tm.GetRootDirCurTest();
+
+    BExternalSorter empty(root, SMALL_MEMORY_LIMIT);
+    EXPECT_TRUE(SortAll(empty, {}).empty());
+
+    BExternalSorter sorter(root, SMALL_MEMORY_LIMIT);
+    auto output = SortAll(sorter, {{"b", "1"}, {"a", "2"}, {"b", "3"}, {"", "4"}, {"a", "5"}});
+    vector<pair<string, string>> expected = {{"", "4"}, {"a", "2"}, {"a", "5"}, {"b", "1"}, {"b", "3"}};
+    EXPECT_EQ(output, expected);
+    EXPECT_EQ(sorter.GetSpilledRunCount(), 0U);
+    GTEST_LOG_(INFO) << "BExternalSorterTest-end b_external_sorter_InMemory_0100";
+}
+
+/**
+ * @tc.number: SUB_b_external_sorter_Spill_0100
+ * @tc.name: b_external_sorter_Spill_0100
+ * @tc.desc: 测试超过内存上限后分段写入临时文件并多轮归并, 结果与稳定排序一致且不残留临时文件
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BExternalSorterTest, b_external_sorter_Spill_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BExternalSorterTest-begin b_external_sorter_Spill_0100";
+    TestManager tm(__func__);
+    string root = tm.GetRootDirCurTest();
+    mt19937 rng(RECORD_COUNT);
+    vector<pair<string, string>> input;
+    for (size_t i = 0; i < RECORD_COUNT; i++) {
+        input.emplace_back("/data/app/" + to_string(rng() % KEY_RANGE), to_string(i));
+    }
+    vector<pair<string, string>> expected = input;
+    stable_sort(expected.begin(), expected.end(),
+        [](const pair<string, string> &lhs, const pair<string, string> &rhs) { return lhs.first < rhs.first; });
+
+    BExternalSorter sorter(root, SMALL_MEMORY_LIMIT, SMALL_MERGE_WAYS);
+    auto output = SortAll(sorter, input);
+    EXPECT_GT(sorter.GetSpilledRunCount(), SMALL_MERGE_WAYS);
+    EXPECT_EQ(output, expected);
+    EXPECT_EQ(CountDirEntries(root), 0U);
+    GTEST_LOG_(INFO) << "BExternalSorterTest-end b_external_sorter_Spill_0100";
+}
+
+/**
+ * @tc.number: SUB_b_external_sorter_TmpDir_0100
+ * @tc.name: b_external_sorter_TmpDir_0100
+ * @tc.desc: 测试临时目录不可用时返回失败
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BExternalSorterTest, b_external_sorter_TmpDir_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BExternalSorterTest-begin b_external_sorter_TmpDir_0100";
+    TestManager tm(__func__);
+    string root = tm.GetRootDirCurTest();
+    BExternalSorter sorter(root + "not_exist", 1);
+    EXPECT_FALSE(sorter.Add("a", "b"));
+    EXPECT_TRUE(sorter.HasError());
+    EXPECT_FALSE(sorter.Finish());
+    string key;
+    string value;
+    EXPECT_FALSE(sorter.Next(key, value));
+    GTEST_LOG_(INFO) << "BExternalSorterTest-end b_external_sorter_TmpDir_0100";
+}
+} // namespace OHOS::FileManagement::Backup
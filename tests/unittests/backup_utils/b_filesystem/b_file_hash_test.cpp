@@ -21,6 +21,7 @@
 #include <file_ex.h>
 
 #include "b_filesystem/b_file_hash.h"
+#include "b_utils/string_utils.h"
 #include "test_manager.h"
 
 namespace OHOS::FileManagement::Backup {
@@ -111,7 +112,7 @@ HWTEST_F(BFileHashTest, b_file_hash_HashFilePath_0100, testing::ext::TestSize.Le
     try {
         std::string filePath = "/AAA/BBB/C.txt";
         std::string hashResult = BackupFileHash::HashFilePath(filePath);
-        EXPECT_TRUE(!hashResult.empty());
+        EXPECT_EQ(hashResult, StringUtils::GenHashName("C.txt"));
     } catch (const exception &e) {
         GTEST_LOG_(INFO) << "BFileHashTest-an exception occurred by HashFilePath.";
         e.what();
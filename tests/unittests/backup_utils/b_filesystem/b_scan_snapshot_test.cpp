@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "b_filesystem/b_dir.h"
+#include "b_filesystem/b_scan_snapshot.h"
+#include "test_manager.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+
+namespace {
+constexpr int64_t NS_PER_SEC = 1000000000;
+// 模拟下一次任务在较晚的时间开始, 使刚创建的文件不落在时间戳竞争窗口内
+constexpr int64_t NEXT_RUN_DELAY_NS = 10 * NS_PER_SEC;
+} // namespace
+
+class BScanSnapshotTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase() {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+static void WriteFile(const string &path, const string &content)
+{
+    ofstream file(path, ios::out | ios::trunc);
+    file << content;
+}
+
+static struct stat StatPath(const string &path)
+{
+    struct stat sta = {};
+    EXPECT_EQ(stat(path.c_str(), &sta), 0);
+    return sta;
+}
+
+static shared_ptr<BScanSnapshot> NextRun(const string &snapshotPath)
+{
+    auto snapshot = make_shared<BScanSnapshot>();
+    snapshot->startNs_ += NEXT_RUN_DELAY_NS;
+    snapshot->Load(snapshotPath);
+    return snapshot;
+}
+
+/**
+ * @tc.number: SUB_b_scan_snapshot_Dir_0100
+ * @tc.name: b_scan_snapshot_Dir_0100
+ * @tc.desc: 测试目录元数据未变化时复用条目列表, 目录内改名后不再复用
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BScanSnapshotTest, b_scan_snapshot_Dir_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BScanSnapshotTest-begin b_scan_snapshot_Dir_0100";
+    TestManager tm(__func__);
+    string root = tm.GetRootDirCurTest();
+    string dir = root + "dir";
+    string snapshotPath = root + "snapshot";
+    ASSERT_EQ(mkdir(dir.c_str(), S_IRWXU), 0);
+    WriteFile(dir + "/a", "a");
+    WriteFile(dir + "/b", "b");
+
+    auto first = NextRun(snapshotPath);
+    vector<BScanSnapshot::DirEntry> entries;
+    EXPECT_FALSE(first->LookupDir(dir, StatPath(dir), entries));
+    first->RecordDir(dir, StatPath(dir), {{"a", DT_REG}, {"b", DT_REG}});
+    ASSERT_TRUE(first->Save(snapshotPath));
+
+    auto second = NextRun(snapshotPath);
+    EXPECT_TRUE(second->LookupDir(dir, StatPath(dir), entries));
+    ASSERT_EQ(entries.size(), 2U);
+    EXPECT_EQ(entries[0].name, "a");
+    EXPECT_EQ(entries[1].name, "b");
+    ASSERT_TRUE(second->Save(snapshotPath));
+
+    ASSERT_EQ(rename((dir + "/a").c_str(), (dir + "/c").c_str()), 0);
+    auto third = NextRun(snapshotPath);
+    EXPECT_FALSE(third->LookupDir(dir, StatPath(dir), entries));
+    GTEST_LOG_(INFO) << "BScanSnapshotTest-end b_scan_snapshot_Dir_0100";
+}
+
+/**
+ * @tc.number: SUB_b_scan_snapshot_Rename_0100
+ * @tc.name: b_scan_snapshot_Rename_0100
+ * @tc.desc: 测试互换两个大小相同的文件后不复用旧的摘要
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BScanSnapshotTest, b_scan_snapshot_Rename_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BScanSnapshotTest-begin b_scan_snapshot_Rename_0100";
+    TestManager tm(__func__);
+    string root = tm.GetRootDirCurTest();
+    string x = root + "x";
+    string y = root + "y";
+    string tmp = root + "tmp";
+    string snapshotPath = root + "snapshot";
+    WriteFile(x, "xxxx");
+    WriteFile(y, "yyyy");
+
+    auto first = NextRun(snapshotPath);
+    first->RecordHash(x, StatPath(x), "hash-x");
+    first->RecordHash(y, StatPath(y), "hash-y");
+    ASSERT_TRUE(first->Save(snapshotPath));
+
+    auto second = NextRun(snapshotPath);
+    EXPECT_EQ(second->LookupHash(x, StatPath(x)), "hash-x");
+    EXPECT_EQ(second->LookupHash(y, StatPath(y)), "hash-y");
+
+    ASSERT_EQ(rename(x.c_str(), tmp.c_str()), 0);
+    ASSERT_EQ(rename(y.c_str(), x.c_str()), 0);
+    ASSERT_EQ(rename(tmp.c_str(), y.c_str()), 0);
+    auto third = NextRun(snapshotPath);
+    EXPECT_EQ(third->LookupHash(x, StatPath(x)), "");
+    EXPECT_EQ(third->LookupHash(y, StatPath(y)), "");
+    GTEST_LOG_(INFO) << "BScanSnapshotTest-end b_scan_snapshot_Rename_0100";
+}
+
+/**
+ * @tc.number: SUB_b_scan_snapshot_HardLink_0100
+ * @tc.name: b_scan_snapshot_HardLink_0100
+ * @tc.desc: 测试通过硬链接修改文件后, 两个路径都不复用旧的摘要
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BScanSnapshotTest, b_scan_snapshot_HardLink_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BScanSnapshotTest-begin b_scan_snapshot_HardLink_0100";
+    TestManager tm(__func__);
+    string root = tm.GetRootDirCurTest();
+    string origin = root + "origin";
+    string link = root + "link";
+    string snapshotPath = root + "snapshot";
+    WriteFile(origin, "content");
+    ASSERT_EQ(::link(origin.c_str(), link.c_str()), 0);
+
+    auto first = NextRun(snapshotPath);
+    first->RecordHash(origin, StatPath(origin), "hash-1");
+    first->RecordHash(link, StatPath(link), "hash-1");
+    ASSERT_TRUE(first->Save(snapshotPath));
+
+    auto second = NextRun(snapshotPath);
+    EXPECT_EQ(second->LookupHash(origin, StatPath(origin)), "hash-1");
+    EXPECT_EQ(second->LookupHash(link, StatPath(link)), "hash-1");
+    ASSERT_TRUE(second->Save(snapshotPath));
+
+    // 内容长度不变, 只有ctime和mtime可以区分
+    WriteFile(link, "CONTENT");
+    auto third = NextRun(snapshotPath);
+    EXPECT_EQ(third->LookupHash(origin, StatPath(origin)), "");
+    EXPECT_EQ(third->LookupHash(link, StatPath(link)), "");
+    GTEST_LOG_(INFO) << "BScanSnapshotTest-end b_scan_snapshot_HardLink_0100";
+}
+
+/**
+ * @tc.number: SUB_b_scan_snapshot_ClockSkew_0100
+ * @tc.name: b_scan_snapshot_ClockSkew_0100
+ * @tc.desc: 测试时间戳在快照开始时间之后的文件不被记录, 时钟回退后整个快照被丢弃
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BScanSnapshotTest, b_scan_snapshot_ClockSkew_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BScanSnapshotTest-begin b_scan_snapshot_ClockSkew_0100";
+    TestManager tm(__func__);
+    string root = tm.GetRootDirCurTest();
+    string future = root + "future";
+    string normal = root + "normal";
+    string snapshotPath = root + "snapshot";
+    WriteFile(future, "future");
+    WriteFile(normal, "normal");
+    struct timespec times[2] = {{0, UTIME_OMIT}, {0, 0}};
+    times[1].tv_sec = time(nullptr) + 3600; // 3600: mtime设置为一小时之后
+    ASSERT_EQ(utimensat(AT_FDCWD, future.c_str(), times, 0), 0);
+
+    auto first = NextRun(snapshotPath);
+    first->RecordHash(future, StatPath(future), "hash-future");
+    first->RecordHash(normal, StatPath(normal), "hash-normal");
+    ASSERT_TRUE(first->Save(snapshotPath));
+    auto second = NextRun(snapshotPath);
+    EXPECT_EQ(second->LookupHash(future, StatPath(future)), "");
+    EXPECT_EQ(second->LookupHash(normal, StatPath(normal)), "hash-normal");
+
+    // 上次快照的开始时间晚于本次, 说明时钟发生了回退
+    auto skewed = make_shared<BScanSnapshot>();
+    skewed->startNs_ += 2 * NEXT_RUN_DELAY_NS; // 2: 晚于下一次任务的开始时间
+    skewed->Load(snapshotPath);
+    skewed->RecordHash(normal, StatPath(normal), "hash-normal");
+    ASSERT_TRUE(skewed->Save(snapshotPath));
+    auto third = NextRun(snapshotPath);
+    EXPECT_TRUE(third->prevBlocks_.empty());
+    EXPECT_EQ(third->LookupHash(normal, StatPath(normal)), "");
+    GTEST_LOG_(INFO) << "BScanSnapshotTest-end b_scan_snapshot_ClockSkew_0100";
+}
+
+/**
+ * @tc.number: SUB_b_scan_snapshot_Corrupt_0100
+ * @tc.name: b_scan_snapshot_Corrupt_0100
+ * @tc.desc: 测试快照文件被截断或改写后整体丢弃
+ * @tc.size: SMALL
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BScanSnapshotTest, b_scan_snapshot_Corrupt_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BScanSnapshotTest-begin b_scan_snapshot_Corrupt_0100";
+    TestManager tm(__func__);
+    string root = tm.GetRootDirCurTest();
+    string file = root + "file";
+    string snapshotPath = root + "snapshot";
+    WriteFile(file, "file");
+    auto first = NextRun(snapshotPath);
+    first->RecordHash(file, StatPath(file), "hash");
+    ASSERT_TRUE(first->Save(snapshotPath));
+    EXPECT_TRUE(NextRun(snapshotPath)->LookupHash(file, StatPath(file)) == "hash");
+
+    struct stat sta = StatPath(snapshotPath);
+    ASSERT_EQ(truncate(snapshotPath.c_str(), sta.st_size - 1), 0);
+    BScanSnapshot truncated;
+    EXPECT_FALSE(truncated.Load(snapshotPath));
+
+    auto second = NextRun(snapshotPath);
+    second->RecordHash(file, StatPath(file), "hash");
+    ASSERT_TRUE(second->Save(snapshotPath));
+    {
+        fstream stream(snapshotPath, ios::in | ios::out | ios::binary);
+        stream.seekp(sizeof(uint32_t) * 2); // 2: 跳过magic和version, 改写开始时间
+        stream.put('\x7f');
+    }
+    BScanSnapshot modified;
+    EXPECT_FALSE(modified.Load(snapshotPath));
+    EXPECT_TRUE(modified.prevBlocks_.empty());
+    GTEST_LOG_(INFO) << "BScanSnapshotTest-end b_scan_snapshot_Corrupt_0100";
+}
+
+/**
+ * @tc.number: SUB_b_scan_snapshot_DirScanner_0100
+ * @tc.name: b_scan_snapshot_DirScanner_0100
+ * @tc.desc: 测试DirScanner复用目录条目列表时, 原地修改的文件大小仍被重新统计
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BScanSnapshotTest, b_scan_snapshot_DirScanner_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BScanSnapshotTest-begin b_scan_snapshot_DirScanner_0100";
+    TestManager tm(__func__);
+    string root = tm.GetRootDirCurTest();
+    string dir = root + "data";
+    string sub = dir + "/sub";
+    string snapshotPath = root + "snapshot";
+    ASSERT_EQ(mkdir(dir.c_str(), S_IRWXU), 0);
+    ASSERT_EQ(mkdir(sub.c_str(), S_IRWXU), 0);
+    WriteFile(dir + "/top", "0123456789");
+    WriteFile(sub + "/inner", "0123456789");
+
+    AdvancedScanOption option;
+    option.resultManager = make_shared<ScanResultManager>();
+    option.snapshot = NextRun(snapshotPath);
+    DirScanner scanner;
+    scanner.SetAdvancedScanOption(option);
+    auto [ret, bigSize, smallSize] = scanner.ScanDir(dir, {}, BConstants::BIG_FILE_BOUNDARY);
+    EXPECT_EQ(ret, ERR_OK);
+    EXPECT_EQ(smallSize, 20); // 20: 两个10字节的文件
+    ASSERT_TRUE(option.snapshot->Save(snapshotPath));
+
+    // 原地改写文件内容不改变所在目录的元数据
+    WriteFile(sub + "/inner", "01234567890123456789");
+    option.resultManager = make_shared<ScanResultManager>();
+    option.snapshot = NextRun(snapshotPath);
+    scanner.SetAdvancedScanOption(option);
+    tie(ret, bigSize, smallSize) = scanner.ScanDir(dir, {}, BConstants::BIG_FILE_BOUNDARY);
+    EXPECT_EQ(ret, ERR_OK);
+    EXPECT_EQ(smallSize, 30); // 30: 10字节和20字节的文件
+    vector<BScanSnapshot::DirEntry> entries;
+    EXPECT_TRUE(option.snapshot->LookupDir(sub, StatPath(sub), entries));
+    GTEST_LOG_(INFO) << "BScanSnapshotTest-end b_scan_snapshot_DirScanner_0100";
+}
+
+/**
+ * @tc.number: SUB_b_scan_snapshot_Blocks_0100
+ * @tc.name: b_scan_snapshot_Blocks_0100
+ * @tc.desc: 测试记录较多时快照切分为多个数据块, 加载时只读入索引, 逐块查询结果正确, 未涉及的记录被沿用
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BScanSnapshotTest, b_scan_snapshot_Blocks_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BScanSnapshotTest-begin b_scan_snapshot_Blocks_0100";
+    TestManager tm(__func__);
+    string root = tm.GetRootDirCurTest();
+    string file = root + "file";
+    string snapshotPath = root + "snapshot";
+    WriteFile(file, "file");
+    struct stat sta = StatPath(file);
+    const int recordCount = 5000;
+    auto first = NextRun(snapshotPath);
+    for (int i = 0; i < recordCount; i++) {
+        first->RecordHash(root + "dir/" + to_string(i), sta, "hash-" + to_string(i));
+    }
+    first->RecordDir(root + "dir", sta, {{"0", DT_REG}});
+    ASSERT_TRUE(first->Save(snapshotPath));
+    EXPECT_FALSE(first->Save(snapshotPath));
+
+    auto second = NextRun(snapshotPath);
+    EXPECT_GT(second->prevBlocks_.size(), 1U);
+    EXPECT_EQ(second->cachedData_.size(), 0U);
+    for (int i = 0; i < recordCount; i += 97) { // 97: 抽查分布在各数据块中的记录
+        EXPECT_EQ(second->LookupHash(root + "dir/" + to_string(i), sta), "hash-" + to_string(i));
+    }
+    EXPECT_EQ(second->LookupHash(root + "dir/missing", sta), "");
+    // 本次只查询了文件摘要, 目录记录沿用上次的结果
+    ASSERT_TRUE(second->Save(snapshotPath));
+    vector<BScanSnapshot::DirEntry> entries;
+    EXPECT_TRUE(NextRun(snapshotPath)->LookupDir(root + "dir", sta, entries));
+    ASSERT_EQ(entries.size(), 1U);
+    EXPECT_EQ(entries[0].name, "0");
+    GTEST_LOG_(INFO) << "BScanSnapshotTest-end b_scan_snapshot_Blocks_0100";
+}
+} // namespace OHOS::FileManagement::Backup
@@ -386,4 +386,139 @@ HWTEST_F(BReportEntityTest, b_report_entity_EncodeReportItem_0100, testing::ext:
     }
     GTEST_LOG_(INFO) << "BReportEntityTest-end b_report_entity_EncodeReportItem_0100";
 }
+
+static string MakeReportLine(const string &path, const string &size, const string &mtime, const string &hash)
+{
+    return path + ";0644;0;" + size + ";" + mtime + ";" + hash + ";1\n";
+}
+
+static string SaveReport(const TestManager &tm, const string &name, const string &lines)
+{
+    string filePath = tm.GetRootDirCurTest() + name;
+    string content = "version=1.0&attrNum=7\npath;mode;dir;size;mtime;hash;isIncremental\n" + lines;
+    if (bool contentCreate = SaveStringToFile(filePath, content, true); !contentCreate) {
+        throw system_error(errno, system_category());
+    }
+    return filePath;
+}
+
+/**
+ * @tc.number: SUB_backup_b_report_entity_GetNextReportInfo_0100
+ * @tc.name: b_report_entity_GetNextReportInfo_0100
+ * @tc.desc: 测试逐条读取、检查路径有序并回到文件开头
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BReportEntityTest, b_report_entity_GetNextReportInfo_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BReportEntityTest-begin b_report_entity_GetNextReportInfo_0100";
+    TestManager tm(__func__);
+    string sortedPath = SaveReport(tm, "sorted.rp",
+        MakeReportLine("/a", "1", "10", "ha") + MakeReportLine("/b", "2", "20", "hb") +
+        MakeReportLine("/b", "2", "20", "hb") + MakeReportLine("/c", "3", "30", "hc"));
+    BReportEntity sortedRp(UniqueFd(open(sortedPath.data(), O_RDONLY, 0)));
+    size_t count = 0;
+    EXPECT_TRUE(sortedRp.IsSortedByPath(count));
+    EXPECT_EQ(count, 4U);
+    struct ReportFileInfo info;
+    ASSERT_TRUE(sortedRp.GetNextReportInfo(info));
+    EXPECT_EQ(info.filePath, "a");
+    EXPECT_EQ(info.size, 1);
+    EXPECT_EQ(info.hash, "ha");
+    unordered_map<string, struct ReportFileInfo> infos;
+    EXPECT_TRUE(sortedRp.Rewind());
+    sortedRp.GetReportInfos(infos);
+    EXPECT_EQ(infos.size(), 3U);
+
+    string unsortedPath = SaveReport(tm, "unsorted.rp",
+        MakeReportLine("/b", "2", "20", "hb") + MakeReportLine("/a", "1", "10", "ha"));
+    BReportEntity unsortedRp(UniqueFd(open(unsortedPath.data(), O_RDONLY, 0)));
+    EXPECT_FALSE(unsortedRp.IsSortedByPath(count));
+    ASSERT_TRUE(unsortedRp.GetNextReportInfo(info));
+    EXPECT_EQ(info.filePath, "b");
+    GTEST_LOG_(INFO) << "BReportEntityTest-end b_report_entity_GetNextReportInfo_0100";
+}
+
+/**
+ * @tc.number: SUB_backup_b_report_entity_MergeJoin_0100
+ * @tc.name: b_report_entity_MergeJoin_0100
+ * @tc.desc: 测试归并对比的新增、修改、删除、未变化分类, 以及两侧重复条目的处理
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BReportEntityTest, b_report_entity_MergeJoin_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BReportEntityTest-begin b_report_entity_MergeJoin_0100";
+    TestManager tm(__func__);
+    string localPath = SaveReport(tm, "local.rp",
+        MakeReportLine("/added", "1", "10", "") + MakeReportLine("/changed", "2", "21", "") +
+        MakeReportLine("/dup", "4", "40", "") + MakeReportLine("/dup", "4", "40", "") +
+        MakeReportLine("/same", "3", "30", ""));
+    string cloudPath = SaveReport(tm, "cloud.rp",
+        MakeReportLine("/changed", "2", "20", "hc") + MakeReportLine("/deleted", "5", "50", "hd") +
+        MakeReportLine("/deleted", "5", "50", "hd") + MakeReportLine("/dup", "4", "40", "first") +
+        MakeReportLine("/dup", "9", "90", "second") + MakeReportLine("/same", "3", "30", "hs") +
+        MakeReportLine("/z", "6", "60", "hz"));
+    BReportEntity localRp(UniqueFd(open(localPath.data(), O_RDONLY, 0)));
+    BReportEntity cloudRp(UniqueFd(open(cloudPath.data(), O_RDONLY, 0)));
+
+    vector<string> results;
+    BReportEntity::MergeJoin(localRp, cloudRp,
+        [&results](ReportDiffType type, struct ReportFileInfo *local, const struct ReportFileInfo *cloud) {
+            string path = (local != nullptr) ? local->filePath : cloud->filePath;
+            string hash = (cloud != nullptr) ? cloud->hash : "";
+            results.emplace_back(to_string(static_cast<int>(type)) + ":" + path + ":" + hash);
+        });
+    vector<string> expected = {
+        to_string(static_cast<int>(ReportDiffType::ADDED)) + ":added:",
+        to_string(static_cast<int>(ReportDiffType::CHANGED)) + ":changed:hc",
+        to_string(static_cast<int>(ReportDiffType::DELETED)) + ":deleted:hd",
+        to_string(static_cast<int>(ReportDiffType::UNCHANGED)) + ":dup:first",
+        to_string(static_cast<int>(ReportDiffType::UNCHANGED)) + ":dup:first",
+        to_string(static_cast<int>(ReportDiffType::UNCHANGED)) + ":same:hs",
+        to_string(static_cast<int>(ReportDiffType::DELETED)) + ":z:hz",
+    };
+    EXPECT_EQ(results, expected);
+    GTEST_LOG_(INFO) << "BReportEntityTest-end b_report_entity_MergeJoin_0100";
+}
+
+/**
+ * @tc.number: SUB_backup_b_report_entity_SortByPath_0100
+ * @tc.name: b_report_entity_SortByPath_0100
+ * @tc.desc: 测试内存上限很小时外部排序得到有序简报, 原简报回到文件开头
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BReportEntityTest, b_report_entity_SortByPath_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BReportEntityTest-begin b_report_entity_SortByPath_0100";
+    TestManager tm(__func__);
+    const int fileCount = 1000;
+    string lines;
+    for (int i = fileCount; i > 0; i--) {
+        lines += MakeReportLine("/dir/" + to_string(i), to_string(i), "10", "h" + to_string(i));
+    }
+    string reportPath = SaveReport(tm, "local.rp", lines);
+    BReportEntity storageRp(UniqueFd(open(reportPath.data(), O_RDONLY, 0)));
+    size_t count = 0;
+    EXPECT_FALSE(storageRp.IsSortedByPath(count));
+
+    const size_t memoryLimit = 4096;
+    BReportEntity sortedRp(storageRp.SortByPath(tm.GetRootDirCurTest(), memoryLimit, count));
+    EXPECT_EQ(count, static_cast<size_t>(fileCount));
+    size_t sortedCount = 0;
+    EXPECT_TRUE(sortedRp.IsSortedByPath(sortedCount));
+    EXPECT_EQ(sortedCount, static_cast<size_t>(fileCount));
+    struct ReportFileInfo info;
+    ASSERT_TRUE(sortedRp.GetNextReportInfo(info));
+    EXPECT_EQ(info.filePath, "dir/1");
+    EXPECT_EQ(info.hash, "h1");
+    EXPECT_TRUE(info.isIncremental);
+    ASSERT_TRUE(storageRp.GetNextReportInfo(info));
+    EXPECT_EQ(info.filePath, "dir/1000");
+    GTEST_LOG_(INFO) << "BReportEntityTest-end b_report_entity_SortByPath_0100";
+}
 } // namespace OHOS::FileManagement::Backup
\ No newline at end of file
@@ -639,6 +639,30 @@ HWTEST_F(BJsonUtilTest, b_jsonutil_ParseBundleInfoJson_ExcludeInfos_0100, testin
     EXPECT_EQ(bundleSettingInfo.excludeInfos[1], "/data/b");
 }
 
+/**
+ * @tc.name: b_jsonutil_ParseBundleInfoJson_RestorePaths_0100
+ * @tc.desc: Test parsing restorePaths from bundle settings.
+ * @tc.type: FUNC
+ */
+HWTEST_F(BJsonUtilTest, b_jsonutil_ParseBundleInfoJson_RestorePaths_0100, testing::ext::TestSize.Level1)
+{
+    BJsonUtil::BundleDetailInfo detailInfo = {
+        .bundleName = "bundle", .bundleIndex = 0, .userId = 100};
+    std::string bundleInfo = R"({
+        "infos":[{"type":"broadcast", "details":[]}],
+        "restorePaths":["/data/storage/el2/base/files/photos/", false, "/data/storage/el2/base/a.db"]
+    })";
+    std::vector<BJsonUtil::BundleDetailInfo> bundleDetailInfos;
+    BJsonUtil::BundleSettingInfo bundleSettingInfo;
+
+    BJsonUtil::ParseBundleInfoJson(bundleInfo, bundleDetailInfos, detailInfo, bundleSettingInfo, 100);
+
+    EXPECT_TRUE(bundleSettingInfo.excludeInfos.empty());
+    ASSERT_EQ(bundleSettingInfo.restorePaths.size(), 2u);
+    EXPECT_EQ(bundleSettingInfo.restorePaths[0], "/data/storage/el2/base/files/photos/");
+    EXPECT_EQ(bundleSettingInfo.restorePaths[1], "/data/storage/el2/base/a.db");
+}
+
 /**
  * @tc.number: b_jsonutil_ParseBundleInfoJson_0200
  * @tc.name: b_jsonutil_ParseBundleInfoJson_0200
@@ -13,9 +13,14 @@
  * limitations under the License.
  */
 
+#include <cerrno>
+#include <chrono>
+#include <csignal>
 #include <cstdlib>
+#include <ctime>
 #include <string>
 
+#include <sys/resource.h>
 #include <sys/stat.h>
 
 #include <gtest/gtest.h>
@@ -121,6 +126,136 @@ HWTEST_F(BProcessTest, SUB_backup_tool_BProcess_1000, testing::ext::TestSize.Lev
     GTEST_LOG_(INFO) << "BProcessTest-end SUB_backup_tool_BProcess_1000";
 }
 
+/**
+ * @tc.number: SUB_backup_tool_BProcess_1100
+ * @tc.name: SUB_backup_tool_BProcess_1100
+ * @tc.desc: 测试Run返回结构化的退出码和终止信号
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ * @tc.require: I6F3GV
+ */
+HWTEST_F(BProcessTest, SUB_backup_tool_BProcess_1100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BProcessTest-begin SUB_backup_tool_BProcess_1100";
+    try {
+        BProcessResult result = BProcess::Run({"sh", "-c", "exit 3"}, {});
+        EXPECT_EQ(result.spawnErrno, 0);
+        EXPECT_EQ(result.exitCode, 3);
+        EXPECT_EQ(result.termSignal, 0);
+
+        result = BProcess::Run({"sh", "-c", "kill -TERM $$"}, {});
+        EXPECT_EQ(result.exitCode, -1);
+        EXPECT_EQ(result.termSignal, SIGTERM);
+
+        result = BProcess::Run({"/nonexistent/bin/cmd"}, {});
+        EXPECT_EQ(result.spawnErrno, ENOENT);
+    } catch (...) {
+        EXPECT_TRUE(false);
+        GTEST_LOG_(INFO) << "BProcessTest-an exception occurred.";
+    }
+    GTEST_LOG_(INFO) << "BProcessTest-end SUB_backup_tool_BProcess_1100";
+}
+
+/**
+ * @tc.number: SUB_backup_tool_BProcess_1200
+ * @tc.name: SUB_backup_tool_BProcess_1200
+ * @tc.desc: 测试Run超时后终止子进程, 以及检测到严重错误时终止子进程
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ * @tc.require: I6F3GV
+ */
+HWTEST_F(BProcessTest, SUB_backup_tool_BProcess_1200, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BProcessTest-begin SUB_backup_tool_BProcess_1200";
+    try {
+        BProcessOptions options;
+        options.timeoutMs = 200;
+        auto begin = chrono::steady_clock::now();
+        BProcessResult result = BProcess::Run({"sh", "-c", "sleep 5"}, options);
+        EXPECT_TRUE(result.timedOut);
+        EXPECT_EQ(result.termSignal, SIGKILL);
+        EXPECT_LT(chrono::steady_clock::now() - begin, chrono::seconds(3));
+
+        result = BProcess::Run({"sh", "-c", "echo empty archive >&2; sleep 5"}, {}, DetectFatalLog);
+        EXPECT_TRUE(result.fatalLog);
+        EXPECT_FALSE(result.timedOut);
+        EXPECT_EQ(result.termSignal, SIGKILL);
+    } catch (...) {
+        EXPECT_TRUE(false);
+        GTEST_LOG_(INFO) << "BProcessTest-an exception occurred.";
+    }
+    GTEST_LOG_(INFO) << "BProcessTest-end SUB_backup_tool_BProcess_1200";
+}
+
+/**
+ * @tc.number: SUB_backup_tool_BProcess_1300
+ * @tc.name: SUB_backup_tool_BProcess_1300
+ * @tc.desc: 测试Run为子进程设置资源限制
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ * @tc.require: I6F3GV
+ */
+HWTEST_F(BProcessTest, SUB_backup_tool_BProcess_1300, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BProcessTest-begin SUB_backup_tool_BProcess_1300";
+    try {
+        BProcessOptions options;
+        options.rlimits.emplace_back(RLIMIT_NOFILE, 64);
+        string output;
+        // 资源限制在exec前设置, 子进程启动后立即可见
+        BProcessResult result = BProcess::Run({"sh", "-c", "ulimit -n >&2"}, options,
+                                              [&output](string_view line) {
+                                                  output = line;
+                                                  return false;
+                                              });
+        EXPECT_EQ(result.exitCode, 0);
+        EXPECT_EQ(output, "64");
+
+        // 资源限制设置失败时视为启动失败, 命令不会被执行
+        options.rlimits = {{RLIMIT_NOFILE, RLIM_INFINITY}};
+        result = BProcess::Run({"sh", "-c", "exit 0"}, options);
+        EXPECT_NE(result.spawnErrno, 0);
+        EXPECT_EQ(result.exitCode, -1);
+
+        options.rlimits = {{RLIMIT_NOFILE, 64}};
+        result = BProcess::Run({"/nonexistent/bin/cmd"}, options);
+        EXPECT_EQ(result.spawnErrno, ENOENT);
+    } catch (...) {
+        EXPECT_TRUE(false);
+        GTEST_LOG_(INFO) << "BProcessTest-an exception occurred.";
+    }
+    GTEST_LOG_(INFO) << "BProcessTest-end SUB_backup_tool_BProcess_1300";
+}
+
+/**
+ * @tc.number: SUB_backup_tool_BProcess_1400
+ * @tc.name: SUB_backup_tool_BProcess_1400
+ * @tc.desc: 测试子进程关闭stderr后继续运行时, 父进程停止监听输出管道而不是空转
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ * @tc.require: I6F3GV
+ */
+HWTEST_F(BProcessTest, SUB_backup_tool_BProcess_1400, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BProcessTest-begin SUB_backup_tool_BProcess_1400";
+    try {
+        clock_t cpuBegin = clock();
+        BProcessResult result = BProcess::Run({"sh", "-c", "exec 2>&-; sleep 1"}, {});
+        clock_t cpuUsed = clock() - cpuBegin;
+        EXPECT_EQ(result.exitCode, 0);
+        // 空转时父进程会占满一个CPU约1秒
+        EXPECT_LT(cpuUsed, CLOCKS_PER_SEC / 4);
+    } catch (...) {
+        EXPECT_TRUE(false);
+        GTEST_LOG_(INFO) << "BProcessTest-an exception occurred.";
+    }
+    GTEST_LOG_(INFO) << "BProcessTest-end SUB_backup_tool_BProcess_1400";
+}
+
 class BUserIdTest : public testing::Test {
 public:
     static void SetUpTestCase() {};
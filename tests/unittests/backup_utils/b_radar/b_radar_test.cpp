@@ -23,6 +23,9 @@
 #include <file_ex.h>
 #include <gtest/gtest.h>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "hisysevent_mock.h"
 #include "b_radar/radar_app_statistic.h"
@@ -279,6 +282,7 @@ HWTEST_F(BRadarTest, RADAR_APP_STAT_0100, testing::ext::TestSize.Level1)
     GTEST_LOG_(INFO) << "BRadarTest-begin RADAR_APP_STAT_0100";
     try {
         appStatistic_->UpdateFileDist("txt", 1024);
+        appStatistic_->MergeFileStat();
         EXPECT_EQ(appStatistic_->fileSizeDist_.GetListPtr()[0].count, 1);
         EXPECT_EQ(appStatistic_->fileSizeDist_.GetListPtr()[0].size, 1024);
         EXPECT_EQ(appStatistic_->fileTypeDist_.GetListPtr()[0].count, 1);
@@ -300,6 +304,67 @@ HWTEST_F(BRadarTest, RADAR_APP_STAT_0100, testing::ext::TestSize.Level1)
     GTEST_LOG_(INFO) << "BRadarTest-end RADAR_APP_STAT_0100";
 }
 
+/**
+ * @tc.number: backup_utils_BRadar_RADAR_APP_STAT_0200
+ * @tc.name: backup_utils_BRadar_RADAR_APP_STAT_0200
+ * @tc.desc: 测试多线程并发UpdateFileStat合并后的结果与串行统计一致
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ * @tc.require: I6F3GV
+ */
+HWTEST_F(BRadarTest, RADAR_APP_STAT_0200, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BRadarTest-begin RADAR_APP_STAT_0200";
+    const vector<string> exts = {"txt", "jpg", "wav", "mov", "zip", "pdf", "unknown", ""};
+    const vector<uint64_t> sizes = {0, 1024, ONE_MB, TWO_MB + 1, TEN_MB, HUNDRED_MB, ONE_GB};
+    constexpr uint32_t threadNum = 24;
+    constexpr uint32_t filesPerThread = 2000;
+    auto fileOf = [&exts, &sizes](uint32_t thread, uint32_t i) {
+        uint32_t seq = thread * filesPerThread + i;
+        return make_tuple(exts[seq % exts.size()], sizes[seq % sizes.size()], seq % 37 + 1);
+    };
+
+    FileSizeStat serialSize;
+    FileTypeStat serialType;
+    uint32_t serialDepth = appStatistic_->dirDepth_;
+    for (uint32_t t = 0; t < threadNum; t++) {
+        for (uint32_t i = 0; i < filesPerThread; i++) {
+            auto [ext, size, depth] = fileOf(t, i);
+            serialSize.UpdateStat(size);
+            serialType.UpdateStat(ext, size);
+            serialDepth = max(serialDepth, depth);
+        }
+    }
+
+    vector<thread> workers;
+    for (uint32_t t = 0; t < threadNum; t++) {
+        workers.emplace_back([this, t, &fileOf]() {
+            for (uint32_t i = 0; i < filesPerThread; i++) {
+                auto [ext, size, depth] = fileOf(t, i);
+                appStatistic_->UpdateFileStat(ext, size, depth);
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    appStatistic_->MergeFileStat();
+    for (uint32_t i = 0; i < SIZE_DEF_COUNT; i++) {
+        EXPECT_EQ(appStatistic_->fileSizeDist_.GetListPtr()[i].count, serialSize.GetListPtr()[i].count);
+        EXPECT_EQ(appStatistic_->fileSizeDist_.GetListPtr()[i].size, serialSize.GetListPtr()[i].size);
+    }
+    for (uint32_t i = 0; i < TYPE_DEF_COUNT; i++) {
+        EXPECT_EQ(appStatistic_->fileTypeDist_.GetListPtr()[i].count, serialType.GetListPtr()[i].count);
+        EXPECT_EQ(appStatistic_->fileTypeDist_.GetListPtr()[i].size, serialType.GetListPtr()[i].size);
+    }
+    EXPECT_EQ(appStatistic_->dirDepth_, serialDepth);
+    appStatistic_->MergeFileStat();
+    EXPECT_EQ(appStatistic_->fileSizeDist_.ToJsonString(), serialSize.ToJsonString());
+    EXPECT_EQ(appStatistic_->fileTypeDist_.ToJsonString(), serialType.ToJsonString());
+    GTEST_LOG_(INFO) << "BRadarTest-end RADAR_APP_STAT_0200";
+}
+
 /**
  * @tc.number: backup_utils_BRadar_RADAR_UpdateErrorFileList_0100
  * @tc.name: backup_utils_BRadar_RADAR_UpdateErrorFileList_0100
@@ -15,6 +15,7 @@
 
 #include <cstddef>
 #include <string>
+#include <sys/stat.h>
 
 #include <file_ex.h>
 #include <gtest/gtest.h>
@@ -164,4 +165,45 @@ HWTEST_F(BTarballFactoryTest, b_tarball_factory_0400, testing::ext::TestSize.Lev
     }
     GTEST_LOG_(INFO) << "BTarballFactoryTest-end b_tarball_factory_0400";
 }
+
+/**
+ * @tc.number: SUB_b_tarball_factory_0500
+ * @tc.name: b_tarball_factory_0500
+ * @tc.desc: 测试BTarballFactory创建进程内打包器, 支持设置进度回调且能完成打包解包; 命令行打包器不支持进度回调
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BTarballFactoryTest, b_tarball_factory_0500, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BTarballFactoryTest-begin b_tarball_factory_0500";
+    try {
+        TestManager tm("b_tarball_factory_0500");
+        string root = tm.GetRootDirCurTest();
+        string src = root + "src";
+        string dst = root + "dst/";
+        ASSERT_EQ(mkdir(src.c_str(), S_IRWXU), 0);
+        ASSERT_EQ(mkdir(dst.c_str(), S_IRWXU), 0);
+        ASSERT_TRUE(SaveStringToFile(src + "/a.txt", "hello"));
+
+        auto cmdline = BTarballFactory::Create("cmdline", root + "cmdline.tar");
+        ASSERT_TRUE(cmdline != nullptr);
+        EXPECT_FALSE(cmdline->setProgress);
+
+        auto native = BTarballFactory::Create("native", root + "native.tar");
+        ASSERT_TRUE(native != nullptr && native->setProgress);
+        size_t calls = 0;
+        native->setProgress([&calls](string_view, uint64_t, uint64_t) { calls++; });
+        native->tar(src, {"a.txt"}, {});
+        native->untar(dst);
+        EXPECT_GT(calls, 0U);
+        string content;
+        EXPECT_TRUE(LoadStringFromFile(dst + "a.txt", content));
+        EXPECT_EQ(content, "hello");
+    } catch (...) {
+        EXPECT_TRUE(false);
+        GTEST_LOG_(INFO) << "BTarballFactoryTest-an exception occurred by BTarballFactory.";
+    }
+    GTEST_LOG_(INFO) << "BTarballFactoryTest-end b_tarball_factory_0500";
+}
 } // namespace OHOS::FileManagement::Backup
\ No newline at end of file
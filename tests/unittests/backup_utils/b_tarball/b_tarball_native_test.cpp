@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <climits>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <file_ex.h>
+#include <gtest/gtest.h>
+
+#include "b_error/b_error.h"
+#include "b_tarball/b_tarball_native.h"
+#include "test_manager.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+
+namespace {
+const vector<string> TAR_CANDIDATES = {"/system/bin/tar", "/usr/bin/tar", "/bin/tar"};
+const string LONG_DIR = string(120, 'd');
+const string LONG_FILE = string(150, 'f');
+constexpr size_t BIG_FILE_SIZE = 3 * 1024 * 1024 + 7;
+
+string FindTar()
+{
+    for (auto &path : TAR_CANDIDATES) {
+        if (access(path.c_str(), X_OK) == 0) {
+            return path;
+        }
+    }
+    return "";
+}
+
+/**
+ * @brief 预置待打包目录: 普通文件、空文件、空目录、超长路径、大文件和符号链接
+ */
+void PrepareSource(const string &src)
+{
+    string longDir = src + "/" + LONG_DIR;
+    ASSERT_EQ(mkdir(src.c_str(), S_IRWXU), 0);
+    ASSERT_EQ(mkdir((src + "/sub").c_str(), S_IRWXU), 0);
+    ASSERT_EQ(mkdir((src + "/empty").c_str(), S_IRWXU), 0);
+    ASSERT_EQ(mkdir(longDir.c_str(), S_IRWXU), 0);
+    ASSERT_TRUE(SaveStringToFile(src + "/a.txt", "hello"));
+    ASSERT_TRUE(SaveStringToFile(src + "/sub/zero", ""));
+    ASSERT_TRUE(SaveStringToFile(longDir + "/" + LONG_FILE, "long name"));
+    ASSERT_TRUE(SaveStringToFile(src + "/sub/big", string(BIG_FILE_SIZE, 'b')));
+    ASSERT_EQ(chmod((src + "/a.txt").c_str(), S_IRUSR | S_IWUSR | S_IXUSR), 0);
+    ASSERT_EQ(symlink("../a.txt", (src + "/sub/link").c_str()), 0);
+}
+
+void ExpectSameTree(const string &src, const string &dst)
+{
+    string content;
+    EXPECT_TRUE(LoadStringFromFile(dst + "/a.txt", content));
+    EXPECT_EQ(content, "hello");
+    EXPECT_TRUE(LoadStringFromFile(dst + "/sub/zero", content));
+    EXPECT_TRUE(content.empty());
+    EXPECT_TRUE(LoadStringFromFile(dst + "/" + LONG_DIR + "/" + LONG_FILE, content));
+    EXPECT_EQ(content, "long name");
+    EXPECT_TRUE(LoadStringFromFile(dst + "/sub/big", content));
+    EXPECT_EQ(content, string(BIG_FILE_SIZE, 'b'));
+    struct stat st = {};
+    EXPECT_EQ(stat((dst + "/empty").c_str(), &st), 0);
+    EXPECT_TRUE(S_ISDIR(st.st_mode));
+    EXPECT_EQ(stat((dst + "/a.txt").c_str(), &st), 0);
+    EXPECT_EQ(st.st_mode & 0777, static_cast<mode_t>(S_IRUSR | S_IWUSR | S_IXUSR));
+    struct stat srcSt = {};
+    EXPECT_EQ(stat((src + "/sub/big").c_str(), &srcSt), 0);
+    EXPECT_EQ(stat((dst + "/sub/big").c_str(), &st), 0);
+    EXPECT_EQ(st.st_mtime, srcSt.st_mtime);
+    char link[PATH_MAX] = {0};
+    EXPECT_GT(readlink((dst + "/sub/link").c_str(), link, sizeof(link) - 1), 0);
+    EXPECT_STREQ(link, "../a.txt");
+}
+} // namespace
+
+class BTarballNativeTest : public testing::Test {
+public:
+    static void SetUpTestCase() {};
+    static void TearDownTestCase() {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+/**
+ * @tc.number: SUB_b_tarball_native_0100
+ * @tc.name: b_tarball_native_0100
+ * @tc.desc: 测试进程内打包后解包, 普通文件、空目录、超长路径、大文件、符号链接、权限和修改时间保持一致
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BTarballNativeTest, b_tarball_native_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BTarballNativeTest-begin b_tarball_native_0100";
+    TestManager tm("b_tarball_native_0100");
+    string root = tm.GetRootDirCurTest();
+    PrepareSource(root + "/src");
+    ASSERT_EQ(mkdir((root + "/dst").c_str(), S_IRWXU), 0);
+
+    BTarballNative tarball(root, "test.tar");
+    tarball.Tar(root + "/src", {"."}, {});
+    tarball.Untar(root + "/dst");
+    ExpectSameTree(root + "/src", root + "/dst");
+    GTEST_LOG_(INFO) << "BTarballNativeTest-end b_tarball_native_0100";
+}
+
+/**
+ * @tc.number: SUB_b_tarball_native_0200
+ * @tc.name: b_tarball_native_0200
+ * @tc.desc: 测试includes为空时抛出异常, excludes中的路径不被打包
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BTarballNativeTest, b_tarball_native_0200, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BTarballNativeTest-begin b_tarball_native_0200";
+    TestManager tm("b_tarball_native_0200");
+    string root = tm.GetRootDirCurTest();
+    PrepareSource(root + "/src");
+    ASSERT_EQ(mkdir((root + "/dst").c_str(), S_IRWXU), 0);
+
+    BTarballNative tarball(root, "test.tar");
+    EXPECT_THROW(tarball.Tar(root + "/src", {}, {}), BError);
+    tarball.Tar(root + "/src", {"sub", "a.txt"}, {"sub/big"});
+    tarball.Untar(root + "/dst");
+    EXPECT_EQ(access((root + "/dst/a.txt").c_str(), F_OK), 0);
+    EXPECT_EQ(access((root + "/dst/sub/zero").c_str(), F_OK), 0);
+    EXPECT_NE(access((root + "/dst/sub/big").c_str(), F_OK), 0);
+    EXPECT_NE(access((root + "/dst/empty").c_str(), F_OK), 0);
+    GTEST_LOG_(INFO) << "BTarballNativeTest-end b_tarball_native_0200";
+}
+
+/**
+ * @tc.number: SUB_b_tarball_native_0300
+ * @tc.name: b_tarball_native_0300
+ * @tc.desc: 测试进度回调: 打包时已处理字节数单调递增且最终等于总字节数
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BTarballNativeTest, b_tarball_native_0300, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BTarballNativeTest-begin b_tarball_native_0300";
+    TestManager tm("b_tarball_native_0300");
+    string root = tm.GetRootDirCurTest();
+    PrepareSource(root + "/src");
+    ASSERT_EQ(mkdir((root + "/dst").c_str(), S_IRWXU), 0);
+
+    BTarballNative tarball(root, "test.tar");
+    uint64_t lastDone = 0;
+    uint64_t lastTotal = 0;
+    size_t calls = 0;
+    tarball.SetProgressCallback([&](string_view path, uint64_t done, uint64_t total) {
+        EXPECT_FALSE(path.empty());
+        EXPECT_GE(done, lastDone);
+        EXPECT_LE(done, total);
+        lastDone = done;
+        lastTotal = total;
+        calls++;
+    });
+    tarball.Tar(root + "/src", {"."}, {});
+    EXPECT_GT(calls, 0U);
+    EXPECT_EQ(lastDone, lastTotal);
+    EXPECT_GE(lastTotal, BIG_FILE_SIZE);
+
+    lastDone = 0;
+    calls = 0;
+    tarball.Untar(root + "/dst");
+    EXPECT_GT(calls, 0U);
+    struct stat st = {};
+    ASSERT_EQ(stat((root + "/test.tar").c_str(), &st), 0);
+    EXPECT_EQ(lastTotal, static_cast<uint64_t>(st.st_size));
+    GTEST_LOG_(INFO) << "BTarballNativeTest-end b_tarball_native_0300";
+}
+
+/**
+ * @tc.number: SUB_b_tarball_native_0400
+ * @tc.name: b_tarball_native_0400
+ * @tc.desc: 测试解包时拒绝路径穿越和经由符号链接写出根目录, 拒绝损坏的归档头
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BTarballNativeTest, b_tarball_native_0400, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BTarballNativeTest-begin b_tarball_native_0400";
+    TestManager tm("b_tarball_native_0400");
+    string root = tm.GetRootDirCurTest();
+    string tarBin = FindTar();
+    if (tarBin.empty()) {
+        GTEST_LOG_(INFO) << "tar is unavailable, skip";
+        return;
+    }
+    ASSERT_EQ(mkdir((root + "/src").c_str(), S_IRWXU), 0);
+    ASSERT_EQ(mkdir((root + "/dst").c_str(), S_IRWXU), 0);
+    ASSERT_TRUE(SaveStringToFile(root + "/src/evil", "evil"));
+    string cmd = tarBin + " -cf " + root + "/dotdot.tar -C " + root + "/src --transform=s,^,../, evil";
+    ASSERT_EQ(system(cmd.c_str()), 0);
+    BTarballNative dotdot(root, "dotdot.tar");
+    EXPECT_THROW(dotdot.Untar(root + "/dst"), BError);
+    EXPECT_NE(access((root + "/evil").c_str(), F_OK), 0);
+
+    ASSERT_EQ(symlink(root.c_str(), (root + "/src/escape").c_str()), 0);
+    ASSERT_EQ(mkdir((root + "/src/escape_dir").c_str(), S_IRWXU), 0);
+    ASSERT_TRUE(SaveStringToFile(root + "/src/escape_dir/pwned", "pwned"));
+    cmd = tarBin + " -cf " + root + "/symlink.tar -C " + root + "/src escape escape_dir/pwned " +
+          "--transform=s,^escape_dir,escape,";
+    ASSERT_EQ(system(cmd.c_str()), 0);
+    BTarballNative viaSymlink(root, "symlink.tar");
+    EXPECT_THROW(viaSymlink.Untar(root + "/dst"), BError);
+    EXPECT_NE(access((root + "/pwned").c_str(), F_OK), 0);
+
+    ASSERT_TRUE(SaveStringToFile(root + "/bad.tar", string(1024, 'x')));
+    BTarballNative bad(root, "bad.tar");
+    EXPECT_THROW(bad.Untar(root + "/dst"), BError);
+    GTEST_LOG_(INFO) << "BTarballNativeTest-end b_tarball_native_0400";
+}
+
+/**
+ * @tc.number: SUB_b_tarball_native_0500
+ * @tc.name: b_tarball_native_0500
+ * @tc.desc: 与系统tar命令做差分测试: 本实现打包的归档可被tar解开, tar打包的归档可被本实现解开, 结果一致
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BTarballNativeTest, b_tarball_native_0500, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BTarballNativeTest-begin b_tarball_native_0500";
+    TestManager tm("b_tarball_native_0500");
+    string root = tm.GetRootDirCurTest();
+    string tarBin = FindTar();
+    if (tarBin.empty()) {
+        GTEST_LOG_(INFO) << "tar is unavailable, skip";
+        return;
+    }
+    PrepareSource(root + "/src");
+    ASSERT_EQ(mkdir((root + "/by_tar").c_str(), S_IRWXU), 0);
+    ASSERT_EQ(mkdir((root + "/by_native").c_str(), S_IRWXU), 0);
+
+    BTarballNative native(root, "native.tar");
+    native.Tar(root + "/src", {"."}, {});
+    string cmd = tarBin + " -xf " + root + "/native.tar -C " + root + "/by_tar";
+    ASSERT_EQ(system(cmd.c_str()), 0);
+    ExpectSameTree(root + "/src", root + "/by_tar");
+
+    cmd = tarBin + " -cf " + root + "/cmdline.tar -C " + root + "/src .";
+    ASSERT_EQ(system(cmd.c_str()), 0);
+    BTarballNative cmdline(root, "cmdline.tar");
+    cmdline.Untar(root + "/by_native");
+    ExpectSameTree(root + "/src", root + "/by_native");
+    GTEST_LOG_(INFO) << "BTarballNativeTest-end b_tarball_native_0500";
+}
+
+/**
+ * @tc.number: SUB_b_tarball_native_0600
+ * @tc.name: b_tarball_native_0600
+ * @tc.desc: 测试解包时目标文件无法创建则抛出UTILS_TARBALL_UNPACK_FAIL, 而不是仅记录日志后继续
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BTarballNativeTest, b_tarball_native_0600, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BTarballNativeTest-begin b_tarball_native_0600";
+    TestManager tm("b_tarball_native_0600");
+    string root = tm.GetRootDirCurTest();
+    PrepareSource(root + "/src");
+    ASSERT_EQ(mkdir((root + "/dst").c_str(), S_IRWXU), 0);
+    ASSERT_EQ(mkdir((root + "/dst/a.txt").c_str(), S_IRWXU), 0);
+    ASSERT_TRUE(SaveStringToFile(root + "/dst/a.txt/keep", "keep"));
+
+    BTarballNative tarball(root, "test.tar");
+    tarball.Tar(root + "/src", {"a.txt"}, {});
+    try {
+        tarball.Untar(root + "/dst");
+        ADD_FAILURE() << "Untar should fail when the file cannot be created";
+    } catch (const BError &e) {
+        EXPECT_EQ(e.GetRawCode(), BError::Codes::UTILS_TARBALL_UNPACK_FAIL);
+    }
+    GTEST_LOG_(INFO) << "BTarballNativeTest-end b_tarball_native_0600";
+}
+} // namespace OHOS::FileManagement::Backup
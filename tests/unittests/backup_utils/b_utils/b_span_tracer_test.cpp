@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "b_utils/b_span_tracer.h"
+#include "test_manager.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+
+class BSpanTracerTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase() {};
+    void SetUp()
+    {
+        BSpanTracer::GetInstance().Clear();
+    };
+    void TearDown()
+    {
+        BSpanTracer::GetInstance().SetEnabled(false);
+        BSpanTracer::GetInstance().Clear();
+    };
+};
+
+/**
+ * @brief 导出并解析trace文件, 返回ph为X的事件
+ */
+static vector<Json::Value> ExportAndParse(const TestManager &tm)
+{
+    string path = tm.GetRootDirCurTest().append("trace.json");
+    EXPECT_TRUE(BSpanTracer::GetInstance().ExportChromeTrace(path));
+    ifstream file(path);
+    Json::Value root;
+    Json::CharReaderBuilder builder;
+    string errs;
+    EXPECT_TRUE(Json::parseFromStream(builder, file, &root, &errs)) << errs;
+    vector<Json::Value> spans;
+    for (const auto &event : root["traceEvents"]) {
+        if (event["ph"].asString() == "X") {
+            spans.emplace_back(event);
+        }
+    }
+    return spans;
+}
+
+/**
+ * @tc.number: SUB_b_span_tracer_Disabled_0100
+ * @tc.name: b_span_tracer_Disabled_0100
+ * @tc.desc: 测试未开启时BSpan不产生记录
+ * @tc.size: SMALL
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BSpanTracerTest, b_span_tracer_Disabled_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BSpanTracerTest-begin b_span_tracer_Disabled_0100";
+    TestManager tm(__func__);
+    BSpanTracer::GetInstance().SetEnabled(false);
+    {
+        BACKUP_SPAN("test.disabled");
+    }
+    EXPECT_TRUE(ExportAndParse(tm).empty());
+    GTEST_LOG_(INFO) << "BSpanTracerTest-end b_span_tracer_Disabled_0100";
+}
+
+/**
+ * @tc.number: SUB_b_span_tracer_MultiThread_0100
+ * @tc.name: b_span_tracer_MultiThread_0100
+ * @tc.desc: 测试多线程并发记录后导出的文件可解析, 每个线程的记录完整且按线程区分
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BSpanTracerTest, b_span_tracer_MultiThread_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BSpanTracerTest-begin b_span_tracer_MultiThread_0100";
+    TestManager tm(__func__);
+    BSpanTracer::GetInstance().SetEnabled(true);
+    const int threadCount = 8;
+    const int spanCount = 1000;
+    // 所有线程记录完成后才退出, 避免线程退出后缓冲区被后启动的线程复用
+    atomic<int> finished = 0;
+    vector<thread> threads;
+    for (int i = 0; i < threadCount; i++) {
+        threads.emplace_back([spanCount, threadCount, &finished]() {
+            for (int j = 0; j < spanCount; j++) {
+                BACKUP_SPAN("test.worker");
+            }
+            finished++;
+            while (finished.load() < threadCount) {
+                this_thread::yield();
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    vector<Json::Value> spans = ExportAndParse(tm);
+    EXPECT_EQ(spans.size(), static_cast<size_t>(threadCount * spanCount));
+    map<uint32_t, int> countByTid;
+    for (const auto &span : spans) {
+        EXPECT_EQ(span["name"].asString(), "test.worker");
+        EXPECT_GE(span["dur"].asDouble(), 0.0);
+        countByTid[span["tid"].asUInt()]++;
+    }
+    EXPECT_EQ(countByTid.size(), static_cast<size_t>(threadCount));
+    for (const auto &[tid, count] : countByTid) {
+        EXPECT_EQ(count, spanCount) << "tid " << tid;
+    }
+    GTEST_LOG_(INFO) << "BSpanTracerTest-end b_span_tracer_MultiThread_0100";
+}
+
+/**
+ * @tc.number: SUB_b_span_tracer_Wraparound_0100
+ * @tc.name: b_span_tracer_Wraparound_0100
+ * @tc.desc: 测试缓冲区写满后只保留最新的RING_CAPACITY条记录
+ * @tc.size: SMALL
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BSpanTracerTest, b_span_tracer_Wraparound_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BSpanTracerTest-begin b_span_tracer_Wraparound_0100";
+    TestManager tm(__func__);
+    BSpanTracer::GetInstance().SetEnabled(true);
+    const uint64_t extra = 100;
+    const uint64_t total = BSpanTracer::RING_CAPACITY + extra;
+    for (uint64_t i = 0; i < total; i++) {
+        BSpanTracer::GetInstance().Record("test.wrap", i * 1000, i * 1000 + 1); // 1000: 每条间隔1微秒
+    }
+    vector<Json::Value> spans = ExportAndParse(tm);
+    ASSERT_EQ(spans.size(), static_cast<size_t>(BSpanTracer::RING_CAPACITY));
+    double minTs = spans[0]["ts"].asDouble();
+    for (const auto &span : spans) {
+        minTs = min(minTs, span["ts"].asDouble());
+    }
+    EXPECT_DOUBLE_EQ(minTs, static_cast<double>(extra));
+    GTEST_LOG_(INFO) << "BSpanTracerTest-end b_span_tracer_Wraparound_0100";
+}
+} // namespace OHOS::FileManagement::Backup
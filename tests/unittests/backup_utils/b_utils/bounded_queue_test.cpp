@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "b_utils/bounded_queue.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+
+class BoundedQueueTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase() {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+/**
+ * @tc.number: SUB_bounded_queue_PushPop_0100
+ * @tc.name: bounded_queue_PushPop_0100
+ * @tc.desc: 测试元素按先进先出顺序出队, Close之后剩余元素仍可取出
+ * @tc.size: SMALL
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BoundedQueueTest, bounded_queue_PushPop_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BoundedQueueTest-begin bounded_queue_PushPop_0100";
+    BoundedQueue<int> queue(3);
+    EXPECT_TRUE(queue.Push(1));
+    EXPECT_TRUE(queue.Push(2));
+    EXPECT_EQ(queue.Size(), 2U);
+    queue.Close();
+    EXPECT_FALSE(queue.Push(3));
+    int item = 0;
+    EXPECT_TRUE(queue.Pop(item));
+    EXPECT_EQ(item, 1);
+    EXPECT_TRUE(queue.Pop(item));
+    EXPECT_EQ(item, 2);
+    EXPECT_FALSE(queue.Pop(item));
+    GTEST_LOG_(INFO) << "BoundedQueueTest-end bounded_queue_PushPop_0100";
+}
+
+/**
+ * @tc.number: SUB_bounded_queue_Backpressure_0100
+ * @tc.name: bounded_queue_Backpressure_0100
+ * @tc.desc: 测试生产者在队列满时被阻塞, 队列长度不超过容量
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(BoundedQueueTest, bounded_queue_Backpressure_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "BoundedQueueTest-begin bounded_queue_Backpressure_0100";
+    const size_t capacity = 4;
+    const int itemCount = 1000;
+    BoundedQueue<int> queue(capacity);
+    atomic<size_t> maxSize = 0;
+    thread producer([&queue, &maxSize, itemCount]() {
+        for (int i = 0; i < itemCount; i++) {
+            queue.Push(i);
+            size_t size = queue.Size();
+            if (size > maxSize.load()) {
+                maxSize.store(size);
+            }
+        }
+        queue.Close();
+    });
+    int item = 0;
+    int expect = 0;
+    while (queue.Pop(item)) {
+        EXPECT_EQ(item, expect++);
+    }
+    producer.join();
+    EXPECT_EQ(expect, itemCount);
+    EXPECT_LE(maxSize.load(), capacity);
+    GTEST_LOG_(INFO) << "BoundedQueueTest-end bounded_queue_Backpressure_0100";
+}
+} // namespace OHOS::FileManagement::Backup
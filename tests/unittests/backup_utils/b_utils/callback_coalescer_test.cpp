@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "b_utils/bounded_queue.h"
+#include "b_utils/callback_coalescer.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+
+namespace {
+constexpr int EVENT_COUNT = 10000;
+constexpr size_t CAPACITY = 64;
+constexpr size_t MAX_BATCH = 16;
+} // namespace
+
+class CallbackCoalescerTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase() {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+// 模拟JS线程: 按投递顺序逐个执行任务
+class EventLoop {
+public:
+    EventLoop() : tasks_(EVENT_COUNT), worker_([this]() {
+        function<void()> task;
+        while (tasks_.Pop(task)) {
+            posted_--;
+            task();
+        }
+    }) {}
+    ~EventLoop()
+    {
+        tasks_.Close();
+        worker_.join();
+    }
+    bool Post(function<void()> task)
+    {
+        size_t cur = ++posted_;
+        if (cur > maxPosted_) {
+            maxPosted_ = cur;
+        }
+        return tasks_.Push(move(task));
+    }
+    size_t GetMaxPosted() const
+    {
+        return maxPosted_;
+    }
+
+private:
+    BoundedQueue<function<void()>> tasks_;
+    atomic<size_t> posted_ = 0;
+    atomic<size_t> maxPosted_ = 0;
+    thread worker_;
+};
+
+/**
+ * @tc.number: SUB_callback_coalescer_Schedule_0100
+ * @tc.name: callback_coalescer_Schedule_0100
+ * @tc.desc: 测试大量事件合并为少量批次按序交付, 同时最多一个待执行任务, 批次大小不超过上限
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(CallbackCoalescerTest, callback_coalescer_Schedule_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "CallbackCoalescerTest-begin callback_coalescer_Schedule_0100";
+    vector<int> received;
+    size_t maxBatch = 0;
+    atomic<size_t> delivered = 0;
+    {
+        EventLoop loop;
+        auto coalescer = make_shared<CallbackCoalescer<int>>(CAPACITY, MAX_BATCH,
+            [&loop](function<void()> task) { return loop.Post(move(task)); },
+            [&received, &maxBatch, &delivered](vector<int> &batch) {
+                maxBatch = max(maxBatch, batch.size());
+                received.insert(received.end(), batch.begin(), batch.end());
+                this_thread::sleep_for(chrono::microseconds(100));
+                delivered += batch.size();
+            });
+        for (int i = 0; i < EVENT_COUNT; i++) {
+            ASSERT_TRUE(coalescer->Push(i));
+            EXPECT_LE(coalescer->Size(), CAPACITY);
+        }
+        while (delivered.load() < static_cast<size_t>(EVENT_COUNT)) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        EXPECT_EQ(loop.GetMaxPosted(), 1U);
+        GTEST_LOG_(INFO) << "events " << EVENT_COUNT << ", batches " << coalescer->GetBatchCount();
+        EXPECT_LT(coalescer->GetBatchCount(), static_cast<uint64_t>(EVENT_COUNT / 2));
+    }
+    ASSERT_EQ(received.size(), static_cast<size_t>(EVENT_COUNT));
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        EXPECT_EQ(received[i], i);
+    }
+    EXPECT_LE(maxBatch, MAX_BATCH);
+    GTEST_LOG_(INFO) << "CallbackCoalescerTest-end callback_coalescer_Schedule_0100";
+}
+
+/**
+ * @tc.number: SUB_callback_coalescer_Inline_0100
+ * @tc.name: callback_coalescer_Inline_0100
+ * @tc.desc: 测试未提供scheduler时多个生产者并发入队, 事件在入队线程中串行处理且不丢失
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(CallbackCoalescerTest, callback_coalescer_Inline_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "CallbackCoalescerTest-begin callback_coalescer_Inline_0100";
+    const int producerCount = 4;
+    atomic<int> inConsumer = 0;
+    atomic<bool> overlapped = false;
+    int total = 0;
+    auto coalescer = make_shared<CallbackCoalescer<int>>(CAPACITY, MAX_BATCH, nullptr,
+        [&inConsumer, &overlapped, &total](vector<int> &batch) {
+            if (++inConsumer > 1) {
+                overlapped = true;
+            }
+            total += static_cast<int>(batch.size());
+            inConsumer--;
+        });
+    vector<thread> producers;
+    for (int i = 0; i < producerCount; i++) {
+        producers.emplace_back([&coalescer]() {
+            for (int j = 0; j < EVENT_COUNT; j++) {
+                coalescer->Push(j);
+            }
+        });
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    EXPECT_FALSE(overlapped.load());
+    EXPECT_EQ(total, producerCount * EVENT_COUNT);
+    EXPECT_EQ(coalescer->Size(), 0U);
+    GTEST_LOG_(INFO) << "CallbackCoalescerTest-end callback_coalescer_Inline_0100";
+}
+
+/**
+ * @tc.number: SUB_callback_coalescer_Close_0100
+ * @tc.name: callback_coalescer_Close_0100
+ * @tc.desc: 测试投递失败后关闭, Close唤醒阻塞的生产者并丢弃未处理事件
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(CallbackCoalescerTest, callback_coalescer_Close_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "CallbackCoalescerTest-begin callback_coalescer_Close_0100";
+    auto failed = make_shared<CallbackCoalescer<int>>(CAPACITY, MAX_BATCH,
+        [](function<void()>) { return false; }, [](vector<int> &) {});
+    EXPECT_FALSE(failed->Push(1));
+    EXPECT_FALSE(failed->Push(2));
+
+    // 任务从不执行, 队列满后生产者阻塞, 直到Close
+    vector<function<void()>> pending;
+    auto stalled = make_shared<CallbackCoalescer<int>>(1, MAX_BATCH,
+        [&pending](function<void()> task) {
+            pending.emplace_back(move(task));
+            return true;
+        },
+        [](vector<int> &) { ADD_FAILURE(); });
+    EXPECT_TRUE(stalled->Push(1));
+    atomic<bool> blockedResult = true;
+    thread producer([&stalled, &blockedResult]() { blockedResult = stalled->Push(2); });
+    this_thread::sleep_for(chrono::milliseconds(20));
+    EXPECT_EQ(stalled->Size(), 1U);
+    stalled->Close();
+    producer.join();
+    EXPECT_FALSE(blockedResult.load());
+    EXPECT_EQ(stalled->Size(), 0U);
+    ASSERT_EQ(pending.size(), 1U);
+    pending[0]();
+    stalled.reset();
+    pending[0]();
+    GTEST_LOG_(INFO) << "CallbackCoalescerTest-end callback_coalescer_Close_0100";
+}
+/**
+ * @tc.number: SUB_callback_coalescer_Close_0200
+ * @tc.name: callback_coalescer_Close_0200
+ * @tc.desc: 测试其他线程正在执行consumer时, Close等待其返回后才退出
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(CallbackCoalescerTest, callback_coalescer_Close_0200, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "CallbackCoalescerTest-begin callback_coalescer_Close_0200";
+    atomic<bool> entered = false;
+    atomic<bool> finished = false;
+    auto coalescer = make_shared<CallbackCoalescer<int>>(CAPACITY, MAX_BATCH, nullptr,
+        [&entered, &finished](vector<int> &) {
+            entered = true;
+            this_thread::sleep_for(chrono::milliseconds(50));
+            finished = true;
+        });
+    thread producer([&coalescer]() { coalescer->Push(1); });
+    while (!entered.load()) {
+        this_thread::yield();
+    }
+    coalescer->Close();
+    EXPECT_TRUE(finished.load());
+    producer.join();
+    EXPECT_FALSE(coalescer->Push(2));
+
+    // consumer内部调用Close不能死锁
+    shared_ptr<CallbackCoalescer<int>> self;
+    self = make_shared<CallbackCoalescer<int>>(CAPACITY, MAX_BATCH, nullptr,
+        [&self](vector<int> &) { self->Close(); });
+    EXPECT_TRUE(self->Push(1));
+    EXPECT_FALSE(self->Push(2));
+    GTEST_LOG_(INFO) << "CallbackCoalescerTest-end callback_coalescer_Close_0200";
+}
+} // namespace OHOS::FileManagement::Backup
@@ -13,8 +13,12 @@
  * limitations under the License.
  */
 
+#include <atomic>
 #include <cstdio>
 #include <chrono>
+#include <set>
+#include <thread>
+#include <vector>
 
 #include <fcntl.h>
 
@@ -61,10 +65,8 @@ public:
     static void TearDownTestCase() {};
     void SetUp()
     {
-        std::queue<std::shared_ptr<IFileInfo>> emptyQueue;
-        manager_.pendingFileQueue_.swap(emptyQueue);
+        manager_.pendingFileQueue_.Clear();
         manager_.smallFiles_.clear();
-        manager_.stopPacket_.store(false);
         manager_.currentTarSize_.store(0);
         manager_.maxTarSize_.store(ONE_HUNDRED_FIFTY_MB);
     };
@@ -317,9 +319,8 @@ HWTEST_F(ScanResultManagerTest, ADD_TAR_FILE_TEST_001, testing::ext::TestSize.Le
     struct stat sta = {.st_size = 1024};
     EXPECT_FALSE(manager_.HasFileReady());
     manager_.maxTarSize_.store(ONE_HUNDRED_FIFTY_MB);
-    manager_.stopPacket_.store(false);
     manager_.AddTarFile(filename, filePath, sta);
-    EXPECT_EQ(manager_.pendingFileQueue_.size(), 1);
+    EXPECT_EQ(manager_.pendingFileQueue_.Size(), 1);
     EXPECT_TRUE(manager_.HasFileReady());
     GTEST_LOG_(INFO) << "ScanResultManagerTest-end: ADD_TAR_FILE_TEST_001";
 }
@@ -341,14 +342,53 @@ HWTEST_F(ScanResultManagerTest, ADD_TAR_FILE_TEST_002, testing::ext::TestSize.Le
     struct stat sta = {.st_size = 1024};
     manager_.maxTarSize_.store(1000); // maxTarSize smaller than file size
     manager_.currentTarSize_.store(0);
-    manager_.stopPacket_.store(false);
     manager_.AddTarFile(filename, filePath, sta);
-    EXPECT_EQ(manager_.pendingFileQueue_.size(), 1);
+    EXPECT_EQ(manager_.pendingFileQueue_.Size(), 1);
     EXPECT_TRUE(manager_.HasFileReady());
-    EXPECT_TRUE(manager_.stopPacket_.load());
+    EXPECT_TRUE(manager_.IsTarBudgetExhausted());
     GTEST_LOG_(INFO) << "ScanResultManagerTest-end: ADD_TAR_FILE_TEST_002";
 }
 
+/**
+ * @tc.number: RESERVE_TAR_BUDGET_TEST_001
+ * @tc.name: RESERVE_TAR_BUDGET_TEST_001
+ * @tc.desc: Test function of ReserveTarBudget, AddTarFile corrects the reservation and CancelTarBudget returns it
+ * @tc.size: SMALL
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(ScanResultManagerTest, RESERVE_TAR_BUDGET_TEST_001, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "ScanResultManagerTest-begin: RESERVE_TAR_BUDGET_TEST_001";
+    manager_.maxTarSize_.store(ONE_HUNDRED_FIFTY_MB);
+    manager_.currentTarSize_.store(0);
+    manager_.ReserveTarBudget(2048);
+    EXPECT_EQ(manager_.currentTarSize_.load(), 2048U);
+    struct stat sta = {.st_size = 3072};
+    manager_.AddTarFile("part.0.tar", "/tmp/part.0.tar", sta, 2048);
+    EXPECT_EQ(manager_.currentTarSize_.load(), 3072U);
+
+    manager_.ReserveTarBudget(1024);
+    manager_.CancelTarBudget(1024);
+    EXPECT_EQ(manager_.currentTarSize_.load(), 3072U);
+
+    GTEST_LOG_(INFO) << "2. the first reservation exceeds the budget, the second one waits for a release";
+    manager_.maxTarSize_.store(4096);
+    manager_.ReserveTarBudget(2048);
+    EXPECT_TRUE(manager_.IsTarBudgetExhausted());
+    std::atomic<bool> reserved = false;
+    std::thread lane([this, &reserved]() {
+        manager_.ReserveTarBudget(2048);
+        reserved.store(true);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_FALSE(reserved.load());
+    manager_.CancelTarBudget(2048);
+    lane.join();
+    EXPECT_TRUE(reserved.load());
+    GTEST_LOG_(INFO) << "ScanResultManagerTest-end: RESERVE_TAR_BUDGET_TEST_001";
+}
+
 /**
  * @tc.number: GET_FILE_INFO_TEST_001
  * @tc.name: GET_FILE_INFO_TEST_001
@@ -369,12 +409,11 @@ HWTEST_F(ScanResultManagerTest, GET_FILE_INFO_TEST_001, testing::ext::TestSize.L
     struct stat sta = {.st_size = 1024};
     manager_.maxTarSize_.store(ONE_HUNDRED_FIFTY_MB);
     manager_.currentTarSize_.store(ONE_HUNDRED_FIFTY_MB + 2048);
-    manager_.stopPacket_.store(true);
     manager_.AddTarFile(filename, filePath, sta);
     auto fileInfo = manager_.GetFileInfo();
     ASSERT_NE(fileInfo, nullptr);
     EXPECT_EQ(fileInfo->GetRestorePath(), "");
-    EXPECT_TRUE(manager_.stopPacket_.load());
+    EXPECT_TRUE(manager_.IsTarBudgetExhausted());
     GTEST_LOG_(INFO) << "ScanResultManagerTest-end: GET_FILE_INFO_TEST_001";
 }
 
@@ -476,7 +515,7 @@ HWTEST_F(ScanResultManagerTest, WAIT_FOR_FILES_TEST_001, testing::ext::TestSize.
     std::string filePath = "abc/aaa/test1";
     struct stat sta = {};
     manager_.AddBigFile(filePath, sta, false);
-    EXPECT_EQ(manager_.pendingFileQueue_.size(), 1);
+    EXPECT_EQ(manager_.pendingFileQueue_.Size(), 1);
 
     auto start = std::chrono::steady_clock::now();
     manager_.WaitForFiles();
@@ -501,10 +540,9 @@ HWTEST_F(ScanResultManagerTest, WAIT_FOR_PACKET_FLAG_TEST_001, testing::ext::Tes
     std::string filePath = "abc/aaa/test1";
     struct stat sta = {};
     manager_.AddBigFile(filePath, sta, false);
-    EXPECT_EQ(manager_.pendingFileQueue_.size(), 1);
-    manager_.stopPacket_ = true;
+    EXPECT_EQ(manager_.pendingFileQueue_.Size(), 1);
     manager_.StartPacket();
-    EXPECT_FALSE(manager_.stopPacket_);
+    EXPECT_FALSE(manager_.IsTarBudgetExhausted());
 
     auto start = std::chrono::steady_clock::now();
     manager_.WaitForPacketFlag();
@@ -630,8 +668,8 @@ HWTEST_F(ScanResultManagerTest, ADD_ANCO_TARFILE_TEST_001, testing::ext::TestSiz
 
     manager_.AddAncoTarFile(filename, filePath, sta);
 
-    EXPECT_EQ(manager_.pendingFileQueue_.size(), 1);
-    auto frontItem = manager_.pendingFileQueue_.front();
+    EXPECT_EQ(manager_.pendingFileQueue_.Size(), 1);
+    auto frontItem = manager_.GetFileInfo();
     EXPECT_NE(frontItem, nullptr);
     GTEST_LOG_(INFO) << "ScanResultManagerTest-end: ADD_ANCO_TARFILE_TEST_001";
 }
@@ -657,8 +695,8 @@ HWTEST_F(ScanResultManagerTest, ADD_ANCO_TARFILE_TEST_002, testing::ext::TestSiz
 
     manager_.AddAncoTarFile(filename, filePath, sta);
 
-    EXPECT_EQ(manager_.pendingFileQueue_.size(), 1);
-    auto frontItem = manager_.pendingFileQueue_.front();
+    EXPECT_EQ(manager_.pendingFileQueue_.Size(), 1);
+    auto frontItem = manager_.GetFileInfo();
     EXPECT_NE(frontItem, nullptr);
     GTEST_LOG_(INFO) << "ScanResultManagerTest-end: ADD_ANCO_TARFILE_TEST_002";
 }
@@ -692,7 +730,6 @@ HWTEST_F(ScanResultManagerTest, CURRENT_TAR_SIZE_EXCEED_001, testing::ext::TestS
     GTEST_LOG_(INFO) << "ScanResultManagerTest-begin: CURRENT_TAR_SIZE_EXCEED_001";
     manager_.maxTarSize_.store(1000);
     manager_.currentTarSize_.store(0);
-    manager_.stopPacket_.store(false);
 
     std::string filename = "test.tar";
     std::string filePath = "/tmp/test.tar";
@@ -700,7 +737,7 @@ HWTEST_F(ScanResultManagerTest, CURRENT_TAR_SIZE_EXCEED_001, testing::ext::TestS
 
     manager_.AddTarFile(filename, filePath, sta);
 
-    EXPECT_TRUE(manager_.stopPacket_.load());
+    EXPECT_TRUE(manager_.IsTarBudgetExhausted());
     GTEST_LOG_(INFO) << "ScanResultManagerTest-end: CURRENT_TAR_SIZE_EXCEED_001";
 }
 
@@ -717,7 +754,6 @@ HWTEST_F(ScanResultManagerTest, CURRENT_TAR_SIZE_RECOVER_001, testing::ext::Test
     GTEST_LOG_(INFO) << "ScanResultManagerTest-begin: CURRENT_TAR_SIZE_RECOVER_001";
     manager_.maxTarSize_.store(ONE_HUNDRED_FIFTY_MB);
     manager_.currentTarSize_.store(ONE_HUNDRED_FIFTY_MB + 2048);
-    manager_.stopPacket_.store(true);
 
     std::string filename = "test.tar";
     std::string filePath = "/tmp/test.tar";
@@ -728,7 +764,7 @@ HWTEST_F(ScanResultManagerTest, CURRENT_TAR_SIZE_RECOVER_001, testing::ext::Test
     auto fileInfo = manager_.GetFileInfo();
     ASSERT_NE(fileInfo, nullptr);
 
-    EXPECT_TRUE(manager_.stopPacket_.load());
+    EXPECT_TRUE(manager_.IsTarBudgetExhausted());
     GTEST_LOG_(INFO) << "ScanResultManagerTest-end: CURRENT_TAR_SIZE_RECOVER_001";
 }
 
@@ -745,7 +781,6 @@ HWTEST_F(ScanResultManagerTest, CURRENT_TAR_SIZE_MULTIPLE_FILES_001, testing::ex
     GTEST_LOG_(INFO) << "ScanResultManagerTest-begin: CURRENT_TAR_SIZE_MULTIPLE_FILES_001";
     manager_.maxTarSize_.store(ONE_HUNDRED_FIFTY_MB);
     manager_.currentTarSize_.store(0);
-    manager_.stopPacket_.store(false);
 
     struct stat sta1 = {.st_size = 1024};
     struct stat sta2 = {.st_size = 2048};
@@ -766,4 +801,161 @@ HWTEST_F(ScanResultManagerTest, CURRENT_TAR_SIZE_MULTIPLE_FILES_001, testing::ex
     GTEST_LOG_(INFO) << "ScanResultManagerTest-end: CURRENT_TAR_SIZE_MULTIPLE_FILES_001";
 }
 
+/**
+ * @tc.number: PENDING_FILE_STRESS_TEST_001
+ * @tc.name: PENDING_FILE_STRESS_TEST_001
+ * @tc.desc: 测试16个扫描线程并发添加同名大文件, 4个线程并发批量取出, 文件不丢失且哈希名不重复
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(ScanResultManagerTest, PENDING_FILE_STRESS_TEST_001, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "ScanResultManagerTest-begin: PENDING_FILE_STRESS_TEST_001";
+    const int producerCount = 16;
+    const int consumerCount = 4;
+    const int fileCountPerProducer = 200;
+    const size_t popBatch = 8;
+    std::atomic<int> producersDone = 0;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producerCount; p++) {
+        producers.emplace_back([this, &producersDone, p, fileCountPerProducer]() {
+            struct stat sta = {};
+            for (int i = 0; i < fileCountPerProducer; i++) {
+                // 不同线程使用相同路径, 触发哈希名冲突处理
+                manager_.AddBigFile("/tmp/stress/file" + std::to_string(i), sta, false);
+            }
+            if (p % 2 == 0) {
+                manager_.AddTarFile("part." + std::to_string(p) + ".tar", "/tmp/stress/part.tar", sta);
+            }
+            producersDone++;
+        });
+    }
+    std::vector<std::vector<std::shared_ptr<IFileInfo>>> received(consumerCount);
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < consumerCount; c++) {
+        consumers.emplace_back([this, &producersDone, &received, c, producerCount, popBatch]() {
+            while (true) {
+                bool done = producersDone.load() == producerCount;
+                auto fileInfos = manager_.GetFileInfos(popBatch);
+                if (fileInfos.empty()) {
+                    if (done) {
+                        break;
+                    }
+                    std::this_thread::yield();
+                }
+                for (const auto &fileInfo : fileInfos) {
+                    manager_.ReleaseTarBudget(fileInfo);
+                }
+                received[c].insert(received[c].end(), fileInfos.begin(), fileInfos.end());
+            }
+        });
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    for (auto &consumer : consumers) {
+        consumer.join();
+    }
+    std::set<std::string> names;
+    size_t total = 0;
+    for (const auto &fileInfos : received) {
+        for (const auto &fileInfo : fileInfos) {
+            ASSERT_NE(fileInfo, nullptr);
+            names.insert(fileInfo->filename_);
+            total++;
+        }
+    }
+    size_t expectCount = producerCount * fileCountPerProducer + producerCount / 2;
+    EXPECT_EQ(total, expectCount);
+    EXPECT_EQ(names.size(), expectCount);
+    EXPECT_FALSE(manager_.HasFileReady());
+    EXPECT_EQ(manager_.currentTarSize_.load(), 0);
+    GTEST_LOG_(INFO) << "ScanResultManagerTest-end: PENDING_FILE_STRESS_TEST_001";
+}
+
+/**
+ * @tc.number: PENDING_FILE_CAPACITY_TEST_001
+ * @tc.name: PENDING_FILE_CAPACITY_TEST_001
+ * @tc.desc: 测试扫描结果队列达到容量时扫描线程阻塞, 回传侧批量取出后扫描线程继续
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(ScanResultManagerTest, PENDING_FILE_CAPACITY_TEST_001, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "ScanResultManagerTest-begin: PENDING_FILE_CAPACITY_TEST_001";
+    const size_t capacity = BConstants::SCAN_RESULT_QUEUE_CAPACITY;
+    const size_t extraCount = 10;
+    std::atomic<size_t> addedCount = 0;
+    std::thread producer([this, &addedCount, capacity, extraCount]() {
+        struct stat sta = {};
+        for (size_t i = 0; i < capacity + extraCount; i++) {
+            manager_.AddBigFile("/tmp/capacity/file" + std::to_string(i), sta, false);
+            addedCount++;
+        }
+    });
+    auto waitAdded = [&addedCount](size_t expect) {
+        for (int i = 0; i < 500 && addedCount.load() < expect; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    };
+    waitAdded(capacity);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(addedCount.load(), capacity);
+    EXPECT_EQ(manager_.pendingFileQueue_.Size(), capacity);
+
+    auto fileInfos = manager_.GetFileInfos(BConstants::BACKUP_FILE_FETCH_BATCH);
+    EXPECT_EQ(fileInfos.size(), BConstants::BACKUP_FILE_FETCH_BATCH);
+    waitAdded(capacity + extraCount);
+    producer.join();
+    EXPECT_EQ(addedCount.load(), capacity + extraCount);
+    EXPECT_EQ(manager_.pendingFileQueue_.Size(), capacity + extraCount - BConstants::BACKUP_FILE_FETCH_BATCH);
+    GTEST_LOG_(INFO) << "ScanResultManagerTest-end: PENDING_FILE_CAPACITY_TEST_001";
+}
+
+/**
+ * @tc.number: PENDING_FILE_STOP_TEST_001
+ * @tc.name: PENDING_FILE_STOP_TEST_001
+ * @tc.desc: 测试队列已满时发送侧停止, 阻塞的扫描线程返回且不再入队, 重置后可继续入队
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(ScanResultManagerTest, PENDING_FILE_STOP_TEST_001, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "ScanResultManagerTest-begin: PENDING_FILE_STOP_TEST_001";
+    const size_t capacity = BConstants::SCAN_RESULT_QUEUE_CAPACITY;
+    const size_t extraCount = 10;
+    std::atomic<size_t> addedCount = 0;
+    std::thread producer([this, &addedCount, capacity, extraCount]() {
+        struct stat sta = {};
+        for (size_t i = 0; i < capacity + extraCount; i++) {
+            manager_.AddBigFile("/tmp/stop/file" + std::to_string(i), sta, false);
+            addedCount++;
+        }
+    });
+    for (int i = 0; i < 500 && addedCount.load() < capacity; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(addedCount.load(), capacity);
+    manager_.StopPendingFiles();
+    producer.join();
+    EXPECT_EQ(addedCount.load(), capacity + extraCount);
+    EXPECT_TRUE(manager_.IsPendingStopped());
+    EXPECT_FALSE(manager_.HasFileReady());
+
+    manager_.ResetPendingFiles();
+    EXPECT_FALSE(manager_.IsPendingStopped());
+    struct stat sta = {.st_size = 1024};
+    manager_.maxTarSize_.store(ONE_HUNDRED_FIFTY_MB);
+    manager_.AddTarFile("part.0.tar", "/tmp/stop/part.0.tar", sta);
+    auto fileInfos = manager_.GetFileInfos(BConstants::BACKUP_FILE_FETCH_BATCH);
+    ASSERT_EQ(fileInfos.size(), 1U);
+    EXPECT_EQ(manager_.currentTarSize_.load(), 1024U);
+    manager_.ReleaseTarBudget(fileInfos[0]);
+    EXPECT_EQ(manager_.currentTarSize_.load(), 0U);
+    GTEST_LOG_(INFO) << "ScanResultManagerTest-end: PENDING_FILE_STOP_TEST_001";
+}
+
 } // namespace OHOS::FileManagement::Backup
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "b_utils/sharded_queue.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+
+namespace {
+constexpr int PRODUCER_COUNT = 16;
+constexpr int CONSUMER_COUNT = 4;
+constexpr int ITEM_COUNT_PER_PRODUCER = 5000;
+constexpr int ITEM_INDEX_BASE = 100000;
+constexpr size_t SHARD_COUNT = 8;
+constexpr size_t CAPACITY = 256;
+constexpr size_t POP_BATCH = 16;
+constexpr size_t PUSH_BATCH = 7;
+}
+
+class ShardedQueueTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+    static void TearDownTestCase() {};
+    void SetUp() {};
+    void TearDown() {};
+};
+
+/**
+ * @tc.number: SUB_sharded_queue_PushPop_0100
+ * @tc.name: sharded_queue_PushPop_0100
+ * @tc.desc: 测试单生产者先进先出, 批量出队在 stopAfter 命中时结束本批
+ * @tc.size: SMALL
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(ShardedQueueTest, sharded_queue_PushPop_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "ShardedQueueTest-begin sharded_queue_PushPop_0100";
+    ShardedQueue<int> queue(SHARD_COUNT, CAPACITY);
+    int item = 0;
+    EXPECT_FALSE(queue.TryPop(item));
+    vector<int> items = {1, 2, 3, 4, 5};
+    queue.PushBatch(items);
+    EXPECT_TRUE(items.empty());
+    queue.Push(6);
+    EXPECT_EQ(queue.Size(), 6U);
+
+    EXPECT_TRUE(queue.TryPop(item));
+    EXPECT_EQ(item, 1);
+    vector<int> out;
+    EXPECT_EQ(queue.PopBatch(out, POP_BATCH, [](const int &value) { return value == 3; }), 2U);
+    EXPECT_EQ(out, vector<int>({2, 3}));
+    out.clear();
+    EXPECT_EQ(queue.PopBatch(out, POP_BATCH), 3U);
+    EXPECT_EQ(out, vector<int>({4, 5, 6}));
+    EXPECT_TRUE(queue.Empty());
+
+    queue.Push(7);
+    queue.Clear();
+    EXPECT_TRUE(queue.Empty());
+    EXPECT_FALSE(queue.TryPop(item));
+    GTEST_LOG_(INFO) << "ShardedQueueTest-end sharded_queue_PushPop_0100";
+}
+
+/**
+ * @tc.number: SUB_sharded_queue_Close_0100
+ * @tc.name: sharded_queue_Close_0100
+ * @tc.desc: 测试队列满时阻塞的生产者在 Close 后返回 false, 已入队元素仍可取出, Reopen 后可继续入队
+ * @tc.size: SMALL
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(ShardedQueueTest, sharded_queue_Close_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "ShardedQueueTest-begin sharded_queue_Close_0100";
+    ShardedQueue<int> queue(SHARD_COUNT, 1);
+    EXPECT_TRUE(queue.Push(1));
+    atomic<bool> pushed = true;
+    thread producer([&queue, &pushed]() { pushed.store(queue.Push(2)); });
+    queue.Close();
+    producer.join();
+    EXPECT_FALSE(pushed.load());
+    vector<int> items = {3, 4};
+    EXPECT_FALSE(queue.PushBatch(items));
+    EXPECT_TRUE(items.empty());
+
+    int item = 0;
+    EXPECT_TRUE(queue.TryPop(item));
+    EXPECT_EQ(item, 1);
+    EXPECT_TRUE(queue.Empty());
+    queue.Reopen();
+    EXPECT_TRUE(queue.Push(5));
+    EXPECT_EQ(queue.Size(), 1U);
+    GTEST_LOG_(INFO) << "ShardedQueueTest-end sharded_queue_Close_0100";
+}
+
+/**
+ * @tc.number: SUB_sharded_queue_Stress_0100
+ * @tc.name: sharded_queue_Stress_0100
+ * @tc.desc: 16个生产者4个消费者并发读写, 每个元素恰好取出一次, 同一生产者的元素保持顺序, 长度不超过容量
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(ShardedQueueTest, sharded_queue_Stress_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "ShardedQueueTest-begin sharded_queue_Stress_0100";
+    ShardedQueue<int> queue(SHARD_COUNT, CAPACITY);
+    atomic<int> producersDone = 0;
+    atomic<size_t> maxSize = 0;
+    vector<thread> producers;
+    for (int p = 0; p < PRODUCER_COUNT; p++) {
+        producers.emplace_back([&queue, &producersDone, &maxSize, p]() {
+            vector<int> batch;
+            for (int i = 0; i < ITEM_COUNT_PER_PRODUCER; i++) {
+                int value = p * ITEM_INDEX_BASE + i;
+                if (p % 2 == 0) {
+                    queue.Push(value);
+                } else {
+                    batch.push_back(value);
+                    if (batch.size() == PUSH_BATCH || i == ITEM_COUNT_PER_PRODUCER - 1) {
+                        queue.PushBatch(batch);
+                    }
+                }
+                size_t size = queue.Size();
+                if (size > maxSize.load()) {
+                    maxSize.store(size);
+                }
+            }
+            producersDone++;
+        });
+    }
+    vector<vector<int>> received(CONSUMER_COUNT);
+    vector<thread> consumers;
+    for (int c = 0; c < CONSUMER_COUNT; c++) {
+        consumers.emplace_back([&queue, &producersDone, &received, c]() {
+            while (true) {
+                bool done = producersDone.load() == PRODUCER_COUNT;
+                if (queue.PopBatch(received[c], POP_BATCH) == 0) {
+                    if (done) {
+                        break;
+                    }
+                    this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    for (auto &consumer : consumers) {
+        consumer.join();
+    }
+
+    vector<int> seen(PRODUCER_COUNT * ITEM_COUNT_PER_PRODUCER, 0);
+    for (const auto &items : received) {
+        vector<int> lastIndex(PRODUCER_COUNT, -1);
+        for (int value : items) {
+            int p = value / ITEM_INDEX_BASE;
+            int i = value % ITEM_INDEX_BASE;
+            ASSERT_LT(p, PRODUCER_COUNT);
+            EXPECT_GT(i, lastIndex[p]);
+            lastIndex[p] = i;
+            seen[p * ITEM_COUNT_PER_PRODUCER + i]++;
+        }
+    }
+    for (int count : seen) {
+        EXPECT_EQ(count, 1);
+    }
+    EXPECT_TRUE(queue.Empty());
+    EXPECT_LE(maxSize.load(), CAPACITY);
+    GTEST_LOG_(INFO) << "ShardedQueueTest-end sharded_queue_Stress_0100";
+}
+
+/**
+ * @tc.number: SUB_sharded_name_set_Insert_0100
+ * @tc.name: sharded_name_set_Insert_0100
+ * @tc.desc: 测试16个线程并发登记同一批名称, 每个名称只有一次登记成功
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ */
+HWTEST_F(ShardedQueueTest, sharded_name_set_Insert_0100, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "ShardedQueueTest-begin sharded_name_set_Insert_0100";
+    ShardedNameSet names(SHARD_COUNT);
+    atomic<int> inserted = 0;
+    vector<thread> threads;
+    for (int t = 0; t < PRODUCER_COUNT; t++) {
+        threads.emplace_back([&names, &inserted]() {
+            for (int i = 0; i < ITEM_COUNT_PER_PRODUCER; i++) {
+                if (names.Insert(to_string(i))) {
+                    inserted++;
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(inserted.load(), ITEM_COUNT_PER_PRODUCER);
+    EXPECT_TRUE(names.Contains("0"));
+    names.Clear();
+    EXPECT_FALSE(names.Contains("0"));
+    GTEST_LOG_(INFO) << "ShardedQueueTest-end sharded_name_set_Insert_0100";
+}
+} // namespace OHOS::FileManagement::Backup
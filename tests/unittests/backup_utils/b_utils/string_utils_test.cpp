@@ -13,6 +13,10 @@
  * limitations under the License.
  */
 
+#include <set>
+#include <string>
+#include <unordered_set>
+
 #include <gtest/gtest.h>
 #include "b_resources/b_constants.h"
 #include "b_utils/string_utils.h"
@@ -211,10 +215,89 @@ HWTEST_F(StringUtilsTest, GEN_HASH_NAME_TEST_001, testing::ext::TestSize.Level1)
     std::string str = "abcdef1234";
     auto hash = StringUtils::GenHashName(str);
     GTEST_LOG_(INFO) << hash;
-    EXPECT_EQ(hash.length(), 16);
+    EXPECT_EQ(hash.length(), 32);
     GTEST_LOG_(INFO) << "StringUtilsTest-end GEN_HASH_NAME_TEST_001";
 }
 
+/**
+ * @tc.number: GEN_HASH_NAME_TEST_002
+ * @tc.name: GEN_HASH_NAME_TEST_002
+ * @tc.desc: 测试GenHashName结果稳定, 与编译器和标准库实现无关
+ * @tc.size: SMALL
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ * @tc.require: NA
+ */
+HWTEST_F(StringUtilsTest, GEN_HASH_NAME_TEST_002, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "StringUtilsTest-begin GEN_HASH_NAME_TEST_002";
+    EXPECT_EQ(StringUtils::GenHashName(""), "00000000000000000000000000000000");
+    EXPECT_EQ(StringUtils::GenHashName("hello"), "cbd8a7b341bd9b025b1e906a48ae1d19");
+    EXPECT_EQ(StringUtils::GenHashName("The quick brown fox jumps over the lazy dog"),
+        "e34bbc7bbc071b6c7a433ca9c49a9347");
+    EXPECT_EQ(StringUtils::GenHashName("/data/storage/el2/base/files/a/b.txt12345678"),
+        "f74c89284059ecf36b814913fac801bc");
+    GTEST_LOG_(INFO) << "StringUtilsTest-end GEN_HASH_NAME_TEST_002";
+}
+
+/**
+ * @tc.number: GEN_HASH_NAME_TEST_003
+ * @tc.name: GEN_HASH_NAME_TEST_003
+ * @tc.desc: 测试名称冲突时按由路径决定的候选序列重新生成
+ * @tc.size: SMALL
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ * @tc.require: NA
+ */
+HWTEST_F(StringUtilsTest, GEN_HASH_NAME_TEST_003, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "StringUtilsTest-begin GEN_HASH_NAME_TEST_003";
+    std::string path = "/data/storage/el2/base/files/dup.txt";
+    std::set<std::string> used;
+    auto isUsed = [&used](const std::string &name) { return !used.emplace(name).second; };
+    std::string first = StringUtils::GenHashName(path, isUsed);
+    std::string second = StringUtils::GenHashName(path, isUsed);
+    std::string third = StringUtils::GenHashName(path, isUsed);
+    EXPECT_EQ(first, StringUtils::GenHashName(path));
+    EXPECT_NE(second, first);
+    EXPECT_NE(third, second);
+    EXPECT_EQ(second.length(), BConstants::BIG_FILE_NAME_SIZE);
+    EXPECT_EQ(used.size(), 3U);
+
+    GTEST_LOG_(INFO) << "2. 候选名只由路径决定, 另一个路径先占用哪些名称不改变本路径的候选序列";
+    std::set<std::string> other = {first};
+    auto isOtherUsed = [&other](const std::string &name) { return !other.emplace(name).second; };
+    EXPECT_EQ(StringUtils::GenHashName("/data/storage/el2/base/files/other.txt", isOtherUsed),
+        StringUtils::GenHashName("/data/storage/el2/base/files/other.txt"));
+    EXPECT_EQ(StringUtils::GenHashName(path, isOtherUsed), second);
+    GTEST_LOG_(INFO) << "StringUtilsTest-end GEN_HASH_NAME_TEST_003";
+}
+
+/**
+ * @tc.number: GEN_HASH_NAME_TEST_004
+ * @tc.name: GEN_HASH_NAME_TEST_004
+ * @tc.desc: 测试百万级合成路径生成的哈希名无冲突
+ * @tc.size: MEDIUM
+ * @tc.type: FUNC
+ * @tc.level Level 1
+ * @tc.require: NA
+ */
+HWTEST_F(StringUtilsTest, GEN_HASH_NAME_TEST_004, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "StringUtilsTest-begin GEN_HASH_NAME_TEST_004";
+    const size_t pathCount = 2000000;
+    const size_t filesPerDir = 1000;
+    std::unordered_set<std::string> names;
+    names.reserve(pathCount);
+    for (size_t i = 0; i < pathCount; i++) {
+        std::string path = "/data/storage/el2/base/files/dir" + std::to_string(i / filesPerDir) + "/file" +
+            std::to_string(i % filesPerDir) + ".dat";
+        names.emplace(StringUtils::GenHashName(path));
+    }
+    EXPECT_EQ(names.size(), pathCount);
+    GTEST_LOG_(INFO) << "StringUtilsTest-end GEN_HASH_NAME_TEST_004";
+}
+
 /**
 * @tc.number: IS_SANBOX_ANCO_PATH_TEST_001
 * @tc.name: IS_SANBOX_ANCO_PATH_TEST_001
@@ -673,7 +756,8 @@ HWTEST_F(StringUtilsTest, STRINGUTILS_STRING_VECTOR_SERIALIZE_DESERIALIZE_TEST_0
 {
     GTEST_LOG_(INFO) << "StringUtilsTest-begin STRING_VECTOR_SERIALIZE_DESERIALIZE_TEST_001";
     std::vector<std::string> input = {"hello", "world", "/storage/Users/currentUser"};
-    std::string serialized = StringUtils::StringVectorSerialize(input);
+    std::string serialized;
+    ASSERT_TRUE(StringUtils::StringVectorSerialize(input, serialized));
     EXPECT_FALSE(serialized.empty());
     std::vector<std::string> output = StringUtils::StringVectorDeserialize(serialized);
     EXPECT_EQ(output.size(), input.size());
@@ -696,7 +780,8 @@ HWTEST_F(StringUtilsTest, STRINGUTILS_STRING_VECTOR_SERIALIZE_DESERIALIZE_TEST_0
 {
     GTEST_LOG_(INFO) << "StringUtilsTest-begin STRING_VECTOR_SERIALIZE_DESERIALIZE_TEST_002";
     std::vector<std::string> input;
-    std::string serialized = StringUtils::StringVectorSerialize(input);
+    std::string serialized;
+    ASSERT_TRUE(StringUtils::StringVectorSerialize(input, serialized));
     EXPECT_FALSE(serialized.empty());
     EXPECT_EQ(serialized.size(), sizeof(uint64_t));
     std::vector<std::string> output = StringUtils::StringVectorDeserialize(serialized);
@@ -717,7 +802,8 @@ HWTEST_F(StringUtilsTest, STRINGUTILS_STRING_VECTOR_SERIALIZE_DESERIALIZE_TEST_0
 {
     GTEST_LOG_(INFO) << "StringUtilsTest-begin STRING_VECTOR_SERIALIZE_DESERIALIZE_TEST_003";
     std::vector<std::string> input = {""};
-    std::string serialized = StringUtils::StringVectorSerialize(input);
+    std::string serialized;
+    ASSERT_TRUE(StringUtils::StringVectorSerialize(input, serialized));
     EXPECT_FALSE(serialized.empty());
     std::vector<std::string> output = StringUtils::StringVectorDeserialize(serialized);
     EXPECT_EQ(output.size(), 1);
@@ -738,7 +824,8 @@ HWTEST_F(StringUtilsTest, STRINGUTILS_STRING_VECTOR_SERIALIZE_DESERIALIZE_TEST_0
 {
     GTEST_LOG_(INFO) << "StringUtilsTest-begin STRING_VECTOR_SERIALIZE_DESERIALIZE_TEST_004";
     std::vector<std::string> input = {"hello\nworld", "tab\there", "with\"quote", "back\\slash"};
-    std::string serialized = StringUtils::StringVectorSerialize(input);
+    std::string serialized;
+    ASSERT_TRUE(StringUtils::StringVectorSerialize(input, serialized));
     EXPECT_FALSE(serialized.empty());
     std::vector<std::string> output = StringUtils::StringVectorDeserialize(serialized);
     EXPECT_EQ(output.size(), input.size());
@@ -789,12 +876,14 @@ HWTEST_F(StringUtilsTest, STRINGUTILS_STRING_VECTOR_DESERIALIZE_TEST_006, testin
 {
     GTEST_LOG_(INFO) << "StringUtilsTest-begin STRING_VECTOR_DESERIALIZE_TEST_006";
     std::vector<std::string> input = {"hello"};
-    std::string serialized = StringUtils::StringVectorSerialize(input);
+    std::string serialized;
+    ASSERT_TRUE(StringUtils::StringVectorSerialize(input, serialized));
     // append trailing garbage data
     serialized.append("GARBAGE");
     EXPECT_TRUE(StringUtils::StringVectorDeserialize(serialized).empty());
     // append single trailing byte
-    serialized = StringUtils::StringVectorSerialize(input);
+    serialized.clear();
+    ASSERT_TRUE(StringUtils::StringVectorSerialize(input, serialized));
     serialized.append(1, '\0');
     EXPECT_TRUE(StringUtils::StringVectorDeserialize(serialized).empty());
     // count=0 with trailing garbage
@@ -869,10 +958,13 @@ HWTEST_F(StringUtilsTest, STRINGUTILS_STRING_VECTOR_SERIALIZE_DESERIALIZE_TEST_0
 {
     GTEST_LOG_(INFO) << "StringUtilsTest-begin STRING_VECTOR_SERIALIZE_DESERIALIZE_TEST_013";
     std::string bigStr(16 * 1024 * 1024, 'A');
-    EXPECT_TRUE(StringUtils::StringVectorSerialize({bigStr}).empty());
-    EXPECT_TRUE(StringUtils::StringVectorSerialize({"hello", bigStr}).empty());
+    std::string rejected;
+    EXPECT_FALSE(StringUtils::StringVectorSerialize({bigStr}, rejected));
+    EXPECT_FALSE(StringUtils::StringVectorSerialize({"hello", bigStr}, rejected));
+    EXPECT_TRUE(rejected.empty());
     std::string nearLimit(16 * 1024 * 1024 - 2 * sizeof(uint64_t), 'A');
-    std::string serialized = StringUtils::StringVectorSerialize({nearLimit});
+    std::string serialized;
+    ASSERT_TRUE(StringUtils::StringVectorSerialize({nearLimit}, serialized));
     EXPECT_FALSE(serialized.empty());
     EXPECT_EQ(serialized.size(), static_cast<size_t>(16 * 1024 * 1024));
     GTEST_LOG_(INFO) << "StringUtilsTest-end STRING_VECTOR_SERIALIZE_DESERIALIZE_TEST_013";
@@ -893,7 +985,8 @@ HWTEST_F(StringUtilsTest, STRINGUTILS_STRING_VECTOR_DESERIALIZE_TEST_014, testin
     std::string hugeData(16 * 1024 * 1024 + 1, 'X');
     EXPECT_TRUE(StringUtils::StringVectorDeserialize(hugeData).empty());
     std::string nearLimit(16 * 1024 * 1024 - 2 * sizeof(uint64_t), 'A');
-    std::string serialized = StringUtils::StringVectorSerialize({nearLimit});
+    std::string serialized;
+    ASSERT_TRUE(StringUtils::StringVectorSerialize({nearLimit}, serialized));
     EXPECT_EQ(serialized.size(), static_cast<size_t>(16 * 1024 * 1024));
     std::vector<std::string> output = StringUtils::StringVectorDeserialize(serialized);
     EXPECT_EQ(output.size(), 1);
@@ -914,7 +1007,8 @@ HWTEST_F(StringUtilsTest, STRINGUTILS_STRING_VECTOR_DESERIALIZE_TEST_009, testin
 {
     GTEST_LOG_(INFO) << "StringUtilsTest-begin STRING_VECTOR_DESERIALIZE_TEST_009";
     std::vector<std::string> input = {"first", "second"};
-    std::string serialized = StringUtils::StringVectorSerialize(input);
+    std::string serialized;
+    ASSERT_TRUE(StringUtils::StringVectorSerialize(input, serialized));
     // truncate: remove last few bytes so second string is incomplete
     EXPECT_TRUE(StringUtils::StringVectorDeserialize(serialized.substr(0, serialized.size() - 3)).empty());
     // truncate: remove len field of second string
@@ -936,7 +1030,8 @@ HWTEST_F(StringUtilsTest, STRINGUTILS_STRING_VECTOR_SERIALIZE_DESERIALIZE_TEST_0
 {
     GTEST_LOG_(INFO) << "StringUtilsTest-begin STRING_VECTOR_SERIALIZE_DESERIALIZE_TEST_010";
     std::vector<std::string> input = {"", "hello", "", "world", ""};
-    std::string serialized = StringUtils::StringVectorSerialize(input);
+    std::string serialized;
+    ASSERT_TRUE(StringUtils::StringVectorSerialize(input, serialized));
     EXPECT_FALSE(serialized.empty());
     std::vector<std::string> output = StringUtils::StringVectorDeserialize(serialized);
     EXPECT_EQ(output.size(), input.size());
@@ -961,7 +1056,8 @@ HWTEST_F(StringUtilsTest, STRINGUTILS_STRING_VECTOR_SERIALIZE_DESERIALIZE_TEST_0
     std::string withNull = "hello\0world";
     withNull.resize(11);
     std::vector<std::string> input = {withNull, "normal"};
-    std::string serialized = StringUtils::StringVectorSerialize(input);
+    std::string serialized;
+    ASSERT_TRUE(StringUtils::StringVectorSerialize(input, serialized));
     EXPECT_FALSE(serialized.empty());
     std::vector<std::string> output = StringUtils::StringVectorDeserialize(serialized);
     EXPECT_EQ(output.size(), input.size());
@@ -990,4 +1086,88 @@ HWTEST_F(StringUtilsTest, STRINGUTILS_STRING_VECTOR_DESERIALIZE_TEST_012, testin
     EXPECT_TRUE(output.empty());
     GTEST_LOG_(INFO) << "StringUtilsTest-end STRING_VECTOR_DESERIALIZE_TEST_012";
 }
-} // namespace OHOS::FileManagement::Backup
\ No newline at end of file
+
+/**
+* @tc.number: STRINGUTILS_STRING_VECTOR_READER_TEST_015
+* @tc.name: StringVectorReader_ZeroCopy
+* @tc.desc: Test reader yields views into the source buffer for a 100k-name batch
+* @tc.size: MEDIUM
+* @tc.type: FUNC
+* @tc.level: Level 1
+* @tc.require: NA
+*/
+HWTEST_F(StringUtilsTest, STRINGUTILS_STRING_VECTOR_READER_TEST_015, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "StringUtilsTest-begin STRING_VECTOR_READER_TEST_015";
+    const size_t itemCount = 100000;
+    std::vector<std::string> input;
+    for (size_t i = 0; i < itemCount; ++i) {
+        input.emplace_back("/data/storage/el2/base/files/" + std::to_string(i));
+    }
+    std::string data;
+    ASSERT_TRUE(StringUtils::StringVectorSerialize(input, data));
+    std::string prefixed = "P";
+    ASSERT_TRUE(StringUtils::StringVectorSerialize(input, prefixed));
+    EXPECT_EQ(prefixed, "P" + data);
+    StringVectorReader reader(data);
+    EXPECT_EQ(reader.Count(), itemCount);
+    std::string_view item;
+    size_t index = 0;
+    while (reader.Next(item)) {
+        EXPECT_GE(item.data(), data.data());
+        EXPECT_LE(item.data() + item.size(), data.data() + data.size());
+        EXPECT_EQ(item, input[index]);
+        index++;
+    }
+    EXPECT_TRUE(reader.Good());
+    EXPECT_EQ(index, itemCount);
+    GTEST_LOG_(INFO) << "StringUtilsTest-end STRING_VECTOR_READER_TEST_015";
+}
+
+/**
+* @tc.number: STRINGUTILS_STRING_VECTOR_VIEWS_TEST_016
+* @tc.name: StringVectorViews_Malformed
+* @tc.desc: Test StringVectorViews returns views for valid data and fails on truncated or trailing data
+* @tc.size: SMALL
+* @tc.type: FUNC
+* @tc.level: Level 1
+* @tc.require: NA
+*/
+HWTEST_F(StringUtilsTest, STRINGUTILS_STRING_VECTOR_VIEWS_TEST_016, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "StringUtilsTest-begin STRING_VECTOR_VIEWS_TEST_016";
+    std::string data;
+    ASSERT_TRUE(StringUtils::StringVectorSerialize({"hello", "", "world"}, data));
+    std::vector<std::string_view> items;
+    ASSERT_TRUE(StringUtils::StringVectorViews(data, items));
+    ASSERT_EQ(items.size(), 3);
+    EXPECT_EQ(items[0], "hello");
+    EXPECT_EQ(items[1], "");
+    EXPECT_EQ(items[2], "world");
+    EXPECT_FALSE(StringUtils::StringVectorViews(data.substr(0, data.size() - 1), items));
+    EXPECT_TRUE(items.empty());
+    EXPECT_FALSE(StringUtils::StringVectorViews(data + "x", items));
+    EXPECT_FALSE(StringUtils::StringVectorViews("", items));
+    GTEST_LOG_(INFO) << "StringUtilsTest-end STRING_VECTOR_VIEWS_TEST_016";
+}
+
+/**
+* @tc.number: STRINGUTILS_GET_PATH_DEPTH_TEST_001
+* @tc.name: STRINGUTILS_GET_PATH_DEPTH_TEST_001
+* @tc.desc: 测试GetPathDepth, 连续分隔符只计一次
+* @tc.size: SMALL
+* @tc.type: FUNC
+* @tc.level: Level 1
+* @tc.require: NA
+*/
+HWTEST_F(StringUtilsTest, STRINGUTILS_GET_PATH_DEPTH_TEST_001, testing::ext::TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "StringUtilsTest-begin GET_PATH_DEPTH_TEST_001";
+    EXPECT_EQ(StringUtils::GetPathDepth(""), 0);
+    EXPECT_EQ(StringUtils::GetPathDepth("file"), 0);
+    EXPECT_EQ(StringUtils::GetPathDepth("/a/b/file"), 3);
+    EXPECT_EQ(StringUtils::GetPathDepth("/a//b///file"), 3);
+    EXPECT_EQ(StringUtils::GetPathDepth("/a/b/"), 3);
+    GTEST_LOG_(INFO) << "StringUtilsTest-end GET_PATH_DEPTH_TEST_001";
+}
+} // namespace OHOS::FileManagement::Backup
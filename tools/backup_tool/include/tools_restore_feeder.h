@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_FILEMGMT_BACKUP_TOOLS_RESTORE_FEEDER_H
+#define OHOS_FILEMGMT_BACKUP_TOOLS_RESTORE_FEEDER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "b_utils/bounded_queue.h"
+#include "nocopyable.h"
+#include "unique_fd.h"
+
+namespace OHOS::FileManagement::Backup {
+/**
+ * @brief 恢复时把本地备份文件并发写入服务提供的文件描述符
+ *
+ * 提交时预读源文件, 由工作线程使用copy_file_range拷贝, 完成后在工作线程回调onDone.
+ * 待拷贝任务超过上限时Submit阻塞. 拷贝过程中定期输出吞吐量.
+ */
+class ToolsRestoreFeeder final : protected NoCopyable {
+public:
+    struct Task {
+        UniqueFd dst;
+        UniqueFd src;
+        // 拷贝完成后调用, 参数为错误码, 成功时为0
+        std::function<void(int)> onDone;
+    };
+
+    struct Stats {
+        uint64_t files = 0;
+        uint64_t failed = 0;
+        uint64_t bytes = 0;
+        double seconds = 0;
+    };
+
+    /**
+     * @brief 构造方法
+     *
+     * @param threads 工作线程个数, 为0时按CPU个数选择
+     * @param reportInterval 输出进度的间隔, 为0时不输出进度
+     */
+    explicit ToolsRestoreFeeder(size_t threads = 0,
+                                std::chrono::milliseconds reportInterval = std::chrono::seconds(1));
+    ~ToolsRestoreFeeder();
+
+    /**
+     * @brief 提交一个拷贝任务
+     */
+    void Submit(Task task);
+
+    /**
+     * @brief 等待已提交的任务完成并输出统计信息, 之后不能再提交任务
+     *
+     * @return 第一个失败任务的错误码, 全部成功时返回0
+     */
+    int Finish();
+
+    Stats GetStats() const;
+
+private:
+    void Worker();
+    void Report(bool force);
+
+    BoundedQueue<Task> tasks_;
+    std::vector<std::thread> workers_;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::milliseconds reportInterval_;
+    std::mutex reportLock_;
+    std::chrono::steady_clock::time_point lastReport_;
+    std::atomic<uint64_t> files_ {0};
+    std::atomic<uint64_t> failed_ {0};
+    std::atomic<uint64_t> bytes_ {0};
+    std::atomic<int> firstErr_ {0};
+    std::atomic<bool> finished_ {false};
+};
+} // namespace OHOS::FileManagement::Backup
+
+#endif // OHOS_FILEMGMT_BACKUP_TOOLS_RESTORE_FEEDER_H
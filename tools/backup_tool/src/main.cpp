@@ -20,9 +20,11 @@ int main()
 }
 #else
 
+#include "b_utils/b_span_tracer.h"
 #include "errors.h"
 #include "tools_op.h"
 #include "tools_op_backup.h"
+#include "tools_op_bench.h"
 #include "tools_op_check_sa.h"
 #include "tools_op_help.h"
 #include "tools_op_restore.h"
@@ -42,6 +44,11 @@ int main()
 namespace OHOS::FileManagement::Backup {
 using namespace std;
 
+namespace {
+// 所有命令通用的参数, 指定后将本次执行的耗时记录导出到该路径
+const string TRACE_PARAM_NAME = "trace";
+} // namespace
+
 optional<map<string, vector<string>>> GetArgsMap(int argc, char *const argv[], const vector<ToolsOp::CmdInfo> &argList)
 {
     int i = 0;
@@ -82,6 +89,7 @@ optional<map<string, vector<string>>> GetArgsMap(int argc, char *const argv[], c
 void ToolRegister()
 {
     OHOS::FileManagement::Backup::BackUpRegister();
+    OHOS::FileManagement::Backup::BenchRegister();
     OHOS::FileManagement::Backup::HelpRegister();
     OHOS::FileManagement::Backup::CheckSaRegister();
     OHOS::FileManagement::Backup::RestoreRegister();
@@ -91,6 +99,22 @@ void ToolRegister()
     OHOS::FileManagement::Backup::IncrementalRestoreAsyncRegister();
 }
 
+int ExecuteWithTrace(const ToolsOp &op, map<string, vector<string>> &mapArgToVal)
+{
+    auto traceIt = mapArgToVal.find(TRACE_PARAM_NAME);
+    if (traceIt == mapArgToVal.end() || traceIt->second.empty()) {
+        return op.Execute(mapArgToVal);
+    }
+    string tracePath = traceIt->second.back();
+    mapArgToVal.erase(traceIt);
+    BSpanTracer::GetInstance().SetEnabled(true);
+    int ret = op.Execute(mapArgToVal);
+    if (!BSpanTracer::GetInstance().ExportChromeTrace(tracePath)) {
+        fprintf(stderr, "Failed to export trace to %s\n", tracePath.c_str());
+    }
+    return ret;
+}
+
 int ParseOpAndExecute(const int argc, char *const argv[])
 {
     // 注册下命令
@@ -109,9 +133,10 @@ int ParseOpAndExecute(const int argc, char *const argv[])
         auto matchedOp = find_if(opeartions.begin(), opeartions.end(), tryOpSucceed);
         if (matchedOp != opeartions.end()) {
             vector<ToolsOp::CmdInfo> argList = matchedOp->GetParams();
+            argList.emplace_back(ToolsOp::CmdInfo {.paramName = TRACE_PARAM_NAME, .repeatable = false});
             optional<map<string, vector<string>>> mapNameToArgs = GetArgsMap(argc, argv, argList);
             if (mapNameToArgs.has_value()) {
-                flag = matchedOp->Execute(mapNameToArgs.value());
+                flag = ExecuteWithTrace(*matchedOp, mapNameToArgs.value());
             }
         }
     }
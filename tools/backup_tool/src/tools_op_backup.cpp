@@ -37,6 +37,7 @@
 #include "b_filesystem/b_file.h"
 #include "b_json/b_json_entity_ext_manage.h"
 #include "b_resources/b_constants.h"
+#include "b_utils/b_span_tracer.h"
 #include "backup_kit_inner.h"
 #include "hitrace_meter.h"
 #include "service_client.h"
@@ -126,6 +127,7 @@ static string GenHelpMsg()
 
 static void OnFileReady(shared_ptr<Session> ctx, const BFileInfo &fileInfo, UniqueFd fd)
 {
+    BACKUP_SPAN("tool.OnFileReady");
     printf("FileReady owner = %s, fileName = %s, sn = %u, fd = %d\n", fileInfo.owner.c_str(), fileInfo.fileName.c_str(),
            fileInfo.sn, fd.Get());
     string tmpPath = string(BConstants::BACKUP_TOOL_RECEIVE_DIR) + fileInfo.owner;
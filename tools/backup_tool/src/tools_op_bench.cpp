@@ -0,0 +1,458 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <directory_ex.h>
+
+#include "b_encryption/b_stream_cipher.h"
+#include "b_error/b_error.h"
+#include "b_filesystem/b_dir.h"
+#include "b_filesystem/b_file_hash.h"
+#include "b_resources/b_constants.h"
+#include "json/json.h"
+#include "tar_file.h"
+#include "tools_op.h"
+#include "tools_op_bench.h"
+#include "unique_fd.h"
+#include "untar_file.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+
+namespace {
+const string DATA_DIR = "data";
+const string TAR_DIR = "tar";
+const string RESTORE_DIR = "restore";
+const string KEY_ID = "bench";
+const string TAR_NAME = "part";
+const string NAME_CHARS = "abcdefghijklmnopqrstuvwxyz0123456789";
+constexpr uint32_t DEFAULT_FILES = 1000;
+constexpr uint64_t DEFAULT_SIZE = 16 * 1024;
+constexpr uint32_t DEFAULT_DEPTH = 3;
+constexpr uint32_t DEFAULT_FANOUT = 4;
+constexpr uint32_t DEFAULT_NAME_LEN = 16;
+constexpr uint32_t DEFAULT_SEED = 1;
+constexpr uint64_t MAX_FILE_SIZE = 64 * 1024 * 1024;
+constexpr size_t PATTERN_SIZE = 1024 * 1024;
+constexpr double LOGNORMAL_SIGMA = 1.0;
+constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+constexpr mode_t DIR_MODE = S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH;
+constexpr mode_t FILE_MODE = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
+
+struct BenchOptions {
+    string workDir;
+    uint32_t files = DEFAULT_FILES;
+    uint64_t size = DEFAULT_SIZE;
+    string sizeDist = "lognormal";
+    uint32_t depth = DEFAULT_DEPTH;
+    uint32_t fanout = DEFAULT_FANOUT;
+    uint32_t nameLen = DEFAULT_NAME_LEN;
+    uint32_t seed = DEFAULT_SEED;
+    vector<string> excludes;
+    bool keep = false;
+    bool encrypt = false;
+};
+
+struct StageResult {
+    double seconds = 0;
+    uint64_t files = 0;
+    uint64_t bytes = 0;
+};
+
+using Clock = chrono::steady_clock;
+} // namespace
+
+static string GenHelpMsg()
+{
+    return "\t\tThis operation generates a synthetic app sandbox and measures the scan, hash, packet and untar\n"
+           "\t\tengines in-process, without the backup sa. The result is printed as one line of json.\n"
+           "\t\t--path\t\t Working directory, data/tar/restore under it will be recreated.\n"
+           "\t\t--files\t\t Number of files, default 1000.\n"
+           "\t\t--size\t\t Mean file size in bytes, default 16384.\n"
+           "\t\t--sizeDist\t\t File size distribution: fixed, uniform, exp or lognormal(default).\n"
+           "\t\t--depth\t\t Directory depth, default 3.\n"
+           "\t\t--fanout\t\t Sub directories per level, default 4.\n"
+           "\t\t--nameLen\t\t File name length, default 16.\n"
+           "\t\t--exclude\t\t Exclude pattern relative to the data directory, repeatable.\n"
+           "\t\t--seed\t\t Random seed, default 1.\n"
+           "\t\t--encrypt\t\t true to encrypt the tars with a random in-memory key.\n"
+           "\t\t--keep\t\t true to keep the generated files.";
+}
+
+static bool ParseUint(const map<string, vector<string>> &args, const string &name, uint64_t maxVal, uint64_t &out)
+{
+    auto it = args.find(name);
+    if (it == args.end() || it->second.empty()) {
+        return true;
+    }
+    const string &str = it->second.front();
+    char *end = nullptr;
+    errno = 0;
+    unsigned long long val = strtoull(str.c_str(), &end, 10);
+    if (str.empty() || str[0] == '-' || errno != 0 || end == nullptr || *end != '\0' || val > maxVal) {
+        fprintf(stderr, "Invalid value of %s: %s\n", name.c_str(), str.c_str());
+        return false;
+    }
+    out = val;
+    return true;
+}
+
+static bool ParseOptions(map<string, vector<string>> &args, BenchOptions &opt)
+{
+    if (args.find("path") == args.end() || args["path"].empty()) {
+        fprintf(stderr, "--path is required\n");
+        return false;
+    }
+    opt.workDir = args["path"].front();
+    if (opt.workDir.empty() || opt.workDir[0] != '/') {
+        fprintf(stderr, "--path must be an absolute path\n");
+        return false;
+    }
+    if (opt.workDir.back() != '/') {
+        opt.workDir += '/';
+    }
+    uint64_t files = opt.files;
+    uint64_t depth = opt.depth;
+    uint64_t fanout = opt.fanout;
+    uint64_t nameLen = opt.nameLen;
+    uint64_t seed = opt.seed;
+    if (!ParseUint(args, "files", UINT32_MAX, files) || !ParseUint(args, "size", MAX_FILE_SIZE, opt.size) ||
+        !ParseUint(args, "depth", UINT8_MAX, depth) || !ParseUint(args, "fanout", UINT16_MAX, fanout) ||
+        !ParseUint(args, "nameLen", NAME_MAX, nameLen) || !ParseUint(args, "seed", UINT32_MAX, seed)) {
+        return false;
+    }
+    opt.files = static_cast<uint32_t>(files);
+    opt.depth = static_cast<uint32_t>(depth);
+    opt.fanout = max<uint32_t>(static_cast<uint32_t>(fanout), 1);
+    opt.nameLen = max<uint32_t>(static_cast<uint32_t>(nameLen), 1);
+    opt.seed = static_cast<uint32_t>(seed);
+    if (args.find("sizeDist") != args.end() && !args["sizeDist"].empty()) {
+        opt.sizeDist = args["sizeDist"].front();
+    }
+    if (opt.sizeDist != "fixed" && opt.sizeDist != "uniform" && opt.sizeDist != "exp" &&
+        opt.sizeDist != "lognormal") {
+        fprintf(stderr, "Invalid value of sizeDist: %s\n", opt.sizeDist.c_str());
+        return false;
+    }
+    if (args.find("exclude") != args.end()) {
+        opt.excludes = args["exclude"];
+    }
+    opt.keep = args.find("keep") != args.end() && !args["keep"].empty() && args["keep"].front() == "true";
+    opt.encrypt =
+        args.find("encrypt") != args.end() && !args["encrypt"].empty() && args["encrypt"].front() == "true";
+    return true;
+}
+
+static function<uint64_t(mt19937_64 &)> MakeSizeGenerator(const BenchOptions &opt)
+{
+    double mean = static_cast<double>(opt.size);
+    if (opt.sizeDist == "uniform") {
+        return [mean](mt19937_64 &rng) {
+            return static_cast<uint64_t>(uniform_real_distribution<double>(0, mean * 2)(rng));
+        };
+    }
+    if (opt.sizeDist == "exp") {
+        return [mean](mt19937_64 &rng) {
+            return mean <= 0 ? 0 : static_cast<uint64_t>(exponential_distribution<double>(1 / mean)(rng));
+        };
+    }
+    if (opt.sizeDist == "lognormal") {
+        // 均值为 exp(mu + sigma^2 / 2)
+        double mu = log(max(mean, 1.0)) - LOGNORMAL_SIGMA * LOGNORMAL_SIGMA / 2;
+        return [mu, mean](mt19937_64 &rng) {
+            return mean <= 0 ? 0 : static_cast<uint64_t>(lognormal_distribution<double>(mu, LOGNORMAL_SIGMA)(rng));
+        };
+    }
+    return [mean](mt19937_64 &) { return static_cast<uint64_t>(mean); };
+}
+
+static string RandomName(mt19937_64 &rng, size_t len)
+{
+    string name(len, 'a');
+    uniform_int_distribution<size_t> dist(0, NAME_CHARS.size() - 1);
+    for (auto &ch : name) {
+        ch = NAME_CHARS[dist(rng)];
+    }
+    return name;
+}
+
+static void WriteContent(const string &path, uint64_t size, const string &pattern, size_t offset)
+{
+    UniqueFd fd(open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, FILE_MODE));
+    if (fd < 0) {
+        throw BError(errno);
+    }
+    uint64_t written = 0;
+    while (written < size) {
+        size_t pos = (offset + written) % pattern.size();
+        size_t len = static_cast<size_t>(min<uint64_t>(size - written, pattern.size() - pos));
+        ssize_t ret = write(fd, pattern.data() + pos, len);
+        if (ret <= 0) {
+            throw BError(errno);
+        }
+        written += static_cast<uint64_t>(ret);
+    }
+}
+
+// 生成随机目录树, 同样的参数和种子生成相同的数据
+static StageResult GenerateDataset(const BenchOptions &opt, const string &dataDir)
+{
+    StageResult res;
+    auto start = Clock::now();
+    mt19937_64 rng(opt.seed);
+    string pattern(PATTERN_SIZE, '\0');
+    for (auto &ch : pattern) {
+        ch = static_cast<char>(rng());
+    }
+    auto sizeGen = MakeSizeGenerator(opt);
+    uniform_int_distribution<uint32_t> dirDist(0, opt.fanout - 1);
+    for (uint32_t i = 0; i < opt.files; i++) {
+        string dir = dataDir;
+        for (uint32_t level = 0; level < opt.depth; level++) {
+            dir += "d" + to_string(dirDist(rng)) + "/";
+        }
+        if (!ForceCreateDirectory(dir)) {
+            throw BError(BError::Codes::TOOL_INVAL_ARG, "Failed to create dir " + dir);
+        }
+        // 序号保证文件名唯一, 不足的长度用随机字符补齐
+        string name = to_string(i) + "_";
+        name += RandomName(rng, opt.nameLen > name.size() ? opt.nameLen - name.size() : 0);
+        uint64_t size = min(sizeGen(rng), MAX_FILE_SIZE);
+        WriteContent(dir + name, size, pattern, static_cast<size_t>(rng() % PATTERN_SIZE));
+        res.files++;
+        res.bytes += size;
+    }
+    res.seconds = chrono::duration<double>(Clock::now() - start).count();
+    return res;
+}
+
+static uint64_t GetFileSize(const string &path)
+{
+    struct stat sta = {};
+    return stat(path.c_str(), &sta) == 0 ? static_cast<uint64_t>(sta.st_size) : 0;
+}
+
+static StageResult Scan(const BenchOptions &opt, const string &dataDir, vector<string> &files)
+{
+    StageResult res;
+    vector<string> excludes;
+    for (const auto &item : opt.excludes) {
+        excludes.emplace_back(dataDir + item);
+    }
+    auto start = Clock::now();
+    auto [bigFiles, smallFiles] = BDir::GetBackupList({dataDir}, excludes);
+    res.seconds = chrono::duration<double>(Clock::now() - start).count();
+    files = move(bigFiles);
+    files.insert(files.end(), smallFiles.begin(), smallFiles.end());
+    sort(files.begin(), files.end());
+    res.files = files.size();
+    for (const auto &file : files) {
+        res.bytes += GetFileSize(file);
+    }
+    return res;
+}
+
+static StageResult Hash(const vector<string> &files)
+{
+    StageResult res;
+    auto start = Clock::now();
+    for (const auto &file : files) {
+        auto [err, hash] = BackupFileHash::HashWithSHA256(file);
+        if (err != 0) {
+            throw BError(BError::Codes::TOOL_INVAL_ARG, "Failed to hash " + file);
+        }
+        res.files++;
+    }
+    res.seconds = chrono::duration<double>(Clock::now() - start).count();
+    for (const auto &file : files) {
+        res.bytes += GetFileSize(file);
+    }
+    return res;
+}
+
+// 按单个tar包的文件数和大小上限分批打包, 与扩展打包小文件的方式一致
+static StageResult Packet(const vector<string> &files, const string &tarDir, vector<string> &tars)
+{
+    StageResult res;
+    auto start = Clock::now();
+    TarFile tarFile;
+    tarFile.SetPacketMode(false);
+    tarFile.SetStreamKey(BEncryption::GetCurrentKey());
+    TarMap tarMap;
+    auto reportCb = [](string path, int err) { fprintf(stderr, "Failed to packet %s, err %d\n", path.c_str(), err); };
+    vector<string> batch;
+    uint64_t batchSize = 0;
+    auto flush = [&]() {
+        if (!batch.empty() && !tarFile.Packet(batch, TAR_NAME, tarDir, tarMap, reportCb)) {
+            throw BError(BError::Codes::TOOL_INVAL_ARG, "Failed to packet files");
+        }
+        batch.clear();
+        batchSize = 0;
+    };
+    for (const auto &file : files) {
+        uint64_t size = GetFileSize(file);
+        if (!batch.empty() && (batch.size() >= BConstants::MAX_FILE_COUNT ||
+                               batchSize + size > BConstants::DEFAULT_SLICE_SIZE)) {
+            flush();
+        }
+        batch.emplace_back(file);
+        batchSize += size;
+    }
+    flush();
+    res.seconds = chrono::duration<double>(Clock::now() - start).count();
+    for (const auto &[name, info] : tarMap) {
+        tars.emplace_back(get<0>(info));
+        res.bytes += static_cast<uint64_t>(get<1>(info).st_size);
+    }
+    res.files = tars.size();
+    return res;
+}
+
+static StageResult Untar(const vector<string> &tars, const string &restoreDir)
+{
+    StageResult res;
+    auto start = Clock::now();
+    for (const auto &tar : tars) {
+        auto [err, endFiles, errFiles] = UntarFile::GetInstance().UnPacket(tar, restoreDir);
+        if (err != 0 || !errFiles.empty()) {
+            throw BError(BError::Codes::TOOL_INVAL_ARG, "Failed to untar " + tar);
+        }
+        res.files += endFiles.size();
+        res.bytes += GetFileSize(tar);
+    }
+    res.seconds = chrono::duration<double>(Clock::now() - start).count();
+    return res;
+}
+
+static Json::Value StageToJson(const StageResult &res)
+{
+    Json::Value val;
+    double seconds = max(res.seconds, 1e-9);
+    val["seconds"] = res.seconds;
+    val["files"] = Json::UInt64(res.files);
+    val["bytes"] = Json::UInt64(res.bytes);
+    val["mbps"] = res.bytes / BYTES_PER_MB / seconds;
+    val["filesPerSec"] = res.files / seconds;
+    return val;
+}
+
+static void RecreateDir(const string &path)
+{
+    if (access(path.c_str(), F_OK) == 0 && !ForceRemoveDirectory(path)) {
+        throw BError(BError::Codes::TOOL_INVAL_ARG, "Failed to remove " + path);
+    }
+    if (mkdir(path.c_str(), DIR_MODE) != 0) {
+        throw BError(errno);
+    }
+}
+
+static shared_ptr<const BEncryption::StreamKey> MakeBenchKey()
+{
+    auto key = make_shared<BEncryption::StreamKey>();
+    key->keyId = KEY_ID;
+    random_device rd;
+    for (size_t i = 0; i < BEncryption::StreamCipher::KEY_SIZE; i++) {
+        key->key.push_back(static_cast<uint8_t>(rd()));
+    }
+    return key;
+}
+
+static int Exec(map<string, vector<string>> &mapArgToVal)
+{
+    BenchOptions opt;
+    if (!ParseOptions(mapArgToVal, opt)) {
+        return -EINVAL;
+    }
+    if (!ForceCreateDirectory(opt.workDir)) {
+        fprintf(stderr, "Failed to create %s, %s\n", opt.workDir.c_str(), strerror(errno));
+        return -EPERM;
+    }
+    string dataDir = opt.workDir + DATA_DIR + "/";
+    string tarDir = opt.workDir + TAR_DIR + "/";
+    string restoreDir = opt.workDir + RESTORE_DIR + "/";
+    Json::Value result;
+    try {
+        RecreateDir(dataDir);
+        RecreateDir(tarDir);
+        RecreateDir(restoreDir);
+        if (opt.encrypt) {
+            BEncryption::SetKeyProvider(make_shared<BEncryption::CallerKeyProvider>(MakeBenchKey()));
+        }
+        result["generate"] = StageToJson(GenerateDataset(opt, dataDir));
+        vector<string> files;
+        result["scan"] = StageToJson(Scan(opt, dataDir, files));
+        result["hash"] = StageToJson(Hash(files));
+        vector<string> tars;
+        result["packet"] = StageToJson(Packet(files, tarDir, tars));
+        StageResult untar = Untar(tars, restoreDir);
+        result["untar"] = StageToJson(untar);
+        result["verified"] = untar.files == files.size();
+    } catch (const BError &e) {
+        BEncryption::SetKeyProvider(nullptr);
+        fprintf(stderr, "Bench failed: %s\n", e.what());
+        return -EPERM;
+    }
+    BEncryption::SetKeyProvider(nullptr);
+    if (!opt.keep) {
+        ForceRemoveDirectory(dataDir);
+        ForceRemoveDirectory(tarDir);
+        ForceRemoveDirectory(restoreDir);
+    }
+    result["encrypt"] = opt.encrypt;
+    result["sizeDist"] = opt.sizeDist;
+    result["depth"] = opt.depth;
+    result["seed"] = opt.seed;
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    printf("%s\n", Json::writeString(builder, result).c_str());
+    return result["verified"].asBool() ? 0 : -EIO;
+}
+
+bool BenchRegister()
+{
+    return ToolsOp::Register(ToolsOp {ToolsOp::Descriptor {
+        .opName = {"bench"},
+        .argList = {{.paramName = "path", .repeatable = false},
+                    {.paramName = "files", .repeatable = false},
+                    {.paramName = "size", .repeatable = false},
+                    {.paramName = "sizeDist", .repeatable = false},
+                    {.paramName = "depth", .repeatable = false},
+                    {.paramName = "fanout", .repeatable = false},
+                    {.paramName = "nameLen", .repeatable = false},
+                    {.paramName = "exclude", .repeatable = true},
+                    {.paramName = "seed", .repeatable = false},
+                    {.paramName = "keep", .repeatable = false},
+                    {.paramName = "encrypt", .repeatable = false}},
+        .funcGenHelpMsg = GenHelpMsg,
+        .funcExec = Exec,
+    }});
+}
+} // namespace OHOS::FileManagement::Backup
@@ -36,12 +36,14 @@
 #include "b_json/b_json_entity_caps.h"
 #include "b_json/b_json_entity_ext_manage.h"
 #include "b_resources/b_constants.h"
+#include "b_utils/b_span_tracer.h"
 #include "backup_kit_inner.h"
 #include "hitrace_meter.h"
 #include "errors.h"
 #include "service_proxy.h"
 #include "tools_op.h"
 #include "tools_op_restore.h"
+#include "tools_restore_feeder.h"
 
 namespace OHOS::FileManagement::Backup {
 using namespace std;
@@ -88,6 +90,34 @@ public:
         cv_.wait(lk, [&] { return ready_; });
     }
 
+    // 所有本地文件拷贝完成后发布应用的文件, 在feeder_的工作线程调用
+    void OnFileSent(const BFileInfo &fileInfo, int err)
+    {
+        if (err != 0) {
+            printf("Failed to send file, owner = %s, fileName = %s, err = %d\n", fileInfo.owner.c_str(),
+                   fileInfo.fileName.c_str(), err);
+            TryNotify(true);
+            return;
+        }
+        std::string bundleName = fileInfo.owner;
+        {
+            unique_lock<mutex> fileLock(fileCountLock_);
+            ++fileCount_[bundleName];
+            // 文件准备完成
+            printf("FileReady count/num = %d/%d\n", fileCount_[bundleName], fileNums_[bundleName]);
+            if (fileCount_[bundleName] == fileNums_[bundleName] && session_ != nullptr) {
+                printf("PublishFile start.\n");
+                BFileInfo fileInfoTemp = fileInfo;
+                fileInfoTemp.fileName = "";
+                int ret = session_->PublishFile(fileInfoTemp);
+                if (ret != 0) {
+                    throw BError(BError::Codes::TOOL_INVAL_ARG, "PublishFile error");
+                }
+            }
+        }
+        TryNotify();
+    }
+
     unique_ptr<BSessionRestore> session_ = {};
 
 private:
@@ -107,6 +137,8 @@ public:
     map<string, int> fileCount_;
     map<string, int> fileNums_;
     mutex fileCountLock_;
+    // 放在最后, 析构时最先等待拷贝任务完成
+    ToolsRestoreFeeder feeder_;
 };
 
 static string GenHelpMsg()
@@ -118,6 +150,7 @@ static string GenHelpMsg()
 
 static void OnFileReady(shared_ptr<Session> ctx, const BFileInfo &fileInfo, UniqueFd fd, int32_t errCode)
 {
+    BACKUP_SPAN("tool.OnFileReady");
     printf("FileReady owner = %s, fileName = %s, sn = %u, fd = %d\n", fileInfo.owner.c_str(), fileInfo.fileName.c_str(),
            fileInfo.sn, fd.Get());
     if (fileInfo.fileName.find('/') != string::npos) {
@@ -131,24 +164,9 @@ static void OnFileReady(shared_ptr<Session> ctx, const BFileInfo &fileInfo, Uniq
     if (fdLocal < 0) {
         throw BError(BError::Codes::TOOL_INVAL_ARG, generic_category().message(errno));
     }
-    BFile::SendFile(fd, fdLocal);
-    std::string bundleName = fileInfo.owner;
-    {
-        unique_lock<mutex> fileLock(ctx->fileCountLock_);
-        ++ctx->fileCount_[bundleName];
-        // 文件准备完成
-        printf("FileReady count/num = %d/%d\n", ctx->fileCount_[bundleName], ctx->fileNums_[bundleName]);
-        if (ctx->fileCount_[bundleName] == ctx->fileNums_[bundleName]) {
-            printf("PublishFile start.\n");
-            BFileInfo fileInfoTemp = fileInfo;
-            fileInfoTemp.fileName = "";
-            int ret = ctx->session_->PublishFile(fileInfoTemp);
-            if (ret != 0) {
-                throw BError(BError::Codes::TOOL_INVAL_ARG, "PublishFile error");
-            }
-        }
-    }
-    ctx->TryNotify();
+    Session *session = ctx.get();
+    ctx->feeder_.Submit({move(fd), move(fdLocal),
+                         [session, fileInfo](int err) { session->OnFileSent(fileInfo, err); }});
 }
 
 static void OnBundleStarted(shared_ptr<Session> ctx, ErrCode err, const BundleName name)
@@ -204,6 +222,7 @@ static void OnProcess(shared_ptr<Session> ctx, const std::string bundleName, con
 
 static void RestoreApp(shared_ptr<Session> restore, vector<BundleName> &bundleNames, bool updateSendFiles)
 {
+    BACKUP_SPAN("tool.RestoreApp");
     StartTrace(HITRACE_TAG_FILEMANAGEMENT, "RestoreApp");
     if (!restore || !restore->session_) {
         throw BError(BError::Codes::TOOL_INVAL_ARG, generic_category().message(errno));
@@ -317,7 +336,12 @@ static int32_t InitPathCapFile(const string &pathCapFile, vector<string> bundleN
     }
     RestoreApp(ctx, bundleNames, false);
     ctx->Wait();
+    int err = ctx->feeder_.Finish();
     ctx->session_->Release();
+    if (err != 0) {
+        printf("restore send files error: %d\n", err);
+        return -EIO;
+    }
     return 0;
 }
 
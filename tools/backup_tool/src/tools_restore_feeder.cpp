@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tools_restore_feeder.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "b_error/b_error.h"
+#include "b_filesystem/b_file.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+
+namespace {
+constexpr size_t MAX_THREADS = 4;
+constexpr size_t TASKS_PER_THREAD = 2;
+constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+
+size_t GetThreadCount(size_t threads)
+{
+    if (threads != 0) {
+        return threads;
+    }
+    size_t cpus = thread::hardware_concurrency();
+    return clamp<size_t>(cpus, 1, MAX_THREADS);
+}
+
+// 返回拷贝的字节数, 失败时抛出BError
+uint64_t CopyFile(int dst, int src)
+{
+    struct stat sta = {};
+    if (fstat(src, &sta) == -1) {
+        throw BError(errno);
+    }
+    if (ftruncate(dst, 0) == -1) {
+        throw BError(errno);
+    }
+    loff_t inOff = 0;
+    loff_t outOff = 0;
+    while (inOff < sta.st_size) {
+        ssize_t ret = copy_file_range(src, &inOff, dst, &outOff, static_cast<size_t>(sta.st_size - inOff), 0);
+        if (ret > 0) {
+            continue;
+        }
+        if (ret == 0) {
+            break;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (inOff == 0 && (errno == EXDEV || errno == EINVAL || errno == ENOSYS || errno == EOPNOTSUPP)) {
+            // 跨文件系统或不支持时使用sendfile
+            BFile::SendFile(dst, src);
+            return static_cast<uint64_t>(sta.st_size);
+        }
+        throw BError(errno);
+    }
+    if (ftruncate(dst, outOff) == -1) {
+        throw BError(errno);
+    }
+    return static_cast<uint64_t>(outOff);
+}
+} // namespace
+
+ToolsRestoreFeeder::ToolsRestoreFeeder(size_t threads, chrono::milliseconds reportInterval)
+    : tasks_(GetThreadCount(threads) * TASKS_PER_THREAD), start_(chrono::steady_clock::now()),
+      reportInterval_(reportInterval), lastReport_(start_)
+{
+    size_t count = GetThreadCount(threads);
+    for (size_t i = 0; i < count; i++) {
+        workers_.emplace_back([this]() { Worker(); });
+    }
+}
+
+ToolsRestoreFeeder::~ToolsRestoreFeeder()
+{
+    Finish();
+}
+
+void ToolsRestoreFeeder::Submit(Task task)
+{
+    // 在排队期间提前把源文件读入页缓存
+    posix_fadvise(task.src, 0, 0, POSIX_FADV_SEQUENTIAL);
+    posix_fadvise(task.src, 0, 0, POSIX_FADV_WILLNEED);
+    if (!tasks_.Push(move(task))) {
+        throw BError(BError::Codes::TOOL_INVAL_ARG, "Restore feeder has finished");
+    }
+}
+
+int ToolsRestoreFeeder::Finish()
+{
+    if (finished_.exchange(true)) {
+        return firstErr_.load();
+    }
+    tasks_.Close();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+    Report(true);
+    return firstErr_.load();
+}
+
+ToolsRestoreFeeder::Stats ToolsRestoreFeeder::GetStats() const
+{
+    Stats stats;
+    stats.files = files_.load();
+    stats.failed = failed_.load();
+    stats.bytes = bytes_.load();
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start_).count();
+    return stats;
+}
+
+void ToolsRestoreFeeder::Worker()
+{
+    Task task;
+    while (tasks_.Pop(task)) {
+        int err = 0;
+        try {
+            bytes_ += CopyFile(task.dst, task.src);
+        } catch (const BError &e) {
+            err = e.GetCode();
+        }
+        task.dst.Reset();
+        task.src.Reset();
+        if (err != 0) {
+            failed_++;
+            int expected = 0;
+            firstErr_.compare_exchange_strong(expected, err);
+        } else {
+            files_++;
+        }
+        if (task.onDone) {
+            try {
+                task.onDone(err);
+            } catch (const BError &e) {
+                printf("Restore feeder callback error: %d, %s\n", e.GetCode(), e.what());
+                int expected = 0;
+                firstErr_.compare_exchange_strong(expected, e.GetCode());
+            }
+        }
+        task = {};
+        Report(false);
+    }
+}
+
+void ToolsRestoreFeeder::Report(bool force)
+{
+    if (reportInterval_.count() == 0) {
+        return;
+    }
+    auto now = chrono::steady_clock::now();
+    {
+        unique_lock<mutex> lock(reportLock_, defer_lock);
+        if (force) {
+            lock.lock();
+        } else if (!lock.try_lock() || now - lastReport_ < reportInterval_) {
+            return;
+        }
+        lastReport_ = now;
+    }
+    Stats stats = GetStats();
+    double seconds = max(stats.seconds, 1e-6);
+    printf("Restore %s: files = %" PRIu64 ", failed = %" PRIu64 ", %.2f MB/s, %.2f files/s\n",
+           force ? "finished" : "progress", stats.files, stats.failed, stats.bytes / BYTES_PER_MB / seconds,
+           stats.files / seconds);
+}
+} // namespace OHOS::FileManagement::Backup
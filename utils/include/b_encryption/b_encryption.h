@@ -16,8 +16,57 @@
 #ifndef OHOS_FILEMGMT_BACKUP_B_ENCRYPTION_H
 #define OHOS_FILEMGMT_BACKUP_B_ENCRYPTION_H
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
 namespace OHOS::FileManagement::Backup::BEncryption {
 unsigned int CalculateChksum(const char *byteBlock, int blockSize);
+
+enum class DigestAlgorithm {
+    NONE,
+    XXH64,  // 非密码学摘要, 速度接近内存带宽, 用于发现静默损坏
+    SHA256, // 密码学摘要, 可防篡改
+};
+
+/**
+ * @brief 流式计算文件内容摘要
+ *
+ * 摘要以"算法名:十六进制值"的形式表示, 如"xxh64:0123456789abcdef", 同一算法的摘要长度固定.
+ */
+class ContentDigest final {
+public:
+    explicit ContentDigest(DigestAlgorithm algorithm);
+    ~ContentDigest();
+    ContentDigest(const ContentDigest &) = delete;
+    ContentDigest &operator=(const ContentDigest &) = delete;
+
+    void Update(const void *data, size_t len);
+
+    /**
+     * @brief 结束计算并返回摘要, 之后不能再调用Update
+     */
+    std::string Final();
+
+    DigestAlgorithm GetAlgorithm() const { return algorithm_; }
+
+    /**
+     * @brief 获取指定算法摘要的长度, NONE返回0
+     */
+    static size_t GetDigestLength(DigestAlgorithm algorithm);
+
+    /**
+     * @brief 根据算法名(如"xxh64")或摘要(如"xxh64:...")解析算法, 无法识别时返回NONE
+     */
+    static DigestAlgorithm ParseAlgorithm(const std::string &digest);
+
+private:
+    struct State;
+
+    DigestAlgorithm algorithm_;
+    std::unique_ptr<State> state_;
+};
 } // namespace OHOS::FileManagement::Backup::BEncryption
 
 #endif // OHOS_FILEMGMT_BACKUP_B_ENCRYPTION_H
\ No newline at end of file
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_FILEMGMT_BACKUP_B_STREAM_CIPHER_H
+#define OHOS_FILEMGMT_BACKUP_B_STREAM_CIPHER_H
+
+/**
+ * @file b_stream_cipher.h
+ * @brief 备份产物(tar包、大文件)的分块认证加密
+ *
+ * 加密文件由64字节的文件头和若干分块组成. 文件头记录格式版本、分块大小、随机文件标识和密钥标识;
+ * 每个分块为"随机nonce(12字节) + 密文 + GCM标签(16字节)", 除最后一块外明文长度都等于分块大小, 因此可按偏移随机读写.
+ * 分块使用AES-256-GCM加密, 密钥由主密钥和文件标识派生, 每个文件不同. 附加数据包含文件头、分块序号和是否为最后一块,
+ * 分块被篡改、调换、跨文件替换或文件被截断时解密失败.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace OHOS::FileManagement::Backup::BEncryption {
+struct StreamKey {
+    std::string keyId;        // 密钥标识, 写入加密文件头, 解密时据此查找密钥
+    std::vector<uint8_t> key; // 主密钥, 长度为StreamCipher::KEY_SIZE
+};
+
+/**
+ * @brief 密钥提供者, 可替换为系统密钥管理等其他实现
+ */
+class KeyProvider {
+public:
+    virtual ~KeyProvider() = default;
+
+    /**
+     * @brief 获取加密新产物使用的密钥, 返回nullptr表示不加密
+     */
+    virtual std::shared_ptr<const StreamKey> GetCurrentKey() = 0;
+
+    /**
+     * @brief 按密钥标识获取解密使用的密钥, 不存在时返回nullptr
+     */
+    virtual std::shared_ptr<const StreamKey> GetKey(const std::string &keyId) = 0;
+
+    /**
+     * @brief 密钥能否交给恢复端, 不能导出的密钥加密的产物在其他设备上无法解密
+     */
+    virtual bool IsExportable() const = 0;
+};
+
+/**
+ * @brief 调用方下发密钥的提供者
+ *
+ * 密钥由备份调用方持有, 备份和恢复时随扩展信息下发, 换设备恢复时调用方下发同一密钥即可解密.
+ */
+class CallerKeyProvider final : public KeyProvider {
+public:
+    explicit CallerKeyProvider(std::shared_ptr<const StreamKey> key);
+
+    std::shared_ptr<const StreamKey> GetCurrentKey() override;
+    std::shared_ptr<const StreamKey> GetKey(const std::string &keyId) override;
+    bool IsExportable() const override;
+
+private:
+    std::shared_ptr<const StreamKey> key_;
+};
+
+/**
+ * @brief 解析"<密钥标识>:<64位十六进制密钥>"格式的密钥, 格式错误时返回nullptr
+ */
+std::shared_ptr<const StreamKey> ParseStreamKey(const std::string &text);
+
+/**
+ * @brief 设置进程内使用的密钥提供者, 为nullptr时备份不加密, 恢复时不识别加密文件
+ */
+void SetKeyProvider(std::shared_ptr<KeyProvider> provider);
+std::shared_ptr<KeyProvider> GetKeyProvider();
+
+/**
+ * @brief 获取当前密钥提供者的加密密钥, 未设置密钥提供者、不加密或密钥不能导出时返回nullptr
+ */
+std::shared_ptr<const StreamKey> GetCurrentKey();
+
+class StreamCipher final {
+public:
+    static constexpr size_t KEY_SIZE = 32;
+    static constexpr size_t NONCE_SIZE = 12;
+    static constexpr size_t TAG_SIZE = 16;
+    static constexpr size_t HEADER_SIZE = 64;
+    static constexpr size_t MAX_KEY_ID_LEN = 31;
+    static constexpr uint32_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+    /**
+     * @brief 以加密流打开文件用于写入
+     *
+     * 返回的流支持fwrite/fseeko/ftello, 偏移均为明文偏移, 只能定位到已写入的范围内.
+     * 已写入的分块被改写时以新的nonce重新加密. 最后一个分块在fclose时写入, fclose失败表示文件不完整.
+     *
+     * @param fd 以读写方式打开的空文件, 所有权转移给返回的流, 失败时关闭
+     * @param key 加密密钥
+     * @param chunkSize 分块的明文长度
+     * @return 成功返回流, 失败返回nullptr且errno为失败原因
+     */
+    static FILE *OpenWriter(int fd, const StreamKey &key, uint32_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    /**
+     * @brief 以解密流打开加密文件用于读取
+     *
+     * 打开时校验最后一个分块以发现截断. 读到校验失败的分块时fread返回不足, ferror置位, errno为EBADMSG.
+     *
+     * @param fd 加密文件, 所有权转移给返回的流, 失败时关闭
+     * @param provider 按文件头中的密钥标识提供密钥
+     * @return 成功返回流, 失败返回nullptr且errno为失败原因, 找不到密钥时为ENOKEY
+     */
+    static FILE *OpenReader(int fd, KeyProvider &provider);
+
+    /**
+     * @brief 文件是否以加密文件头开始, 不改变文件偏移
+     */
+    static bool IsEncrypted(int fd);
+
+    /**
+     * @brief 把srcFd从当前偏移开始的内容加密写入dstFd, 不关闭两个fd
+     */
+    static bool EncryptFile(int srcFd, int dstFd, const StreamKey &key);
+
+    /**
+     * @brief 把srcFd从当前偏移开始的size字节顺序加密写入dstFd, 不关闭两个fd
+     *
+     * 只做顺序写, dstFd可以是管道, 每个分块只加密一次. 输出与OpenWriter写入的文件格式相同.
+     */
+    static bool EncryptStream(int srcFd, int dstFd, const StreamKey &key, uint64_t size);
+
+    /**
+     * @brief 把加密文件srcFd解密写入dstFd的当前偏移, 不关闭两个fd
+     */
+    static bool DecryptFile(int srcFd, int dstFd, KeyProvider &provider);
+
+    /**
+     * @brief AES-256-GCM加密一段数据
+     *
+     * @param key 长度为KEY_SIZE的密钥
+     * @param nonce 长度为NONCE_SIZE的nonce
+     * @param aad 附加认证数据
+     * @param out 密文, 长度与明文相同
+     * @param tag 长度为TAG_SIZE的认证标签
+     */
+    static bool Seal(const uint8_t *key, const uint8_t *nonce, const std::string &aad, const uint8_t *in, size_t len,
+        uint8_t *out, uint8_t *tag);
+
+    /**
+     * @brief AES-256-GCM解密一段数据, 认证失败时返回false
+     */
+    static bool Open(const uint8_t *key, const uint8_t *nonce, const std::string &aad, const uint8_t *in, size_t len,
+        uint8_t *out, const uint8_t *tag);
+};
+
+/**
+ * @brief 在后台线程中把文件加密写入管道, 不生成加密副本
+ *
+ * 加密随读端的读取进行, 读端关闭后加密线程以失败结束. 析构时等待全部加密线程结束.
+ */
+class PipeEncryptor final {
+public:
+    PipeEncryptor() = default;
+    ~PipeEncryptor();
+    PipeEncryptor(const PipeEncryptor &) = delete;
+    PipeEncryptor &operator=(const PipeEncryptor &) = delete;
+
+    /**
+     * @brief 开始加密文件
+     *
+     * @param srcFd 明文文件, 从偏移0开始加密, 所有权转移
+     * @param key 加密密钥
+     * @return 成功返回管道读端, 失败返回-1
+     */
+    int Start(int srcFd, std::shared_ptr<const StreamKey> key);
+
+    /**
+     * @brief 等待已开始的加密全部结束
+     *
+     * @return 上次等待之后开始的加密是否全部成功
+     */
+    bool Wait();
+
+private:
+    std::mutex lock_;
+    std::vector<std::thread> workers_;
+    std::atomic<bool> failed_ {false};
+};
+} // namespace OHOS::FileManagement::Backup::BEncryption
+
+#endif // OHOS_FILEMGMT_BACKUP_B_STREAM_CIPHER_H
@@ -62,6 +62,8 @@ public:
         UTILS_INVAL_TARBALL_ARG = 0x1002,
         UTILS_INVAL_PROCESS_ARG = 0x1003,
         UTILS_INTERRUPTED_PROCESS = 0x1004,
+        UTILS_TARBALL_PACK_FAIL = 0x1005,
+        UTILS_TARBALL_UNPACK_FAIL = 0x1006,
 
         // 0x2000~0x2999 backup_tool错误
         TOOL_INVAL_ARG = 0x2000,
@@ -283,6 +285,8 @@ private:
         {Codes::UTILS_INVAL_TARBALL_ARG, "Tarball utils received an invalid argument"},
         {Codes::UTILS_INVAL_PROCESS_ARG, "Process utils received an invalid argument"},
         {Codes::UTILS_INTERRUPTED_PROCESS, "Can't launch a process or the process was corrupted"},
+        {Codes::UTILS_TARBALL_PACK_FAIL, "Tarball utils failed to pack files"},
+        {Codes::UTILS_TARBALL_UNPACK_FAIL, "Tarball utils failed to unpack the tarball"},
         {Codes::TOOL_INVAL_ARG, "TOOL received invalid arguments"},
         {Codes::SA_INVAL_ARG, "SA received invalid arguments"},
         {Codes::SA_BROKEN_IPC, "SA failed to issue a IPC"},
@@ -320,6 +324,8 @@ private:
         {static_cast<int>(Codes::UTILS_INVAL_TARBALL_ARG), BackupErrorCode::E_UKERR},
         {static_cast<int>(Codes::UTILS_INVAL_PROCESS_ARG), BackupErrorCode::E_UKERR},
         {static_cast<int>(Codes::UTILS_INTERRUPTED_PROCESS), BackupErrorCode::E_UKERR},
+        {static_cast<int>(Codes::UTILS_TARBALL_PACK_FAIL), BackupErrorCode::E_PACKET},
+        {static_cast<int>(Codes::UTILS_TARBALL_UNPACK_FAIL), BackupErrorCode::E_UNPACKET},
         {static_cast<int>(Codes::TOOL_INVAL_ARG), BackupErrorCode::E_UKERR},
         {static_cast<int>(Codes::SA_INVAL_ARG), BackupErrorCode::E_INVAL},
         {static_cast<int>(Codes::SA_BROKEN_IPC), BackupErrorCode::E_IPCSS},
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_FILEMGMT_BACKUP_B_BACKUP_CHECKPOINT_H
+#define OHOS_FILEMGMT_BACKUP_B_BACKUP_CHECKPOINT_H
+
+/**
+ * @file b_backup_checkpoint.h
+ * @brief 备份进度检查点
+ *
+ * 以追加日志的形式持久化一个应用已交付的产物(tar包、大文件)及其指纹, 每条记录带校验和, Commit返回前已落盘.
+ * 进程在任意时刻被杀死后, 重新Open只保留完整且校验通过的记录, 末尾写了一半的记录被截掉.
+ * 日志头记录会话标识, 与Open传入的标识不一致时视为另一次会话的残留, 清空后重新开始.
+ * 所有接口线程安全.
+ */
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "nocopyable.h"
+#include "unique_fd.h"
+
+namespace OHOS::FileManagement::Backup {
+class BBackupCheckpoint final : protected NoCopyable {
+public:
+    explicit BBackupCheckpoint(const std::string &path);
+
+    /**
+     * @brief 打开检查点并加载已提交的记录
+     *
+     * @param token 会话标识
+     * @return 是否打开成功. 打开失败后Commit均返回false, IsCommitted均返回false
+     */
+    bool Open(const std::string &token);
+
+    /**
+     * @brief 记录产物已交付, 返回true时记录已落盘
+     *
+     * @param name 产物名
+     * @param fingerprint 产物指纹, 同名产物以最后一次提交的指纹为准
+     */
+    bool Commit(const std::string &name, const std::string &fingerprint);
+
+    /**
+     * @brief 产物是否已以相同指纹交付过
+     */
+    bool IsCommitted(const std::string &name, const std::string &fingerprint) const;
+
+    size_t GetCommittedCount() const;
+
+    /**
+     * @brief 关闭并删除检查点文件
+     */
+    void Remove();
+
+private:
+    bool LoadLocked(const std::string &token);
+    bool ResetLocked(const std::string &token);
+
+    mutable std::mutex lock_;
+    std::string path_;
+    UniqueFd fd_ {-1};
+    uint64_t size_ = 0;
+    std::unordered_map<std::string, std::string> committed_;
+};
+} // namespace OHOS::FileManagement::Backup
+
+#endif // OHOS_FILEMGMT_BACKUP_B_BACKUP_CHECKPOINT_H
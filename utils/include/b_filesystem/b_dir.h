@@ -29,6 +29,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "b_filesystem/b_scan_snapshot.h"
 #include "b_json/b_report_entity.h"
 #include "b_radar/radar_app_statistic.h"
 #include "b_utils/scan_result_manager.h"
@@ -39,15 +40,19 @@ struct ProcessInfo {
     std::string backupPath_;
     std::string restorePath_;
     off_t sizeBoundary_;
+    // 扫描时随目录栈维护的路径深度, 与StringUtils::GetPathDepth(backupPath_)一致
+    uint32_t dirDepth_;
 
-    ProcessInfo(const std::string& backupPath, const std::string& restorePath, off_t sizeBoundary)
-        : backupPath_(backupPath), restorePath_(restorePath), sizeBoundary_(sizeBoundary) {}
+    ProcessInfo(const std::string& backupPath, const std::string& restorePath, off_t sizeBoundary, uint32_t dirDepth)
+        : backupPath_(backupPath), restorePath_(restorePath), sizeBoundary_(sizeBoundary), dirDepth_(dirDepth) {}
 };
 
 struct AdvancedScanOption {
     bool enableBatch = false;
     std::string restoreTempPath;
     std::shared_ptr<ScanResultManager> resultManager;
+    // 非空时目录元数据未变化的目录复用上次的条目列表, 并记录本次的结果
+    std::shared_ptr<BScanSnapshot> snapshot;
 
     AdvancedScanOption() : enableBatch(false), resultManager(nullptr) {}
     AdvancedScanOption(
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_FILEMGMT_BACKUP_B_DIR_CACHE_H
+#define OHOS_FILEMGMT_BACKUP_B_DIR_CACHE_H
+
+/**
+ * @file b_dir_cache.h
+ * @brief 恢复时使用的目录描述符缓存
+ *
+ * 以目录路径为key缓存已打开的目录描述符. 创建目录或文件时从最近的已缓存祖先目录出发,
+ * 用mkdirat/openat逐级处理剩余部分, 同一目录在一次恢复中最多创建和打开一次.
+ * 缓存的描述符跟随目录本身而不是路径, 目录可能被改名或删除时(如切换恢复根目录)需要调用Clear.
+ * 经缓存目录操作失败且错误为ENOENT时, 认为缓存的目录已被删除, 丢弃全部缓存后重试一次.
+ * 所有接口线程安全.
+ */
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <sys/stat.h>
+#include <unordered_map>
+
+#include "nocopyable.h"
+#include "unique_fd.h"
+
+namespace OHOS::FileManagement::Backup {
+class BDirCache final : protected NoCopyable {
+public:
+    static constexpr size_t DEFAULT_MAX_FDS = 64;
+    static constexpr mode_t DEFAULT_DIR_MODE = S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH;
+
+    struct Stats {
+        uint64_t hits = 0;     // 直接命中目标目录的次数
+        uint64_t dirOpens = 0; // 打开目录的次数
+        uint64_t mkdirs = 0;   // 创建目录的次数
+    };
+
+    /**
+     * @brief 构造方法
+     *
+     * @param maxFds 最多缓存的目录描述符个数, 超出时淘汰最久未使用的目录
+     */
+    explicit BDirCache(size_t maxFds = DEFAULT_MAX_FDS);
+
+    /**
+     * @brief 确保目录存在, 不存在的各级目录以指定权限创建
+     *
+     * @param path 目录路径, 相对路径相对于当前工作目录
+     * @param mode 新建目录的权限
+     * @return 目录存在或创建成功时返回true, 失败时errno为失败原因
+     */
+    bool EnsureDir(const std::string &path, mode_t mode = DEFAULT_DIR_MODE);
+
+    /**
+     * @brief 在父目录中打开文件, 父目录不存在时先创建
+     *
+     * @param filePath 文件路径, 必须包含父目录
+     * @param flags 传给openat的打开标志
+     * @param mode 新建文件的权限
+     * @param dirMode 新建父目录的权限
+     * @return 文件描述符, 失败时小于0且errno为失败原因
+     */
+    UniqueFd OpenFile(const std::string &filePath, int flags, mode_t mode, mode_t dirMode = DEFAULT_DIR_MODE);
+
+    /**
+     * @brief 关闭并丢弃所有缓存的目录描述符
+     */
+    void Clear();
+
+    Stats GetStats() const;
+
+private:
+    struct Entry {
+        UniqueFd fd;
+        std::list<std::string>::iterator lruIt;
+    };
+
+    int OpenDirLocked(const std::string &path, mode_t mode, std::string &cachedBase);
+    int OpenChildLocked(int parentFd, const std::string &path, const std::string &name, mode_t mode);
+    void InvalidateLocked();
+    void TrimLocked();
+
+    mutable std::mutex lock_;
+    size_t maxFds_;
+    std::unordered_map<std::string, Entry> dirs_;
+    std::list<std::string> lru_;
+    Stats stats_;
+};
+} // namespace OHOS::FileManagement::Backup
+
+#endif // OHOS_FILEMGMT_BACKUP_B_DIR_CACHE_H
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_FILEMGMT_BACKUP_B_EXTERNAL_SORTER_H
+#define OHOS_FILEMGMT_BACKUP_B_EXTERNAL_SORTER_H
+
+/**
+ * @file b_external_sorter.h
+ * @brief 内存受限的外部排序
+ *
+ * 记录由key(通常为路径)和任意字节的value组成. 缓存的记录超过内存上限时排序后写入临时文件形成有序段,
+ * 结束输入后对所有有序段做多路归并, 段数超过归并路数上限时先合并为更少的段.
+ * key相同的记录保持加入的先后顺序. 临时文件创建后立即删除, 进程退出时由内核回收.
+ *
+ * 用于增量简报按路径排序(BReportEntity::SortByPath)和扫描快照(BScanSnapshot)按路径写盘. 小文件列表、TarMap和manage.json
+ * 持有打包流程直接使用的对象和fd, 仍在内存中处理, 不经过本排序器.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "nocopyable.h"
+#include "unique_fd.h"
+
+namespace OHOS::FileManagement::Backup {
+class BExternalSorter final : protected NoCopyable {
+public:
+    static constexpr size_t DEFAULT_MERGE_WAYS = 64;
+
+    /**
+     * @brief 构造方法
+     *
+     * @param tmpDir 有序段临时文件所在目录
+     * @param memoryLimit 缓存记录占用内存的上限, 字节
+     * @param mergeWays 单次归并的最大段数
+     */
+    BExternalSorter(const std::string &tmpDir, size_t memoryLimit, size_t mergeWays = DEFAULT_MERGE_WAYS);
+    ~BExternalSorter();
+
+    /**
+     * @brief 加入一条记录
+     *
+     * @return 写临时文件失败时返回false, 此后排序器不可用
+     */
+    bool Add(std::string key, std::string value);
+
+    /**
+     * @brief 结束输入, 准备按key升序读取
+     *
+     * @return 写临时文件失败时返回false
+     */
+    bool Finish();
+
+    /**
+     * @brief 按key升序读取下一条记录
+     *
+     * @return 读完或出错时返回false, 可通过HasError区分
+     */
+    bool Next(std::string &key, std::string &value);
+
+    /**
+     * @brief 在指定目录创建匿名临时文件, 创建后立即删除目录项
+     *
+     * @param tmpDir 临时文件所在目录
+     * @return 文件描述符, 失败时小于0
+     */
+    static UniqueFd CreateTmpFile(const std::string &tmpDir);
+
+    bool HasError() const
+    {
+        return hasError_;
+    }
+
+    // 写入过临时文件的有序段数, 为0表示全部在内存中完成排序
+    size_t GetSpilledRunCount() const
+    {
+        return spilledRunCount_;
+    }
+
+private:
+    using Record = std::pair<std::string, std::string>;
+
+    class RunReader;
+    struct HeapItem {
+        Record record;
+        size_t runIndex;
+    };
+    struct HeapGreater {
+        bool operator()(const HeapItem &lhs, const HeapItem &rhs) const;
+    };
+
+    bool SpillRun();
+    bool StartMerge(size_t begin, size_t end);
+    bool PopMerged(Record &record);
+    bool MergeRuns(size_t begin, size_t end, UniqueFd &outFd);
+
+    std::string tmpDir_;
+    size_t memoryLimit_;
+    size_t mergeWays_;
+    std::vector<Record> buffer_;
+    size_t bufferBytes_ = 0;
+    std::vector<UniqueFd> runs_;
+    size_t spilledRunCount_ = 0;
+    bool finished_ = false;
+    bool hasError_ = false;
+    // 全部记录都在内存中时直接顺序读取
+    size_t bufferPos_ = 0;
+    std::vector<std::unique_ptr<RunReader>> readers_;
+    std::vector<HeapItem> heap_;
+};
+} // namespace OHOS::FileManagement::Backup
+
+#endif // OHOS_FILEMGMT_BACKUP_B_EXTERNAL_SORTER_H
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_FILEMGMT_BACKUP_B_SCAN_SNAPSHOT_H
+#define OHOS_FILEMGMT_BACKUP_B_SCAN_SNAPSHOT_H
+
+/**
+ * @file b_scan_snapshot.h
+ * @brief 跨备份任务持久化的扫描快照
+ *
+ * 目录记录(inode, mtime_ns, ctime_ns, 条目数)及其条目列表: 目录元数据未变化时直接复用上次的条目列表, 省去readdir.
+ * 目录元数据只反映条目的增删改名, 不反映文件内容的原地修改, 因此文件本身仍需逐个stat.
+ * 文件记录(inode, size, mtime_ns, ctime_ns)及其摘要: 元数据完全一致时复用上次的摘要, 省去重新计算.
+ * 时间戳落在快照开始时间附近或之后的记录不会被保存, 避免时间戳精度不足和时钟跳变导致误判.
+ * 快照文件任何不一致(版本、校验、长度)都会整体丢弃, 退化为全量扫描.
+ *
+ * 快照文件按路径排序, 切分为约64KiB的数据块, 文件末尾是每块首个路径组成的稀疏索引. 加载时只读入索引,
+ * 查询时二分定位数据块后按需读取, 同一目录及其下文件的记录相邻, 通常落在同一块中. 本次记录经BExternalSorter
+ * 排序, 超过内存上限时写入临时文件, 内存占用与目录和文件数量无关.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+#include "b_filesystem/b_external_sorter.h"
+#include "unique_fd.h"
+
+namespace OHOS::FileManagement::Backup {
+class BScanSnapshot {
+public:
+    struct DirEntry {
+        std::string name;
+        uint8_t type; // dirent中的d_type
+    };
+
+    // 判断记录是否可复用的元数据
+    struct Meta {
+        uint64_t ino = 0;
+        int64_t mtimeNs = 0;
+        int64_t ctimeNs = 0;
+    };
+
+    BScanSnapshot();
+
+    /**
+     * @brief 加载上次保存的快照, 文件不存在或不一致时以空快照开始. 需在记录之前调用
+     *
+     * @param path 快照文件路径, 所在目录同时用于存放排序临时文件
+     * @return 是否加载到可用的快照
+     */
+    bool Load(const std::string &path);
+
+    /**
+     * @brief 保存本次记录的快照, 先写临时文件再改名. 每个对象只能保存一次
+     *
+     * @param path 快照文件路径
+     * @return 是否保存成功
+     */
+    bool Save(const std::string &path);
+
+    /**
+     * @brief 查询目录的条目列表
+     *
+     * @param dirPath 目录路径
+     * @param st 目录当前的stat结果
+     * @param entries 命中时输出上次的条目列表
+     * @return 目录元数据与上次一致时返回true
+     */
+    bool LookupDir(const std::string &dirPath, const struct stat &st, std::vector<DirEntry> &entries);
+
+    // 记录本次读到的目录条目列表
+    void RecordDir(const std::string &dirPath, const struct stat &st, const std::vector<DirEntry> &entries);
+
+    /**
+     * @brief 查询文件的摘要
+     *
+     * @param filePath 文件路径
+     * @param st 文件当前的stat结果
+     * @return 元数据与上次一致时返回上次的摘要, 否则返回空串
+     */
+    std::string LookupHash(const std::string &filePath, const struct stat &st);
+
+    // 记录本次计算的文件摘要
+    void RecordHash(const std::string &filePath, const struct stat &st, const std::string &hash);
+
+private:
+    struct BlockInfo {
+        std::string firstKey;
+        uint64_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    static Meta GetMeta(const struct stat &st);
+    bool IsStable(const Meta &meta) const;
+    bool VerifyAndLoadIndex(int fd, int64_t &savedStartNs);
+    bool ReadBlock(size_t index);
+    bool LookupRecord(const std::string &key, uint8_t type, std::string &value);
+    void AddRecord(const std::string &key, std::string value);
+    bool CarryOver(uint8_t type);
+    bool WriteSorted(int fd);
+
+    std::mutex lock_;
+    // 本次扫描开始的CLOCK_REALTIME时间, 写入快照供下次加载时检查时钟回退
+    int64_t startNs_ = 0;
+    // 上次的快照文件及其稀疏索引, 数据块按需读取, 仅缓存最近读取的一块
+    UniqueFd prevFd_;
+    std::vector<BlockInfo> prevBlocks_;
+    size_t cachedBlock_ = SIZE_MAX;
+    std::string cachedData_;
+    // 本次记录, 排序后写入新快照
+    std::unique_ptr<BExternalSorter> sorter_;
+    bool dirsTouched_ = false;
+    bool filesTouched_ = false;
+};
+} // namespace OHOS::FileManagement::Backup
+
+#endif // OHOS_FILEMGMT_BACKUP_B_SCAN_SNAPSHOT_H
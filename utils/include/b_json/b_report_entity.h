@@ -18,6 +18,7 @@
 #define FILE_DEFAULT_MODE "0660"
 
 #include <fcntl.h>
+#include <functional>
 #include <map>
 #include <string>
 
@@ -47,6 +48,17 @@ enum class KeyType {
     ENCODE_FLAG
 };
 
+enum class ReportDiffType {
+    ADDED,
+    CHANGED,
+    DELETED,
+    UNCHANGED
+};
+
+// ADDED时cloud为空, DELETED时local为空
+using ReportDiffVisitor =
+    std::function<void(ReportDiffType type, struct ReportFileInfo *local, const struct ReportFileInfo *cloud)>;
+
 class BReportEntity {
 public:
     /**
@@ -61,6 +73,53 @@ public:
      */
     bool GetStorageReportInfos(std::unordered_map<std::string, struct ReportFileInfo> &infos);
 
+    /**
+     * @brief 按文件中的顺序逐条读取Report信息
+     *
+     * @param info 输出读到的条目
+     * @return 读到文件末尾时返回false
+     */
+    bool GetNextReportInfo(struct ReportFileInfo &info);
+
+    /**
+     * @brief 回到文件开头重新读取
+     *
+     * @return 文件不支持lseek时返回false
+     */
+    bool Rewind();
+
+    /**
+     * @brief 检查条目是否按路径非降序排列, 检查后回到文件开头
+     *
+     * @param count 输出条目数
+     * @return 有序且可以重新读取时返回true
+     */
+    bool IsSortedByPath(size_t &count);
+
+    /**
+     * @brief 在内存上限内按路径对Report做外部排序, 排序结果写入匿名临时文件, 完成后本Report回到文件开头
+     *
+     * key相同的条目保持原有先后顺序
+     *
+     * @param tmpDir 临时文件所在目录
+     * @param memoryLimit 排序缓存的内存上限, 字节
+     * @param count 输出条目数
+     * @return 排序后Report的文件描述符, 失败时小于0
+     */
+    UniqueFd SortByPath(const std::string &tmpDir, size_t memoryLimit, size_t &count);
+
+    /**
+     * @brief 对两份按路径排序的Report做归并对比, 内存占用与条目数无关
+     *
+     * 同一路径在本地重复出现时均与同一条云端条目对比, 云端重复出现时只取第一条, 与按哈希表查找的结果一致
+     * 大小和修改时间都相同时为UNCHANGED, 否则为CHANGED
+     *
+     * @param local 本地Report, 需按路径排序
+     * @param cloud 云端Report, 需按路径排序
+     * @param visitor 每条对比结果的回调
+     */
+    static void MergeJoin(BReportEntity &local, BReportEntity &cloud, const ReportDiffVisitor &visitor);
+
     /**
      * @brief Check if line is encode
      *
@@ -94,9 +153,13 @@ public:
 protected:
     UniqueFd srcFile_;
 private:
+    bool GetNextLine(std::string &line);
+
     std::string currLineInfo_;
     int currLineNum_ = 0;
     std::vector<std::string> keys_;
+    std::string readBuf_;
+    size_t readPos_ = 0;
 };
 } // namespace OHOS::FileManagement::Backup
 
@@ -53,6 +53,8 @@ public:
         int32_t delayTime {0};
         bool isSupportWithoutTar {false};
         std::vector<std::string> excludeInfos;
+        // 只恢复与这些路径匹配的文件, 为空时恢复全部
+        std::vector<std::string> restorePaths;
         int32_t batchSize {500};
     }BundleSettingInfo;
 
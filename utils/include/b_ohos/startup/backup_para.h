@@ -16,8 +16,12 @@
 #ifndef OHOS_FILEMGMT_BACKUP_BACKUP_PARA_H
 #define OHOS_FILEMGMT_BACKUP_BACKUP_PARA_H
 
+#include <cstdint>
+#include <string>
 #include <tuple>
 
+#include "b_encryption/b_encryption.h"
+
 namespace OHOS::FileManagement::Backup {
 class BackupPara {
 public:
@@ -56,6 +60,27 @@ public:
      * @return 获取的配置项backup.backupDebugState的值为true时则返回true，否则返回false
      */
     static bool GetBackupDebugState();
+
+    /**
+     * @brief 获取backup.para配置项backup.packet.laneCount的值
+     *
+     * @return 应用备份时并行打包的路数，配置为0或未配置时根据设备内存和CPU核数计算，范围为[1, MAX_PACKET_LANE_COUNT]
+     */
+    static uint32_t GetBackupPacketLaneCount();
+
+    /**
+     * @brief 获取backup.para配置项backup.trace.enable的值
+     *
+     * @return 配置项值为true时返回true, 表示需要记录各阶段耗时并在会话结束时导出
+     */
+    static bool GetBackupTraceEnable();
+
+    /**
+     * @brief 获取backup.para配置项backup.tar.digest的值
+     *
+     * @return 打包时为每个文件计算内容摘要的算法，未配置或无法识别时返回NONE，即不写入摘要
+     */
+    static BEncryption::DigestAlgorithm GetBackupTarDigestAlgorithm();
 };
 } // namespace OHOS::FileManagement::Backup
 
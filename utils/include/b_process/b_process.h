@@ -16,17 +16,58 @@
 #ifndef OHOS_FILEMGMT_BACKUP_B_PROCESS_H
 #define OHOS_FILEMGMT_BACKUP_B_PROCESS_H
 
+#include <cstdint>
 #include <functional>
 #include <string_view>
+#include <sys/resource.h>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "errors.h"
 #include "nocopyable.h"
 
 namespace OHOS::FileManagement::Backup {
+struct BProcessOptions {
+    // 超时时间(毫秒), 超时后子进程被SIGKILL终止; 小于0表示不超时
+    int32_t timeoutMs = -1;
+    // 子进程资源限制, first为RLIMIT_*, second同时作为软限制和硬限制
+    std::vector<std::pair<int, rlim_t>> rlimits;
+};
+
+struct BProcessResult {
+    // 启动失败时的errno, 为0表示启动成功
+    int spawnErrno = 0;
+    // 子进程正常退出时的退出码, 否则为-1
+    int exitCode = -1;
+    // 子进程被信号终止时的信号值, 否则为0
+    int termSignal = 0;
+    bool timedOut = false;
+    // DetectFatalLog检测到严重错误, 子进程已被终止
+    bool fatalLog = false;
+};
+
 class BProcess final : protected NoCopyable {
 public:
+    /**
+     * @brief 以posix_spawn启动命令, 通过epoll读取stderr、pidfd等待子进程退出
+     *
+     * 不复制父进程页表, 启动开销与父进程内存大小无关. stdin/stdout重定向到/dev/null.
+     *
+     * @param argv 命令参数表, 规则同ExecuteCmd
+     * @param options 超时时间与资源限制. 指定资源限制时改为fork启动, 在子进程exec前设置, 设置失败视为启动失败
+     * @param DetectFatalLog 对stderr的每一个非空行回调, 返回true时终止子进程
+     *
+     * @return BProcessResult 结构化的退出信息
+     *
+     * @throw BError(UTILS_INTERRUPTED_PROCESS) 系统调用异常(pipe、epoll调用失败)
+     *
+     * @throw BError(UTILS_INVAL_PROCESS_ARG) 系统调用异常(waitpid调用失败)
+     */
+    static BProcessResult Run(const std::vector<std::string_view> &argv,
+                              const BProcessOptions &options,
+                              std::function<bool(std::string_view)> DetectFatalLog = nullptr);
+
     /**
      * @brief 执行一个命令并同步等待执行结果
      *
@@ -16,6 +16,9 @@
 #ifndef OHOS_FILEMGMT_BACKUP_RADAR_APP_STATISTIC_H
 #define OHOS_FILEMGMT_BACKUP_RADAR_APP_STATISTIC_H
 
+#include <atomic>
+#include <cstdint>
+#include <string>
 #include <unordered_map>
 #include <utility>
 #include "b_resources/b_constants.h"
@@ -83,6 +86,7 @@ private:
 
 class FileSizeStat : public FileStatList {
 public:
+    static uint8_t GetIndexBySize(uint64_t fileSize);
     void UpdateStat(uint64_t fileSize);
     ItemInfo* GetListPtr() override
     {
@@ -96,6 +100,20 @@ private:
     ItemInfo sizeInfoList_[SIZE_DEF_COUNT] = {{0, 0}};
 };
 
+constexpr uint32_t FILE_STAT_SHARD_COUNT = 16;
+constexpr size_t FILE_STAT_SHARD_ALIGN = 64;
+
+/**
+ * @brief 文件分布统计分片. 每个线程固定写入一个分片, 以relaxed原子操作累加, 上报前合并
+ */
+struct alignas(FILE_STAT_SHARD_ALIGN) FileStatShard {
+    std::atomic<uint32_t> typeCount[TYPE_DEF_COUNT] = {};
+    std::atomic<uint64_t> typeSize[TYPE_DEF_COUNT] = {};
+    std::atomic<uint32_t> sizeCount[SIZE_DEF_COUNT] = {};
+    std::atomic<uint64_t> sizeSize[SIZE_DEF_COUNT] = {};
+    std::atomic<uint32_t> maxDirDepth = {0};
+};
+
 class FileErrorList {
 public:
     FileErrorList() {}
@@ -152,6 +170,10 @@ public:
     void UpdateSendRateZeroSpend();
     void UpdateErrorFileList(const std::string &fileName, int32_t errorCode);
     void UpdateFileDist(std::string fileExtension, uint64_t fileSize);
+    // 无锁更新文件分布与目录深度, 可在多个线程并发调用, 结果在MergeFileStat后可见
+    void UpdateFileStat(const std::string &fileExtension, uint64_t fileSize, uint32_t dirDepth);
+    // 将各线程分片合并到fileSizeDist_、fileTypeDist_和dirDepth_, 上报时自动调用
+    void MergeFileStat();
     void ReportBackup(const std::string &func, int32_t errorCode, std::string errMsg = "");
     void ReportBackup(const std::string &func, BError errCode);
     void ReportRestore(const std::string &func, int32_t errorCode, std::string errMsg = "");
@@ -160,6 +182,9 @@ public:
     void ReportSA(const std::string &func, RadarError error);
 
 private:
+    FileStatShard &GetLocalShard();
+
+    FileStatShard fileStatShards_[FILE_STAT_SHARD_COUNT];
     FileSizeStat fileSizeDist_;
     FileTypeStat fileTypeDist_;
     FileErrorList fileErrorList_;
@@ -40,8 +40,12 @@ static inline const char *EXTENSION_OLD_BACKUP_VERSION_PARA = "oldBackupVersion"
 static inline const char *EXTENSION_BACKUP_SCENE_PARA = "backupScene";
 static inline const char *EXTENSION_SUPPORT_WITHOUT_TAR_PARA = "supportWithoutTar";
 static inline const char *EXTENSION_EXCLUDE_INFOS_PARA = "excludeInfos";
+static inline const char *EXTENSION_RESTORE_PATHS_PARA = "restorePaths";
 static inline const char *EXTENSION_BATCH_SIZE_PARA = "batchSize";
 static inline const char *EXTENSION_CALLER_BUNDLE_NAME_PARA = "callerBundleName";
+static inline const char *EXTENSION_SESSION_ACTIVE_TIME_PARA = "sessionActiveTime";
+// 扩展信息中备份产物加密密钥的类型，detail为"<密钥标识>:<64位十六进制密钥>"，恢复时由调用方下发同一密钥
+static inline const char *EXT_INFO_STREAM_KEY_TYPE = "backup_stream_key";
 
 enum class ExtensionAction {
     INVALID = 0,
@@ -75,7 +79,7 @@ constexpr int BACKUP_LOADSA_TIMEOUT_MS = 5000;
 constexpr int DECIMAL_BASE = 10; // 十进制基数
 
 constexpr off_t BIG_FILE_BOUNDARY = 2 * 1024 * 1024; // 大文件边界
-constexpr unsigned long BIG_FILE_NAME_SIZE = 16;     // 大文件名长度(hash处理)
+constexpr unsigned long BIG_FILE_NAME_SIZE = 32;     // 大文件名长度(hash处理)
 constexpr off_t BIG_FILE_BOUNDARY_WITHOUT_TAR = -1; // 免tar不设置大文件边界
 
 constexpr int PATHES_TO_BACKUP_SIZE = 13;     // 应用默认备份的目录个数
@@ -96,6 +100,10 @@ const uint32_t MAX_FILE_COUNT = 6000; // 单个tar包最多包含6000个文件
 const uint64_t DEFAULT_APP_SLICE_SIZE = 50 * 1024 * 1024; // default打包大小为50M
 const uint32_t MAX_DEFAULT_APP_FILE_COUNT = 400; // 单个default tar包最多包含400个文件
 const int FILE_AND_MANIFEST_FD_COUNT = 2; // 每组文件和简报数量统计
+const uint32_t BIG_FILE_PIPELINE_DEPTH = 4; // 大文件回传时最多预先打开的文件数
+const size_t SCAN_RESULT_QUEUE_SHARD_COUNT = 16; // 扫描结果队列分片数
+const size_t SCAN_RESULT_QUEUE_CAPACITY = 16384; // 扫描结果队列最多缓存的文件个数
+const size_t BACKUP_FILE_FETCH_BATCH = 64; // 回传阶段每次从扫描结果队列批量取出的文件个数
 
 constexpr int DEFAULT_VFS_CACHE_PRESSURE = 100; // 默认内存回收参数
 constexpr int BACKUP_VFS_CACHE_PRESSURE = 10000; // 备份过程修改参数
@@ -146,6 +154,21 @@ static const bool BACKUP_DEBUG_OVERRIDE_BACKUP_SA_RELEASE_DEFAULT_VALUE = true;
 static inline std::string BACKUP_OVERRIDE_INCREMENTAL_KEY = "backup.overrideIncrementalRestore";
 static const bool BACKUP_DEBUG_OVERRIDE_INCREMENTAL_DEFAULT_VALUE = true;
 
+// backup.para内配置项的名称，该配置项为true时记录备份恢复各阶段耗时并在会话结束时导出
+static inline std::string BACKUP_TRACE_ENABLE_KEY = "backup.trace.enable";
+static inline std::string_view BACKUP_TRACE_FILE_NAME = "backup_trace.json";
+
+// backup.para内配置项的名称，该配置项为应用备份时并行打包的路数，0表示根据设备内存和CPU核数自动选择
+static inline std::string BACKUP_PACKET_LANE_COUNT_KEY = "backup.packet.laneCount";
+constexpr uint32_t DEFAULT_PACKET_LANE_COUNT = 1;
+constexpr uint32_t MAX_PACKET_LANE_COUNT = 4;
+constexpr uint32_t CPU_COUNT_PER_PACKET_LANE = 4; // 自动选择时每4个CPU核增加一路打包
+constexpr uint64_t PACKET_MULTI_LANE_MEM_THRESHOLD = 6ULL * 1024 * 1024 * 1024; // 内存不低于6G时才允许多路打包
+
+// backup.para内配置项的名称，该配置项为tar包内文件内容摘要算法，取值为xxh64或sha256，未配置时不写入摘要
+static inline std::string BACKUP_TAR_DIGEST_KEY = "backup.tar.digest";
+constexpr uint32_t BACKUP_TAR_DIGEST_VALUE_MAX = 16;
+
 // 应用备份数据暂存路径
 static inline std::string_view SA_BUNDLE_BACKUP_BACKUP = "/backup/";
 static inline std::string_view SA_BUNDLE_BACKUP_RESTORE = "/restore/";
@@ -262,6 +285,10 @@ constexpr uint32_t APP_BASE_PATH_DEPTH = 4;
 
 // 备份恢复配置文件暂存路径
 static inline std::string_view BACKUP_CONFIG_EXTENSION_PATH = "/data/storage/el2/base/cache/";
+// 扫描快照文件, 位于BACKUP_CONFIG_EXTENSION_PATH下, 跨备份任务保留
+static inline std::string_view BACKUP_SCAN_SNAPSHOT = "backup_scan_snapshot";
+// 简报外部排序的内存上限, 超过后分段写入BACKUP_CONFIG_EXTENSION_PATH下的临时文件
+constexpr size_t REPORT_SORT_MEMORY_LIMIT = 8 * 1024 * 1024;
 
 // 应用备份恢复所需的索引文件
 static inline std::string_view EXT_BACKUP_MANAGE = "manage.json";
@@ -21,6 +21,7 @@
  * @brief 使用指定实现打包/解包，本层在进行打包/解包前还负责防御路径穿越攻击
  *
  */
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string_view>
@@ -32,7 +33,7 @@ class BTarballFactory final : protected NoCopyable {
 public:
     /**
      * @brief 打包器仿函数集合
-     * 当前迫于时间所限，不得不采用命令行实现。后续必然要实现自研打包协议，从而满足在同一个进程进行打包的诉求。
+     * 最初迫于时间所限采用命令行实现，现已提供进程内实现'native'，命令行实现仅作为兼容保留。
      * 在降低调用成本后，就可以实现逐个向tarball追加文件的append方法。append方法是优化方法，和tar二选一即可。
      * 然而纯虚函数必须得在子类实现，这一性质使得基于继承的设计模式无法方便地选择合适的打包方法，为了解决这个问题，
      * 这里采用组合的方式实现。现在在外层简单地判断相应仿函数是否为空，就知道如何进行选择了。
@@ -57,13 +58,20 @@ public:
          * An absolute path is required.
          */
         std::function<void(std::string_view)> untar;
+
+        /**
+         * @brief 设置进度回调，仅进程内实现支持，为空表示不支持
+         *
+         * @param _1 进度回调，参数依次为当前处理的归档内路径、已处理字节数、总字节数
+         */
+        std::function<void(std::function<void(std::string_view, uint64_t, uint64_t)>)> setProgress;
     };
 
 public:
     /**
      * @brief 打包器工厂方法
      *
-     * @param implType 打包器实现方式，可选择'cmdline'
+     * @param implType 打包器实现方式，可选择'cmdline'或'native'
      * @param tarballPath Absolute path of the file package。Cannot contain extra slashes, must be suffixed with .tar
      * @return std::unique_ptr<Impl> 打包器仿函数集合
      */
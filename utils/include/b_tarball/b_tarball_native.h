@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_FILEMGMT_BACKUP_B_TARBALL_NATIVE_H
+#define OHOS_FILEMGMT_BACKUP_B_TARBALL_NATIVE_H
+
+/**
+ * @file b_tarball_native.h
+ * @brief 进程内打包/解包实现, 不再fork外部tar命令
+ *
+ * 归档格式与扩展侧TarFile/UntarFile一致: ustar头, 超长路径使用GNU 'L'/'K'扩展记录.
+ * 解包时同时兼容pax扩展头('x')中的path/linkpath/size字段, 可以解开GNU tar默认格式和posix格式的归档.
+ */
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <sys/stat.h>
+#include <vector>
+
+#include "nocopyable.h"
+
+namespace OHOS::FileManagement::Backup {
+class BTarballNative final : protected NoCopyable {
+public:
+    /**
+     * @brief 进度回调
+     *
+     * @param _1 当前处理完成的归档内路径
+     * @param _2 已处理的字节数(打包时为已写入的文件内容大小, 解包时为已读取的归档大小)
+     * @param _3 总字节数
+     */
+    using ProgressCallback = std::function<void(std::string_view, uint64_t, uint64_t)>;
+
+    /**
+     * @brief 打包, 单个文件读取失败时跳过并记录日志, 归档无法写入时抛出 UTILS_TARBALL_PACK_FAIL
+     *
+     * @param root 根目录, includes/excludes中的相对路径相对于该目录
+     * @param includes 需要打包的路径, 支持通配符
+     * @param excludes 不需要打包的路径, 支持通配符
+     */
+    void Tar(std::string_view root, std::vector<std::string_view> includes, std::vector<std::string_view> excludes);
+
+    /**
+     * @brief 解包, 归档损坏、存在路径穿越或文件/目录/链接无法创建写入时抛出 UTILS_TARBALL_UNPACK_FAIL
+     *
+     * @param root 用于存储解包文件的根目录
+     */
+    void Untar(std::string_view root);
+
+    void SetProgressCallback(ProgressCallback callback);
+
+public:
+    BTarballNative(std::string_view tarballDir, std::string_view tarballName);
+
+private:
+    struct Entry {
+        std::string fullPath;
+        std::string name;
+        struct stat st;
+    };
+
+    void CollectEntries(std::string_view root,
+                        const std::vector<std::string_view> &includes,
+                        const std::vector<std::string_view> &excludes,
+                        std::vector<Entry> &entries);
+    void ReportProgress(std::string_view name, uint64_t done, uint64_t total);
+
+    std::string tarballDir_;
+    std::string tarballName_;
+    std::string tarballPath_;
+    ProgressCallback progressCb_;
+};
+} // namespace OHOS::FileManagement::Backup
+#endif // OHOS_FILEMGMT_BACKUP_B_TARBALL_NATIVE_H
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_FILEMGMT_BACKUP_B_SPAN_TRACER_H
+#define OHOS_FILEMGMT_BACKUP_B_SPAN_TRACER_H
+
+/**
+ * @file b_span_tracer.h
+ * @brief 备份恢复会话的细粒度耗时记录
+ *
+ * 每个线程独占一个定长环形缓冲区, 记录时无锁, 缓冲区写满后覆盖最旧的记录.
+ * 时间戳取自CLOCK_MONOTONIC, 扩展、SA和backup_tool导出的文件可以放在同一时间轴上查看.
+ * 导出格式为Chrome trace事件格式, 可直接用chrome://tracing或Perfetto打开.
+ * 未开启时BSpan只有一次relaxed原子读.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "nocopyable.h"
+
+namespace OHOS::FileManagement::Backup {
+class BSpanTracer final : protected NoCopyable {
+public:
+    static BSpanTracer &GetInstance();
+
+    static bool IsEnabled()
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    static uint64_t NowNs();
+
+    void SetEnabled(bool enabled);
+
+    /**
+     * @brief 记录一段耗时
+     *
+     * @param name 名称, 必须是生命周期覆盖整个进程的字符串常量
+     * @param beginNs 开始时间, 取自NowNs
+     * @param endNs 结束时间, 取自NowNs
+     */
+    void Record(const char *name, uint64_t beginNs, uint64_t endNs);
+
+    /**
+     * @brief 将当前所有线程缓冲区中的记录导出为Chrome trace JSON文件
+     *
+     * @param path 导出文件路径, 已存在时覆盖
+     * @return 写入成功返回true
+     */
+    bool ExportChromeTrace(const std::string &path);
+
+    // 丢弃已记录的数据, 仅在没有线程正在记录时调用
+    void Clear();
+
+public:
+    static constexpr uint32_t RING_CAPACITY = 4096;
+
+private:
+    struct Event {
+        std::atomic<const char *> name {nullptr};
+        std::atomic<uint64_t> beginNs {0};
+        std::atomic<uint64_t> endNs {0};
+        std::atomic<uint32_t> tid {0};
+    };
+
+    struct Ring {
+        Event events[RING_CAPACITY];
+        std::atomic<uint64_t> head {0};
+    };
+
+    class RingHolder;
+
+    BSpanTracer() = default;
+    Ring *AcquireRing();
+    void ReleaseRing(Ring *ring);
+
+    static std::atomic<bool> enabled_;
+    std::mutex ringsLock_;
+    std::vector<std::unique_ptr<Ring>> rings_;
+    std::vector<Ring *> freeRings_;
+};
+
+/**
+ * @brief 作用域耗时记录, 析构时写入当前线程的缓冲区
+ */
+class BSpan final : protected NoCopyable {
+public:
+    explicit BSpan(const char *name)
+        : name_(BSpanTracer::IsEnabled() ? name : nullptr), beginNs_(name_ ? BSpanTracer::NowNs() : 0)
+    {
+    }
+
+    ~BSpan()
+    {
+        if (name_ != nullptr) {
+            BSpanTracer::GetInstance().Record(name_, beginNs_, BSpanTracer::NowNs());
+        }
+    }
+
+private:
+    const char *name_;
+    uint64_t beginNs_;
+};
+
+#define BACKUP_SPAN_CONCAT_INNER(a, b) a##b
+#define BACKUP_SPAN_CONCAT(a, b) BACKUP_SPAN_CONCAT_INNER(a, b)
+#define BACKUP_SPAN(name) BSpan BACKUP_SPAN_CONCAT(backupSpan, __LINE__)(name)
+} // namespace OHOS::FileManagement::Backup
+
+#endif // OHOS_FILEMGMT_BACKUP_B_SPAN_TRACER_H
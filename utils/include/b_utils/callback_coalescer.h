@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_FILEMGMT_BACKUP_CALLBACK_COALESCER_H
+#define OHOS_FILEMGMT_BACKUP_CALLBACK_COALESCER_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace OHOS::FileManagement::Backup {
+/**
+ * @brief 合并回调事件, 把大量来自native线程的事件成批交给回调线程(如JS线程)处理
+ *
+ * 同一时刻最多只有一个待执行的投递任务: 回调线程忙时新事件只入队, 由下一次任务一并取走,
+ * 因此事件的等待时间不超过正在执行的批次加上自身所在批次. 每个任务最多处理 maxBatch 个事件, 剩余事件重新投递,
+ * 避免长时间占用回调线程. 队列满时 Push 阻塞生产者(背压). 未提供 scheduler 时由入队线程就地处理,
+ * 其他线程同时入队的事件由该线程一并处理.
+ * 必须通过 std::make_shared 创建; 使用 scheduler 时不能在回调线程上调用 Push.
+ */
+template <typename T>
+class CallbackCoalescer : public std::enable_shared_from_this<CallbackCoalescer<T>> {
+public:
+    using Task = std::function<void()>;
+    // 把任务投递到回调线程, 失败返回false
+    using Scheduler = std::function<bool(Task)>;
+    // 在回调线程处理一批事件, 事件按入队顺序排列
+    using Consumer = std::function<void(std::vector<T> &)>;
+
+    CallbackCoalescer(size_t capacity, size_t maxBatch, Scheduler scheduler, Consumer consumer)
+        : capacity_(capacity == 0 ? 1 : capacity), maxBatch_(maxBatch == 0 ? 1 : maxBatch),
+          scheduler_(std::move(scheduler)), consumer_(std::move(consumer))
+    {
+    }
+    ~CallbackCoalescer() = default;
+    CallbackCoalescer(const CallbackCoalescer &) = delete;
+    CallbackCoalescer &operator=(const CallbackCoalescer &) = delete;
+
+    /**
+     * @brief 事件入队, 队列满时阻塞直到回调线程取走事件
+     *
+     * @return 已关闭或投递任务失败时返回false
+     */
+    bool Push(T item)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this] { return closed_ || queue_.size() < capacity_; });
+        if (closed_) {
+            return false;
+        }
+        queue_.emplace_back(std::move(item));
+        if (scheduled_) {
+            return true;
+        }
+        scheduled_ = true;
+        lock.unlock();
+        if (!scheduler_) {
+            while (DrainOnce()) {
+            }
+            return true;
+        }
+        return Schedule();
+    }
+
+    /**
+     * @brief 关闭队列, 丢弃未处理的事件并唤醒阻塞的生产者
+     *
+     * 其他线程正在执行consumer时等待其返回, 之后consumer不会再被调用, 调用方可以安全释放consumer引用的对象
+     */
+    void Close()
+    {
+        std::deque<T> dropped;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            closed_ = true;
+            dropped.swap(queue_);
+            notFull_.notify_all();
+            idle_.wait(lock, [this] { return !consuming_ || consumerThread_ == std::this_thread::get_id(); });
+        }
+    }
+
+    size_t Size()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.size();
+    }
+
+    // 已交给consumer处理的批次数
+    uint64_t GetBatchCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return batchCount_;
+    }
+
+private:
+    bool Schedule()
+    {
+        std::weak_ptr<CallbackCoalescer> weak = this->weak_from_this();
+        bool ret = scheduler_([weak]() {
+            auto self = weak.lock();
+            if (self != nullptr && self->DrainOnce() && !self->Schedule()) {
+                self->Close();
+            }
+        });
+        if (!ret) {
+            Close();
+        }
+        return ret;
+    }
+
+    // 处理一批事件, 还有剩余事件需要继续处理时返回true
+    bool DrainOnce()
+    {
+        std::vector<T> batch;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            size_t count = std::min(maxBatch_, queue_.size());
+            batch.reserve(count);
+            std::move(queue_.begin(), queue_.begin() + count, std::back_inserter(batch));
+            queue_.erase(queue_.begin(), queue_.begin() + count);
+            notFull_.notify_all();
+            if (!batch.empty()) {
+                batchCount_++;
+                consuming_ = true;
+                consumerThread_ = std::this_thread::get_id();
+            }
+        }
+        if (!batch.empty() && consumer_) {
+            consumer_(batch);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        consuming_ = false;
+        idle_.notify_all();
+        if (closed_ || queue_.empty()) {
+            scheduled_ = false;
+            return false;
+        }
+        return true;
+    }
+
+    const size_t capacity_;
+    const size_t maxBatch_;
+    Scheduler scheduler_;
+    Consumer consumer_;
+    bool closed_ = false;
+    bool scheduled_ = false;
+    bool consuming_ = false;
+    std::thread::id consumerThread_;
+    uint64_t batchCount_ = 0;
+    std::deque<T> queue_;
+    std::mutex mutex_;
+    std::condition_variable notFull_;
+    std::condition_variable idle_;
+};
+} // namespace OHOS::FileManagement::Backup
+#endif // OHOS_FILEMGMT_BACKUP_CALLBACK_COALESCER_H
@@ -20,7 +20,6 @@
 #include <map>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <shared_mutex>
 #include <string>
 #include <sys/stat.h>
@@ -30,6 +29,8 @@
 #include <vector>
 
 #include "b_radar/radar_app_statistic.h"
+#include "b_resources/b_constants.h"
+#include "b_utils/sharded_queue.h"
 
 namespace OHOS::FileManagement::Backup {
 class IFileInfo {
@@ -45,6 +46,8 @@ public:
     bool isBigFile_ = false;
     bool isAncoFile_ = false;
     bool isLongPath_ = false;
+    // 扫描阶段得到的路径深度, 为0表示未知
+    uint32_t dirDepth_ = 0;
 };
 
 struct FileInfo : public IFileInfo {
@@ -91,6 +94,8 @@ public:
     virtual std::string GetRestorePath() = 0;
     std::string filePath_ = "";
     size_t fileSize_ = 0;
+    // 扫描阶段得到的路径深度, 为0表示未知
+    uint32_t dirDepth_ = 0;
 };
 
 struct SmallFileInfo : public ISmallFileInfo {
@@ -116,14 +121,26 @@ public:
     void AddBigFile(const std::string &filePath,
                     const struct stat &sta,
                     bool isLongPath,
-                    const std::string &restorePath = "");
-    void AddTarFile(const std::string& filename, const std::string& filePath, const struct stat& sta);
+                    const std::string &restorePath = "",
+                    uint32_t dirDepth = 0);
+    /**
+     * @brief tar包打包完成后入队, reservedSize为打包前通过ReserveTarBudget预占的空间
+     */
+    void AddTarFile(const std::string& filename, const std::string& filePath, const struct stat& sta,
+        uint64_t reservedSize = 0);
     void AddAncoBigFile(const std::string &filePath, const std::string &restorePath, const struct stat &sta);
     void AddAncoTarFile(const std::string &filename, const std::string &filePath, const struct stat &sta);
     std::shared_ptr<IFileInfo> GetFileInfo();
+    /**
+     * @brief 批量取出待发送文件, 取到tar包即结束本批. 不释放tar空间预算, 调用方每发送完一个再调用ReleaseTarBudget
+     *
+     * @param maxCount 本批最多取出的个数
+     */
+    std::vector<std::shared_ptr<IFileInfo>> GetFileInfos(size_t maxCount);
     bool HasFileReady();
 
-    void AddSmallFile(const std::string& filePath, size_t fileSize, const std::string& restorePath = "");
+    void AddSmallFile(const std::string& filePath, size_t fileSize, const std::string& restorePath = "",
+        uint32_t dirDepth = 0);
     std::vector<std::shared_ptr<ISmallFileInfo>> GetAllSmallFiles();
 
     bool IsProcessCompleted();
@@ -137,25 +154,44 @@ public:
 
     void StartPacket();
     void WaitForPacketFlag();
+    /**
+     * @brief 打包前等待空间预算可用并预占size, 多路并发打包时总量不超过预算一个分片以上
+     */
+    void ReserveTarBudget(uint64_t size);
+    // 打包失败时归还预占的空间
+    void CancelTarBudget(uint64_t size);
+    /**
+     * @brief 发送侧退出或任务取消时停止接收待发送文件, 唤醒阻塞在入队和预算上的扫描、打包线程
+     */
+    void StopPendingFiles();
+    // 新一次备份开始前重新允许入队
+    void ResetPendingFiles();
+    bool IsPendingStopped();
+    bool IsTarBudgetExhausted();
 
 public:
     uint64_t GetMaxTarSize();
-
-    std::mutex pendingFileMutex_;
-    std::queue<std::shared_ptr<IFileInfo>> pendingFileQueue_;
-    std::unordered_set<std::string> hashNameSet_;
+    std::string RegisterHashName(const std::string &filePath);
+    bool PushPendingFile(std::shared_ptr<IFileInfo> fileInfo);
+    void ReleaseTarBudget(const std::shared_ptr<IFileInfo> &fileInfo);
+    void NotifyFilesReady();
+
+    ShardedQueue<std::shared_ptr<IFileInfo>> pendingFileQueue_ {BConstants::SCAN_RESULT_QUEUE_SHARD_COUNT,
+        BConstants::SCAN_RESULT_QUEUE_CAPACITY};
+    ShardedNameSet hashNames_ {BConstants::SCAN_RESULT_QUEUE_SHARD_COUNT};
     std::mutex smallFileMutex_;
     std::vector<std::shared_ptr<ISmallFileInfo>> smallFiles_;
     std::vector<std::shared_ptr<IFileInfo>> allFiles_;
     std::mutex mutexLock_;
     std::condition_variable waitFilesReady_;
+    std::atomic<uint32_t> filesWaiters_ = 0;
     std::atomic<bool> isProcessCompleted_ = false;
     std::atomic<uint64_t> currentTarSize_ = 0;
     std::atomic<uint64_t> maxTarSize_ = 0;
-    std::atomic<bool> stopPacket_ = false;
     std::atomic<bool> isFirstAddTarFile_ = true;
     std::mutex mutexPacket_;
     std::condition_variable waitPacketFlag_;
+    std::atomic<uint32_t> packetWaiters_ = 0;
     std::mutex allFileMutex_;
     std::string callerBundleName_;
 };
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_FILEMGMT_BACKUP_SHARDED_QUEUE_H
+#define OHOS_FILEMGMT_BACKUP_SHARDED_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace OHOS::FileManagement::Backup {
+/**
+ * @brief 分片锁有界多生产者多消费者队列
+ *
+ * 每个生产者线程固定写入一个分片, 生产者之间不再竞争同一把锁; 消费者轮询各分片取数据.
+ * 同一生产者写入的元素保持先进先出, 不同生产者之间不保证顺序.
+ * 队列元素总数达到容量时 Push 阻塞生产者, 出队后唤醒. Pop 类接口均不阻塞.
+ * Close 之后 Push 不再阻塞并直接丢弃元素, 用于消费者退出或任务取消时释放被阻塞的生产者.
+ */
+template <typename T>
+class ShardedQueue {
+public:
+    ShardedQueue(size_t shardCount, size_t capacity)
+        : capacity_(capacity == 0 ? 1 : capacity), shards_(shardCount == 0 ? 1 : shardCount) {}
+    ~ShardedQueue() = default;
+    ShardedQueue(const ShardedQueue &) = delete;
+    ShardedQueue &operator=(const ShardedQueue &) = delete;
+
+    /**
+     * @return true 入队成功; false 队列已关闭, 元素被丢弃
+     */
+    bool Push(T item)
+    {
+        if (Reserve(1) == 0) {
+            return false;
+        }
+        Shard &shard = shards_[ShardIndex()];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.items.emplace_back(std::move(item));
+            size_.fetch_add(1);
+        }
+        return true;
+    }
+
+    /**
+     * @brief 批量入队, 一次加锁写入尽可能多的元素, 空间不足时等待后继续写入剩余元素
+     *
+     * @return true 全部入队; false 队列已关闭, 剩余元素被丢弃
+     */
+    bool PushBatch(std::vector<T> &items)
+    {
+        Shard &shard = shards_[ShardIndex()];
+        size_t pushed = 0;
+        while (pushed < items.size()) {
+            size_t count = Reserve(items.size() - pushed);
+            if (count == 0) {
+                items.clear();
+                return false;
+            }
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                for (size_t i = 0; i < count; i++) {
+                    shard.items.emplace_back(std::move(items[pushed + i]));
+                }
+                size_.fetch_add(count);
+            }
+            pushed += count;
+        }
+        items.clear();
+        return true;
+    }
+
+    bool TryPop(T &item)
+    {
+        std::vector<T> items;
+        if (PopBatch(items, 1) == 0) {
+            return false;
+        }
+        item = std::move(items.front());
+        return true;
+    }
+
+    /**
+     * @brief 批量出队, 最多取 maxCount 个元素追加到 items
+     *
+     * @param stopAfter 可选, 对某个元素返回 true 时取完该元素即结束本批
+     * @return 本次取出的元素个数
+     */
+    size_t PopBatch(std::vector<T> &items, size_t maxCount, const std::function<bool(const T &)> &stopAfter = nullptr)
+    {
+        if (maxCount == 0 || size_.load() == 0) {
+            return 0;
+        }
+        size_t count = 0;
+        size_t start = popCursor_.fetch_add(1) % shards_.size();
+        bool stop = false;
+        for (size_t i = 0; i < shards_.size() && count < maxCount && !stop; i++) {
+            Shard &shard = shards_[(start + i) % shards_.size()];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            size_t taken = 0;
+            while (!shard.items.empty() && count + taken < maxCount && !stop) {
+                items.emplace_back(std::move(shard.items.front()));
+                shard.items.pop_front();
+                taken++;
+                stop = stopAfter != nullptr && stopAfter(items.back());
+            }
+            size_.fetch_sub(taken);
+            count += taken;
+        }
+        Release(count);
+        return count;
+    }
+
+    void Clear()
+    {
+        size_t count = 0;
+        for (auto &shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            size_.fetch_sub(shard.items.size());
+            count += shard.items.size();
+            shard.items.clear();
+        }
+        Release(count);
+    }
+
+    /**
+     * @brief 关闭队列并唤醒阻塞的生产者, 已入队的元素仍可取出
+     */
+    void Close()
+    {
+        std::lock_guard<std::mutex> lock(fullMutex_);
+        closed_.store(true);
+        notFull_.notify_all();
+    }
+
+    // 重新打开队列, 供下一次任务复用
+    void Reopen()
+    {
+        closed_.store(false);
+    }
+
+    bool IsClosed() const
+    {
+        return closed_.load();
+    }
+
+    size_t Size() const
+    {
+        return size_.load();
+    }
+
+    bool Empty() const
+    {
+        return size_.load() == 0;
+    }
+
+private:
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::deque<T> items;
+    };
+
+    size_t ShardIndex() const
+    {
+        return std::hash<std::thread::id> {}(std::this_thread::get_id()) % shards_.size();
+    }
+
+    // 预留至少一个位置, 返回实际预留的个数(不超过 want), 队列关闭时返回0
+    size_t Reserve(size_t want)
+    {
+        size_t used = reserved_.load();
+        while (true) {
+            if (closed_.load()) {
+                return 0;
+            }
+            if (used < capacity_) {
+                size_t count = std::min(want, capacity_ - used);
+                if (reserved_.compare_exchange_weak(used, used + count)) {
+                    return count;
+                }
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(fullMutex_);
+            fullWaiters_.fetch_add(1);
+            notFull_.wait(lock, [this] { return reserved_.load() < capacity_ || closed_.load(); });
+            fullWaiters_.fetch_sub(1);
+            used = reserved_.load();
+        }
+    }
+
+    void Release(size_t count)
+    {
+        if (count == 0) {
+            return;
+        }
+        reserved_.fetch_sub(count);
+        if (fullWaiters_.load() > 0) {
+            std::lock_guard<std::mutex> lock(fullMutex_);
+            notFull_.notify_all();
+        }
+    }
+
+    const size_t capacity_;
+    std::vector<Shard> shards_;
+    std::atomic<size_t> size_ {0};
+    std::atomic<size_t> reserved_ {0};
+    std::atomic<size_t> popCursor_ {0};
+    std::atomic<size_t> fullWaiters_ {0};
+    std::atomic<bool> closed_ {false};
+    std::mutex fullMutex_;
+    std::condition_variable notFull_;
+};
+
+/**
+ * @brief 分片锁字符串集合, 用于多线程并发登记文件名并检测重名
+ */
+class ShardedNameSet {
+public:
+    explicit ShardedNameSet(size_t shardCount) : shards_(shardCount == 0 ? 1 : shardCount) {}
+    ~ShardedNameSet() = default;
+    ShardedNameSet(const ShardedNameSet &) = delete;
+    ShardedNameSet &operator=(const ShardedNameSet &) = delete;
+
+    /**
+     * @brief 登记名称
+     *
+     * @return true 登记成功; false 名称已存在
+     */
+    bool Insert(const std::string &name)
+    {
+        Shard &shard = shards_[std::hash<std::string> {}(name) % shards_.size()];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.names.emplace(name).second;
+    }
+
+    bool Contains(const std::string &name)
+    {
+        Shard &shard = shards_[std::hash<std::string> {}(name) % shards_.size()];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.names.find(name) != shard.names.end();
+    }
+
+    void Clear()
+    {
+        for (auto &shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.names.clear();
+        }
+    }
+
+private:
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::unordered_set<std::string> names;
+    };
+
+    std::vector<Shard> shards_;
+};
+} // namespace OHOS::FileManagement::Backup
+#endif // OHOS_FILEMGMT_BACKUP_SHARDED_QUEUE_H
@@ -15,27 +15,65 @@
 
 #ifndef OHOS_FILEMGMT_BACKUP_STRING_UTILS_H
 #define OHOS_FILEMGMT_BACKUP_STRING_UTILS_H
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 #include <set>
 
 namespace OHOS::FileManagement::Backup {
+/**
+ * @brief 字符串数组零拷贝读取器, Next返回的视图指向原始数据
+ *
+ * 格式: [count u64][[len u64][bytes]...]
+ */
+class StringVectorReader {
+public:
+    explicit StringVectorReader(std::string_view data);
+    // 读取下一项, 读完或数据非法时返回false, 二者用Good区分
+    bool Next(std::string_view &item);
+    bool Good() const
+    {
+        return !error_;
+    }
+    // 头部声明的元素个数, 用于预留空间
+    size_t Count() const
+    {
+        return count_;
+    }
+
+private:
+    bool Fail(const char *reason);
+
+    std::string_view data_;
+    size_t pos_ = 0;
+    bool error_ = false;
+    uint64_t itemsLeft_ = 0;
+    size_t count_ = 0;
+};
 
 class StringUtils {
 public:
     static bool EndsWith(const std::string& str, const std::string& suffix);
     static std::vector<std::string> Split(const std::string& str, const std::string& delimiter);
     static std::string Concat(const std::vector<std::string>& strs, const std::string& connector);
-    static std::string StringVectorSerialize(const std::vector<std::string>& vec);
-    static std::vector<std::string> StringVectorDeserialize(const std::string& data);
+    // 将vec编码后追加到out, 可直接写入IPC原始数据缓冲区; 超过16MiB上限时返回false且不修改out
+    static bool StringVectorSerialize(const std::vector<std::string>& vec, std::string& out);
+    static std::vector<std::string> StringVectorDeserialize(std::string_view data);
+    // 零拷贝解析, items指向data内部, 数据非法时返回false
+    static bool StringVectorViews(std::string_view data, std::vector<std::string_view>& items);
 
     static std::string PathAddDelimiter(const std::string& path);
     static std::string GenMappingDir(const std::string& backupDir, const std::string& restoreDir);
     // 返回值pair first为待备份的路径，pair second为待恢复的路径
     static std::pair<std::string, std::string> ParseMappingDir(const std::string& str);
 
+    // 基于路径生成稳定的128位哈希名(32位十六进制), 不依赖std::hash实现, 跨版本、跨设备结果一致
     static std::string GenHashName(const std::string &str);
+    // 同上, isUsed返回true表示名称已被占用, 此时换用由路径决定的下一个候选名(不同种子的哈希)
+    static std::string GenHashName(const std::string &str, const std::function<bool(const std::string &)> &isUsed);
 
     static bool IsSubdirectory(const std::string &parent, const std::string &child);
     static bool IsPathPrefix(const std::string &path, const std::string &prefix);
@@ -54,6 +92,8 @@ public:
     static std::string RemoveTrailingSlash(const std::string& path);
     static std::string GetFileName(const std::string& filePath);
     static bool IsPathWithDirectory(const std::string& filePath);
+    // 路径深度, 即路径中分隔符的个数, 连续的分隔符只计一次
+    static uint32_t GetPathDepth(std::string_view path);
 };
 } // namespace OHOS::FileManagement::Backup
 #endif // OHOS_FILEMGMT_BACKUP_STRING_UTILS_H
\ No newline at end of file
@@ -15,7 +15,68 @@
 
 #include "b_encryption/b_encryption.h"
 
+#include <cstring>
+#include <openssl/sha.h>
+
 namespace OHOS::FileManagement::Backup::BEncryption {
+using namespace std;
+
+namespace {
+const string XXH64_NAME = "xxh64";
+const string SHA256_NAME = "sha256";
+constexpr char DIGEST_SEPARATOR = ':';
+constexpr size_t HEX_PER_BYTE = 2;
+constexpr size_t XXH64_STRIPE = 32;
+constexpr uint64_t XXH_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t XXH_PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t XXH_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t XXH_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t Rotl64(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t Read64(const uint8_t *p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t Read32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t Xxh64Round(uint64_t acc, uint64_t input)
+{
+    acc += input * XXH_PRIME64_2;
+    acc = Rotl64(acc, 31);
+    return acc * XXH_PRIME64_1;
+}
+
+inline uint64_t Xxh64MergeRound(uint64_t acc, uint64_t val)
+{
+    acc ^= Xxh64Round(0, val);
+    return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+string ToHex(const uint8_t *data, size_t len)
+{
+    static const char digits[] = "0123456789abcdef";
+    string hex(len * HEX_PER_BYTE, '0');
+    for (size_t i = 0; i < len; i++) {
+        hex[i * HEX_PER_BYTE] = digits[data[i] >> 4];
+        hex[i * HEX_PER_BYTE + 1] = digits[data[i] & 0xF];
+    }
+    return hex;
+}
+} // namespace
+
 unsigned int CalculateChksum(const char *byteBlock, int blockSize)
 {
     unsigned int chksum = 0U;
@@ -24,4 +85,141 @@ unsigned int CalculateChksum(const char *byteBlock, int blockSize)
     }
     return chksum;
 }
-} // namespace OHOS::FileManagement::Backup::BEncryption
\ No newline at end of file
+
+// XXH64的流式实现(种子为0), 与xxHash的XXH64结果一致
+struct ContentDigest::State {
+    uint64_t acc[4] = {XXH_PRIME64_1 + XXH_PRIME64_2, XXH_PRIME64_2, 0, 0 - XXH_PRIME64_1};
+    uint8_t stripe[XXH64_STRIPE] = {0};
+    size_t stripeLen = 0;
+    uint64_t totalLen = 0;
+    SHA256_CTX sha256 {};
+
+    void ConsumeStripe(const uint8_t *p)
+    {
+        for (size_t i = 0; i < 4; i++) {
+            acc[i] = Xxh64Round(acc[i], Read64(p + i * sizeof(uint64_t)));
+        }
+    }
+
+    void Xxh64Update(const uint8_t *p, size_t len)
+    {
+        totalLen += len;
+        if (stripeLen > 0) {
+            size_t fill = min(len, XXH64_STRIPE - stripeLen);
+            memcpy(stripe + stripeLen, p, fill);
+            stripeLen += fill;
+            p += fill;
+            len -= fill;
+            if (stripeLen < XXH64_STRIPE) {
+                return;
+            }
+            ConsumeStripe(stripe);
+            stripeLen = 0;
+        }
+        for (; len >= XXH64_STRIPE; p += XXH64_STRIPE, len -= XXH64_STRIPE) {
+            ConsumeStripe(p);
+        }
+        memcpy(stripe, p, len);
+        stripeLen = len;
+    }
+
+    uint64_t Xxh64Final() const
+    {
+        uint64_t h = 0;
+        if (totalLen >= XXH64_STRIPE) {
+            h = Rotl64(acc[0], 1) + Rotl64(acc[1], 7) + Rotl64(acc[2], 12) + Rotl64(acc[3], 18);
+            for (size_t i = 0; i < 4; i++) {
+                h = Xxh64MergeRound(h, acc[i]);
+            }
+        } else {
+            h = acc[2] + XXH_PRIME64_5;
+        }
+        h += totalLen;
+        const uint8_t *p = stripe;
+        size_t len = stripeLen;
+        for (; len >= sizeof(uint64_t); p += sizeof(uint64_t), len -= sizeof(uint64_t)) {
+            h ^= Xxh64Round(0, Read64(p));
+            h = Rotl64(h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+        }
+        if (len >= sizeof(uint32_t)) {
+            h ^= static_cast<uint64_t>(Read32(p)) * XXH_PRIME64_1;
+            h = Rotl64(h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+            p += sizeof(uint32_t);
+            len -= sizeof(uint32_t);
+        }
+        for (; len > 0; p++, len--) {
+            h ^= (*p) * XXH_PRIME64_5;
+            h = Rotl64(h, 11) * XXH_PRIME64_1;
+        }
+        h ^= h >> 33;
+        h *= XXH_PRIME64_2;
+        h ^= h >> 29;
+        h *= XXH_PRIME64_3;
+        h ^= h >> 32;
+        return h;
+    }
+};
+
+ContentDigest::ContentDigest(DigestAlgorithm algorithm) : algorithm_(algorithm), state_(make_unique<State>())
+{
+    if (algorithm_ == DigestAlgorithm::SHA256) {
+        SHA256_Init(&state_->sha256);
+    }
+}
+
+ContentDigest::~ContentDigest() = default;
+
+void ContentDigest::Update(const void *data, size_t len)
+{
+    if (data == nullptr || len == 0) {
+        return;
+    }
+    if (algorithm_ == DigestAlgorithm::XXH64) {
+        state_->Xxh64Update(static_cast<const uint8_t *>(data), len);
+    } else if (algorithm_ == DigestAlgorithm::SHA256) {
+        SHA256_Update(&state_->sha256, data, len);
+    }
+}
+
+string ContentDigest::Final()
+{
+    if (algorithm_ == DigestAlgorithm::XXH64) {
+        uint64_t h = state_->Xxh64Final();
+        uint8_t bytes[sizeof(h)];
+        // 按大端输出, 与xxHash的规范表示一致
+        for (size_t i = 0; i < sizeof(h); i++) {
+            bytes[i] = static_cast<uint8_t>(h >> ((sizeof(h) - 1 - i) * 8));
+        }
+        return XXH64_NAME + DIGEST_SEPARATOR + ToHex(bytes, sizeof(bytes));
+    }
+    if (algorithm_ == DigestAlgorithm::SHA256) {
+        uint8_t md[SHA256_DIGEST_LENGTH] = {0};
+        SHA256_Final(md, &state_->sha256);
+        return SHA256_NAME + DIGEST_SEPARATOR + ToHex(md, sizeof(md));
+    }
+    return "";
+}
+
+size_t ContentDigest::GetDigestLength(DigestAlgorithm algorithm)
+{
+    if (algorithm == DigestAlgorithm::XXH64) {
+        return XXH64_NAME.size() + 1 + sizeof(uint64_t) * HEX_PER_BYTE;
+    }
+    if (algorithm == DigestAlgorithm::SHA256) {
+        return SHA256_NAME.size() + 1 + SHA256_DIGEST_LENGTH * HEX_PER_BYTE;
+    }
+    return 0;
+}
+
+DigestAlgorithm ContentDigest::ParseAlgorithm(const string &digest)
+{
+    string name = digest.substr(0, digest.find(DIGEST_SEPARATOR));
+    if (name == XXH64_NAME) {
+        return DigestAlgorithm::XXH64;
+    }
+    if (name == SHA256_NAME) {
+        return DigestAlgorithm::SHA256;
+    }
+    return DigestAlgorithm::NONE;
+}
+} // namespace OHOS::FileManagement::Backup::BEncryption
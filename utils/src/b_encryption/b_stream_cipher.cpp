@@ -0,0 +1,771 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "b_encryption/b_stream_cipher.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cinttypes>
+#include <climits>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "filemgmt_libhilog.h"
+#include "unique_fd.h"
+
+namespace OHOS::FileManagement::Backup::BEncryption {
+using namespace std;
+
+namespace {
+const string STREAM_MAGIC = "OHBKSTRM";
+const string FILE_KEY_LABEL = "OHOS backup stream file key";
+constexpr char KEY_ID_SEPARATOR = ':';
+constexpr int HEX_LETTER_OFFSET = 10;
+constexpr int HEX_DIGIT_BITS = 4;
+constexpr uint32_t STREAM_VERSION = 1;
+constexpr size_t VERSION_OFFSET = 8;
+constexpr size_t CHUNK_SIZE_OFFSET = 12;
+constexpr size_t FILE_ID_OFFSET = 16;
+constexpr size_t FILE_ID_SIZE = 16;
+constexpr size_t KEY_ID_LEN_OFFSET = 32;
+constexpr size_t KEY_ID_OFFSET = 33;
+constexpr uint32_t MAX_CHUNK_SIZE = 16 * 1024 * 1024;
+constexpr size_t COPY_BUFF_SIZE = 1024 * 1024;
+constexpr uint64_t NO_CHUNK = UINT64_MAX;
+constexpr int BYTE_BITS = 8;
+
+mutex g_providerLock;
+shared_ptr<KeyProvider> g_provider;
+
+using CipherCtx = unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)>;
+
+struct Stream {
+    UniqueFd fd {-1};
+    bool writable = false;
+    bool broken = false;
+    string header;
+    vector<uint8_t> fileKey;
+    CipherCtx ctx {nullptr, EVP_CIPHER_CTX_free};
+    uint32_t chunkSize = 0;
+    uint64_t plainSize = 0;    // 明文总长度
+    uint64_t storedChunks = 0; // 已写入文件的分块数
+    uint64_t pos = 0;
+    uint64_t curChunk = NO_CHUNK;
+    bool dirty = false;
+    vector<uint8_t> plain; // curChunk的明文
+    vector<uint8_t> record;
+};
+
+void PutUint32(string &out, size_t offset, uint32_t value)
+{
+    for (size_t i = 0; i < sizeof(value); i++) {
+        out[offset + i] = static_cast<char>((value >> (i * BYTE_BITS)) & 0xff);
+    }
+}
+
+uint32_t GetUint32(const string &in, size_t offset)
+{
+    uint32_t value = 0;
+    for (size_t i = 0; i < sizeof(value); i++) {
+        value |= static_cast<uint32_t>(static_cast<uint8_t>(in[offset + i])) << (i * BYTE_BITS);
+    }
+    return value;
+}
+
+bool ValidKeyId(const string &keyId)
+{
+    if (keyId.empty() || keyId.size() > StreamCipher::MAX_KEY_ID_LEN) {
+        return false;
+    }
+    return all_of(keyId.begin(), keyId.end(), [](char ch) { return isalnum(static_cast<unsigned char>(ch)) ||
+        ch == '-' || ch == '_'; });
+}
+
+bool PreadAll(int fd, uint8_t *buf, size_t len, off_t offset)
+{
+    size_t done = 0;
+    while (done < len) {
+        ssize_t ret = pread(fd, buf + done, len - done, offset + static_cast<off_t>(done));
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            errno = ret == 0 ? EBADMSG : errno;
+            return false;
+        }
+        done += static_cast<size_t>(ret);
+    }
+    return true;
+}
+
+bool PwriteAll(int fd, const uint8_t *buf, size_t len, off_t offset)
+{
+    size_t done = 0;
+    while (done < len) {
+        ssize_t ret = pwrite(fd, buf + done, len - done, offset + static_cast<off_t>(done));
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(ret);
+    }
+    return true;
+}
+
+bool WriteAll(int fd, const uint8_t *buf, size_t len)
+{
+    size_t done = 0;
+    while (done < len) {
+        ssize_t ret = write(fd, buf + done, len - done);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(ret);
+    }
+    return true;
+}
+
+bool ReadAll(int fd, uint8_t *buf, size_t len)
+{
+    size_t done = 0;
+    while (done < len) {
+        ssize_t ret = read(fd, buf + done, len - done);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            errno = ret == 0 ? ENODATA : errno;
+            return false;
+        }
+        done += static_cast<size_t>(ret);
+    }
+    return true;
+}
+
+bool GcmCrypt(EVP_CIPHER_CTX *ctx, bool encrypt, const uint8_t *key, const uint8_t *nonce, const string &aad,
+    const uint8_t *in, size_t len, uint8_t *out, uint8_t *tag)
+{
+    if (ctx == nullptr || len > INT_MAX || aad.size() > INT_MAX) {
+        return false;
+    }
+    int outLen = 0;
+    if (EVP_CipherInit_ex(ctx, EVP_aes_256_gcm(), nullptr, key, nonce, encrypt ? 1 : 0) != 1 ||
+        EVP_CipherUpdate(ctx, nullptr, &outLen, reinterpret_cast<const uint8_t *>(aad.data()),
+            static_cast<int>(aad.size())) != 1) {
+        return false;
+    }
+    if (len > 0 && EVP_CipherUpdate(ctx, out, &outLen, in, static_cast<int>(len)) != 1) {
+        return false;
+    }
+    if (!encrypt && EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, StreamCipher::TAG_SIZE, tag) != 1) {
+        return false;
+    }
+    if (EVP_CipherFinal_ex(ctx, out + len, &outLen) != 1) {
+        return false;
+    }
+    return !encrypt || EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, StreamCipher::TAG_SIZE, tag) == 1;
+}
+
+bool DeriveFileKey(const vector<uint8_t> &key, const string &header, vector<uint8_t> &fileKey)
+{
+    string info = FILE_KEY_LABEL + header.substr(FILE_ID_OFFSET, FILE_ID_SIZE);
+    fileKey.resize(StreamCipher::KEY_SIZE);
+    unsigned int outLen = 0;
+    return HMAC(EVP_sha256(), key.data(), static_cast<int>(key.size()), reinterpret_cast<const uint8_t *>(info.data()),
+        info.size(), fileKey.data(), &outLen) != nullptr && outLen == StreamCipher::KEY_SIZE;
+}
+
+uint64_t RecordSize(const Stream &s)
+{
+    return StreamCipher::NONCE_SIZE + s.chunkSize + StreamCipher::TAG_SIZE;
+}
+
+off_t RecordOffset(const Stream &s, uint64_t index)
+{
+    return static_cast<off_t>(StreamCipher::HEADER_SIZE + index * RecordSize(s));
+}
+
+size_t ChunkLen(const Stream &s, uint64_t index)
+{
+    uint64_t begin = index * s.chunkSize;
+    return s.plainSize > begin ? static_cast<size_t>(min<uint64_t>(s.chunkSize, s.plainSize - begin)) : 0;
+}
+
+uint64_t LastChunk(const Stream &s)
+{
+    return s.plainSize == 0 ? 0 : (s.plainSize - 1) / s.chunkSize;
+}
+
+string ChunkAad(const Stream &s, uint64_t index, bool isFinal)
+{
+    string aad = s.header;
+    for (size_t i = 0; i < sizeof(index); i++) {
+        aad.push_back(static_cast<char>((index >> (i * BYTE_BITS)) & 0xff));
+    }
+    aad.push_back(isFinal ? 1 : 0);
+    return aad;
+}
+
+bool SealRecord(Stream &s, uint64_t index, const uint8_t *data, size_t len, bool isFinal)
+{
+    s.record.resize(StreamCipher::NONCE_SIZE + len + StreamCipher::TAG_SIZE);
+    uint8_t *nonce = s.record.data();
+    if (RAND_bytes(nonce, StreamCipher::NONCE_SIZE) != 1 ||
+        !GcmCrypt(s.ctx.get(), true, s.fileKey.data(), nonce, ChunkAad(s, index, isFinal), data, len,
+            nonce + StreamCipher::NONCE_SIZE, nonce + StreamCipher::NONCE_SIZE + len)) {
+        HILOGE("Failed to seal chunk %{public}" PRIu64, index);
+        errno = EIO;
+        return false;
+    }
+    return true;
+}
+
+bool SealData(Stream &s, uint64_t index, const uint8_t *data, size_t len, bool isFinal)
+{
+    if (!SealRecord(s, index, data, len, isFinal)) {
+        return false;
+    }
+    if (!PwriteAll(s.fd, s.record.data(), s.record.size(), RecordOffset(s, index))) {
+        HILOGE("Failed to write chunk %{public}" PRIu64 ", err = %{public}d", index, errno);
+        return false;
+    }
+    s.storedChunks = max(s.storedChunks, index + 1);
+    return true;
+}
+
+bool OpenData(Stream &s, uint64_t index, uint8_t *data, size_t len)
+{
+    // 写入时已落盘的分块都不是最后一块, 读取时文件中的最后一个分块是最后一块
+    bool isFinal = !s.writable && index + 1 == s.storedChunks;
+    s.record.resize(StreamCipher::NONCE_SIZE + len + StreamCipher::TAG_SIZE);
+    uint8_t *nonce = s.record.data();
+    if (!PreadAll(s.fd, nonce, s.record.size(), RecordOffset(s, index))) {
+        HILOGE("Failed to read chunk %{public}" PRIu64 ", err = %{public}d", index, errno);
+        return false;
+    }
+    if (!GcmCrypt(s.ctx.get(), false, s.fileKey.data(), nonce, ChunkAad(s, index, isFinal),
+        nonce + StreamCipher::NONCE_SIZE, len, data, nonce + StreamCipher::NONCE_SIZE + len)) {
+        HILOGE("Failed to authenticate chunk %{public}" PRIu64, index);
+        errno = EBADMSG;
+        return false;
+    }
+    return true;
+}
+
+bool SealChunk(Stream &s, bool isFinal)
+{
+    if (!SealData(s, s.curChunk, s.plain.data(), s.plain.size(), isFinal)) {
+        return false;
+    }
+    s.dirty = false;
+    return true;
+}
+
+bool FlushChunk(Stream &s)
+{
+    return !s.dirty || SealChunk(s, false);
+}
+
+bool LoadChunk(Stream &s, uint64_t index)
+{
+    if (index == s.curChunk) {
+        return true;
+    }
+    if (!FlushChunk(s)) {
+        return false;
+    }
+    s.curChunk = NO_CHUNK;
+    size_t len = ChunkLen(s, index);
+    s.plain.resize(len);
+    if (index < s.storedChunks && !OpenData(s, index, s.plain.data(), len)) {
+        return false;
+    }
+    s.curChunk = index;
+    return true;
+}
+
+ssize_t StreamRead(void *cookie, char *buf, size_t size)
+{
+    auto &s = *static_cast<Stream *>(cookie);
+    size_t done = 0;
+    while (done < size && s.pos < s.plainSize) {
+        uint64_t index = s.pos / s.chunkSize;
+        size_t chunkLen = ChunkLen(s, index);
+        if (!s.broken && s.pos % s.chunkSize == 0 && size - done >= chunkLen && index != s.curChunk) {
+            // 整块读取时直接解密到调用方的缓冲区
+            s.broken = !OpenData(s, index, reinterpret_cast<uint8_t *>(buf + done), chunkLen);
+            if (!s.broken) {
+                s.pos += chunkLen;
+                done += chunkLen;
+                continue;
+            }
+        }
+        if (s.broken || !LoadChunk(s, index)) {
+            s.broken = true;
+            errno = EBADMSG;
+            return done > 0 ? static_cast<ssize_t>(done) : -1;
+        }
+        size_t offset = static_cast<size_t>(s.pos % s.chunkSize);
+        size_t len = min(size - done, s.plain.size() - offset);
+        memcpy(buf + done, s.plain.data() + offset, len);
+        s.pos += len;
+        done += len;
+    }
+    return static_cast<ssize_t>(done);
+}
+
+ssize_t StreamWrite(void *cookie, const char *buf, size_t size)
+{
+    auto &s = *static_cast<Stream *>(cookie);
+    size_t done = 0;
+    while (done < size) {
+        uint64_t index = s.pos / s.chunkSize;
+        if (!s.broken && s.pos % s.chunkSize == 0 && size - done >= s.chunkSize && index >= s.storedChunks) {
+            // 整块写入新分块时直接加密调用方的数据, 省去一次拷贝
+            if (index == s.curChunk) {
+                s.curChunk = NO_CHUNK;
+                s.dirty = false;
+            }
+            s.broken = !FlushChunk(s) ||
+                !SealData(s, index, reinterpret_cast<const uint8_t *>(buf + done), s.chunkSize, false);
+            if (!s.broken) {
+                s.pos += s.chunkSize;
+                s.plainSize = max(s.plainSize, s.pos);
+                done += s.chunkSize;
+                continue;
+            }
+        }
+        if (s.broken || !LoadChunk(s, index)) {
+            s.broken = true;
+            errno = errno == 0 ? EIO : errno;
+            return done > 0 ? static_cast<ssize_t>(done) : -1;
+        }
+        size_t offset = static_cast<size_t>(s.pos % s.chunkSize);
+        size_t len = min<size_t>(size - done, s.chunkSize - offset);
+        if (s.plain.size() < offset + len) {
+            s.plain.resize(offset + len);
+        }
+        memcpy(s.plain.data() + offset, buf + done, len);
+        s.dirty = true;
+        s.pos += len;
+        s.plainSize = max(s.plainSize, s.pos);
+        done += len;
+    }
+    return static_cast<ssize_t>(done);
+}
+
+int StreamSeek(void *cookie, off_t *offset, int whence)
+{
+    auto &s = *static_cast<Stream *>(cookie);
+    int64_t base = 0;
+    if (whence == SEEK_CUR) {
+        base = static_cast<int64_t>(s.pos);
+    } else if (whence == SEEK_END) {
+        base = static_cast<int64_t>(s.plainSize);
+    } else if (whence != SEEK_SET) {
+        errno = EINVAL;
+        return -1;
+    }
+    int64_t pos = base + static_cast<int64_t>(*offset);
+    // 写入时不支持在文件末尾之后留下空洞
+    if (pos < 0 || (s.writable && static_cast<uint64_t>(pos) > s.plainSize)) {
+        errno = EINVAL;
+        return -1;
+    }
+    s.pos = static_cast<uint64_t>(pos);
+    *offset = static_cast<off_t>(pos);
+    return 0;
+}
+
+int StreamClose(void *cookie)
+{
+    unique_ptr<Stream> s(static_cast<Stream *>(cookie));
+    if (!s->writable) {
+        return 0;
+    }
+    // 以最后一块的标记重新加密最后一个分块, 之后的截断都能在解密时发现
+    if (s->broken || !LoadChunk(*s, LastChunk(*s)) || !SealChunk(*s, true)) {
+        HILOGE("Failed to finish encrypted stream, err = %{public}d", errno);
+        errno = errno == 0 ? EIO : errno;
+        return -1;
+    }
+    return 0;
+}
+
+bool InitWriter(Stream &s, const StreamKey &key, uint32_t chunkSize)
+{
+    if (key.key.size() != StreamCipher::KEY_SIZE || !ValidKeyId(key.keyId) || chunkSize == 0 ||
+        chunkSize > MAX_CHUNK_SIZE) {
+        errno = EINVAL;
+        return false;
+    }
+    string &header = s.header;
+    header.assign(StreamCipher::HEADER_SIZE, '\0');
+    header.replace(0, STREAM_MAGIC.size(), STREAM_MAGIC);
+    PutUint32(header, VERSION_OFFSET, STREAM_VERSION);
+    PutUint32(header, CHUNK_SIZE_OFFSET, chunkSize);
+    if (RAND_bytes(reinterpret_cast<uint8_t *>(&header[FILE_ID_OFFSET]), FILE_ID_SIZE) != 1) {
+        errno = EIO;
+        return false;
+    }
+    header[KEY_ID_LEN_OFFSET] = static_cast<char>(key.keyId.size());
+    header.replace(KEY_ID_OFFSET, key.keyId.size(), key.keyId);
+    if (!DeriveFileKey(key.key, header, s.fileKey)) {
+        errno = EIO;
+        return false;
+    }
+    s.writable = true;
+    s.chunkSize = chunkSize;
+    return true;
+}
+
+int HexValue(char ch)
+{
+    if (ch >= '0' && ch <= '9') {
+        return ch - '0';
+    }
+    if (ch >= 'a' && ch <= 'f') {
+        return ch - 'a' + HEX_LETTER_OFFSET;
+    }
+    if (ch >= 'A' && ch <= 'F') {
+        return ch - 'A' + HEX_LETTER_OFFSET;
+    }
+    return -1;
+}
+
+FILE *OpenCookie(unique_ptr<Stream> stream, const char *mode)
+{
+    if (stream->ctx == nullptr) {
+        stream->ctx.reset(EVP_CIPHER_CTX_new());
+    }
+    if (stream->ctx == nullptr) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+    cookie_io_functions_t funcs = {
+        .read = StreamRead,
+        .write = StreamWrite,
+        .seek = StreamSeek,
+        .close = StreamClose,
+    };
+    FILE *fp = fopencookie(stream.get(), mode, funcs);
+    if (fp == nullptr) {
+        HILOGE("Failed to open encrypted stream, err = %{public}d", errno);
+        return nullptr;
+    }
+    // 缓冲区与分块等长, 顺序读写时每次都是整块
+    setvbuf(fp, nullptr, _IOFBF, stream->chunkSize);
+    stream.release();
+    return fp;
+}
+} // namespace
+
+CallerKeyProvider::CallerKeyProvider(shared_ptr<const StreamKey> key) : key_(move(key)) {}
+
+shared_ptr<const StreamKey> CallerKeyProvider::GetCurrentKey()
+{
+    return key_;
+}
+
+shared_ptr<const StreamKey> CallerKeyProvider::GetKey(const string &keyId)
+{
+    return key_ != nullptr && key_->keyId == keyId ? key_ : nullptr;
+}
+
+bool CallerKeyProvider::IsExportable() const
+{
+    return true;
+}
+
+shared_ptr<const StreamKey> ParseStreamKey(const string &text)
+{
+    size_t pos = text.find(KEY_ID_SEPARATOR);
+    if (pos == string::npos || text.size() - pos - 1 != StreamCipher::KEY_SIZE * 2) {
+        HILOGE("Invalid stream key format");
+        return nullptr;
+    }
+    auto key = make_shared<StreamKey>();
+    key->keyId = text.substr(0, pos);
+    if (!ValidKeyId(key->keyId)) {
+        HILOGE("Invalid key id");
+        return nullptr;
+    }
+    key->key.resize(StreamCipher::KEY_SIZE);
+    for (size_t i = 0; i < StreamCipher::KEY_SIZE; i++) {
+        int high = HexValue(text[pos + 1 + i * 2]);
+        int low = HexValue(text[pos + 2 + i * 2]);
+        if (high < 0 || low < 0) {
+            HILOGE("Invalid stream key format");
+            return nullptr;
+        }
+        key->key[i] = static_cast<uint8_t>((high << HEX_DIGIT_BITS) | low);
+    }
+    return key;
+}
+
+void SetKeyProvider(shared_ptr<KeyProvider> provider)
+{
+    lock_guard<mutex> lock(g_providerLock);
+    g_provider = move(provider);
+}
+
+shared_ptr<KeyProvider> GetKeyProvider()
+{
+    lock_guard<mutex> lock(g_providerLock);
+    return g_provider;
+}
+
+shared_ptr<const StreamKey> GetCurrentKey()
+{
+    auto provider = GetKeyProvider();
+    if (provider == nullptr) {
+        return nullptr;
+    }
+    // 恢复端拿不到的密钥加密的产物无法恢复, 宁可不加密
+    if (!provider->IsExportable()) {
+        HILOGW("Key provider is not exportable, backup artifacts will not be encrypted");
+        return nullptr;
+    }
+    return provider->GetCurrentKey();
+}
+
+FILE *StreamCipher::OpenWriter(int fd, const StreamKey &key, uint32_t chunkSize)
+{
+    auto stream = make_unique<Stream>();
+    stream->fd = UniqueFd(fd);
+    if (fd < 0) {
+        errno = EINVAL;
+        return nullptr;
+    }
+    if (!InitWriter(*stream, key, chunkSize)) {
+        return nullptr;
+    }
+    const string &header = stream->header;
+    if (!PwriteAll(fd, reinterpret_cast<const uint8_t *>(header.data()), header.size(), 0)) {
+        HILOGE("Failed to write stream header, err = %{public}d", errno);
+        return nullptr;
+    }
+    return OpenCookie(move(stream), "w");
+}
+
+FILE *StreamCipher::OpenReader(int fd, KeyProvider &provider)
+{
+    auto stream = make_unique<Stream>();
+    stream->fd = UniqueFd(fd);
+    string &header = stream->header;
+    header.assign(HEADER_SIZE, '\0');
+    if (fd < 0 || !PreadAll(fd, reinterpret_cast<uint8_t *>(header.data()), header.size(), 0)) {
+        return nullptr;
+    }
+    uint32_t chunkSize = GetUint32(header, CHUNK_SIZE_OFFSET);
+    size_t keyIdLen = static_cast<uint8_t>(header[KEY_ID_LEN_OFFSET]);
+    if (header.compare(0, STREAM_MAGIC.size(), STREAM_MAGIC) != 0 ||
+        GetUint32(header, VERSION_OFFSET) != STREAM_VERSION || chunkSize == 0 || chunkSize > MAX_CHUNK_SIZE ||
+        keyIdLen > MAX_KEY_ID_LEN) {
+        HILOGE("Unsupported stream header");
+        errno = EBADMSG;
+        return nullptr;
+    }
+    string keyId = header.substr(KEY_ID_OFFSET, keyIdLen);
+    auto key = provider.GetKey(keyId);
+    if (key == nullptr || key->key.size() != KEY_SIZE) {
+        HILOGE("No key to decrypt stream, key id:%{public}s", keyId.c_str());
+        errno = ENOKEY;
+        return nullptr;
+    }
+    struct stat sta = {};
+    if (!DeriveFileKey(key->key, header, stream->fileKey) || fstat(fd, &sta) != 0) {
+        errno = errno == 0 ? EIO : errno;
+        return nullptr;
+    }
+    stream->chunkSize = chunkSize;
+    uint64_t dataSize =
+        sta.st_size > static_cast<off_t>(HEADER_SIZE) ? static_cast<uint64_t>(sta.st_size) - HEADER_SIZE : 0;
+    uint64_t recordSize = RecordSize(*stream);
+    uint64_t chunks = (dataSize + recordSize - 1) / recordSize;
+    uint64_t lastRecord = chunks == 0 ? 0 : dataSize - (chunks - 1) * recordSize;
+    if (chunks == 0 || lastRecord < NONCE_SIZE + TAG_SIZE) {
+        HILOGE("Encrypted stream is truncated");
+        errno = EBADMSG;
+        return nullptr;
+    }
+    stream->storedChunks = chunks;
+    stream->plainSize = (chunks - 1) * chunkSize + lastRecord - NONCE_SIZE - TAG_SIZE;
+    stream->ctx.reset(EVP_CIPHER_CTX_new());
+    if (!LoadChunk(*stream, chunks - 1)) {
+        errno = EBADMSG;
+        return nullptr;
+    }
+    return OpenCookie(move(stream), "r");
+}
+
+bool StreamCipher::IsEncrypted(int fd)
+{
+    string magic(STREAM_MAGIC.size(), '\0');
+    return fd >= 0 && PreadAll(fd, reinterpret_cast<uint8_t *>(magic.data()), magic.size(), 0) && magic == STREAM_MAGIC;
+}
+
+bool StreamCipher::EncryptFile(int srcFd, int dstFd, const StreamKey &key)
+{
+    FILE *dst = OpenWriter(dup(dstFd), key);
+    if (dst == nullptr) {
+        return false;
+    }
+    vector<uint8_t> buf(COPY_BUFF_SIZE);
+    bool ok = true;
+    while (ok) {
+        ssize_t ret = read(srcFd, buf.data(), buf.size());
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            ok = ret == 0;
+            break;
+        }
+        ok = fwrite(buf.data(), 1, static_cast<size_t>(ret), dst) == static_cast<size_t>(ret);
+    }
+    int err = errno;
+    if (fclose(dst) != 0 || !ok) {
+        HILOGE("Failed to encrypt file, err = %{public}d", ok ? errno : err);
+        return false;
+    }
+    return true;
+}
+
+bool StreamCipher::EncryptStream(int srcFd, int dstFd, const StreamKey &key, uint64_t size)
+{
+    Stream s;
+    s.ctx.reset(EVP_CIPHER_CTX_new());
+    if (s.ctx == nullptr || !InitWriter(s, key, DEFAULT_CHUNK_SIZE) ||
+        !WriteAll(dstFd, reinterpret_cast<const uint8_t *>(s.header.data()), s.header.size())) {
+        HILOGE("Failed to start encrypted stream, err = %{public}d", errno);
+        return false;
+    }
+    s.plainSize = size;
+    s.plain.resize(s.chunkSize);
+    uint64_t lastChunk = LastChunk(s);
+    for (uint64_t index = 0; index <= lastChunk; index++) {
+        size_t len = ChunkLen(s, index);
+        if (!ReadAll(srcFd, s.plain.data(), len) || !SealRecord(s, index, s.plain.data(), len, index == lastChunk) ||
+            !WriteAll(dstFd, s.record.data(), s.record.size())) {
+            HILOGE("Failed to encrypt stream at chunk %{public}" PRIu64 ", err = %{public}d", index, errno);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool StreamCipher::DecryptFile(int srcFd, int dstFd, KeyProvider &provider)
+{
+    FILE *src = OpenReader(dup(srcFd), provider);
+    if (src == nullptr) {
+        return false;
+    }
+    vector<uint8_t> buf(COPY_BUFF_SIZE);
+    bool ok = true;
+    size_t len = 0;
+    while (ok && (len = fread(buf.data(), 1, buf.size(), src)) > 0) {
+        ok = WriteAll(dstFd, buf.data(), len);
+    }
+    ok = ok && ferror(src) == 0;
+    int err = errno;
+    fclose(src);
+    if (!ok) {
+        HILOGE("Failed to decrypt file, err = %{public}d", err);
+        errno = err;
+    }
+    return ok;
+}
+
+bool StreamCipher::Seal(const uint8_t *key, const uint8_t *nonce, const string &aad, const uint8_t *in, size_t len,
+    uint8_t *out, uint8_t *tag)
+{
+    CipherCtx ctx(EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+    return GcmCrypt(ctx.get(), true, key, nonce, aad, in, len, out, tag);
+}
+
+bool StreamCipher::Open(const uint8_t *key, const uint8_t *nonce, const string &aad, const uint8_t *in, size_t len,
+    uint8_t *out, const uint8_t *tag)
+{
+    CipherCtx ctx(EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+    return GcmCrypt(ctx.get(), false, key, nonce, aad, in, len, out, const_cast<uint8_t *>(tag));
+}
+
+PipeEncryptor::~PipeEncryptor()
+{
+    Wait();
+}
+
+int PipeEncryptor::Start(int srcFd, shared_ptr<const StreamKey> key)
+{
+    UniqueFd src(srcFd);
+    struct stat sta = {};
+    int fds[2] = {-1, -1};
+    if (src < 0 || key == nullptr || fstat(src, &sta) != 0 || lseek(src, 0, SEEK_SET) != 0 ||
+        pipe2(fds, O_CLOEXEC) != 0) {
+        HILOGE("Failed to start pipe encryption, err = %{public}d", errno);
+        return -1;
+    }
+    UniqueFd readEnd(fds[0]);
+    auto writeEnd = make_shared<UniqueFd>(fds[1]);
+    auto plainFd = make_shared<UniqueFd>(src.Release());
+    uint64_t size = static_cast<uint64_t>(sta.st_size);
+    try {
+        lock_guard<mutex> lock(lock_);
+        workers_.emplace_back([this, plainFd, writeEnd, key, size]() {
+            // 读端关闭后write返回EPIPE结束加密, 屏蔽本线程的SIGPIPE, 避免进程被终止
+            sigset_t set;
+            sigemptyset(&set);
+            sigaddset(&set, SIGPIPE);
+            pthread_sigmask(SIG_BLOCK, &set, nullptr);
+            if (!StreamCipher::EncryptStream(*plainFd, *writeEnd, *key, size)) {
+                failed_ = true;
+            }
+            writeEnd->Reset();
+            plainFd->Reset();
+        });
+    } catch (const exception &e) {
+        HILOGE("Failed to start encrypt thread, %{public}s", e.what());
+        return -1;
+    }
+    return readEnd.Release();
+}
+
+bool PipeEncryptor::Wait()
+{
+    vector<thread> workers;
+    {
+        lock_guard<mutex> lock(lock_);
+        workers.swap(workers_);
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    return !failed_.exchange(false);
+}
+} // namespace OHOS::FileManagement::Backup::BEncryption
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "b_filesystem/b_backup_checkpoint.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "b_anony/b_anony.h"
+#include "filemgmt_libhilog.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+
+namespace {
+constexpr uint32_t CHECKPOINT_MAGIC = 0x504b4342; // "BCKP"
+constexpr uint32_t CHECKPOINT_VERSION = 1;
+constexpr uint32_t FNV_OFFSET_BASIS = 2166136261U;
+constexpr uint32_t FNV_PRIME = 16777619U;
+constexpr size_t RECORD_HEADER_SIZE = sizeof(uint32_t) * 2;
+constexpr uint32_t MAX_RECORD_SIZE = 64 * 1024;
+
+template <typename T>
+void PutInt(string &out, T value)
+{
+    out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T>
+bool GetInt(const string &data, size_t &pos, T &value)
+{
+    if (data.size() - pos < sizeof(value)) {
+        return false;
+    }
+    memcpy(&value, data.data() + pos, sizeof(value));
+    pos += sizeof(value);
+    return true;
+}
+
+uint32_t Checksum(const char *data, size_t len)
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+bool WriteAll(int fd, const string &data)
+{
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t ret = write(fd, data.data() + written, data.size() - written);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            return false;
+        }
+        written += static_cast<size_t>(ret);
+    }
+    return true;
+}
+} // namespace
+
+BBackupCheckpoint::BBackupCheckpoint(const string &path) : path_(path) {}
+
+bool BBackupCheckpoint::Open(const string &token)
+{
+    lock_guard<mutex> lock(lock_);
+    fd_.Reset();
+    committed_.clear();
+    if (token.size() > UINT16_MAX) {
+        HILOGE("Checkpoint token too long");
+        return false;
+    }
+    if (LoadLocked(token)) {
+        HILOGI("Resume from checkpoint, committed:%{public}zu", committed_.size());
+        return true;
+    }
+    committed_.clear();
+    return ResetLocked(token);
+}
+
+bool BBackupCheckpoint::LoadLocked(const string &token)
+{
+    ifstream file(path_, ios::in | ios::binary);
+    if (!file) {
+        return false;
+    }
+    string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    size_t pos = 0;
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint16_t tokenLen = 0;
+    if (!GetInt(data, pos, magic) || magic != CHECKPOINT_MAGIC || !GetInt(data, pos, version) ||
+        version != CHECKPOINT_VERSION || !GetInt(data, pos, tokenLen) || data.size() - pos < tokenLen ||
+        data.compare(pos, tokenLen, token) != 0) {
+        HILOGI("No checkpoint of current session, path:%{public}s", GetAnonyPath(path_).c_str());
+        return false;
+    }
+    pos += tokenLen;
+    while (data.size() - pos >= RECORD_HEADER_SIZE) {
+        size_t recordPos = pos;
+        uint32_t len = 0;
+        uint32_t sum = 0;
+        uint16_t nameLen = 0;
+        GetInt(data, pos, len);
+        GetInt(data, pos, sum);
+        if (len < sizeof(nameLen) || len > MAX_RECORD_SIZE || data.size() - pos < len ||
+            Checksum(data.data() + pos, len) != sum || !GetInt(data, pos, nameLen) ||
+            nameLen > len - sizeof(nameLen)) {
+            // 进程在写入过程中退出留下的不完整记录, 之后的内容一并丢弃
+            pos = recordPos;
+            break;
+        }
+        string name = data.substr(pos, nameLen);
+        committed_[name] = data.substr(pos + nameLen, len - sizeof(nameLen) - nameLen);
+        pos = recordPos + RECORD_HEADER_SIZE + len;
+    }
+    fd_ = UniqueFd(open(path_.c_str(), O_WRONLY | O_CLOEXEC));
+    if (fd_ < 0 || ftruncate(fd_, static_cast<off_t>(pos)) != 0 ||
+        lseek(fd_, static_cast<off_t>(pos), SEEK_SET) < 0) {
+        HILOGE("Failed to reopen checkpoint, errno = %{public}d", errno);
+        fd_.Reset();
+        return false;
+    }
+    size_ = pos;
+    return true;
+}
+
+bool BBackupCheckpoint::ResetLocked(const string &token)
+{
+    fd_ = UniqueFd(open(path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR));
+    if (fd_ < 0) {
+        HILOGE("Failed to create checkpoint, errno = %{public}d", errno);
+        return false;
+    }
+    string header;
+    PutInt(header, CHECKPOINT_MAGIC);
+    PutInt(header, CHECKPOINT_VERSION);
+    PutInt(header, static_cast<uint16_t>(token.size()));
+    header.append(token);
+    if (!WriteAll(fd_, header) || fdatasync(fd_) != 0) {
+        HILOGE("Failed to write checkpoint header, errno = %{public}d", errno);
+        fd_.Reset();
+        return false;
+    }
+    size_ = header.size();
+    return true;
+}
+
+bool BBackupCheckpoint::Commit(const string &name, const string &fingerprint)
+{
+    string payload;
+    PutInt(payload, static_cast<uint16_t>(name.size()));
+    payload.append(name).append(fingerprint);
+    if (name.size() > UINT16_MAX || payload.size() > MAX_RECORD_SIZE) {
+        HILOGE("Checkpoint record too long");
+        return false;
+    }
+    string record;
+    PutInt(record, static_cast<uint32_t>(payload.size()));
+    PutInt(record, Checksum(payload.data(), payload.size()));
+    record.append(payload);
+
+    lock_guard<mutex> lock(lock_);
+    if (fd_ < 0) {
+        return false;
+    }
+    if (!WriteAll(fd_, record) || fdatasync(fd_) != 0) {
+        HILOGE("Failed to commit checkpoint, errno = %{public}d", errno);
+        // 去掉写了一半的记录, 否则之后追加的记录在加载时都会被丢弃
+        if (ftruncate(fd_, static_cast<off_t>(size_)) != 0 || lseek(fd_, static_cast<off_t>(size_), SEEK_SET) < 0) {
+            fd_.Reset();
+        }
+        return false;
+    }
+    size_ += record.size();
+    committed_[name] = fingerprint;
+    return true;
+}
+
+bool BBackupCheckpoint::IsCommitted(const string &name, const string &fingerprint) const
+{
+    lock_guard<mutex> lock(lock_);
+    auto it = committed_.find(name);
+    return it != committed_.end() && it->second == fingerprint;
+}
+
+size_t BBackupCheckpoint::GetCommittedCount() const
+{
+    lock_guard<mutex> lock(lock_);
+    return committed_.size();
+}
+
+void BBackupCheckpoint::Remove()
+{
+    lock_guard<mutex> lock(lock_);
+    fd_.Reset();
+    committed_.clear();
+    if (unlink(path_.c_str()) != 0 && errno != ENOENT) {
+        HILOGE("Failed to remove checkpoint, errno = %{public}d", errno);
+    }
+}
+} // namespace OHOS::FileManagement::Backup
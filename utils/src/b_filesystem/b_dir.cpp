@@ -141,6 +141,35 @@ static bool IsEmptyDirectory(const string &path)
     return isEmpty;
 }
 
+/**
+ * @brief 读取目录下的条目(不含.和..), 有快照且目录元数据未变化时直接复用快照中的结果
+ */
+static bool ListDirEntries(const string &path, const AdvancedScanOption &option,
+    vector<BScanSnapshot::DirEntry> &entries)
+{
+    struct stat sta = {};
+    bool useSnapshot = option.snapshot != nullptr && stat(path.c_str(), &sta) == 0;
+    if (useSnapshot && option.snapshot->LookupDir(path, sta, entries)) {
+        return true;
+    }
+    unique_ptr<DIR, function<void(DIR *)>> dir = {opendir(path.c_str()), closedir};
+    if (dir == nullptr) {
+        HILOGE("openDir fail, path:%{public}s, errno:%{public}d", GetAnonyPath(path).c_str(), errno);
+        return false;
+    }
+    struct dirent *ptr = nullptr;
+    while (!!(ptr = readdir(dir.get()))) {
+        if ((strcmp(ptr->d_name, ".") == 0) || (strcmp(ptr->d_name, "..") == 0)) {
+            continue;
+        }
+        entries.push_back({ptr->d_name, ptr->d_type});
+    }
+    if (useSnapshot) {
+        option.snapshot->RecordDir(path, sta, entries);
+    }
+    return true;
+}
+
 static void ProcessFile(const ProcessInfo &info, int64_t &bigFileSize, int64_t &smallFileSize,
     const std::vector<std::string> &excludes, const AdvancedScanOption &option = {})
 {
@@ -166,19 +195,21 @@ static void ProcessFile(const ProcessInfo &info, int64_t &bigFileSize, int64_t &
     }
     if (option.resultManager != nullptr) {
         if (sta.st_size <= info.sizeBoundary_) {
-            option.resultManager->AddSmallFile(info.backupPath_, sta.st_size, info.restorePath_);
+            option.resultManager->AddSmallFile(info.backupPath_, sta.st_size, info.restorePath_, info.dirDepth_);
             smallFileSize += sta.st_size;
         } else {
-            option.resultManager->AddBigFile(info.backupPath_, sta, isLongPath, info.restorePath_);
+            option.resultManager->AddBigFile(info.backupPath_, sta, isLongPath, info.restorePath_, info.dirDepth_);
             bigFileSize += sta.st_size;
         }
         return;
     }
     if (sta.st_size <= info.sizeBoundary_) {
-        ScanFileSingleton::GetInstance().AddSmallFile(info.backupPath_, sta.st_size, info.restorePath_);
+        ScanFileSingleton::GetInstance().AddSmallFile(info.backupPath_, sta.st_size, info.restorePath_,
+            info.dirDepth_);
         smallFileSize += sta.st_size;
     } else {
-        ScanFileSingleton::GetInstance().AddBigFile(info.backupPath_, sta, isLongPath, info.restorePath_);
+        ScanFileSingleton::GetInstance().AddBigFile(info.backupPath_, sta, isLongPath, info.restorePath_,
+            info.dirDepth_);
         bigFileSize += sta.st_size;
     }
 }
@@ -191,7 +222,8 @@ static tuple<ErrCode, int64_t, int64_t> ProcessSingleFile(const vector<string> &
     }
     int64_t bigFileSize = 0;
     int64_t smallFileSize = 0;
-    ProcessFile({backupPath, restorePath, sizeBoundary}, bigFileSize, smallFileSize, excludes, option);
+    ProcessFile({backupPath, restorePath, sizeBoundary, StringUtils::GetPathDepth(backupPath)}, bigFileSize,
+        smallFileSize, excludes, option);
     return {ERR_OK, bigFileSize, smallFileSize};
 }
 
@@ -205,33 +237,29 @@ tuple<ErrCode, int64_t, int64_t> DirScanner::ScanDir(const string &backupPath, c
     }
     int64_t bigFileSize = 0;
     int64_t smallFileSize = 0;
-    stack<string> dirStack;
-    dirStack.push(backupPath);
+    // 栈中同时记录目录下条目的路径深度, 子目录在父目录基础上加一, 无需逐个文件解析路径
+    stack<pair<string, uint32_t>> dirStack;
+    dirStack.push({backupPath, StringUtils::GetPathDepth(StringUtils::PathAddDelimiter(backupPath))});
     while (!dirStack.empty()) {
-        auto currentPath = dirStack.top();
+        auto [currentPath, depth] = dirStack.top();
         dirStack.pop();
         if (BDir::IsDirsMatch(excludes, currentPath)) {
             continue;
         }
-        if (IsEmptyDirectory(currentPath)) {
-            ScanFileSingleton::GetInstance().AddSmallFile(StringUtils::PathAddDelimiter(currentPath), 0);
+        vector<BScanSnapshot::DirEntry> entries;
+        if (!ListDirEntries(currentPath, scanOption_, entries)) {
             continue;
         }
-        unique_ptr<DIR, function<void(DIR *)>> dir = {opendir(currentPath.c_str()), closedir};
-        if (dir == nullptr) {
-            HILOGE("openDir fail, path:%{public}s, errno:%{public}d", GetAnonyPath(currentPath).c_str(), errno);
+        if (entries.empty()) {
+            ScanFileSingleton::GetInstance().AddSmallFile(StringUtils::PathAddDelimiter(currentPath), 0, "", depth);
             continue;
         }
-        struct dirent *ptr = nullptr;
-        while (!!(ptr = readdir(dir.get()))) {
-            if ((strcmp(ptr->d_name, ".") == 0) || (strcmp(ptr->d_name, "..") == 0)) {
-                continue;
-            }
-            std::string filePath = StringUtils::PathAddDelimiter(currentPath) + string(ptr->d_name);
-            if (ptr->d_type == DT_REG) {
-                ProcessFile({filePath, "", size}, bigFileSize, smallFileSize, excludes, scanOption_);
-            } else if (ptr->d_type == DT_DIR) {
-                dirStack.push(filePath);
+        for (const auto &entry : entries) {
+            std::string filePath = StringUtils::PathAddDelimiter(currentPath) + entry.name;
+            if (entry.type == DT_REG) {
+                ProcessFile({filePath, "", size, depth}, bigFileSize, smallFileSize, excludes, scanOption_);
+            } else if (entry.type == DT_DIR) {
+                dirStack.push({filePath, depth + 1});
             } else {
                 HILOGE("Not support file type");
             }
@@ -252,35 +280,31 @@ tuple<ErrCode, int64_t, int64_t> CompatibleDirScanner::ScanDir(const string &pat
     }
     int64_t bigFileSize = 0;
     int64_t smallFileSize = 0;
-    stack<pair<string, string>> dirStack;
-    dirStack.push({backupPath, restorePath});
+    stack<tuple<string, string, uint32_t>> dirStack;
+    dirStack.push({backupPath, restorePath, StringUtils::GetPathDepth(StringUtils::PathAddDelimiter(backupPath))});
     while (!dirStack.empty()) {
-        auto [currentPath, currentRestorePath] = dirStack.top();
+        auto [currentPath, currentRestorePath, depth] = dirStack.top();
         dirStack.pop();
         if (BDir::IsDirsMatch(excludes, currentPath)) {
             continue;
         }
-        if (IsEmptyDirectory(currentPath)) {
-            ScanFileSingleton::GetInstance()
-                .AddSmallFile(StringUtils::PathAddDelimiter(currentPath), 0, currentRestorePath);
+        vector<BScanSnapshot::DirEntry> entries;
+        if (!ListDirEntries(currentPath, scanOption_, entries)) {
             continue;
         }
-        unique_ptr<DIR, function<void(DIR *)>> dir = {opendir(currentPath.c_str()), closedir};
-        if (dir == nullptr) {
-            HILOGE("openDir fail, path:%{public}s, errno:%{public}d", GetAnonyPath(currentPath).c_str(), errno);
+        if (entries.empty()) {
+            ScanFileSingleton::GetInstance()
+                .AddSmallFile(StringUtils::PathAddDelimiter(currentPath), 0, currentRestorePath, depth);
             continue;
         }
-        struct dirent *ptr = nullptr;
-        while (!!(ptr = readdir(dir.get()))) {
-            if ((strcmp(ptr->d_name, ".") == 0) || (strcmp(ptr->d_name, "..") == 0)) {
-                continue;
-            }
-            std::string subBackupPath = StringUtils::PathAddDelimiter(currentPath) + string(ptr->d_name);
-            std::string subRestorePath = StringUtils::PathAddDelimiter(currentRestorePath) + string(ptr->d_name);
-            if (ptr->d_type == DT_REG) {
-                ProcessFile({subBackupPath, subRestorePath, size}, bigFileSize, smallFileSize, excludes, scanOption_);
-            } else if (ptr->d_type == DT_DIR) {
-                dirStack.push({subBackupPath, subRestorePath});
+        for (const auto &entry : entries) {
+            std::string subBackupPath = StringUtils::PathAddDelimiter(currentPath) + entry.name;
+            std::string subRestorePath = StringUtils::PathAddDelimiter(currentRestorePath) + entry.name;
+            if (entry.type == DT_REG) {
+                ProcessFile({subBackupPath, subRestorePath, size, depth}, bigFileSize, smallFileSize, excludes,
+                    scanOption_);
+            } else if (entry.type == DT_DIR) {
+                dirStack.push({subBackupPath, subRestorePath, depth + 1});
             } else {
                 HILOGE("Not support file type");
             }
@@ -402,12 +426,12 @@ struct ScanDirContext {
     int64_t smallFileSize = 0;
     const vector<string> &excludes;
     AdvancedScanOption option;
-    stack<string> dirStack;
+    stack<pair<string, uint32_t>> dirStack;
     int64_t stackCount = 0;
     std::shared_ptr<ScanResultManager> resultManager;
 };
 
-static void ProcessDirectoryEntries(const string &currentPath, DIR *dir, ScanDirContext &ctx)
+static void ProcessDirectoryEntries(const string &currentPath, uint32_t depth, DIR *dir, ScanDirContext &ctx)
 {
     struct dirent *ptr = nullptr;
     while (!!(ptr = readdir(dir))) {
@@ -419,10 +443,10 @@ static void ProcessDirectoryEntries(const string &currentPath, DIR *dir, ScanDir
             continue;
         }
         if (ptr->d_type == DT_REG) {
-            ProcessFile({filePath, "", ctx.sizeBoundary}, ctx.bigFileSize, ctx.smallFileSize,
+            ProcessFile({filePath, "", ctx.sizeBoundary, depth}, ctx.bigFileSize, ctx.smallFileSize,
                 ctx.excludes, ctx.option);
         } else if (ptr->d_type == DT_DIR) {
-            ctx.dirStack.push(filePath);
+            ctx.dirStack.push({filePath, depth + 1});
         } else {
             HILOGE("Not support file type");
         }
@@ -439,9 +463,9 @@ tuple<ErrCode, int64_t, int64_t> DefaultAppScanner::ScanDir(const string &backup
         HILOGE("Invalid directory path: %{private}s", backupPath.c_str());
         return ProcessSingleFile(excludes, backupPath, "", size, ctx.option);
     }
-    ctx.dirStack.push(backupPath);
+    ctx.dirStack.push({backupPath, StringUtils::GetPathDepth(StringUtils::PathAddDelimiter(backupPath))});
     while (!ctx.dirStack.empty()) {
-        auto currentPath = ctx.dirStack.top();
+        auto [currentPath, depth] = ctx.dirStack.top();
         ctx.stackCount++;
         ctx.dirStack.pop();
         if (BDir::IsDirsMatch(ctx.excludes, currentPath)) {
@@ -452,7 +476,7 @@ tuple<ErrCode, int64_t, int64_t> DefaultAppScanner::ScanDir(const string &backup
         }
         if (IsEmptyDirectory(currentPath)) {
             if (ctx.resultManager != nullptr) {
-                ctx.resultManager->AddSmallFile(StringUtils::PathAddDelimiter(currentPath), 0);
+                ctx.resultManager->AddSmallFile(StringUtils::PathAddDelimiter(currentPath), 0, "", depth);
             }
             continue;
         }
@@ -461,7 +485,7 @@ tuple<ErrCode, int64_t, int64_t> DefaultAppScanner::ScanDir(const string &backup
             HILOGE("openDir fail, path:%{public}s, errno:%{public}d", GetAnonyPath(currentPath).c_str(), errno);
             continue;
         }
-        ProcessDirectoryEntries(currentPath, dir.get(), ctx);
+        ProcessDirectoryEntries(currentPath, depth, dir.get(), ctx);
     }
     return {ERR_OK, ctx.bigFileSize, ctx.smallFileSize};
 }
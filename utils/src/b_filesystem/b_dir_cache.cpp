@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "b_filesystem/b_dir_cache.h"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "filemgmt_libhilog.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+
+namespace {
+const string ROOT_DIR = "/";
+
+// 去掉重复和末尾的'/', 使同一目录只对应一个key
+string NormalizeDir(const string &path)
+{
+    string out = (!path.empty() && path[0] == '/') ? ROOT_DIR : "";
+    size_t start = 0;
+    while (start < path.size()) {
+        size_t end = path.find('/', start);
+        if (end == string::npos) {
+            end = path.size();
+        }
+        if (end > start) {
+            if (!out.empty() && out.back() != '/') {
+                out.push_back('/');
+            }
+            out.append(path, start, end - start);
+        }
+        start = end + 1;
+    }
+    return out;
+}
+} // namespace
+
+BDirCache::BDirCache(size_t maxFds) : maxFds_(maxFds) {}
+
+bool BDirCache::EnsureDir(const string &path, mode_t mode)
+{
+    string dir = NormalizeDir(path);
+    if (dir.empty()) {
+        errno = EINVAL;
+        return false;
+    }
+    lock_guard<mutex> lock(lock_);
+    string cachedBase;
+    int dirFd = OpenDirLocked(dir, mode, cachedBase);
+    if (dirFd < 0 && errno == ENOENT && !cachedBase.empty()) {
+        InvalidateLocked();
+        dirFd = OpenDirLocked(dir, mode, cachedBase);
+    }
+    int err = errno;
+    TrimLocked();
+    errno = err;
+    return dirFd >= 0;
+}
+
+UniqueFd BDirCache::OpenFile(const string &filePath, int flags, mode_t mode, mode_t dirMode)
+{
+    size_t pos = filePath.rfind('/');
+    if (pos == string::npos || pos + 1 == filePath.size()) {
+        errno = EINVAL;
+        return UniqueFd(-1);
+    }
+    string dir = (pos == 0) ? ROOT_DIR : NormalizeDir(filePath.substr(0, pos));
+    string name = filePath.substr(pos + 1);
+    lock_guard<mutex> lock(lock_);
+    UniqueFd fd(-1);
+    for (int attempt = 0; attempt < 2; attempt++) {
+        string cachedBase;
+        int dirFd = OpenDirLocked(dir, dirMode, cachedBase);
+        if (dirFd >= 0) {
+            fd = UniqueFd(openat(dirFd, name.c_str(), flags | O_CLOEXEC, mode));
+        }
+        if (fd >= 0 || errno != ENOENT || cachedBase.empty()) {
+            break;
+        }
+        InvalidateLocked();
+    }
+    int err = errno;
+    TrimLocked();
+    errno = err;
+    return fd;
+}
+
+void BDirCache::Clear()
+{
+    lock_guard<mutex> lock(lock_);
+    InvalidateLocked();
+}
+
+BDirCache::Stats BDirCache::GetStats() const
+{
+    lock_guard<mutex> lock(lock_);
+    return stats_;
+}
+
+int BDirCache::OpenDirLocked(const string &path, mode_t mode, string &cachedBase)
+{
+    cachedBase.clear();
+    string cur = path;
+    int curFd = AT_FDCWD;
+    while (!cur.empty()) {
+        auto it = dirs_.find(cur);
+        if (it != dirs_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second.lruIt);
+            curFd = it->second.fd.Get();
+            cachedBase = cur;
+            break;
+        }
+        size_t pos = cur.rfind('/');
+        if (pos == string::npos || cur == ROOT_DIR) {
+            cur.clear();
+        } else {
+            cur.resize((pos == 0) ? 1 : pos);
+        }
+    }
+    if (cur == path) {
+        stats_.hits++;
+        return curFd;
+    }
+    // 从最近的已缓存祖先开始逐级打开或创建剩余部分
+    while (cur != path) {
+        string name;
+        string next;
+        if (cur.empty() && path[0] == '/') {
+            name = ROOT_DIR;
+            next = ROOT_DIR;
+        } else {
+            size_t start = cur.empty() ? 0 : ((cur == ROOT_DIR) ? 1 : cur.size() + 1);
+            size_t end = path.find('/', start);
+            if (end == string::npos) {
+                end = path.size();
+            }
+            name = path.substr(start, end - start);
+            next = path.substr(0, end);
+        }
+        curFd = OpenChildLocked(curFd, next, name, mode);
+        if (curFd < 0) {
+            return -1;
+        }
+        cur = move(next);
+    }
+    return curFd;
+}
+
+int BDirCache::OpenChildLocked(int parentFd, const string &path, const string &name, mode_t mode)
+{
+    stats_.dirOpens++;
+    UniqueFd fd(openat(parentFd, name.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+    if (fd < 0 && errno == ENOENT) {
+        stats_.mkdirs++;
+        if (mkdirat(parentFd, name.c_str(), mode) != 0 && errno != EEXIST) {
+            HILOGD("Failed to create directory, err = %{public}d", errno);
+            return -1;
+        }
+        stats_.dirOpens++;
+        fd = UniqueFd(openat(parentFd, name.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+    }
+    if (fd < 0) {
+        HILOGD("Failed to open directory, err = %{public}d", errno);
+        return -1;
+    }
+    int rawFd = fd.Get();
+    lru_.push_front(path);
+    dirs_[path] = Entry {move(fd), lru_.begin()};
+    return rawFd;
+}
+
+void BDirCache::InvalidateLocked()
+{
+    dirs_.clear();
+    lru_.clear();
+}
+
+void BDirCache::TrimLocked()
+{
+    while (dirs_.size() > maxFds_ && !lru_.empty()) {
+        dirs_.erase(lru_.back());
+        lru_.pop_back();
+    }
+}
+} // namespace OHOS::FileManagement::Backup
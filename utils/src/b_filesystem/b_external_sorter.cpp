@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "b_filesystem/b_external_sorter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "filemgmt_libhilog.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+
+namespace {
+constexpr size_t IO_BUFFER_SIZE = 32 * 1024;
+// 每条记录除key和value内容外的估算开销
+constexpr size_t RECORD_OVERHEAD = sizeof(pair<string, string>);
+const string TMP_FILE_TEMPLATE = "/.bsort_XXXXXX";
+
+bool WriteAll(int fd, const string &data)
+{
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t ret = write(fd, data.data() + written, data.size() - written);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            HILOGE("Failed to write sort run, errno = %{public}d", errno);
+            return false;
+        }
+        written += static_cast<size_t>(ret);
+    }
+    return true;
+}
+
+void PutRecord(string &out, const string &key, const string &value)
+{
+    uint32_t keyLen = static_cast<uint32_t>(key.size());
+    uint32_t valueLen = static_cast<uint32_t>(value.size());
+    out.append(reinterpret_cast<const char *>(&keyLen), sizeof(keyLen));
+    out.append(reinterpret_cast<const char *>(&valueLen), sizeof(valueLen));
+    out.append(key);
+    out.append(value);
+}
+} // namespace
+
+class BExternalSorter::RunReader {
+public:
+    explicit RunReader(int fd) : fd_(fd) {}
+
+    // 读完返回false且error为false
+    bool Read(Record &record, bool &error)
+    {
+        uint32_t keyLen = 0;
+        uint32_t valueLen = 0;
+        if (!Fill(sizeof(keyLen) + sizeof(valueLen), error)) {
+            return false;
+        }
+        memcpy(&keyLen, buf_.data() + pos_, sizeof(keyLen));
+        memcpy(&valueLen, buf_.data() + pos_ + sizeof(keyLen), sizeof(valueLen));
+        pos_ += sizeof(keyLen) + sizeof(valueLen);
+        if (!Fill(static_cast<size_t>(keyLen) + valueLen, error)) {
+            error = true;
+            return false;
+        }
+        record.first.assign(buf_, pos_, keyLen);
+        record.second.assign(buf_, pos_ + keyLen, valueLen);
+        pos_ += static_cast<size_t>(keyLen) + valueLen;
+        return true;
+    }
+
+private:
+    bool Fill(size_t need, bool &error)
+    {
+        if (buf_.size() - pos_ >= need) {
+            return true;
+        }
+        buf_.erase(0, pos_);
+        pos_ = 0;
+        char chunk[IO_BUFFER_SIZE];
+        while (buf_.size() < need) {
+            ssize_t ret = read(fd_, chunk, sizeof(chunk));
+            if (ret < 0 && errno == EINTR) {
+                continue;
+            }
+            if (ret < 0) {
+                HILOGE("Failed to read sort run, errno = %{public}d", errno);
+                error = true;
+                return false;
+            }
+            if (ret == 0) {
+                // 段尾只可能恰好落在记录边界上
+                error = error || !buf_.empty();
+                return false;
+            }
+            buf_.append(chunk, static_cast<size_t>(ret));
+        }
+        return true;
+    }
+
+    int fd_;
+    string buf_;
+    size_t pos_ = 0;
+};
+
+bool BExternalSorter::HeapGreater::operator()(const HeapItem &lhs, const HeapItem &rhs) const
+{
+    int cmp = lhs.record.first.compare(rhs.record.first);
+    if (cmp != 0) {
+        return cmp > 0;
+    }
+    // 序号小的段包含更早加入的记录
+    return lhs.runIndex > rhs.runIndex;
+}
+
+BExternalSorter::BExternalSorter(const string &tmpDir, size_t memoryLimit, size_t mergeWays)
+    : tmpDir_(tmpDir), memoryLimit_(memoryLimit), mergeWays_(max<size_t>(mergeWays, 2))
+{
+}
+
+BExternalSorter::~BExternalSorter() = default;
+
+bool BExternalSorter::Add(string key, string value)
+{
+    if (finished_ || hasError_) {
+        return false;
+    }
+    bufferBytes_ += key.size() + value.size() + RECORD_OVERHEAD;
+    buffer_.emplace_back(move(key), move(value));
+    if (bufferBytes_ > memoryLimit_) {
+        return SpillRun();
+    }
+    return true;
+}
+
+UniqueFd BExternalSorter::CreateTmpFile(const string &tmpDir)
+{
+    string path = tmpDir + TMP_FILE_TEMPLATE;
+    UniqueFd fd(mkostemp(path.data(), O_CLOEXEC));
+    if (fd < 0) {
+        HILOGE("Failed to create sort run, errno = %{public}d", errno);
+        return fd;
+    }
+    unlink(path.c_str());
+    return fd;
+}
+
+bool BExternalSorter::SpillRun()
+{
+    stable_sort(buffer_.begin(), buffer_.end(),
+        [](const Record &lhs, const Record &rhs) { return lhs.first < rhs.first; });
+    UniqueFd fd = CreateTmpFile(tmpDir_);
+    if (fd < 0) {
+        hasError_ = true;
+        return false;
+    }
+    string out;
+    for (const auto &[key, value] : buffer_) {
+        PutRecord(out, key, value);
+        if (out.size() >= IO_BUFFER_SIZE) {
+            if (!WriteAll(fd, out)) {
+                hasError_ = true;
+                return false;
+            }
+            out.clear();
+        }
+    }
+    if (!WriteAll(fd, out)) {
+        hasError_ = true;
+        return false;
+    }
+    vector<Record>().swap(buffer_);
+    bufferBytes_ = 0;
+    runs_.emplace_back(move(fd));
+    spilledRunCount_++;
+    return true;
+}
+
+bool BExternalSorter::StartMerge(size_t begin, size_t end)
+{
+    readers_.clear();
+    heap_.clear();
+    for (size_t i = begin; i < end; i++) {
+        if (lseek(runs_[i], 0, SEEK_SET) != 0) {
+            HILOGE("Failed to rewind sort run, errno = %{public}d", errno);
+            return false;
+        }
+        readers_.emplace_back(make_unique<RunReader>(runs_[i].Get()));
+        HeapItem item {{}, readers_.size() - 1};
+        bool error = false;
+        if (readers_.back()->Read(item.record, error)) {
+            heap_.emplace_back(move(item));
+            push_heap(heap_.begin(), heap_.end(), HeapGreater());
+        } else if (error) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BExternalSorter::PopMerged(Record &record)
+{
+    if (heap_.empty()) {
+        return false;
+    }
+    pop_heap(heap_.begin(), heap_.end(), HeapGreater());
+    HeapItem &item = heap_.back();
+    record = move(item.record);
+    bool error = false;
+    if (readers_[item.runIndex]->Read(item.record, error)) {
+        push_heap(heap_.begin(), heap_.end(), HeapGreater());
+    } else {
+        heap_.pop_back();
+        if (error) {
+            hasError_ = true;
+            heap_.clear();
+        }
+    }
+    return true;
+}
+
+bool BExternalSorter::MergeRuns(size_t begin, size_t end, UniqueFd &outFd)
+{
+    outFd = CreateTmpFile(tmpDir_);
+    if (outFd < 0 || !StartMerge(begin, end)) {
+        return false;
+    }
+    string out;
+    Record record;
+    while (PopMerged(record)) {
+        PutRecord(out, record.first, record.second);
+        if (out.size() >= IO_BUFFER_SIZE) {
+            if (!WriteAll(outFd, out)) {
+                return false;
+            }
+            out.clear();
+        }
+    }
+    return !hasError_ && WriteAll(outFd, out);
+}
+
+bool BExternalSorter::Finish()
+{
+    if (finished_ || hasError_) {
+        return !hasError_;
+    }
+    finished_ = true;
+    if (runs_.empty()) {
+        stable_sort(buffer_.begin(), buffer_.end(),
+            [](const Record &lhs, const Record &rhs) { return lhs.first < rhs.first; });
+        return true;
+    }
+    if (!buffer_.empty() && !SpillRun()) {
+        return false;
+    }
+    // 段数超过归并路数时按顺序分组合并, 保持段之间的先后关系
+    while (runs_.size() > mergeWays_) {
+        vector<UniqueFd> merged;
+        for (size_t begin = 0; begin < runs_.size(); begin += mergeWays_) {
+            size_t end = min(begin + mergeWays_, runs_.size());
+            if (end - begin == 1) {
+                merged.emplace_back(move(runs_[begin]));
+                continue;
+            }
+            UniqueFd outFd;
+            if (!MergeRuns(begin, end, outFd)) {
+                hasError_ = true;
+                return false;
+            }
+            merged.emplace_back(move(outFd));
+        }
+        readers_.clear();
+        runs_ = move(merged);
+    }
+    if (!StartMerge(0, runs_.size())) {
+        hasError_ = true;
+        return false;
+    }
+    return true;
+}
+
+bool BExternalSorter::Next(string &key, string &value)
+{
+    if (!finished_ || hasError_) {
+        return false;
+    }
+    if (runs_.empty()) {
+        if (bufferPos_ >= buffer_.size()) {
+            vector<Record>().swap(buffer_);
+            return false;
+        }
+        key = move(buffer_[bufferPos_].first);
+        value = move(buffer_[bufferPos_].second);
+        bufferPos_++;
+        return true;
+    }
+    Record record;
+    if (!PopMerged(record)) {
+        return false;
+    }
+    key = move(record.first);
+    value = move(record.second);
+    return !hasError_;
+}
+} // namespace OHOS::FileManagement::Backup
@@ -27,6 +27,7 @@
 #include <sstream>
 #include <unistd.h>
 #include "b_resources/b_constants.h"
+#include "b_utils/string_utils.h"
 
 namespace OHOS::FileManagement::Backup {
 using namespace std;
@@ -83,17 +84,7 @@ tuple<int, string> BackupFileHash::HashWithSHA256(const string &fpath)
 std::string BackupFileHash::HashFilePath(const string &fileName)
 {
     std::filesystem::path filePath = fileName;
-    std::string realFileName = filePath.filename().string();
-    ostringstream strHex;
-    strHex << hex;
-
-    hash<string> strHash;
-    size_t szHash = strHash(realFileName);
-    strHex << setfill('0') << setw(BConstants::BIG_FILE_NAME_SIZE) << szHash;
-    string hashResult = strHex.str();
-    szHash = strHash(realFileName);
-    strHex << setfill('0') << setw(BConstants::BIG_FILE_NAME_SIZE) << szHash;
-    hashResult = strHex.str();
-    return hashResult;
+    // 与大文件名使用同一种哈希名格式
+    return StringUtils::GenHashName(filePath.filename().string());
 }
 } // namespace OHOS::FileManagement::Backup
\ No newline at end of file
@@ -0,0 +1,513 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "b_filesystem/b_scan_snapshot.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <type_traits>
+#include <unistd.h>
+
+#include <openssl/sha.h>
+
+#include "b_anony/b_anony.h"
+#include "filemgmt_libhilog.h"
+#include "securec.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+
+namespace {
+constexpr uint32_t SNAPSHOT_MAGIC = 0x504e5342; // "BSNP"
+constexpr uint32_t SNAPSHOT_VERSION = 3;
+constexpr int64_t NS_PER_SEC = 1000000000;
+// 文件系统时间戳精度可能低至秒级, 距快照开始时间不足该窗口的记录视为可能在扫描期间被修改
+constexpr int64_t RACY_WINDOW_NS = 2 * NS_PER_SEC;
+constexpr size_t CHECKSUM_LEN = SHA256_DIGEST_LENGTH;
+constexpr size_t HEADER_LEN = sizeof(uint32_t) * 2 + sizeof(int64_t);
+constexpr size_t FOOTER_LEN = sizeof(uint64_t) + CHECKSUM_LEN;
+constexpr size_t BLOCK_TARGET_SIZE = 64 * 1024;
+constexpr size_t IO_BUFFER_SIZE = 64 * 1024;
+constexpr size_t SORT_MEMORY_LIMIT = 4 * 1024 * 1024;
+constexpr mode_t SNAPSHOT_FILE_MODE = 0660;
+constexpr uint8_t RECORD_DIR = 1;
+constexpr uint8_t RECORD_FILE = 2;
+const string SNAPSHOT_TMP_SUFFIX = ".tmp";
+
+int64_t GetRealTimeNs()
+{
+    struct timespec ts = {};
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * NS_PER_SEC + ts.tv_nsec;
+}
+
+template <typename T>
+void PutInt(string &out, T value)
+{
+    static_assert(is_integral_v<T>);
+    out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void PutString(string &out, string_view value)
+{
+    PutInt(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+class Reader {
+public:
+    explicit Reader(string_view data) : data_(data) {}
+
+    template <typename T>
+    bool GetInt(T &value)
+    {
+        if (data_.size() - pos_ < sizeof(value) ||
+            memcpy_s(&value, sizeof(value), data_.data() + pos_, sizeof(value)) != EOK) {
+            return false;
+        }
+        pos_ += sizeof(value);
+        return true;
+    }
+
+    bool GetString(string_view &value)
+    {
+        uint32_t len = 0;
+        if (!GetInt(len) || data_.size() - pos_ < len) {
+            return false;
+        }
+        value = data_.substr(pos_, len);
+        pos_ += len;
+        return true;
+    }
+
+    bool GetString(string &value)
+    {
+        string_view view;
+        if (!GetString(view)) {
+            return false;
+        }
+        value.assign(view);
+        return true;
+    }
+
+    bool AtEnd() const
+    {
+        return pos_ == data_.size();
+    }
+
+private:
+    string_view data_;
+    size_t pos_ = 0;
+};
+
+bool PreadAll(int fd, char *buf, size_t len, uint64_t offset)
+{
+    while (len > 0) {
+        ssize_t ret = TEMP_FAILURE_RETRY(pread(fd, buf, len, static_cast<off_t>(offset)));
+        if (ret <= 0) {
+            return false;
+        }
+        buf += ret;
+        len -= static_cast<size_t>(ret);
+        offset += static_cast<uint64_t>(ret);
+    }
+    return true;
+}
+
+bool WriteAll(int fd, const string &data, SHA256_CTX &ctx)
+{
+    SHA256_Update(&ctx, data.data(), data.size());
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t ret = TEMP_FAILURE_RETRY(write(fd, data.data() + written, data.size() - written));
+        if (ret <= 0) {
+            return false;
+        }
+        written += static_cast<size_t>(ret);
+    }
+    return true;
+}
+
+// 记录值: [类型 u8][inode u64][mtime i64][ctime i64][目录条目列表或文件大小与摘要]
+string EncodeMeta(uint8_t type, const BScanSnapshot::Meta &meta)
+{
+    string value;
+    PutInt(value, type);
+    PutInt(value, meta.ino);
+    PutInt(value, meta.mtimeNs);
+    PutInt(value, meta.ctimeNs);
+    return value;
+}
+
+bool DecodeMeta(Reader &reader, BScanSnapshot::Meta &meta)
+{
+    uint8_t type = 0;
+    return reader.GetInt(type) && reader.GetInt(meta.ino) && reader.GetInt(meta.mtimeNs) &&
+           reader.GetInt(meta.ctimeNs);
+}
+
+bool SameMeta(const BScanSnapshot::Meta &lhs, const BScanSnapshot::Meta &rhs)
+{
+    return lhs.ino == rhs.ino && lhs.mtimeNs == rhs.mtimeNs && lhs.ctimeNs == rhs.ctimeNs;
+}
+} // namespace
+
+BScanSnapshot::BScanSnapshot() : startNs_(GetRealTimeNs()) {}
+
+BScanSnapshot::Meta BScanSnapshot::GetMeta(const struct stat &st)
+{
+    Meta meta;
+    meta.ino = static_cast<uint64_t>(st.st_ino);
+    meta.mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * NS_PER_SEC + st.st_mtim.tv_nsec;
+    meta.ctimeNs = static_cast<int64_t>(st.st_ctim.tv_sec) * NS_PER_SEC + st.st_ctim.tv_nsec;
+    return meta;
+}
+
+bool BScanSnapshot::IsStable(const Meta &meta) const
+{
+    return meta.mtimeNs < startNs_ - RACY_WINDOW_NS && meta.ctimeNs < startNs_ - RACY_WINDOW_NS;
+}
+
+bool BScanSnapshot::ReadBlock(size_t index)
+{
+    if (cachedBlock_ == index) {
+        return true;
+    }
+    cachedBlock_ = SIZE_MAX;
+    const auto &block = prevBlocks_[index];
+    cachedData_.resize(block.length);
+    if (!PreadAll(prevFd_, cachedData_.data(), cachedData_.size(), block.offset)) {
+        HILOGE("Failed to read scan snapshot block, errno = %{public}d", errno);
+        return false;
+    }
+    cachedBlock_ = index;
+    return true;
+}
+
+bool BScanSnapshot::LookupRecord(const string &key, uint8_t type, string &value)
+{
+    // 定位首个路径不大于key的数据块, 同一路径的记录不会跨块
+    auto it = upper_bound(prevBlocks_.begin(), prevBlocks_.end(), key,
+                          [](const string &target, const BlockInfo &block) { return target < block.firstKey; });
+    if (it == prevBlocks_.begin() || !ReadBlock(static_cast<size_t>(it - prevBlocks_.begin() - 1))) {
+        return false;
+    }
+    Reader reader(cachedData_);
+    string_view recordKey;
+    string_view recordValue;
+    while (reader.GetString(recordKey) && reader.GetString(recordValue)) {
+        if (recordKey > key) {
+            return false;
+        }
+        if (recordKey == key && !recordValue.empty() && static_cast<uint8_t>(recordValue[0]) == type) {
+            value.assign(recordValue);
+            return true;
+        }
+    }
+    return false;
+}
+
+void BScanSnapshot::AddRecord(const string &key, string value)
+{
+    if (sorter_ == nullptr) {
+        return;
+    }
+    if (!sorter_->Add(key, move(value))) {
+        HILOGE("Failed to add scan snapshot record");
+    }
+}
+
+bool BScanSnapshot::LookupDir(const string &dirPath, const struct stat &st, vector<DirEntry> &entries)
+{
+    Meta meta = GetMeta(st);
+    lock_guard<mutex> lock(lock_);
+    string value;
+    if (!IsStable(meta) || !LookupRecord(dirPath, RECORD_DIR, value)) {
+        return false;
+    }
+    Reader reader(value);
+    Meta saved;
+    uint32_t count = 0;
+    if (!DecodeMeta(reader, saved) || !SameMeta(saved, meta) || !reader.GetInt(count)) {
+        return false;
+    }
+    vector<DirEntry> savedEntries;
+    for (uint32_t i = 0; i < count; i++) {
+        DirEntry entry;
+        if (!reader.GetString(entry.name) || !reader.GetInt(entry.type)) {
+            return false;
+        }
+        savedEntries.emplace_back(move(entry));
+    }
+    entries = move(savedEntries);
+    dirsTouched_ = true;
+    AddRecord(dirPath, move(value));
+    return true;
+}
+
+void BScanSnapshot::RecordDir(const string &dirPath, const struct stat &st, const vector<DirEntry> &entries)
+{
+    Meta meta = GetMeta(st);
+    lock_guard<mutex> lock(lock_);
+    dirsTouched_ = true;
+    if (!IsStable(meta)) {
+        return;
+    }
+    string value = EncodeMeta(RECORD_DIR, meta);
+    PutInt(value, static_cast<uint32_t>(entries.size()));
+    for (const auto &entry : entries) {
+        PutString(value, entry.name);
+        PutInt(value, entry.type);
+    }
+    AddRecord(dirPath, move(value));
+}
+
+string BScanSnapshot::LookupHash(const string &filePath, const struct stat &st)
+{
+    Meta meta = GetMeta(st);
+    lock_guard<mutex> lock(lock_);
+    string value;
+    if (!IsStable(meta) || !LookupRecord(filePath, RECORD_FILE, value)) {
+        return "";
+    }
+    Reader reader(value);
+    Meta saved;
+    uint64_t size = 0;
+    string hash;
+    if (!DecodeMeta(reader, saved) || !SameMeta(saved, meta) || !reader.GetInt(size) ||
+        size != static_cast<uint64_t>(st.st_size) || !reader.GetString(hash)) {
+        return "";
+    }
+    filesTouched_ = true;
+    AddRecord(filePath, move(value));
+    return hash;
+}
+
+void BScanSnapshot::RecordHash(const string &filePath, const struct stat &st, const string &hash)
+{
+    Meta meta = GetMeta(st);
+    lock_guard<mutex> lock(lock_);
+    filesTouched_ = true;
+    if (hash.empty() || !IsStable(meta)) {
+        return;
+    }
+    string value = EncodeMeta(RECORD_FILE, meta);
+    PutInt(value, static_cast<uint64_t>(st.st_size));
+    PutString(value, hash);
+    AddRecord(filePath, move(value));
+}
+
+bool BScanSnapshot::CarryOver(uint8_t type)
+{
+    for (size_t i = 0; i < prevBlocks_.size(); i++) {
+        if (!ReadBlock(i)) {
+            return false;
+        }
+        Reader reader(cachedData_);
+        string_view key;
+        string_view value;
+        while (reader.GetString(key) && reader.GetString(value)) {
+            if (!value.empty() && static_cast<uint8_t>(value[0]) == type && !sorter_->Add(string(key), string(value))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool BScanSnapshot::WriteSorted(int fd)
+{
+    // 格式: [头部][按路径排序的数据块...][稀疏索引][索引偏移 u64][SHA-256]
+    SHA256_CTX ctx;
+    SHA256_Init(&ctx);
+    string out;
+    PutInt(out, SNAPSHOT_MAGIC);
+    PutInt(out, SNAPSHOT_VERSION);
+    PutInt(out, startNs_);
+    uint64_t offset = 0;
+    vector<BlockInfo> blocks;
+    auto flush = [&]() {
+        offset += out.size();
+        bool ok = WriteAll(fd, out, ctx);
+        out.clear();
+        return ok;
+    };
+    // 同一路径的记录作为一组写入同一块, 每种类型只保留最后一条
+    vector<pair<string, string>> group;
+    auto emitGroup = [&]() {
+        if (group.empty()) {
+            return true;
+        }
+        uint64_t pos = offset + out.size();
+        if (blocks.empty() || pos - blocks.back().offset >= BLOCK_TARGET_SIZE) {
+            if (!blocks.empty()) {
+                blocks.back().length = static_cast<uint32_t>(pos - blocks.back().offset);
+            }
+            blocks.push_back({group.front().first, pos, 0});
+        }
+        for (auto &[key, value] : group) {
+            if (!value.empty()) {
+                PutString(out, key);
+                PutString(out, value);
+            }
+        }
+        group.clear();
+        return out.size() < IO_BUFFER_SIZE || flush();
+    };
+    string key;
+    string value;
+    bool ok = true;
+    while (ok && sorter_->Next(key, value)) {
+        if (!group.empty() && group.front().first != key) {
+            ok = emitGroup();
+        }
+        auto same = find_if(group.begin(), group.end(), [&value](const pair<string, string> &item) {
+            return !value.empty() && item.second[0] == value[0];
+        });
+        if (same != group.end()) {
+            same->second = move(value);
+        } else {
+            group.emplace_back(key, move(value));
+        }
+    }
+    ok = ok && !sorter_->HasError() && emitGroup();
+    uint64_t indexOffset = offset + out.size();
+    if (!blocks.empty()) {
+        blocks.back().length = static_cast<uint32_t>(indexOffset - blocks.back().offset);
+    }
+    PutInt(out, static_cast<uint32_t>(blocks.size()));
+    for (const auto &block : blocks) {
+        PutString(out, block.firstKey);
+        PutInt(out, block.offset);
+        PutInt(out, block.length);
+    }
+    PutInt(out, indexOffset);
+    ok = ok && flush();
+    unsigned char digest[CHECKSUM_LEN] = {};
+    SHA256_Final(digest, &ctx);
+    out.assign(reinterpret_cast<const char *>(digest), CHECKSUM_LEN);
+    return ok && flush();
+}
+
+bool BScanSnapshot::VerifyAndLoadIndex(int fd, int64_t &savedStartNs)
+{
+    struct stat st = {};
+    if (fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < HEADER_LEN + sizeof(uint32_t) + FOOTER_LEN) {
+        return false;
+    }
+    // 流式校验整个文件, 不整体读入内存
+    uint64_t bodyLen = static_cast<uint64_t>(st.st_size) - CHECKSUM_LEN;
+    SHA256_CTX ctx;
+    SHA256_Init(&ctx);
+    string buf(IO_BUFFER_SIZE, '\0');
+    for (uint64_t pos = 0; pos < bodyLen;) {
+        size_t len = static_cast<size_t>(min<uint64_t>(buf.size(), bodyLen - pos));
+        if (!PreadAll(fd, buf.data(), len, pos)) {
+            return false;
+        }
+        SHA256_Update(&ctx, buf.data(), len);
+        pos += len;
+    }
+    unsigned char digest[CHECKSUM_LEN] = {};
+    SHA256_Final(digest, &ctx);
+    string tail(FOOTER_LEN, '\0');
+    if (!PreadAll(fd, tail.data(), tail.size(), bodyLen + CHECKSUM_LEN - FOOTER_LEN) ||
+        memcmp(digest, tail.data() + sizeof(uint64_t), CHECKSUM_LEN) != 0) {
+        HILOGE("Scan snapshot checksum mismatch");
+        return false;
+    }
+    string header(HEADER_LEN, '\0');
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t indexOffset = 0;
+    Reader headerReader(header);
+    Reader tailReader(tail);
+    if (!PreadAll(fd, header.data(), header.size(), 0) || !headerReader.GetInt(magic) || magic != SNAPSHOT_MAGIC ||
+        !headerReader.GetInt(version) || version != SNAPSHOT_VERSION || !headerReader.GetInt(savedStartNs) ||
+        !tailReader.GetInt(indexOffset) || indexOffset < HEADER_LEN || indexOffset > bodyLen - sizeof(uint64_t)) {
+        return false;
+    }
+    string index(static_cast<size_t>(bodyLen - sizeof(uint64_t) - indexOffset), '\0');
+    uint32_t blockCount = 0;
+    Reader indexReader(index);
+    if (!PreadAll(fd, index.data(), index.size(), indexOffset) || !indexReader.GetInt(blockCount)) {
+        return false;
+    }
+    uint64_t expectOffset = HEADER_LEN;
+    for (uint32_t i = 0; i < blockCount; i++) {
+        BlockInfo block;
+        if (!indexReader.GetString(block.firstKey) || !indexReader.GetInt(block.offset) ||
+            !indexReader.GetInt(block.length) || block.offset != expectOffset) {
+            return false;
+        }
+        expectOffset += block.length;
+        prevBlocks_.emplace_back(move(block));
+    }
+    return indexReader.AtEnd() && expectOffset == indexOffset;
+}
+
+bool BScanSnapshot::Load(const string &path)
+{
+    lock_guard<mutex> lock(lock_);
+    size_t pos = path.rfind('/');
+    string tmpDir = pos == string::npos ? "." : path.substr(0, pos == 0 ? 1 : pos);
+    sorter_ = make_unique<BExternalSorter>(tmpDir, SORT_MEMORY_LIMIT);
+    UniqueFd fd(open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd < 0) {
+        HILOGI("No scan snapshot, full scan");
+        return false;
+    }
+    int64_t savedStartNs = 0;
+    bool loaded = VerifyAndLoadIndex(fd, savedStartNs);
+    if (loaded && savedStartNs > startNs_) {
+        HILOGW("Clock moved backwards since last snapshot, discard it");
+        loaded = false;
+    }
+    if (!loaded) {
+        HILOGE("Invalid scan snapshot, full scan");
+        prevBlocks_.clear();
+        return false;
+    }
+    prevFd_ = move(fd);
+    HILOGI("Scan snapshot loaded, blocks:%{public}zu", prevBlocks_.size());
+    return true;
+}
+
+bool BScanSnapshot::Save(const string &path)
+{
+    lock_guard<mutex> lock(lock_);
+    if (sorter_ == nullptr) {
+        HILOGE("Scan snapshot was not loaded or has been saved");
+        return false;
+    }
+    // 本次未涉及的记录类型沿用上次的结果, 全量备份与增量备份交替进行时互不清空
+    bool ok = (dirsTouched_ || CarryOver(RECORD_DIR)) && (filesTouched_ || CarryOver(RECORD_FILE)) &&
+              sorter_->Finish();
+    string tmpPath = path + SNAPSHOT_TMP_SUFFIX;
+    UniqueFd fd(ok ? open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, SNAPSHOT_FILE_MODE) : -1);
+    ok = fd >= 0 && WriteSorted(fd);
+    fd.Reset();
+    sorter_.reset();
+    if (!ok || rename(tmpPath.c_str(), path.c_str()) != 0) {
+        HILOGE("Failed to save scan snapshot %{public}s, errno = %{public}d", GetAnonyPath(path).c_str(), errno);
+        remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+} // namespace OHOS::FileManagement::Backup
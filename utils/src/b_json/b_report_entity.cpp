@@ -15,13 +15,16 @@
 
 #include "b_json/b_report_entity.h"
 
+#include <cerrno>
 #include <map>
 #include <sstream>
 #include <string>
+#include <unistd.h>
 #include <unordered_map>
 #include <vector>
 
 #include "b_error/b_error.h"
+#include "b_filesystem/b_external_sorter.h"
 #include "filemgmt_libhilog.h"
 #include "sandbox_helper.h"
 #include "unique_fd.h"
@@ -36,6 +39,7 @@ const int64_t HASH_BUFFER_SIZE = 4096; // 每次读取的size
 const int INFO_ALIGN_NUM = 2;
 const size_t ENCODE_FLAG_VERSION = 7; // 7: "path", "mode", "dir", "size", "mtime", "hash", "isIncremental"
 const std::string DEFAULT_VALUE = "1";
+const size_t SORT_WRITE_BUFFER_SIZE = 32 * 1024;
 const std::vector<std::string> Data_Header = {
     "path", "mode", "dir", "size", "mtime", "hash", "isIncremental", "encodeFlag"
 };
@@ -106,13 +110,10 @@ static ErrCode ParseReportInfo(struct ReportFileInfo &fileStat,
     }
 }
 
-static void DealLine(vector<std::string> &keys,
-                     int &num,
-                     const string &line,
-                     unordered_map<string, struct ReportFileInfo> &infos)
+static bool ParseLine(vector<std::string> &keys, int &num, const string &line, struct ReportFileInfo &fileState)
 {
     if (line.empty()) {
-        return;
+        return false;
     }
 
     string currentLine = line;
@@ -129,14 +130,24 @@ static void DealLine(vector<std::string> &keys,
             }
         }
         num++;
-    } else {
-        struct ReportFileInfo fileState;
-        auto code = ParseReportInfo(fileState, splits, keys.size());
-        if (code != ERR_OK) {
-            HILOGE("ParseReportInfo err:%{public}d, %{public}s", code, currentLine.c_str());
-        } else {
-            infos.try_emplace(fileState.filePath, fileState);
-        }
+        return false;
+    }
+    auto code = ParseReportInfo(fileState, splits, keys.size());
+    if (code != ERR_OK) {
+        HILOGE("ParseReportInfo err:%{public}d, %{public}s", code, currentLine.c_str());
+        return false;
+    }
+    return true;
+}
+
+static void DealLine(vector<std::string> &keys,
+                     int &num,
+                     const string &line,
+                     unordered_map<string, struct ReportFileInfo> &infos)
+{
+    struct ReportFileInfo fileState;
+    if (ParseLine(keys, num, line, fileState)) {
+        infos.try_emplace(fileState.filePath, fileState);
     }
 }
 
@@ -189,6 +200,166 @@ bool BReportEntity::GetStorageReportInfos(std::unordered_map<string, struct Repo
     return true;
 }
 
+bool BReportEntity::GetNextLine(string &line)
+{
+    while (true) {
+        size_t lineEnd = readBuf_.find(LINE_SEP, readPos_);
+        if (lineEnd != string::npos) {
+            line = readBuf_.substr(readPos_, lineEnd - readPos_);
+            readPos_ = lineEnd + 1;
+            return true;
+        }
+        readBuf_.erase(0, readPos_);
+        readPos_ = 0;
+        char buffer[HASH_BUFFER_SIZE];
+        ssize_t bytesRead = read(srcFile_, buffer, sizeof(buffer));
+        if (bytesRead > 0) {
+            readBuf_.append(buffer, bytesRead);
+            continue;
+        }
+        if (readBuf_.empty()) {
+            return false;
+        }
+        // 处理文件中的最后一行
+        line.clear();
+        line.swap(readBuf_);
+        return true;
+    }
+}
+
+bool BReportEntity::GetNextReportInfo(struct ReportFileInfo &info)
+{
+    string line;
+    while (GetNextLine(line)) {
+        info = ReportFileInfo();
+        if (ParseLine(keys_, currLineNum_, line, info)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BReportEntity::Rewind()
+{
+    if (lseek(srcFile_, 0, SEEK_SET) != 0) {
+        HILOGE("Failed to rewind report, errno = %{public}d", errno);
+        return false;
+    }
+    keys_.clear();
+    currLineNum_ = 0;
+    currLineInfo_.clear();
+    readBuf_.clear();
+    readPos_ = 0;
+    return true;
+}
+
+bool BReportEntity::IsSortedByPath(size_t &count)
+{
+    count = 0;
+    if (!Rewind()) {
+        return false;
+    }
+    bool sorted = true;
+    struct ReportFileInfo prev;
+    struct ReportFileInfo curr;
+    while (GetNextReportInfo(curr)) {
+        if (count > 0 && curr.filePath < prev.filePath) {
+            sorted = false;
+            break;
+        }
+        prev.filePath.swap(curr.filePath);
+        count++;
+    }
+    return Rewind() && sorted;
+}
+
+UniqueFd BReportEntity::SortByPath(const string &tmpDir, size_t memoryLimit, size_t &count)
+{
+    count = 0;
+    if (!Rewind()) {
+        return UniqueFd(-1);
+    }
+    BExternalSorter sorter(tmpDir, memoryLimit);
+    string headerLines;
+    string line;
+    bool added = true;
+    while (added && GetNextLine(line)) {
+        struct ReportFileInfo info;
+        if (currLineNum_ < INFO_ALIGN_NUM) {
+            if (!line.empty()) {
+                headerLines.append(line).append(1, LINE_SEP);
+            }
+            ParseLine(keys_, currLineNum_, line, info);
+        } else if (ParseLine(keys_, currLineNum_, line, info)) {
+            added = sorter.Add(move(info.filePath), move(line));
+            count++;
+        }
+    }
+    UniqueFd sortedFd;
+    if (added && sorter.Finish()) {
+        sortedFd = BExternalSorter::CreateTmpFile(tmpDir);
+    }
+    string out = move(headerLines);
+    string key;
+    string value;
+    while (sortedFd >= 0 && sorter.Next(key, value)) {
+        out.append(value).append(1, LINE_SEP);
+        if (out.size() >= SORT_WRITE_BUFFER_SIZE) {
+            if (write(sortedFd, out.data(), out.size()) != static_cast<ssize_t>(out.size())) {
+                sortedFd.Reset();
+            }
+            out.clear();
+        }
+    }
+    if (sortedFd >= 0 && (sorter.HasError() || write(sortedFd, out.data(), out.size()) !=
+        static_cast<ssize_t>(out.size()) || lseek(sortedFd, 0, SEEK_SET) != 0)) {
+        sortedFd.Reset();
+    }
+    if (!Rewind() || sortedFd < 0) {
+        HILOGE("Failed to sort report, errno = %{public}d", errno);
+        return UniqueFd(-1);
+    }
+    HILOGI("Report sorted, count:%{public}zu, spilled runs:%{public}zu", count, sorter.GetSpilledRunCount());
+    return sortedFd;
+}
+
+void BReportEntity::MergeJoin(BReportEntity &local, BReportEntity &cloud, const ReportDiffVisitor &visitor)
+{
+    struct ReportFileInfo localInfo;
+    struct ReportFileInfo cloudInfo;
+    bool hasLocal = local.GetNextReportInfo(localInfo);
+    bool hasCloud = cloud.GetNextReportInfo(cloudInfo);
+    bool cloudMatched = false;
+    bool hasPrevCloud = false;
+    string prevCloudPath;
+    auto nextCloud = [&]() {
+        // 云端重复条目只有第一条参与对比
+        if (!cloudMatched && (!hasPrevCloud || cloudInfo.filePath != prevCloudPath)) {
+            visitor(ReportDiffType::DELETED, nullptr, &cloudInfo);
+        }
+        hasPrevCloud = true;
+        prevCloudPath = cloudInfo.filePath;
+        cloudMatched = false;
+        hasCloud = cloud.GetNextReportInfo(cloudInfo);
+    };
+    while (hasLocal) {
+        while (hasCloud && cloudInfo.filePath < localInfo.filePath) {
+            nextCloud();
+        }
+        if (hasCloud && cloudInfo.filePath == localInfo.filePath) {
+            cloudMatched = true;
+            bool unchanged = localInfo.size == cloudInfo.size && localInfo.mtime == cloudInfo.mtime;
+            visitor(unchanged ? ReportDiffType::UNCHANGED : ReportDiffType::CHANGED, &localInfo, &cloudInfo);
+        } else {
+            visitor(ReportDiffType::ADDED, &localInfo, nullptr);
+        }
+        hasLocal = local.GetNextReportInfo(localInfo);
+    }
+    while (hasCloud) {
+        nextCloud();
+    }
+}
+
 void BReportEntity::CheckAndUpdateIfReportLineEncoded(std::string &path)
 {
     if (path.empty()) {
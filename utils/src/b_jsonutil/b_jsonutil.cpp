@@ -261,20 +261,30 @@ static void ParseSupportWithoutTar(cJSON *root, BJsonUtil::BundleSettingInfo &bu
     }
 }
 
-static void ParseExcludeInfos(cJSON *root, BJsonUtil::BundleSettingInfo &bundleSettingInfo)
+static void ParseStringArray(cJSON *root, const char *key, std::vector<std::string> &values)
 {
-    cJSON *excludeInfos = cJSON_GetObjectItem(root, "excludeInfos");
-    if (excludeInfos == nullptr || !cJSON_IsArray(excludeInfos)) {
+    cJSON *items = cJSON_GetObjectItem(root, key);
+    if (items == nullptr || !cJSON_IsArray(items)) {
         return;
     }
-    int excludeInfosCount = cJSON_GetArraySize(excludeInfos);
-    for (int i = 0; i < excludeInfosCount; i++) {
-        cJSON *excludeInfo = cJSON_GetArrayItem(excludeInfos, i);
-        if (cJSON_IsString(excludeInfo) && excludeInfo->valuestring != nullptr) {
-            bundleSettingInfo.excludeInfos.emplace_back(excludeInfo->valuestring);
+    int itemsCount = cJSON_GetArraySize(items);
+    for (int i = 0; i < itemsCount; i++) {
+        cJSON *item = cJSON_GetArrayItem(items, i);
+        if (cJSON_IsString(item) && item->valuestring != nullptr) {
+            values.emplace_back(item->valuestring);
         }
     }
-    HILOGI("Parse excludeInfos success, size is %{public}zu", bundleSettingInfo.excludeInfos.size());
+    HILOGI("Parse %{public}s success, size is %{public}zu", key, values.size());
+}
+
+static void ParseExcludeInfos(cJSON *root, BJsonUtil::BundleSettingInfo &bundleSettingInfo)
+{
+    ParseStringArray(root, "excludeInfos", bundleSettingInfo.excludeInfos);
+}
+
+static void ParseRestorePaths(cJSON *root, BJsonUtil::BundleSettingInfo &bundleSettingInfo)
+{
+    ParseStringArray(root, "restorePaths", bundleSettingInfo.restorePaths);
 }
 
 static void ParseBatchSize(cJSON *root, BJsonUtil::BundleSettingInfo &bundleSettingInfo)
@@ -322,6 +332,7 @@ void BJsonUtil::ParseBundleInfoJson(const std::string &bundleInfo, std::vector<B
     ParseBackupScene(root, bundleDetailInfo);
     ParseSupportWithoutTar(root, bundleSettingInfo);
     ParseExcludeInfos(root, bundleSettingInfo);
+    ParseRestorePaths(root, bundleSettingInfo);
     ParseBatchSize(root, bundleSettingInfo);
     if (!ParseBundleInfos(root, bundleDetails, bundleDetailInfo, userId)) {
         cJSON_Delete(root);
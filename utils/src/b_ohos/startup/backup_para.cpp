@@ -15,11 +15,15 @@
 
 #include "b_ohos/startup/backup_para.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <thread>
 #include <tuple>
 
+#include <unistd.h>
+
 #include "b_error/b_error.h"
 #include "b_resources/b_constants.h"
 #include "filemgmt_libhilog.h"
@@ -37,13 +41,13 @@ const char* BACKUP_DEBUG_STATE = "sys.backup.check.enable";
  */
 static tuple<bool, string> GetConfigParameterValue(const string &key, uint32_t len)
 {
-    char configParam[] = "false";
-    int length = GetParameter(key.c_str(), "", configParam, len + 1);
+    string configParam(len + 1, '\0');
+    int length = GetParameter(key.c_str(), "", configParam.data(), len + 1);
     if (length <= 0) {
         HILOGE("Fail to GetParameter name = %{public}s, length = %{public}d", key.c_str(), length);
         return {false, ""};
     }
-    return {true, configParam};
+    return {true, configParam.c_str()};
 }
 
 bool BackupPara::GetBackupDebugOverrideExtensionConfig()
@@ -109,4 +113,44 @@ bool BackupPara::GetBackupDebugState()
     std::string result(paraValue);
     return result == "true";
 }
-} // namespace OHOS::FileManagement::Backup
\ No newline at end of file
+
+uint32_t BackupPara::GetBackupPacketLaneCount()
+{
+    auto [getCfgParaValSucc, value] =
+        GetConfigParameterValue(BConstants::BACKUP_PACKET_LANE_COUNT_KEY, BConstants::BACKUP_PARA_VALUE_MAX);
+    if (getCfgParaValSucc) {
+        int laneCount = atoi(value.c_str());
+        if (laneCount > 0) {
+            return min(static_cast<uint32_t>(laneCount), BConstants::MAX_PACKET_LANE_COUNT);
+        }
+    }
+    long pageCount = sysconf(_SC_PHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGE_SIZE);
+    if (pageCount <= 0 || pageSize <= 0) {
+        return BConstants::DEFAULT_PACKET_LANE_COUNT;
+    }
+    uint64_t memSize = static_cast<uint64_t>(pageCount) * static_cast<uint64_t>(pageSize);
+    if (memSize < BConstants::PACKET_MULTI_LANE_MEM_THRESHOLD) {
+        return BConstants::DEFAULT_PACKET_LANE_COUNT;
+    }
+    uint32_t laneCount = std::thread::hardware_concurrency() / BConstants::CPU_COUNT_PER_PACKET_LANE;
+    return std::clamp(laneCount, BConstants::DEFAULT_PACKET_LANE_COUNT, BConstants::MAX_PACKET_LANE_COUNT);
+}
+
+bool BackupPara::GetBackupTraceEnable()
+{
+    auto [getCfgParaValSucc, value] =
+        GetConfigParameterValue(BConstants::BACKUP_TRACE_ENABLE_KEY, BConstants::BACKUP_PARA_VALUE_MAX);
+    return getCfgParaValSucc && value == "true";
+}
+
+BEncryption::DigestAlgorithm BackupPara::GetBackupTarDigestAlgorithm()
+{
+    auto [getCfgParaValSucc, value] =
+        GetConfigParameterValue(BConstants::BACKUP_TAR_DIGEST_KEY, BConstants::BACKUP_TAR_DIGEST_VALUE_MAX);
+    if (!getCfgParaValSucc) {
+        return BEncryption::DigestAlgorithm::NONE;
+    }
+    return BEncryption::ContentDigest::ParseAlgorithm(value);
+}
+} // namespace OHOS::FileManagement::Backup
@@ -16,12 +16,18 @@
 #include "b_process/b_process.h"
 
 #include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <csignal>
 #include <cstddef>
-#include <cstdio>
+#include <fcntl.h>
 #include <functional>
 #include <memory>
-#include <regex>
+#include <spawn.h>
+#include <string>
 #include <string_view>
+#include <sys/epoll.h>
+#include <sys/syscall.h>
 #include <sys/wait.h>
 #include <tuple>
 #include <unistd.h>
@@ -30,87 +36,326 @@
 #include "b_process/b_guard_signal.h"
 #include "errors.h"
 #include "filemgmt_libhilog.h"
-#include "securec.h"
 #include "unique_fd.h"
 
+extern char **environ;
+
 namespace OHOS::FileManagement::Backup {
 using namespace std;
 
-static tuple<bool, ErrCode> WaitForChild(pid_t pid,
-                                         unique_ptr<FILE, function<void(FILE *)>> pipeStream,
-                                         function<bool(string_view)> DetectFatalLog)
+namespace {
+constexpr size_t READ_BUF_LEN = 4096;
+constexpr int MAX_EPOLL_EVENTS = 2;
+constexpr int REAP_POLL_INTERVAL_MS = 10;
+const char *DEV_NULL = "/dev/null";
+} // namespace
+
+static int OpenPidFd(pid_t pid)
+{
+#ifdef SYS_pidfd_open
+    return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+#else
+    (void)pid;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+/**
+ * @brief 子进程中exec前的准备: 重定向标准输入输出、恢复信号、设置资源限制. 仅调用异步信号安全的函数
+ */
+static int PrepareForkedChild(int errFd, const vector<pair<int, rlim_t>> &rlimits)
 {
-    const int BUF_LEN = 1024;
-    auto buf = make_unique<char[]>(BUF_LEN);
-    int status = 0;
-
-    do {
-        regex reg("^\\W*$");
-        while ((void)memset_s(buf.get(), BUF_LEN, 0, BUF_LEN),
-               fgets(buf.get(), BUF_LEN - 1, pipeStream.get()) != nullptr) {
-            if (regex_match(buf.get(), reg)) {
+    int nullFd = open(DEV_NULL, O_RDWR);
+    if (nullFd < 0 || dup2(nullFd, STDIN_FILENO) < 0 || dup2(nullFd, STDOUT_FILENO) < 0 ||
+        dup2(errFd, STDERR_FILENO) < 0) {
+        return errno;
+    }
+    struct sigaction dfl = {};
+    dfl.sa_handler = SIG_DFL;
+    for (int sig = 1; sig < NSIG; sig++) {
+        sigaction(sig, &dfl, nullptr);
+    }
+    sigset_t sigs;
+    sigemptyset(&sigs);
+    sigprocmask(SIG_SETMASK, &sigs, nullptr);
+    for (auto &[resource, limit] : rlimits) {
+        struct rlimit rl = {limit, limit};
+        if (setrlimit(static_cast<decltype(RLIMIT_NOFILE)>(resource), &rl) != 0) {
+            return errno;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 需要资源限制时以fork启动, 在子进程exec前设置限制, 使限制对命令的整个生命周期生效.
+ * exec失败时通过CLOEXEC管道把errno传回父进程
+ */
+static pid_t ForkChild(vector<char *> &argv, int errFd, const vector<pair<int, rlim_t>> &rlimits, int &spawnErrno)
+{
+    int statusPipe[2];
+    if (pipe2(statusPipe, O_CLOEXEC) < 0) {
+        spawnErrno = errno;
+        return -1;
+    }
+    UniqueFd statusRead(statusPipe[0]);
+    UniqueFd statusWrite(statusPipe[1]);
+    pid_t pid = fork();
+    if (pid == 0) {
+        int err = PrepareForkedChild(errFd, rlimits);
+        if (err == 0) {
+            execvp(argv[0], argv.data());
+            err = errno;
+        }
+        (void)!write(statusWrite, &err, sizeof(err));
+        _exit(err);
+    }
+    if (pid == -1) {
+        spawnErrno = errno;
+        return -1;
+    }
+    statusWrite.Reset();
+    int err = 0;
+    ssize_t len = -1;
+    while ((len = read(statusRead, &err, sizeof(err))) == -1 && errno == EINTR) {
+    }
+    if (len == static_cast<ssize_t>(sizeof(err))) {
+        while (waitpid(pid, nullptr, 0) == -1 && errno == EINTR) {
+        }
+        spawnErrno = err;
+        return -1;
+    }
+    spawnErrno = 0;
+    return pid;
+}
+
+static pid_t SpawnChild(const vector<string_view> &argvSv,
+                        int errFd,
+                        const vector<pair<int, rlim_t>> &rlimits,
+                        int &spawnErrno)
+{
+    if (argvSv.empty()) {
+        spawnErrno = EINVAL;
+        return -1;
+    }
+    vector<string> args(argvSv.begin(), argvSv.end());
+    vector<char *> argv;
+    for (auto &arg : args) {
+        argv.push_back(arg.data());
+    }
+    argv.push_back(nullptr);
+    if (!rlimits.empty()) {
+        return ForkChild(argv, errFd, rlimits, spawnErrno);
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawnattr_init(&attr);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, DEV_NULL, O_RDONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, DEV_NULL, O_WRONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, errFd, STDERR_FILENO);
+    // 子进程恢复默认信号处理且不屏蔽任何信号, 避免继承父进程忽略的SIGPIPE等
+    sigset_t sigs;
+    sigfillset(&sigs);
+    posix_spawnattr_setsigdefault(&attr, &sigs);
+    sigemptyset(&sigs);
+    posix_spawnattr_setsigmask(&attr, &sigs);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK);
+
+    pid_t pid = -1;
+    spawnErrno = posix_spawnp(&pid, argv[0], &actions, &attr, argv.data(), environ);
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&actions);
+    return spawnErrno == 0 ? pid : -1;
+}
+
+/**
+ * @brief 跟踪一个子进程直至退出: 按行转发stderr, 处理超时和严重错误
+ */
+class ChildWatcher {
+public:
+    ChildWatcher(pid_t pid, int outFd, function<bool(string_view)> detectFatalLog)
+        : pid_(pid), outFd_(outFd), detectFatalLog_(move(detectFatalLog))
+    {
+    }
+
+    void Watch(int32_t timeoutMs, BProcessResult &result)
+    {
+        UniqueFd epollFd(epoll_create1(EPOLL_CLOEXEC));
+        UniqueFd pidFd(OpenPidFd(pid_));
+        if (epollFd < 0 || !AddToEpoll(epollFd, outFd_) || (pidFd >= 0 && !AddToEpoll(epollFd, pidFd))) {
+            Kill(result);
+            throw BError(BError::Codes::UTILS_INTERRUPTED_PROCESS, generic_category().message(errno));
+        }
+        auto deadline = chrono::steady_clock::now() + chrono::milliseconds(timeoutMs);
+        bool exited = false;
+        bool outputOpen = true;
+        while (!exited || outputOpen) {
+            if (!exited && (exited = Reap(WNOHANG, result)) && pidFd >= 0) {
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, pidFd, nullptr);
+            }
+            int waitMs = exited ? 0 : -1;
+            if (!exited && timeoutMs >= 0) {
+                auto left = chrono::duration_cast<chrono::milliseconds>(deadline - chrono::steady_clock::now());
+                if (left.count() <= 0) {
+                    HILOGE("child process timed out after %{public}d ms", timeoutMs);
+                    result.timedOut = true;
+                    Kill(result);
+                    return;
+                }
+                waitMs = static_cast<int>(left.count());
+            }
+            if (!exited && pidFd < 0) {
+                waitMs = waitMs < 0 ? REAP_POLL_INTERVAL_MS : min(waitMs, REAP_POLL_INTERVAL_MS);
+            }
+            struct epoll_event events[MAX_EPOLL_EVENTS] = {};
+            int n = epoll_wait(epollFd, events, MAX_EPOLL_EVENTS, waitMs);
+            if (n < 0 && errno != EINTR) {
+                Kill(result);
+                throw BError(BError::Codes::UTILS_INTERRUPTED_PROCESS, generic_category().message(errno));
+            }
+            if (n == 0 && exited) {
+                break;
+            }
+            for (int i = 0; i < n; i++) {
+                if (events[i].data.fd != outFd_ || !outputOpen) {
+                    continue;
+                }
+                if (!ReadOutput(outputOpen)) {
+                    result.fatalLog = true;
+                    Kill(result);
+                    return;
+                }
+                // 写端已全部关闭, 不再监听, 否则EPOLLHUP持续就绪导致空转
+                if (!outputOpen) {
+                    epoll_ctl(epollFd, EPOLL_CTL_DEL, outFd_, nullptr);
+                }
+            }
+        }
+        if (FlushLine(string_view(pending_))) {
+            result.fatalLog = true;
+        }
+    }
+
+private:
+    static bool AddToEpoll(int epollFd, int fd)
+    {
+        struct epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) == 0;
+    }
+
+    // 读取当前可读的全部输出, 检测到严重错误时返回false
+    bool ReadOutput(bool &outputOpen)
+    {
+        char buf[READ_BUF_LEN];
+        while (true) {
+            ssize_t len = read(outFd_, buf, sizeof(buf));
+            if (len < 0 && errno == EINTR) {
                 continue;
             }
-            HILOGE("child process output error: %{public}s", buf.get());
-            if (DetectFatalLog && DetectFatalLog(string_view(buf.get()))) {
-                return {true, EPERM};
+            if (len <= 0) {
+                outputOpen = len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+                return true;
+            }
+            pending_.append(buf, static_cast<size_t>(len));
+            size_t begin = 0;
+            size_t end = 0;
+            while ((end = pending_.find('\n', begin)) != string::npos) {
+                if (FlushLine(string_view(pending_).substr(begin, end - begin))) {
+                    return false;
+                }
+                begin = end + 1;
             }
+            pending_.erase(0, begin);
         }
+    }
+
+    bool FlushLine(string_view line)
+    {
+        if (none_of(line.begin(), line.end(), [](char c) { return isalnum(static_cast<unsigned char>(c)) || c == '_'; })) {
+            return false;
+        }
+        string text(line);
+        HILOGE("child process output error: %{public}s", text.c_str());
+        return detectFatalLog_ && detectFatalLog_(text);
+    }
 
-        if (waitpid(pid, &status, 0) == -1) {
+    bool Reap(int options, BProcessResult &result)
+    {
+        int status = 0;
+        pid_t ret = -1;
+        while ((ret = waitpid(pid_, &status, options)) == -1 && errno == EINTR) {
+        }
+        if (ret == -1) {
             throw BError(BError::Codes::UTILS_INVAL_PROCESS_ARG, generic_category().message(errno));
-        } else if (WIFEXITED(status)) {
-            return {false, WEXITSTATUS(status)};
+        }
+        if (ret == 0) {
+            return false;
+        }
+        if (WIFEXITED(status)) {
+            result.exitCode = WEXITSTATUS(status);
         } else if (WIFSIGNALED(status)) {
-            // 因某种信号中断获取状态
-            // 异常机制存在问题，导致应用在正常的错误下Crash。为确保测试顺利展开，此处暂时屏蔽崩溃错误。
-            HILOGE("some fatal errors occurred, child process is killed by a signal.");
-            return {true, EPERM};
+            result.termSignal = WTERMSIG(status);
         }
-    } while (!WIFEXITED(status) && !WIFSIGNALED(status));
+        return true;
+    }
 
-    HILOGE("If you look at me, there are some fatal errors occurred!!!");
-    return {true, EPERM};
-}
+    void Kill(BProcessResult &result)
+    {
+        kill(pid_, SIGKILL);
+        Reap(0, result);
+    }
 
-tuple<bool, ErrCode> BProcess::ExecuteCmd(vector<string_view> argvSv, function<bool(string_view)> DetectFatalLog)
-{
-    vector<const char *> argv;
-    auto getStringViewData = [](const auto &arg) { return arg.data(); };
-    transform(argvSv.begin(), argvSv.end(), back_inserter(argv), getStringViewData);
-    argv.push_back(nullptr);
+    pid_t pid_;
+    int outFd_;
+    function<bool(string_view)> detectFatalLog_;
+    string pending_;
+};
 
+BProcessResult BProcess::Run(const vector<string_view> &argv,
+                             const BProcessOptions &options,
+                             function<bool(string_view)> DetectFatalLog)
+{
     // 临时将SIGCHLD恢复成默认值，从而能够从作为僵尸进程的子进程中获得返回值
     BGuardSignal guard(SIGCHLD);
 
     int pipeFd[2];
-    if (pipe(pipeFd) < 0) {
+    if (pipe2(pipeFd, O_CLOEXEC) < 0) {
         throw BError(BError::Codes::UTILS_INTERRUPTED_PROCESS, generic_category().message(errno));
     }
-
-    pid_t pid = 0;
-    if ((pid = fork()) == 0) {
-        close(STDIN_FILENO);
-        close(STDOUT_FILENO);
-        close(pipeFd[0]);
-        UniqueFd fd(pipeFd[1]);
-        if (dup2(pipeFd[1], STDERR_FILENO) == -1) {
-            throw BError(BError::Codes::UTILS_INTERRUPTED_PROCESS, generic_category().message(errno));
-        }
-        exit((execvp(argv[0], const_cast<char **>(argv.data())) == -1) ? errno : 0);
+    UniqueFd readFd(pipeFd[0]);
+    UniqueFd writeFd(pipeFd[1]);
+    if (fcntl(readFd, F_SETFL, fcntl(readFd, F_GETFL) | O_NONBLOCK) == -1) {
+        throw BError(BError::Codes::UTILS_INTERRUPTED_PROCESS, generic_category().message(errno));
     }
 
-    UniqueFd fd(pipeFd[0]);
-    close(pipeFd[1]);
+    BProcessResult result;
+    pid_t pid = SpawnChild(argv, writeFd, options.rlimits, result.spawnErrno);
+    writeFd.Reset();
     if (pid == -1) {
-        throw BError(BError::Codes::UTILS_INVAL_PROCESS_ARG, generic_category().message(errno));
-    }
-    unique_ptr<FILE, function<void(FILE *)>> pipeStream {fdopen(pipeFd[0], "r"), fclose};
-    if (!pipeStream) {
-        throw BError(errno);
+        HILOGE("Failed to spawn child process, errno = %{public}d", result.spawnErrno);
+        return result;
     }
-    fd.Release();
+    ChildWatcher(pid, readFd, move(DetectFatalLog)).Watch(options.timeoutMs, result);
+    return result;
+}
 
-    return WaitForChild(pid, move(pipeStream), DetectFatalLog);
+tuple<bool, ErrCode> BProcess::ExecuteCmd(vector<string_view> argv, function<bool(string_view)> DetectFatalLog)
+{
+    BProcessResult result = Run(argv, {}, move(DetectFatalLog));
+    if (result.spawnErrno != 0) {
+        // 与子进程中exec失败时以errno退出的旧行为保持一致
+        return {false, result.spawnErrno};
+    }
+    if (result.fatalLog || result.termSignal != 0) {
+        // 异常机制存在问题，导致应用在正常的错误下Crash。为确保测试顺利展开，此处暂时屏蔽崩溃错误。
+        HILOGE("some fatal errors occurred, signal = %{public}d", result.termSignal);
+        return {true, EPERM};
+    }
+    return {false, result.exitCode};
 }
-} // namespace OHOS::FileManagement::Backup
\ No newline at end of file
+} // namespace OHOS::FileManagement::Backup
@@ -13,6 +13,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <vector>
 
 #include "b_radar/radar_app_statistic.h"
@@ -63,27 +64,27 @@ void FileTypeStat::UpdateStat(std::string extension, uint64_t size)
     typeInfoList_[idx].size += size;
 }
 
-void FileSizeStat::UpdateStat(uint64_t fileSize)
+uint8_t FileSizeStat::GetIndexBySize(uint64_t fileSize)
 {
     if (fileSize < ONE_MB) {
-        sizeInfoList_[TINY].count++;
-        sizeInfoList_[TINY].size += fileSize;
+        return TINY;
     } else if (fileSize < TWO_MB) {
-        sizeInfoList_[SMALL].count++;
-        sizeInfoList_[SMALL].size += fileSize;
+        return SMALL;
     } else if (fileSize < TEN_MB) {
-        sizeInfoList_[MEDIUM].count++;
-        sizeInfoList_[MEDIUM].size += fileSize;
+        return MEDIUM;
     } else if (fileSize < HUNDRED_MB) {
-        sizeInfoList_[BIG].count++;
-        sizeInfoList_[BIG].size += fileSize;
+        return BIG;
     } else if (fileSize < ONE_GB) {
-        sizeInfoList_[GREAT_BIG].count++;
-        sizeInfoList_[GREAT_BIG].size += fileSize;
-    } else {
-        sizeInfoList_[GIANT].count++;
-        sizeInfoList_[GIANT].size += fileSize;
+        return GREAT_BIG;
     }
+    return GIANT;
+}
+
+void FileSizeStat::UpdateStat(uint64_t fileSize)
+{
+    uint8_t idx = GetIndexBySize(fileSize);
+    sizeInfoList_[idx].count++;
+    sizeInfoList_[idx].size += fileSize;
 }
 
 std::string FileErrorList::ToJsonString()
@@ -112,6 +113,7 @@ void FileErrorList::UpdateFileList(const std::string &fileName, int32_t errCode)
 
 void RadarAppStatistic::ReportBackup(const std::string &func, int32_t errorCode, std::string errMsg)
 {
+    MergeFileStat();
     HiSysEventWrite(
         DOMAIN,
         BACKUP_RESTORE_APP_STATISTIC,
@@ -139,6 +141,7 @@ void RadarAppStatistic::ReportBackup(const std::string &func, int32_t errorCode,
         ON_BACKUPEX_SPEND, onBackupexSpend_.GetSpan(),
         TAR_SPEND, tarSpend_,
         HASH_SPEND, static_cast<uint32_t>(hashSpendUS_ / MS_TO_US),
+        BIG_FILE_SPEND, bigFileSpend_,
         SCAN_FILE_SPEND, scanFileSpend_.GetSpan(),
         SEND_RATE_ZERO_SPAN, static_cast<uint32_t>(sendRateZeroSpendUS_ / MS_TO_US),
         DO_BACKUP_SPEND, doBackupSpend_.GetSpan(),
@@ -197,8 +200,52 @@ void RadarAppStatistic::UpdateSendRateZeroSpend()
 
 void RadarAppStatistic::UpdateFileDist(std::string fileExtension, uint64_t fileSize)
 {
-    fileSizeDist_.UpdateStat(fileSize);
-    fileTypeDist_.UpdateStat(fileExtension, fileSize);
+    UpdateFileStat(fileExtension, fileSize, 0);
+}
+
+FileStatShard &RadarAppStatistic::GetLocalShard()
+{
+    static std::atomic<uint32_t> nextShard {0};
+    thread_local uint32_t shardIdx = nextShard.fetch_add(1, std::memory_order_relaxed) % FILE_STAT_SHARD_COUNT;
+    return fileStatShards_[shardIdx];
+}
+
+void RadarAppStatistic::UpdateFileStat(const std::string &fileExtension, uint64_t fileSize, uint32_t dirDepth)
+{
+    FileStatShard &shard = GetLocalShard();
+    uint8_t typeIdx = fileTypeDist_.GetIndexByType(fileExtension);
+    shard.typeCount[typeIdx].fetch_add(1, std::memory_order_relaxed);
+    shard.typeSize[typeIdx].fetch_add(fileSize, std::memory_order_relaxed);
+    uint8_t sizeIdx = FileSizeStat::GetIndexBySize(fileSize);
+    shard.sizeCount[sizeIdx].fetch_add(1, std::memory_order_relaxed);
+    shard.sizeSize[sizeIdx].fetch_add(fileSize, std::memory_order_relaxed);
+    uint32_t maxDepth = shard.maxDirDepth.load(std::memory_order_relaxed);
+    while (dirDepth > maxDepth &&
+        !shard.maxDirDepth.compare_exchange_weak(maxDepth, dirDepth, std::memory_order_relaxed)) {
+    }
+}
+
+void RadarAppStatistic::MergeFileStat()
+{
+    ItemInfo *typeList = fileTypeDist_.GetListPtr();
+    ItemInfo *sizeList = fileSizeDist_.GetListPtr();
+    for (uint32_t i = 0; i < TYPE_DEF_COUNT; i++) {
+        typeList[i] = {0, 0};
+    }
+    for (uint32_t i = 0; i < SIZE_DEF_COUNT; i++) {
+        sizeList[i] = {0, 0};
+    }
+    for (const auto &shard : fileStatShards_) {
+        for (uint32_t i = 0; i < TYPE_DEF_COUNT; i++) {
+            typeList[i].count += shard.typeCount[i].load(std::memory_order_relaxed);
+            typeList[i].size += shard.typeSize[i].load(std::memory_order_relaxed);
+        }
+        for (uint32_t i = 0; i < SIZE_DEF_COUNT; i++) {
+            sizeList[i].count += shard.sizeCount[i].load(std::memory_order_relaxed);
+            sizeList[i].size += shard.sizeSize[i].load(std::memory_order_relaxed);
+        }
+        dirDepth_ = std::max(dirDepth_, shard.maxDirDepth.load(std::memory_order_relaxed));
+    }
 }
 
 void RadarAppStatistic::ReportError(const std::string &func, RadarError error)
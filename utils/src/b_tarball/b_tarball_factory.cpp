@@ -30,6 +30,7 @@
 #include "b_error/b_error.h"
 #include "b_error/b_excep_utils.h"
 #include "b_tarball/b_tarball_cmdline.h"
+#include "b_tarball/b_tarball_native.h"
 
 namespace OHOS::FileManagement::Backup {
 using namespace std;
@@ -156,10 +157,30 @@ static unique_ptr<BTarballFactory::Impl> BindCmdline(string_view tarballDir, str
     });
 }
 
+/**
+ * @brief 绑定进程内实现的打包器
+ *
+ * @param tarballDir taball路径
+ * @param tarballName taball文件名
+ * @return unique_ptr<BTarballFactory::Impl> 打包器实现，包括tar、untar和设置进度回调三种方法
+ * @see GetTarballDirAndName
+ */
+static unique_ptr<BTarballFactory::Impl> BindNative(string_view tarballDir, string_view tarballName)
+{
+    auto ptr = make_shared<BTarballNative>(tarballDir, tarballName);
+
+    return make_unique<BTarballFactory::Impl>(BTarballFactory::Impl {
+        .tar = bind(&BTarballNative::Tar, ptr, placeholders::_1, placeholders::_2, placeholders::_3),
+        .untar = bind(&BTarballNative::Untar, ptr, placeholders::_1),
+        .setProgress = bind(&BTarballNative::SetProgressCallback, ptr, placeholders::_1),
+    });
+}
+
 unique_ptr<BTarballFactory::Impl> BTarballFactory::Create(string_view implType, string_view tarballPath)
 {
     static map<string_view, function<unique_ptr<BTarballFactory::Impl>(string_view, string_view)>> mapType2Tarball = {
         {"cmdline", BindCmdline},
+        {"native", BindNative},
     };
 
     try {
@@ -0,0 +1,850 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "b_tarball/b_tarball_native.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <functional>
+#include <memory>
+#include <set>
+#include <sys/time.h>
+#include <tuple>
+#include <unistd.h>
+#include <unordered_set>
+
+#include "b_error/b_error.h"
+#include "b_filesystem/b_dir.h"
+#include "filemgmt_libhilog.h"
+#include "securec.h"
+#include "unique_fd.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+
+namespace {
+constexpr size_t BLOCK_SIZE = 512;
+constexpr size_t IO_BUFF_SIZE = 512 * 1024;
+constexpr size_t NAME_FIELD_LEN = 100;
+constexpr size_t PREFIX_FIELD_LEN = 155;
+constexpr size_t CHKSUM_DIGITS = 6;
+constexpr int OCTAL = 8;
+constexpr int BITS_PER_BYTE = 8;
+constexpr unsigned char BASE256_FLAG = 0x80;
+constexpr mode_t PERMISSION_MASK = 07777;
+constexpr mode_t DIR_CREATE_MODE = 0771;
+constexpr mode_t TARBALL_CREATE_MODE = 0660;
+const string LONG_LINK_NAME = "././@LongLink";
+const string POSIX_MAGIC = string("ustar\0", 6);
+const string POSIX_VERSION = "00";
+
+constexpr char REGTYPE = '0';
+constexpr char AREGTYPE = '\0';
+constexpr char LNKTYPE = '1';
+constexpr char SYMTYPE = '2';
+constexpr char DIRTYPE = '5';
+constexpr char FIFOTYPE = '6';
+constexpr char CONTTYPE = '7';
+constexpr char GNUTYPE_LONGNAME = 'L';
+constexpr char GNUTYPE_LONGLINK = 'K';
+constexpr char PAX_EXTENDED = 'x';
+constexpr char PAX_GLOBAL = 'g';
+
+struct TarHeader {
+    char name[NAME_FIELD_LEN];
+    char mode[8];
+    char uid[8];
+    char gid[8];
+    char size[12];
+    char mtime[12];
+    char chksum[8];
+    char typeFlag;
+    char linkName[NAME_FIELD_LEN];
+    char magic[6];
+    char version[2];
+    char uname[32];
+    char gname[32];
+    char devMajor[8];
+    char devMinor[8];
+    char prefix[PREFIX_FIELD_LEN];
+    char pad[12];
+};
+static_assert(sizeof(TarHeader) == BLOCK_SIZE, "tar header must be one block");
+
+uint64_t PaddingOf(uint64_t size)
+{
+    return (BLOCK_SIZE - size % BLOCK_SIZE) % BLOCK_SIZE;
+}
+
+/**
+ * @brief 数值字段编码, 放得下时使用八进制, 否则使用GNU base-256编码
+ */
+void EncodeNumber(char *field, size_t len, uint64_t value)
+{
+    uint64_t limit = 1;
+    for (size_t i = 0; i + 1 < len; i++) {
+        limit *= OCTAL;
+    }
+    if (value < limit) {
+        for (size_t i = len - 1; i > 0; i--) {
+            field[i - 1] = static_cast<char>('0' + value % OCTAL);
+            value /= OCTAL;
+        }
+        field[len - 1] = '\0';
+        return;
+    }
+    (void)memset_s(field, len, 0, len);
+    for (size_t i = len - 1; i > 0 && value != 0; i--) {
+        field[i] = static_cast<char>(value & 0xFF);
+        value >>= BITS_PER_BYTE;
+    }
+    field[0] = static_cast<char>(BASE256_FLAG);
+}
+
+bool DecodeNumber(const char *field, size_t len, uint64_t &value)
+{
+    value = 0;
+    if (static_cast<unsigned char>(field[0]) & BASE256_FLAG) {
+        for (size_t i = 1; i < len; i++) {
+            if (value >> (sizeof(value) * BITS_PER_BYTE - BITS_PER_BYTE)) {
+                return false;
+            }
+            value = (value << BITS_PER_BYTE) | static_cast<unsigned char>(field[i]);
+        }
+        return true;
+    }
+    size_t i = 0;
+    while (i < len && field[i] == ' ') {
+        i++;
+    }
+    for (; i < len && field[i] >= '0' && field[i] <= '7'; i++) {
+        value = value * OCTAL + static_cast<uint64_t>(field[i] - '0');
+    }
+    return i == len || field[i] == '\0' || field[i] == ' ';
+}
+
+void FillChecksum(TarHeader &hdr)
+{
+    (void)memset_s(hdr.chksum, sizeof(hdr.chksum), ' ', sizeof(hdr.chksum));
+    uint64_t sum = 0;
+    auto *bytes = reinterpret_cast<const unsigned char *>(&hdr);
+    for (size_t i = 0; i < BLOCK_SIZE; i++) {
+        sum += bytes[i];
+    }
+    EncodeNumber(hdr.chksum, CHKSUM_DIGITS + 1, sum);
+    hdr.chksum[CHKSUM_DIGITS + 1] = ' ';
+}
+
+bool VerifyChecksum(const TarHeader &hdr)
+{
+    uint64_t expected = 0;
+    if (!DecodeNumber(hdr.chksum, sizeof(hdr.chksum), expected)) {
+        return false;
+    }
+    auto *bytes = reinterpret_cast<const unsigned char *>(&hdr);
+    uint64_t unsignedSum = 0;
+    int64_t signedSum = 0;
+    for (size_t i = 0; i < BLOCK_SIZE; i++) {
+        bool inChksum = i >= offsetof(TarHeader, chksum) && i < offsetof(TarHeader, chksum) + sizeof(hdr.chksum);
+        unsigned char byte = inChksum ? ' ' : bytes[i];
+        unsignedSum += byte;
+        signedSum += static_cast<signed char>(byte);
+    }
+    return expected == unsignedSum || static_cast<int64_t>(expected) == signedSum;
+}
+
+bool IsZeroBlock(const char *block)
+{
+    return all_of(block, block + BLOCK_SIZE, [](char c) { return c == '\0'; });
+}
+
+/**
+ * @brief 写入定长头部字段, 超出部分截断(超长路径已由'L'/'K'记录给出)
+ */
+void CopyField(char *field, size_t len, const string &value)
+{
+    size_t count = min(len, value.size());
+    if (count > 0 && memcpy_s(field, len, value.data(), count) != EOK) {
+        throw BError(BError::Codes::UTILS_TARBALL_PACK_FAIL, "Failed to fill tar header");
+    }
+}
+
+string FieldToString(const char *field, size_t len)
+{
+    return string(field, strnlen(field, len));
+}
+
+/**
+ * @brief 归档内路径规范化: 去掉开头的'/'和'./', 含有'..'时返回false
+ */
+bool SanitizeName(const string &name, string &out)
+{
+    out.clear();
+    size_t pos = 0;
+    while (pos < name.size()) {
+        size_t end = name.find('/', pos);
+        if (end == string::npos) {
+            end = name.size();
+        }
+        string_view part(name.data() + pos, end - pos);
+        pos = end + 1;
+        if (part.empty() || part == ".") {
+            continue;
+        }
+        if (part == "..") {
+            return false;
+        }
+        if (!out.empty()) {
+            out += '/';
+        }
+        out += part;
+    }
+    return true;
+}
+
+string JoinPath(string_view root, string_view name)
+{
+    string path(root);
+    if (path.empty() || path.back() != '/') {
+        path += '/';
+    }
+    path += name;
+    return path;
+}
+
+class TarWriter {
+public:
+    explicit TarWriter(int fd) : fd_(fd)
+    {
+        buf_.reserve(IO_BUFF_SIZE);
+    }
+
+    void Write(const void *data, size_t len)
+    {
+        auto *bytes = static_cast<const char *>(data);
+        while (len > 0) {
+            size_t count = min(len, IO_BUFF_SIZE - buf_.size());
+            buf_.insert(buf_.end(), bytes, bytes + count);
+            bytes += count;
+            len -= count;
+            if (buf_.size() == IO_BUFF_SIZE) {
+                Flush();
+            }
+        }
+    }
+
+    void WriteZeros(size_t len)
+    {
+        static const char zeros[BLOCK_SIZE] = {0};
+        while (len > 0) {
+            size_t count = min(len, BLOCK_SIZE);
+            Write(zeros, count);
+            len -= count;
+        }
+    }
+
+    /**
+     * @brief 直接从文件读入写缓冲, 返回实际读到的字节数
+     */
+    uint64_t CopyFrom(int srcFd, uint64_t size)
+    {
+        uint64_t copied = 0;
+        while (copied < size) {
+            if (buf_.size() == IO_BUFF_SIZE) {
+                Flush();
+            }
+            size_t room = static_cast<size_t>(min<uint64_t>(IO_BUFF_SIZE - buf_.size(), size - copied));
+            size_t used = buf_.size();
+            buf_.resize(used + room);
+            ssize_t ret = TEMP_FAILURE_RETRY(read(srcFd, buf_.data() + used, room));
+            buf_.resize(used + (ret > 0 ? static_cast<size_t>(ret) : 0));
+            if (ret <= 0) {
+                break;
+            }
+            copied += static_cast<uint64_t>(ret);
+        }
+        return copied;
+    }
+
+    void Flush()
+    {
+        size_t written = 0;
+        while (written < buf_.size()) {
+            ssize_t ret = TEMP_FAILURE_RETRY(write(fd_, buf_.data() + written, buf_.size() - written));
+            if (ret <= 0) {
+                throw BError(BError::Codes::UTILS_TARBALL_PACK_FAIL,
+                             string("Failed to write tarball: ") + strerror(errno));
+            }
+            written += static_cast<size_t>(ret);
+        }
+        buf_.clear();
+    }
+
+private:
+    int fd_;
+    vector<char> buf_;
+};
+
+class TarReader {
+public:
+    explicit TarReader(int fd) : fd_(fd)
+    {
+        buf_.resize(IO_BUFF_SIZE);
+    }
+
+    /**
+     * @brief 读取len字节, 数据不足时返回false
+     */
+    bool Read(void *data, size_t len)
+    {
+        auto *bytes = static_cast<char *>(data);
+        while (len > 0) {
+            if (pos_ == end_ && !Fill()) {
+                return false;
+            }
+            size_t count = min(len, end_ - pos_);
+            if (bytes != nullptr) {
+                if (memcpy_s(bytes, len, buf_.data() + pos_, count) != EOK) {
+                    throw BError(BError::Codes::UTILS_TARBALL_UNPACK_FAIL, "Failed to copy tarball data");
+                }
+                bytes += count;
+            }
+            pos_ += count;
+            offset_ += count;
+            len -= count;
+        }
+        return true;
+    }
+
+    bool Skip(uint64_t len)
+    {
+        while (len > 0) {
+            size_t count = static_cast<size_t>(min<uint64_t>(len, IO_BUFF_SIZE));
+            if (!Read(nullptr, count)) {
+                return false;
+            }
+            len -= count;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 将len字节写入dstFd, dstFd无效时仅跳过数据. 归档数据不足时返回false
+     */
+    bool CopyTo(int dstFd, uint64_t len, bool &writeOk)
+    {
+        writeOk = true;
+        while (len > 0) {
+            if (pos_ == end_ && !Fill()) {
+                return false;
+            }
+            size_t count = static_cast<size_t>(min<uint64_t>(len, end_ - pos_));
+            size_t written = 0;
+            while (dstFd >= 0 && writeOk && written < count) {
+                ssize_t ret = TEMP_FAILURE_RETRY(write(dstFd, buf_.data() + pos_ + written, count - written));
+                writeOk = ret > 0;
+                written += ret > 0 ? static_cast<size_t>(ret) : 0;
+            }
+            pos_ += count;
+            offset_ += count;
+            len -= count;
+        }
+        return true;
+    }
+
+    uint64_t Offset() const
+    {
+        return offset_;
+    }
+
+private:
+    bool Fill()
+    {
+        ssize_t ret = TEMP_FAILURE_RETRY(read(fd_, buf_.data(), buf_.size()));
+        if (ret < 0) {
+            throw BError(BError::Codes::UTILS_TARBALL_UNPACK_FAIL,
+                         string("Failed to read tarball: ") + strerror(errno));
+        }
+        pos_ = 0;
+        end_ = static_cast<size_t>(ret);
+        return ret > 0;
+    }
+
+    int fd_;
+    vector<char> buf_;
+    size_t pos_ = 0;
+    size_t end_ = 0;
+    uint64_t offset_ = 0;
+};
+
+void WriteLongRecord(TarWriter &writer, char type, const string &value)
+{
+    TarHeader hdr {};
+    CopyField(hdr.name, sizeof(hdr.name), LONG_LINK_NAME);
+    EncodeNumber(hdr.mode, sizeof(hdr.mode), 0);
+    EncodeNumber(hdr.uid, sizeof(hdr.uid), 0);
+    EncodeNumber(hdr.gid, sizeof(hdr.gid), 0);
+    EncodeNumber(hdr.size, sizeof(hdr.size), value.size() + 1);
+    EncodeNumber(hdr.mtime, sizeof(hdr.mtime), 0);
+    hdr.typeFlag = type;
+    CopyField(hdr.magic, sizeof(hdr.magic), POSIX_MAGIC);
+    CopyField(hdr.version, sizeof(hdr.version), POSIX_VERSION);
+    FillChecksum(hdr);
+    writer.Write(&hdr, sizeof(hdr));
+    writer.Write(value.c_str(), value.size() + 1);
+    writer.WriteZeros(PaddingOf(value.size() + 1));
+}
+
+void WriteHeader(TarWriter &writer, const string &name, const struct stat &st, char type, const string &link,
+                 uint64_t size)
+{
+    if (name.size() >= NAME_FIELD_LEN) {
+        WriteLongRecord(writer, GNUTYPE_LONGNAME, name);
+    }
+    if (link.size() >= NAME_FIELD_LEN) {
+        WriteLongRecord(writer, GNUTYPE_LONGLINK, link);
+    }
+    TarHeader hdr {};
+    CopyField(hdr.name, NAME_FIELD_LEN - 1, name);
+    EncodeNumber(hdr.mode, sizeof(hdr.mode), st.st_mode & PERMISSION_MASK);
+    EncodeNumber(hdr.uid, sizeof(hdr.uid), st.st_uid);
+    EncodeNumber(hdr.gid, sizeof(hdr.gid), st.st_gid);
+    EncodeNumber(hdr.size, sizeof(hdr.size), size);
+    EncodeNumber(hdr.mtime, sizeof(hdr.mtime), st.st_mtime > 0 ? static_cast<uint64_t>(st.st_mtime) : 0);
+    hdr.typeFlag = type;
+    CopyField(hdr.linkName, NAME_FIELD_LEN - 1, link);
+    CopyField(hdr.magic, sizeof(hdr.magic), POSIX_MAGIC);
+    CopyField(hdr.version, sizeof(hdr.version), POSIX_VERSION);
+    FillChecksum(hdr);
+    writer.Write(&hdr, sizeof(hdr));
+}
+
+/**
+ * @brief 打包单个文件, 源文件无法访问时跳过. 返回写入的文件内容字节数
+ */
+uint64_t PackOneEntry(TarWriter &writer, const string &fullPath, const string &name, const struct stat &st)
+{
+    if (S_ISDIR(st.st_mode)) {
+        WriteHeader(writer, name, st, DIRTYPE, "", 0);
+        return 0;
+    }
+    if (S_ISLNK(st.st_mode)) {
+        string link(static_cast<size_t>(PATH_MAX), '\0');
+        ssize_t len = readlink(fullPath.c_str(), link.data(), link.size());
+        if (len < 0) {
+            HILOGE("Failed to readlink, errno = %{public}d", errno);
+            return 0;
+        }
+        link.resize(static_cast<size_t>(len));
+        WriteHeader(writer, name, st, SYMTYPE, link, 0);
+        return 0;
+    }
+    UniqueFd fd(open(fullPath.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC));
+    struct stat fdSt = {};
+    if (fd < 0 || fstat(fd, &fdSt) != 0 || !S_ISREG(fdSt.st_mode)) {
+        HILOGE("Failed to open file to pack, errno = %{public}d", errno);
+        return 0;
+    }
+    uint64_t size = static_cast<uint64_t>(fdSt.st_size);
+    WriteHeader(writer, name, fdSt, REGTYPE, "", size);
+    uint64_t copied = writer.CopyFrom(fd, size);
+    if (copied < size) {
+        HILOGW("File shrank while packing, padding %{public}llu bytes",
+               static_cast<unsigned long long>(size - copied));
+        writer.WriteZeros(static_cast<size_t>(size - copied));
+    }
+    writer.WriteZeros(PaddingOf(size));
+    return size;
+}
+
+struct PaxAttrs {
+    string path;
+    string linkPath;
+    bool hasSize = false;
+    uint64_t size = 0;
+};
+
+void ParsePaxRecords(const string &data, PaxAttrs &attrs)
+{
+    size_t pos = 0;
+    while (pos < data.size()) {
+        size_t space = data.find(' ', pos);
+        if (space == string::npos) {
+            return;
+        }
+        size_t recLen = strtoull(data.c_str() + pos, nullptr, 10);
+        if (recLen == 0 || pos + recLen > data.size() || recLen <= space - pos + 1) {
+            return;
+        }
+        string record = data.substr(space + 1, recLen - (space - pos) - 2);
+        pos += recLen;
+        size_t eq = record.find('=');
+        if (eq == string::npos) {
+            continue;
+        }
+        string key = record.substr(0, eq);
+        string value = record.substr(eq + 1);
+        if (key == "path") {
+            attrs.path = value;
+        } else if (key == "linkpath") {
+            attrs.linkPath = value;
+        } else if (key == "size") {
+            attrs.hasSize = true;
+            attrs.size = strtoull(value.c_str(), nullptr, 10);
+        }
+    }
+}
+
+class TarExtractor {
+public:
+    TarExtractor(TarReader &reader, string_view root) : reader_(reader), root_(root) {}
+
+    /**
+     * @brief 解包一个条目, 读到归档结束标记时返回false
+     */
+    bool ExtractNext(string &entryName);
+
+    void FinishDirs()
+    {
+        for (auto it = dirs_.rbegin(); it != dirs_.rend(); ++it) {
+            auto &[path, mode, mtime] = *it;
+            struct timespec times[2] = {{0, UTIME_OMIT}, {mtime, 0}};
+            if (chmod(path.c_str(), mode) != 0 || utimensat(AT_FDCWD, path.c_str(), times, AT_SYMLINK_NOFOLLOW)) {
+                HILOGW("Failed to restore dir attributes, errno = %{public}d", errno);
+            }
+        }
+    }
+
+private:
+    string ReadLongValue(uint64_t size)
+    {
+        string value(static_cast<size_t>(size), '\0');
+        if (!reader_.Read(value.data(), value.size()) || !reader_.Skip(PaddingOf(size))) {
+            throw BError(BError::Codes::UTILS_TARBALL_UNPACK_FAIL, "Unexpected EOF in extended header");
+        }
+        value.resize(strnlen(value.c_str(), value.size()));
+        return value;
+    }
+
+    void EnsureParentDirs(const string &name);
+    void ExtractFile(const string &path, const TarHeader &hdr, uint64_t size);
+    void ExtractDir(const string &path, const TarHeader &hdr);
+    void ExtractLink(const string &path, char type, const string &linkName);
+
+    TarReader &reader_;
+    string root_;
+    unordered_set<string> checkedDirs_;
+    vector<tuple<string, mode_t, time_t>> dirs_;
+};
+
+void TarExtractor::EnsureParentDirs(const string &name)
+{
+    size_t pos = 0;
+    while ((pos = name.find('/', pos)) != string::npos) {
+        string dir = name.substr(0, pos++);
+        if (checkedDirs_.count(dir) != 0) {
+            continue;
+        }
+        string path = JoinPath(root_, dir);
+        struct stat st = {};
+        if (lstat(path.c_str(), &st) != 0) {
+            if (mkdir(path.c_str(), DIR_CREATE_MODE) != 0 && errno != EEXIST) {
+                throw BError(BError::Codes::UTILS_TARBALL_UNPACK_FAIL,
+                             string("Failed to create dir: ") + strerror(errno));
+            }
+        } else if (!S_ISDIR(st.st_mode)) {
+            throw BError(BError::Codes::UTILS_TARBALL_UNPACK_FAIL, "Parent path is not a directory");
+        }
+        checkedDirs_.insert(dir);
+    }
+}
+
+void TarExtractor::ExtractFile(const string &path, const TarHeader &hdr, uint64_t size)
+{
+    struct stat st = {};
+    if (lstat(path.c_str(), &st) == 0 && !S_ISREG(st.st_mode) && !S_ISDIR(st.st_mode)) {
+        unlink(path.c_str());
+    }
+    uint64_t mode = 0;
+    DecodeNumber(hdr.mode, sizeof(hdr.mode), mode);
+    UniqueFd fd(open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW | O_CLOEXEC,
+                     static_cast<mode_t>(mode & PERMISSION_MASK)));
+    if (fd < 0) {
+        throw BError(BError::Codes::UTILS_TARBALL_UNPACK_FAIL, string("Failed to create file: ") + strerror(errno));
+    }
+    bool writeOk = true;
+    if (!reader_.CopyTo(fd, size, writeOk) || !reader_.Skip(PaddingOf(size))) {
+        throw BError(BError::Codes::UTILS_TARBALL_UNPACK_FAIL, "Unexpected EOF in file data");
+    }
+    if (!writeOk) {
+        throw BError(BError::Codes::UTILS_TARBALL_UNPACK_FAIL, string("Failed to write file: ") + strerror(errno));
+    }
+    uint64_t mtime = 0;
+    DecodeNumber(hdr.mtime, sizeof(hdr.mtime), mtime);
+    struct timespec times[2] = {{0, UTIME_OMIT}, {static_cast<time_t>(mtime), 0}};
+    if (fchmod(fd, static_cast<mode_t>(mode & PERMISSION_MASK)) != 0 || futimens(fd, times) != 0) {
+        HILOGW("Failed to restore file attributes, errno = %{public}d", errno);
+    }
+}
+
+void TarExtractor::ExtractDir(const string &path, const TarHeader &hdr)
+{
+    struct stat st = {};
+    if (lstat(path.c_str(), &st) == 0 && !S_ISDIR(st.st_mode)) {
+        unlink(path.c_str());
+    }
+    if (mkdir(path.c_str(), DIR_CREATE_MODE) != 0 && errno != EEXIST) {
+        throw BError(BError::Codes::UTILS_TARBALL_UNPACK_FAIL, string("Failed to create dir: ") + strerror(errno));
+    }
+    uint64_t mode = 0;
+    uint64_t mtime = 0;
+    DecodeNumber(hdr.mode, sizeof(hdr.mode), mode);
+    DecodeNumber(hdr.mtime, sizeof(hdr.mtime), mtime);
+    dirs_.emplace_back(path, static_cast<mode_t>(mode & PERMISSION_MASK), static_cast<time_t>(mtime));
+}
+
+void TarExtractor::ExtractLink(const string &path, char type, const string &linkName)
+{
+    struct stat st = {};
+    if (lstat(path.c_str(), &st) == 0 && !S_ISDIR(st.st_mode)) {
+        unlink(path.c_str());
+    }
+    if (type == SYMTYPE) {
+        if (symlink(linkName.c_str(), path.c_str()) != 0) {
+            throw BError(BError::Codes::UTILS_TARBALL_UNPACK_FAIL,
+                         string("Failed to create symlink: ") + strerror(errno));
+        }
+        return;
+    }
+    string target;
+    if (!SanitizeName(linkName, target) || target.empty()) {
+        throw BError(BError::Codes::UTILS_TARBALL_UNPACK_FAIL, "Hard link target escapes the root");
+    }
+    if (link(JoinPath(root_, target).c_str(), path.c_str()) != 0) {
+        throw BError(BError::Codes::UTILS_TARBALL_UNPACK_FAIL,
+                     string("Failed to create hard link: ") + strerror(errno));
+    }
+}
+
+bool TarExtractor::ExtractNext(string &entryName)
+{
+    PaxAttrs pax;
+    string longName;
+    string longLink;
+    TarHeader hdr {};
+    while (true) {
+        if (!reader_.Read(&hdr, sizeof(hdr)) || IsZeroBlock(reinterpret_cast<const char *>(&hdr))) {
+            return false;
+        }
+        if (!VerifyChecksum(hdr)) {
+            throw BError(BError::Codes::UTILS_TARBALL_UNPACK_FAIL, "Bad header checksum");
+        }
+        uint64_t size = 0;
+        if (!DecodeNumber(hdr.size, sizeof(hdr.size), size)) {
+            throw BError(BError::Codes::UTILS_TARBALL_UNPACK_FAIL, "Bad header size");
+        }
+        if (hdr.typeFlag == GNUTYPE_LONGNAME) {
+            longName = ReadLongValue(size);
+        } else if (hdr.typeFlag == GNUTYPE_LONGLINK) {
+            longLink = ReadLongValue(size);
+        } else if (hdr.typeFlag == PAX_EXTENDED || hdr.typeFlag == PAX_GLOBAL) {
+            string data = ReadLongValue(size);
+            if (hdr.typeFlag == PAX_EXTENDED) {
+                ParsePaxRecords(data, pax);
+            }
+        } else {
+            break;
+        }
+    }
+    uint64_t size = 0;
+    DecodeNumber(hdr.size, sizeof(hdr.size), size);
+    size = pax.hasSize ? pax.size : size;
+    string name = !pax.path.empty() ? pax.path : longName;
+    if (name.empty()) {
+        name = FieldToString(hdr.name, sizeof(hdr.name));
+        string prefix = FieldToString(hdr.prefix, sizeof(hdr.prefix));
+        if (memcmp(hdr.magic, POSIX_MAGIC.data(), sizeof(hdr.magic)) == 0 && !prefix.empty()) {
+            name = prefix + "/" + name;
+        }
+    }
+    string linkName = !pax.linkPath.empty() ? pax.linkPath : longLink;
+    linkName = linkName.empty() ? FieldToString(hdr.linkName, sizeof(hdr.linkName)) : linkName;
+    if (!SanitizeName(name, entryName)) {
+        throw BError(BError::Codes::UTILS_TARBALL_UNPACK_FAIL, "Entry path escapes the root");
+    }
+    // 链接/设备/目录/管道类型(1~6)没有数据块, 其余类型按size跳过
+    bool hasData = hdr.typeFlag < LNKTYPE || hdr.typeFlag > FIFOTYPE;
+    bool isRegular = hdr.typeFlag == REGTYPE || hdr.typeFlag == AREGTYPE || hdr.typeFlag == CONTTYPE;
+    if (entryName.empty() || !(isRegular || hdr.typeFlag == DIRTYPE || hdr.typeFlag == SYMTYPE ||
+                               hdr.typeFlag == LNKTYPE)) {
+        if (!reader_.Skip(hasData ? size + PaddingOf(size) : 0)) {
+            throw BError(BError::Codes::UTILS_TARBALL_UNPACK_FAIL, "Unexpected EOF in skipped entry");
+        }
+        return true;
+    }
+    EnsureParentDirs(entryName);
+    string path = JoinPath(root_, entryName);
+    if (isRegular) {
+        ExtractFile(path, hdr, size);
+    } else if (hdr.typeFlag == DIRTYPE) {
+        ExtractDir(path, hdr);
+        checkedDirs_.insert(entryName);
+    } else {
+        ExtractLink(path, hdr.typeFlag, linkName);
+    }
+    return true;
+}
+} // namespace
+
+void BTarballNative::CollectEntries(string_view root,
+                                    const vector<string_view> &includes,
+                                    const vector<string_view> &excludes,
+                                    vector<Entry> &entries)
+{
+    vector<string> excludePatterns(excludes.begin(), excludes.end());
+    set<string> seen;
+    for (auto &include : includes) {
+        bool isAbsolute = !include.empty() && include.front() == '/';
+        string pattern = isAbsolute ? string(include) : JoinPath(root, include);
+        vector<string> stack = BDir::GetDirs({pattern});
+        reverse(stack.begin(), stack.end());
+        while (!stack.empty()) {
+            string fullPath = stack.back();
+            stack.pop_back();
+            while (fullPath.size() > 1 && fullPath.back() == '/') {
+                fullPath.pop_back();
+            }
+            string name;
+            string rel = isAbsolute ? fullPath : fullPath.substr(min(fullPath.size(), JoinPath(root, "").size()));
+            if (!SanitizeName(rel, name) || BDir::IsDirsMatch(excludePatterns, name) ||
+                BDir::IsDirsMatch(excludePatterns, fullPath)) {
+                continue;
+            }
+            Entry entry {fullPath, name, {}};
+            if (lstat(fullPath.c_str(), &entry.st) != 0) {
+                HILOGE("Failed to lstat file to pack, errno = %{public}d", errno);
+                continue;
+            }
+            if (!S_ISDIR(entry.st.st_mode)) {
+                if (!name.empty() && seen.insert(name).second) {
+                    entries.emplace_back(move(entry));
+                }
+                continue;
+            }
+            // 根目录本身(如include为".")不生成条目, 只展开其内容
+            if (!seen.insert(name + "/").second) {
+                continue;
+            }
+            if (!name.empty()) {
+                entry.name += "/";
+                entries.emplace_back(move(entry));
+            }
+            unique_ptr<DIR, function<void(DIR *)>> dir = {opendir(fullPath.c_str()), closedir};
+            if (dir == nullptr) {
+                HILOGE("Failed to open dir to pack, errno = %{public}d", errno);
+                continue;
+            }
+            vector<string> children;
+            struct dirent *ptr = nullptr;
+            while (!!(ptr = readdir(dir.get()))) {
+                if (strcmp(ptr->d_name, ".") != 0 && strcmp(ptr->d_name, "..") != 0) {
+                    children.emplace_back(JoinPath(fullPath, ptr->d_name));
+                }
+            }
+            sort(children.rbegin(), children.rend());
+            stack.insert(stack.end(), children.begin(), children.end());
+        }
+    }
+}
+
+void BTarballNative::ReportProgress(string_view name, uint64_t done, uint64_t total)
+{
+    if (progressCb_) {
+        progressCb_(name, done, total);
+    }
+}
+
+void BTarballNative::Tar(string_view root, vector<string_view> includes, vector<string_view> excludes)
+{
+    if (includes.empty()) {
+        throw BError(BError::Codes::UTILS_INVAL_TARBALL_ARG, "tar includes argument must be not empty");
+    }
+    vector<Entry> entries;
+    CollectEntries(root, includes, excludes, entries);
+    if (entries.empty()) {
+        HILOGE("The package path does not exist, and an empty package is generated");
+    }
+    uint64_t total = 0;
+    for (auto &entry : entries) {
+        total += S_ISREG(entry.st.st_mode) ? static_cast<uint64_t>(entry.st.st_size) : 0;
+    }
+
+    UniqueFd fd(open(tarballPath_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, TARBALL_CREATE_MODE));
+    if (fd < 0) {
+        throw BError(BError::Codes::UTILS_TARBALL_PACK_FAIL, string("Failed to create tarball: ") + strerror(errno));
+    }
+    try {
+        TarWriter writer(fd);
+        uint64_t done = 0;
+        for (auto &entry : entries) {
+            done += PackOneEntry(writer, entry.fullPath, entry.name, entry.st);
+            ReportProgress(entry.name, min(done, total), total);
+        }
+        writer.WriteZeros(BLOCK_SIZE * 2);
+        writer.Flush();
+    } catch (const BError &) {
+        unlink(tarballPath_.c_str());
+        throw;
+    }
+}
+
+void BTarballNative::Untar(string_view root)
+{
+    UniqueFd fd(open(tarballPath_.c_str(), O_RDONLY | O_CLOEXEC));
+    struct stat st = {};
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        throw BError(BError::Codes::UTILS_TARBALL_UNPACK_FAIL, string("Failed to open tarball: ") + strerror(errno));
+    }
+    uint64_t total = static_cast<uint64_t>(st.st_size);
+    TarReader reader(fd);
+    TarExtractor extractor(reader, root);
+    string name;
+    bool hasEntry = false;
+    while (extractor.ExtractNext(name)) {
+        hasEntry = true;
+        ReportProgress(name, reader.Offset(), total);
+    }
+    extractor.FinishDirs();
+    if (!hasEntry && reader.Offset() == 0) {
+        throw BError(BError::Codes::UTILS_TARBALL_UNPACK_FAIL, "Empty archive");
+    }
+}
+
+void BTarballNative::SetProgressCallback(ProgressCallback callback)
+{
+    progressCb_ = move(callback);
+}
+
+BTarballNative::BTarballNative(string_view tarballDir, string_view tarballName)
+    : tarballDir_(tarballDir), tarballName_(tarballName)
+{
+    tarballPath_ = tarballDir_ + "/" + tarballName_;
+}
+} // namespace OHOS::FileManagement::Backup
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "b_utils/b_span_tracer.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "filemgmt_libhilog.h"
+
+namespace OHOS::FileManagement::Backup {
+using namespace std;
+
+namespace {
+constexpr uint64_t NS_PER_SEC = 1000000000;
+constexpr uint64_t NS_PER_US = 1000;
+const char *PROC_COMM_PATH = "/proc/self/comm";
+} // namespace
+
+atomic<bool> BSpanTracer::enabled_ {false};
+
+/**
+ * @brief 线程退出时归还环形缓冲区, 已记录的数据保留到被下一个线程覆盖
+ */
+class BSpanTracer::RingHolder {
+public:
+    ~RingHolder()
+    {
+        if (ring_ != nullptr) {
+            BSpanTracer::GetInstance().ReleaseRing(ring_);
+        }
+    }
+
+    Ring *Get()
+    {
+        if (ring_ == nullptr) {
+            ring_ = BSpanTracer::GetInstance().AcquireRing();
+        }
+        return ring_;
+    }
+
+private:
+    Ring *ring_ = nullptr;
+};
+
+static uint32_t GetTid()
+{
+    thread_local uint32_t tid = static_cast<uint32_t>(syscall(SYS_gettid));
+    return tid;
+}
+
+static string EscapeJson(const char *str)
+{
+    string result;
+    for (const char *p = str; *p != '\0'; p++) {
+        if (*p == '"' || *p == '\\') {
+            result.push_back('\\');
+        }
+        if (static_cast<unsigned char>(*p) >= ' ') {
+            result.push_back(*p);
+        }
+    }
+    return result;
+}
+
+static string GetProcessName()
+{
+    ifstream comm(PROC_COMM_PATH);
+    string name;
+    getline(comm, name);
+    return name;
+}
+
+BSpanTracer &BSpanTracer::GetInstance()
+{
+    static BSpanTracer instance;
+    return instance;
+}
+
+uint64_t BSpanTracer::NowNs()
+{
+    struct timespec ts = {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * NS_PER_SEC + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+void BSpanTracer::SetEnabled(bool enabled)
+{
+    HILOGI("span tracer %{public}s", enabled ? "enabled" : "disabled");
+    enabled_.store(enabled, memory_order_relaxed);
+}
+
+BSpanTracer::Ring *BSpanTracer::AcquireRing()
+{
+    lock_guard<mutex> lock(ringsLock_);
+    if (!freeRings_.empty()) {
+        Ring *ring = freeRings_.back();
+        freeRings_.pop_back();
+        return ring;
+    }
+    rings_.emplace_back(make_unique<Ring>());
+    return rings_.back().get();
+}
+
+void BSpanTracer::ReleaseRing(Ring *ring)
+{
+    lock_guard<mutex> lock(ringsLock_);
+    freeRings_.push_back(ring);
+}
+
+void BSpanTracer::Record(const char *name, uint64_t beginNs, uint64_t endNs)
+{
+    thread_local RingHolder holder;
+    Ring *ring = holder.Get();
+    uint64_t idx = ring->head.load(memory_order_relaxed);
+    Event &event = ring->events[idx % RING_CAPACITY];
+    event.name.store(name, memory_order_relaxed);
+    event.beginNs.store(beginNs, memory_order_relaxed);
+    event.endNs.store(endNs, memory_order_relaxed);
+    event.tid.store(GetTid(), memory_order_relaxed);
+    ring->head.store(idx + 1, memory_order_release);
+}
+
+bool BSpanTracer::ExportChromeTrace(const string &path)
+{
+    int pid = static_cast<int>(getpid());
+    string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" + to_string(pid) +
+        ",\"args\":{\"name\":\"" + EscapeJson(GetProcessName().c_str()) + "\"}}";
+    size_t count = 0;
+    {
+        lock_guard<mutex> lock(ringsLock_);
+        for (const auto &ring : rings_) {
+            uint64_t head = ring->head.load(memory_order_acquire);
+            uint64_t begin = head > RING_CAPACITY ? head - RING_CAPACITY : 0;
+            for (uint64_t i = begin; i < head; i++) {
+                const Event &event = ring->events[i % RING_CAPACITY];
+                const char *name = event.name.load(memory_order_relaxed);
+                uint64_t beginNs = event.beginNs.load(memory_order_relaxed);
+                uint64_t endNs = event.endNs.load(memory_order_relaxed);
+                if (name == nullptr || endNs < beginNs) {
+                    continue;
+                }
+                char timing[64] = {0}; // 64: 足够容纳两个微秒精度的时间
+                snprintf(timing, sizeof(timing), "%" PRIu64 ".%03" PRIu64 ",\"dur\":%" PRIu64 ".%03" PRIu64,
+                    beginNs / NS_PER_US, beginNs % NS_PER_US, (endNs - beginNs) / NS_PER_US,
+                    (endNs - beginNs) % NS_PER_US);
+                out += ",{\"name\":\"" + EscapeJson(name) + "\",\"cat\":\"backup\",\"ph\":\"X\",\"ts\":" + timing +
+                    ",\"pid\":" + to_string(pid) + ",\"tid\":" + to_string(event.tid.load(memory_order_relaxed)) +
+                    "}";
+                count++;
+            }
+        }
+    }
+    out += "]}\n";
+    ofstream file(path, ios::out | ios::trunc);
+    if (!file) {
+        HILOGE("Failed to open trace file, errno = %{public}d", errno);
+        return false;
+    }
+    file << out;
+    file.close();
+    if (!file) {
+        HILOGE("Failed to write trace file, errno = %{public}d", errno);
+        return false;
+    }
+    HILOGI("span tracer exported %{public}zu events", count);
+    return true;
+}
+
+void BSpanTracer::Clear()
+{
+    lock_guard<mutex> lock(ringsLock_);
+    for (const auto &ring : rings_) {
+        for (auto &event : ring->events) {
+            event.name.store(nullptr, memory_order_relaxed);
+        }
+        ring->head.store(0, memory_order_release);
+    }
+}
+} // namespace OHOS::FileManagement::Backup
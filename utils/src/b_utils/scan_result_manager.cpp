@@ -86,17 +86,40 @@ uint64_t ScanResultManager::GetMaxTarSize()
     return maxTarSize_.load();
 }
 
+std::string ScanResultManager::RegisterHashName(const std::string &filePath)
+{
+    // 登记成功即视为未占用, 冲突时按确定顺序重新生成
+    return StringUtils::GenHashName(filePath, [this](const std::string &hashName) {
+        return !hashNames_.Insert(hashName);
+    });
+}
+
+bool ScanResultManager::PushPendingFile(std::shared_ptr<IFileInfo> fileInfo)
+{
+    if (!pendingFileQueue_.Push(std::move(fileInfo))) {
+        HILOGW("Pending files stopped, drop the file");
+        return false;
+    }
+    NotifyFilesReady();
+    return true;
+}
+
+void ScanResultManager::NotifyFilesReady()
+{
+    // 仅在有消费者等待时加锁, 避免生产者之间在同一把锁上排队
+    if (filesWaiters_.load() > 0) {
+        std::lock_guard<std::mutex> lock(mutexLock_);
+    }
+    waitFilesReady_.notify_all();
+}
+
 void ScanResultManager::AddBigFile(const std::string &filePath,
                                    const struct stat &sta,
                                    bool isLongPath,
-                                   const std::string &restorePath)
+                                   const std::string &restorePath,
+                                   uint32_t dirDepth)
 {
-    std::lock_guard<std::mutex> lock(pendingFileMutex_);
-    std::string hashName = StringUtils::GenHashName(filePath);
-    for (size_t i = 0; hashNameSet_.find(hashName) != hashNameSet_.end(); i++) {
-        hashName = StringUtils::GenHashName(filePath + std::to_string(i));
-    }
-    hashNameSet_.emplace(hashName);
+    std::string hashName = RegisterHashName(filePath);
     std::string fileName = ExtractFileName(filePath);
     std::string ext = ExtractFileExt(fileName);
     if (!ext.empty() && ext.find(BConstants::ANCO_TAG) == std::string::npos) {
@@ -105,41 +128,42 @@ void ScanResultManager::AddBigFile(const std::string &filePath,
     if (restorePath.empty()) {
         auto file = std::make_shared<FileInfo>(hashName, filePath, sta, true);
         file->isLongPath_ = isLongPath;
-        pendingFileQueue_.push(file);
+        file->dirDepth_ = dirDepth;
+        PushPendingFile(file);
     } else {
         auto file = std::make_shared<CompatibleFileInfo>(hashName, filePath, sta, true, restorePath);
         file->isLongPath_ = isLongPath;
-        pendingFileQueue_.push(file);
+        file->dirDepth_ = dirDepth;
+        PushPendingFile(file);
     }
-    waitFilesReady_.notify_all();
 }
 
-void ScanResultManager::AddTarFile(const std::string& filename, const std::string& filePath, const struct stat& sta)
+void ScanResultManager::AddTarFile(const std::string& filename, const std::string& filePath, const struct stat& sta,
+    uint64_t reservedSize)
 {
-    std::lock_guard<std::mutex> lock(pendingFileMutex_);
     if (sta.st_size < 0) {
         HILOGE("st_size is negative, fileName:%{public}s!", filename.c_str());
+        CancelTarBudget(reservedSize);
         return;
     }
-    pendingFileQueue_.push(std::make_shared<FileInfo>(filename, filePath, sta, false));
-    currentTarSize_.fetch_add(sta.st_size);
-    if (currentTarSize_.load() > GetMaxTarSize()) {
-        HILOGW("meet max tar size, stop scan. tarSize=%{public}uM",
-            static_cast<uint32_t>(currentTarSize_.load() / MEGA_BYTE));
-        stopPacket_.store(true);
+    // tar包已落盘, 先按实际大小修正预占的空间预算再入队, 保证出队释放时不会减到负数
+    uint64_t actualSize = static_cast<uint64_t>(sta.st_size);
+    uint64_t tarSize = 0;
+    if (actualSize >= reservedSize) {
+        tarSize = currentTarSize_.fetch_add(actualSize - reservedSize) + actualSize - reservedSize;
+    } else {
+        tarSize = currentTarSize_.fetch_sub(reservedSize - actualSize) - (reservedSize - actualSize);
     }
-    waitFilesReady_.notify_all();
+    if (tarSize > GetMaxTarSize()) {
+        HILOGW("meet max tar size, stop scan. tarSize=%{public}uM", static_cast<uint32_t>(tarSize / MEGA_BYTE));
+    }
+    PushPendingFile(std::make_shared<FileInfo>(filename, filePath, sta, false));
 }
 
 void ScanResultManager::AddAncoBigFile(
     const std::string &filePath, const std::string &restorePath, const struct stat &sta)
 {
-    std::lock_guard<std::mutex> lock(pendingFileMutex_);
-    std::string hashName = StringUtils::GenHashName(filePath);
-    for (size_t i = 0; hashNameSet_.find(hashName) != hashNameSet_.end(); i++) {
-        hashName = StringUtils::GenHashName(filePath + std::to_string(i));
-    }
-    hashNameSet_.emplace(hashName);
+    std::string hashName = RegisterHashName(filePath);
     hashName += BConstants::ANCO_TAG;
     std::string fileName = ExtractFileName(filePath);
     std::string ext = ExtractFileExt(fileName);
@@ -147,58 +171,68 @@ void ScanResultManager::AddAncoBigFile(
         hashName += "." + ext;
     }
     if (restorePath.empty()) {
-        pendingFileQueue_.push(std::make_shared<AncoFileInfo>(hashName, filePath, sta, true));
+        PushPendingFile(std::make_shared<AncoFileInfo>(hashName, filePath, sta, true));
     } else {
-        pendingFileQueue_.push(
-            std::make_shared<AncoCompatibleFileInfo>(hashName, filePath, sta, true, restorePath));
+        PushPendingFile(std::make_shared<AncoCompatibleFileInfo>(hashName, filePath, sta, true, restorePath));
     }
-    waitFilesReady_.notify_all();
 }
 
 void ScanResultManager::AddAncoTarFile(const std::string &filename, const std::string &filePath, const struct stat &sta)
 {
-    std::lock_guard<std::mutex> lock(pendingFileMutex_);
-    pendingFileQueue_.push(std::make_shared<AncoFileInfo>(filename, filePath, sta, false));
-    currentTarSize_.fetch_add(sta.st_size);
-    if (currentTarSize_.load() > GetMaxTarSize()) {
-        HILOGW("meet max tar size, stop scan. tarSize=%{public}uM",
-            static_cast<uint32_t>(currentTarSize_.load() / MEGA_BYTE));
-        stopPacket_.store(true);
+    uint64_t tarSize = currentTarSize_.fetch_add(sta.st_size) + static_cast<uint64_t>(sta.st_size);
+    if (tarSize > GetMaxTarSize()) {
+        HILOGW("meet max tar size, stop scan. tarSize=%{public}uM", static_cast<uint32_t>(tarSize / MEGA_BYTE));
+    }
+    PushPendingFile(std::make_shared<AncoFileInfo>(filename, filePath, sta, false));
+}
+
+void ScanResultManager::ReleaseTarBudget(const std::shared_ptr<IFileInfo> &fileInfo)
+{
+    if (fileInfo == nullptr || fileInfo->isBigFile_) {
+        return;
+    }
+    currentTarSize_.fetch_sub(fileInfo->sta_.st_size);
+    if (!IsTarBudgetExhausted() || !HasFileReady()) {
+        StartPacket();
     }
-    waitFilesReady_.notify_all();
 }
 
 std::shared_ptr<IFileInfo> ScanResultManager::GetFileInfo()
 {
-    std::lock_guard<std::mutex> lock(pendingFileMutex_);
-    if (!pendingFileQueue_.empty()) {
-        std::shared_ptr<IFileInfo> fileInfo = pendingFileQueue_.front();
-        pendingFileQueue_.pop();
-        if (fileInfo != nullptr && !fileInfo->isBigFile_) {
-            currentTarSize_.fetch_sub(fileInfo->sta_.st_size);
-            if (currentTarSize_.load() < GetMaxTarSize()) {
-                StartPacket();
-            }
-        }
-        return fileInfo;
+    std::shared_ptr<IFileInfo> fileInfo = nullptr;
+    if (!pendingFileQueue_.TryPop(fileInfo)) {
+        return nullptr;
     }
-    return nullptr;
+    ReleaseTarBudget(fileInfo);
+    return fileInfo;
+}
+
+std::vector<std::shared_ptr<IFileInfo>> ScanResultManager::GetFileInfos(size_t maxCount)
+{
+    std::vector<std::shared_ptr<IFileInfo>> fileInfos;
+    pendingFileQueue_.PopBatch(fileInfos, maxCount, [](const std::shared_ptr<IFileInfo> &fileInfo) {
+        return fileInfo != nullptr && !fileInfo->isBigFile_;
+    });
+    return fileInfos;
 }
 
 bool ScanResultManager::HasFileReady()
 {
-    std::lock_guard<std::mutex> lock(pendingFileMutex_);
-    return !pendingFileQueue_.empty();
+    return !pendingFileQueue_.Empty();
 }
 
-void ScanResultManager::AddSmallFile(const std::string& filePath, size_t fileSize, const std::string& restorePath)
+void ScanResultManager::AddSmallFile(const std::string& filePath, size_t fileSize, const std::string& restorePath,
+    uint32_t dirDepth)
 {
-    std::lock_guard<std::mutex> lock(smallFileMutex_);
+    std::shared_ptr<ISmallFileInfo> file = nullptr;
     if (restorePath.empty()) {
-        smallFiles_.push_back(std::make_shared<SmallFileInfo>(filePath, fileSize));
+        file = std::make_shared<SmallFileInfo>(filePath, fileSize);
     } else {
-        smallFiles_.push_back(std::make_shared<CompatibleSmallFileInfo>(filePath, fileSize, restorePath));
+        file = std::make_shared<CompatibleSmallFileInfo>(filePath, fileSize, restorePath);
     }
+    file->dirDepth_ = dirDepth;
+    std::lock_guard<std::mutex> lock(smallFileMutex_);
+    smallFiles_.push_back(std::move(file));
 }
 
 void ScanResultManager::AddAllFile(std::shared_ptr<IFileInfo> &fileInfo)
@@ -253,7 +287,9 @@ void ScanResultManager::SetCallerBundleName(const std::string& callerBundleName)
 void ScanResultManager::WaitForFiles()
 {
     std::unique_lock<std::mutex> lock(mutexLock_);
+    filesWaiters_.fetch_add(1);
     waitFilesReady_.wait(lock, [this] {return HasFileReady() || IsProcessCompleted(); });
+    filesWaiters_.fetch_sub(1);
 }
 
 void ScanResultManager::WaitForCompleted()
@@ -262,16 +298,68 @@ void ScanResultManager::WaitForCompleted()
     waitFilesReady_.wait(lock, [this] {return IsProcessCompleted(); });
 }
 
+bool ScanResultManager::IsTarBudgetExhausted()
+{
+    return currentTarSize_.load() > GetMaxTarSize();
+}
+
 void ScanResultManager::StartPacket()
 {
-    stopPacket_.store(false);
+    if (packetWaiters_.load() > 0) {
+        std::lock_guard<std::mutex> lock(mutexPacket_);
+    }
     waitPacketFlag_.notify_all();
 }
 
 void ScanResultManager::WaitForPacketFlag()
 {
     std::unique_lock<std::mutex> lock(mutexPacket_);
-    waitPacketFlag_.wait(lock, [this] {return !HasFileReady() || !stopPacket_.load(); });
+    packetWaiters_.fetch_add(1);
+    waitPacketFlag_.wait(lock, [this] {return !HasFileReady() || !IsTarBudgetExhausted(); });
+    packetWaiters_.fetch_sub(1);
+}
+
+void ScanResultManager::ReserveTarBudget(uint64_t size)
+{
+    // 判断与预占在同一把锁内完成, 后一路能看到前一路的预占, 避免各路同时通过判断后一起超出预算
+    std::unique_lock<std::mutex> lock(mutexPacket_);
+    packetWaiters_.fetch_add(1);
+    waitPacketFlag_.wait(lock, [this] {
+        return !HasFileReady() || !IsTarBudgetExhausted() || pendingFileQueue_.IsClosed();
+    });
+    packetWaiters_.fetch_sub(1);
+    currentTarSize_.fetch_add(size);
+}
+
+void ScanResultManager::StopPendingFiles()
+{
+    pendingFileQueue_.Close();
+    pendingFileQueue_.Clear();
+    currentTarSize_.store(0);
+    NotifyFilesReady();
+    StartPacket();
+}
+
+void ScanResultManager::ResetPendingFiles()
+{
+    // 停止期间的预算增减已无意义, 统一清零
+    pendingFileQueue_.Clear();
+    currentTarSize_.store(0);
+    pendingFileQueue_.Reopen();
+}
+
+bool ScanResultManager::IsPendingStopped()
+{
+    return pendingFileQueue_.IsClosed();
+}
+
+void ScanResultManager::CancelTarBudget(uint64_t size)
+{
+    if (size == 0) {
+        return;
+    }
+    currentTarSize_.fetch_sub(size);
+    StartPacket();
 }
 
 } // namespace OHOS::FileManagement::Backup
@@ -24,6 +24,22 @@
 namespace OHOS::FileManagement::Backup {
 constexpr size_t CLOUD_HASH_LENGTH = 33;
 constexpr size_t MAX_SERIALIZED_SIZE = 16 * 1024 * 1024;
+constexpr uint32_t BITS_PER_BYTE = 8;
+constexpr uint32_t BIT_COUNT_OF_UINT64 = 64;
+constexpr size_t MURMUR_BLOCK_SIZE = 16;
+constexpr uint64_t MURMUR_C1 = 0x87c37b91114253d5ULL;
+constexpr uint64_t MURMUR_C2 = 0x4cf5ad432745937fULL;
+constexpr uint64_t MURMUR_MUL = 5;
+constexpr uint64_t MURMUR_H1_ADD = 0x52dce729;
+constexpr uint64_t MURMUR_H2_ADD = 0x38495ab5;
+constexpr uint32_t MURMUR_K1_ROTATE = 31;
+constexpr uint32_t MURMUR_K2_ROTATE = 33;
+constexpr uint32_t MURMUR_H1_ROTATE = 27;
+constexpr uint32_t MURMUR_H2_ROTATE = 31;
+constexpr uint32_t MURMUR_FMIX_SHIFT = 33;
+constexpr uint64_t MURMUR_FMIX_C1 = 0xff51afd7ed558ccdULL;
+constexpr uint64_t MURMUR_FMIX_C2 = 0xc4ceb9fe1a85ec53ULL;
+constexpr size_t HASH_NAME_HALF_COUNT = 2;
 
 bool StringUtils::EndsWith(const std::string& str, const std::string& suffix)
 {
@@ -61,7 +77,57 @@ std::string StringUtils::Concat(const std::vector<std::string>& strs, const std:
     return result;
 }
 
-std::string StringUtils::StringVectorSerialize(const std::vector<std::string>& vec)
+template <typename T>
+static bool ReadRaw(std::string_view data, size_t pos, T &value)
+{
+    if (pos > data.size() || data.size() - pos < sizeof(T)) {
+        return false;
+    }
+    return memcpy_s(&value, sizeof(T), data.data() + pos, sizeof(T)) == EOK;
+}
+
+StringVectorReader::StringVectorReader(std::string_view data) : data_(data)
+{
+    if (data_.size() < sizeof(uint64_t) || data_.size() > MAX_SERIALIZED_SIZE) {
+        Fail("data size invalid");
+        return;
+    }
+    ReadRaw(data_, 0, itemsLeft_);
+    pos_ = sizeof(uint64_t);
+    if (itemsLeft_ > data_.size() / sizeof(uint64_t)) {
+        Fail("count too large");
+        return;
+    }
+    count_ = static_cast<size_t>(itemsLeft_);
+}
+
+bool StringVectorReader::Fail(const char *reason)
+{
+    HILOGE("StringVectorReader invalid data at %{public}zu, size %{public}zu: %{public}s", pos_, data_.size(), reason);
+    error_ = true;
+    return false;
+}
+
+bool StringVectorReader::Next(std::string_view &item)
+{
+    if (error_) {
+        return false;
+    }
+    if (itemsLeft_ == 0) {
+        return pos_ == data_.size() ? false : Fail("trailing data");
+    }
+    uint64_t len = 0;
+    if (!ReadRaw(data_, pos_, len) || len > data_.size() - pos_ - sizeof(len)) {
+        return Fail("item exceeds data");
+    }
+    pos_ += sizeof(len);
+    item = data_.substr(pos_, static_cast<size_t>(len));
+    pos_ += static_cast<size_t>(len);
+    itemsLeft_--;
+    return true;
+}
+
+bool StringUtils::StringVectorSerialize(const std::vector<std::string>& vec, std::string& out)
 {
     size_t total = sizeof(uint64_t);
     for (const auto& str : vec) {
@@ -69,86 +135,46 @@ std::string StringUtils::StringVectorSerialize(const std::vector<std::string>& v
     }
     if (total > MAX_SERIALIZED_SIZE) {
         HILOGE("StringVectorSerialize total size %{public}zu exceeds limit %{public}zu", total, MAX_SERIALIZED_SIZE);
-        return {};
+        return false;
     }
-    std::string result;
-    result.resize(total);
-    size_t pos = 0;
+    // 直接追加到调用方缓冲区(如IPC原始数据), 格式与旧版一致: [count u64][[len u64][bytes]...]
+    out.reserve(out.size() + total);
     uint64_t count = static_cast<uint64_t>(vec.size());
-    if (memcpy_s(&result[pos], result.size() - pos, &count, sizeof(uint64_t)) != EOK) {
-        HILOGE("StringVectorSerialize write count failed");
-        result.clear();
-        return result;
-    }
-    pos += sizeof(uint64_t);
+    out.append(reinterpret_cast<const char *>(&count), sizeof(count));
     for (const auto& str : vec) {
         uint64_t len = static_cast<uint64_t>(str.size());
-        if (memcpy_s(&result[pos], result.size() - pos, &len, sizeof(uint64_t)) != EOK) {
-            HILOGE("StringVectorSerialize write len failed");
-            result.clear();
-            return result;
-        }
-        pos += sizeof(uint64_t);
-        if (len > 0 && memcpy_s(&result[pos], result.size() - pos, str.data(), static_cast<size_t>(len)) != EOK) {
-            HILOGE("StringVectorSerialize write str failed");
-            result.clear();
-            return result;
-        }
-        pos += static_cast<size_t>(len);
+        out.append(reinterpret_cast<const char *>(&len), sizeof(len));
+        out.append(str);
     }
-    return result;
+    return true;
 }
 
-static bool ReadOneString(const std::string& data, size_t& pos, std::string& out)
+bool StringUtils::StringVectorViews(std::string_view data, std::vector<std::string_view>& items)
 {
-    if (pos + sizeof(uint64_t) > data.size()) {
-        HILOGE("StringVectorDeserialize unexpected end of data at string length");
+    StringVectorReader reader(data);
+    items.clear();
+    items.reserve(reader.Count());
+    std::string_view item;
+    while (reader.Next(item)) {
+        items.emplace_back(item);
+    }
+    if (!reader.Good()) {
+        items.clear();
         return false;
     }
-    uint64_t len = 0;
-    if (memcpy_s(&len, sizeof(uint64_t), data.data() + pos, sizeof(uint64_t)) != EOK) {
-        HILOGE("StringVectorDeserialize read len failed");
-        return false;
-    }
-    pos += sizeof(uint64_t);
-    if (len > data.size() - pos) {
-        HILOGE("StringVectorDeserialize unexpected end of data at string content");
-        return false;
-    }
-    out.assign(data.data() + pos, static_cast<size_t>(len));
-    pos += static_cast<size_t>(len);
     return true;
 }
 
-std::vector<std::string> StringUtils::StringVectorDeserialize(const std::string& data)
+std::vector<std::string> StringUtils::StringVectorDeserialize(std::string_view data)
 {
     std::vector<std::string> result;
-    if (data.size() < sizeof(uint64_t) || data.size() > MAX_SERIALIZED_SIZE) {
-        HILOGE("StringVectorDeserialize data size %{public}zu invalid", data.size());
-        return result;
-    }
-    size_t pos = 0;
-    uint64_t count = 0;
-    if (memcpy_s(&count, sizeof(uint64_t), data.data() + pos, sizeof(uint64_t)) != EOK) {
-        HILOGE("StringVectorDeserialize read count failed");
-        return result;
-    }
-    pos += sizeof(uint64_t);
-    if (count > data.size() / sizeof(uint64_t)) {
-        HILOGE("StringVectorDeserialize count %{public}llu too large", static_cast<unsigned long long>(count));
-        return result;
-    }
-    result.reserve(static_cast<size_t>(count));
-    for (uint64_t i = 0; i < count; ++i) {
-        std::string item;
-        if (!ReadOneString(data, pos, item)) {
-            return {};
-        }
-        result.emplace_back(std::move(item));
+    StringVectorReader reader(data);
+    result.reserve(reader.Count());
+    std::string_view item;
+    while (reader.Next(item)) {
+        result.emplace_back(item);
     }
-    if (pos != data.size()) {
-        HILOGE("StringVectorDeserialize trailing data detected, pos=%{public}zu, dataSize=%{public}zu",
-            pos, data.size());
+    if (!reader.Good()) {
         return {};
     }
     return result;
@@ -186,16 +212,116 @@ std::pair<std::string, std::string> StringUtils::ParseMappingDir(const std::stri
     }
 }
 
-std::string StringUtils::GenHashName(const std::string &str)
+static inline uint64_t RotateLeft64(uint64_t x, uint32_t r)
+{
+    return (x << r) | (x >> (BIT_COUNT_OF_UINT64 - r));
+}
+
+static inline uint64_t FinalMix64(uint64_t k)
+{
+    k ^= k >> MURMUR_FMIX_SHIFT;
+    k *= MURMUR_FMIX_C1;
+    k ^= k >> MURMUR_FMIX_SHIFT;
+    k *= MURMUR_FMIX_C2;
+    k ^= k >> MURMUR_FMIX_SHIFT;
+    return k;
+}
+
+// 按小端序读取, 保证不同字节序平台上结果一致
+static inline uint64_t LoadLittleEndian64(const uint8_t *data)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < sizeof(uint64_t); i++) {
+        value |= static_cast<uint64_t>(data[i]) << (BITS_PER_BYTE * i);
+    }
+    return value;
+}
+
+/**
+ * MurmurHash3 x64_128, 与编译器和标准库实现无关, 同一路径在不同版本和设备上得到相同结果
+ */
+static std::pair<uint64_t, uint64_t> StableHash128(const std::string &str, uint32_t seed)
+{
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(str.data());
+    const size_t len = str.size();
+    const size_t blockCount = len / MURMUR_BLOCK_SIZE;
+    uint64_t h1 = seed;
+    uint64_t h2 = seed;
+    for (size_t i = 0; i < blockCount; i++) {
+        uint64_t k1 = LoadLittleEndian64(data + i * MURMUR_BLOCK_SIZE);
+        uint64_t k2 = LoadLittleEndian64(data + i * MURMUR_BLOCK_SIZE + sizeof(uint64_t));
+        k1 *= MURMUR_C1;
+        k1 = RotateLeft64(k1, MURMUR_K1_ROTATE);
+        k1 *= MURMUR_C2;
+        h1 ^= k1;
+        h1 = RotateLeft64(h1, MURMUR_H1_ROTATE);
+        h1 += h2;
+        h1 = h1 * MURMUR_MUL + MURMUR_H1_ADD;
+        k2 *= MURMUR_C2;
+        k2 = RotateLeft64(k2, MURMUR_K2_ROTATE);
+        k2 *= MURMUR_C1;
+        h2 ^= k2;
+        h2 = RotateLeft64(h2, MURMUR_H2_ROTATE);
+        h2 += h1;
+        h2 = h2 * MURMUR_MUL + MURMUR_H2_ADD;
+    }
+    const uint8_t *tail = data + blockCount * MURMUR_BLOCK_SIZE;
+    const size_t tailLen = len % MURMUR_BLOCK_SIZE;
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+    for (size_t i = 0; i < tailLen; i++) {
+        if (i < sizeof(uint64_t)) {
+            k1 |= static_cast<uint64_t>(tail[i]) << (BITS_PER_BYTE * i);
+        } else {
+            k2 |= static_cast<uint64_t>(tail[i]) << (BITS_PER_BYTE * (i - sizeof(uint64_t)));
+        }
+    }
+    if (tailLen > sizeof(uint64_t)) {
+        k2 *= MURMUR_C2;
+        k2 = RotateLeft64(k2, MURMUR_K2_ROTATE);
+        k2 *= MURMUR_C1;
+        h2 ^= k2;
+    }
+    if (tailLen > 0) {
+        k1 *= MURMUR_C1;
+        k1 = RotateLeft64(k1, MURMUR_K1_ROTATE);
+        k1 *= MURMUR_C2;
+        h1 ^= k1;
+    }
+    h1 ^= static_cast<uint64_t>(len);
+    h2 ^= static_cast<uint64_t>(len);
+    h1 += h2;
+    h2 += h1;
+    h1 = FinalMix64(h1);
+    h2 = FinalMix64(h2);
+    h1 += h2;
+    h2 += h1;
+    return {h1, h2};
+}
+
+static std::string FormatHashName(const std::pair<uint64_t, uint64_t> &hash)
 {
     std::ostringstream strHex;
-    strHex << std::hex;
-    std::hash<std::string> strHash;
-    size_t szHash = strHash(str);
-    strHex << std::setfill('0') << std::setw(BConstants::BIG_FILE_NAME_SIZE) << szHash;
+    strHex << std::hex << std::setfill('0') << std::setw(BConstants::BIG_FILE_NAME_SIZE / HASH_NAME_HALF_COUNT)
+           << hash.first << std::setw(BConstants::BIG_FILE_NAME_SIZE / HASH_NAME_HALF_COUNT) << hash.second;
     return strHex.str();
 }
 
+std::string StringUtils::GenHashName(const std::string &str)
+{
+    return FormatHashName(StableHash128(str, 0));
+}
+
+std::string StringUtils::GenHashName(const std::string &str, const std::function<bool(const std::string &)> &isUsed)
+{
+    // 冲突时换用不同的种子对同一路径重新哈希, 候选名序列只由路径决定, 不受其他文件登记顺序影响
+    std::string hashName = GenHashName(str);
+    for (uint32_t seed = 1; isUsed(hashName); seed++) {
+        hashName = FormatHashName(StableHash128(str, seed));
+    }
+    return hashName;
+}
+
 bool StringUtils::IsSubdirectory(const std::string &parent, const std::string &child)
 {
     auto newParent = AddTrailingSlash(parent);
@@ -347,4 +473,17 @@ bool StringUtils::IsPathWithDirectory(const std::string& filePath)
     size_t lastSlashPos = filePath.find_last_of("/");
     return (lastSlashPos != std::string::npos);
 }
+
+uint32_t StringUtils::GetPathDepth(std::string_view path)
+{
+    uint32_t depth = 0;
+    char pre = '-';
+    for (char c : path) {
+        if (c == BConstants::FILE_SEPARATOR_CHAR && pre != BConstants::FILE_SEPARATOR_CHAR) {
+            depth++;
+        }
+        pre = c;
+    }
+    return depth;
+}
 } // namespace OHOS::FileManagement::Backup
\ No newline at end of file